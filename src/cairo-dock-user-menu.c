@@ -45,7 +45,7 @@
 #include "cairo-dock-themes-manager.h"  // cairo_dock_update_conf_file
 #include "cairo-dock-file-manager.h"  // cairo_dock_copy_file
 #include "cairo-dock-log.h"
-#include "cairo-dock-utils.h"  // cairo_dock_launch_command_sync
+#include "cairo-dock-utils.h"  // cairo_dock_launch_command, cairo_dock_search_desktop_file
 #include "cairo-dock-desklet-manager.h"
 #include "cairo-dock-dock-manager.h"
 #include "cairo-dock-class-manager.h"
@@ -58,6 +58,7 @@
 #include "cairo-dock-gui-commons.h"
 #include "cairo-dock-applet-facility.h"  // cairo_dock_pop_up_about_applet
 #include "cairo-dock-menu.h"
+#include "cairo-dock-task.h"
 #include "cairo-dock-user-menu.h"
 
 #define CAIRO_DOCK_CONF_PANEL_WIDTH 1000
@@ -161,6 +162,21 @@ static void _cairo_dock_lock_icons (G_GNUC_UNUSED GtkMenuItem *pMenuItem, G_GNUC
 		G_TYPE_INVALID);
 }
 
+// set the state of a check-item of a menu that is shown again, without triggering its action.
+static void _set_check_item_state (GtkWidget *pMenuItem, gboolean bActive, gpointer data)
+{
+	if (gtk_check_menu_item_get_active (GTK_CHECK_MENU_ITEM (pMenuItem)) == bActive)
+		return;
+	g_signal_handlers_block_matched (pMenuItem, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, data);
+	gtk_check_menu_item_set_active (GTK_CHECK_MENU_ITEM (pMenuItem), bActive);
+	g_signal_handlers_unblock_matched (pMenuItem, G_SIGNAL_MATCH_DATA, 0, 0, NULL, NULL, data);
+}
+
+static void _update_lock_icons_item (GtkWidget *pMenuItem, G_GNUC_UNUSED gpointer data)
+{
+	_set_check_item_state (pMenuItem, myDocksParam.bLockIcons, NULL);
+}
+
 /* Not used
 static void _cairo_dock_lock_all (GtkMenuItem *pMenuItem, gpointer data)
 {
@@ -709,69 +725,98 @@ static void _cairo_dock_add_docks_sub_menu (GtkWidget *pMenu, Icon *pIcon)
 	g_list_free (pDocks);
 }
 
+static void _add_launcher_from_desktop_file (const gchar *cDesktopFilePath)
+{
+	cd_message ("found desktop file : %s", cDesktopFilePath);
+	// place it after the last launcher, since the user will probably want to move this new launcher amongst the already existing ones.
+	double fOrder = CAIRO_DOCK_LAST_ORDER;
+	Icon *pIcon;
+	GList *ic, *last_launcher_ic = NULL;
+	for (ic = g_pMainDock->icons; ic != NULL; ic = ic->next)
+	{
+		pIcon = ic->data;
+		if (CAIRO_DOCK_ICON_TYPE_IS_LAUNCHER (pIcon)
+		|| CAIRO_DOCK_ICON_TYPE_IS_CONTAINER (pIcon))
+		{
+			last_launcher_ic = ic;
+		}
+	}
+	if (last_launcher_ic != NULL)
+	{
+		ic = last_launcher_ic;
+		pIcon = ic->data;
+		Icon *next_icon = (ic->next ? ic->next->data : NULL);
+		if (next_icon != NULL && cairo_dock_get_icon_order (next_icon) == cairo_dock_get_icon_order (pIcon))
+			fOrder = (pIcon->fOrder + next_icon->fOrder) / 2;
+		else
+			fOrder = pIcon->fOrder + 1;
+	}
+	gldi_launcher_add_new (cDesktopFilePath, g_pMainDock, fOrder);  // add in the main dock
+}
+
+// the .desktop files are searched in a thread, since reading all of them can take a while.
+typedef struct {
+	gchar *cClass;
+	gchar *cDesktopFilePath;
+} CDDesktopFileSearch;
+static GldiTask *s_pDesktopFileSearchTask = NULL;
+
+static void _search_desktop_file_async (CDDesktopFileSearch *pSearch)
+{
+	pSearch->cDesktopFilePath = cairo_dock_search_desktop_file (pSearch->cClass, NULL);
+}
+static gboolean _on_desktop_file_found (CDDesktopFileSearch *pSearch)
+{
+	if (pSearch->cDesktopFilePath != NULL)
+	{
+		_add_launcher_from_desktop_file (pSearch->cDesktopFilePath);
+	}
+	else  // the icon may have been destroyed in the meantime, so take any window of the class.
+	{
+		const gchar *cMessage = _("Sorry, couldn't find the corresponding description file.\nConsider dragging and dropping the launcher from the Applications Menu.");
+		const GList *pApplis = cairo_dock_list_existing_appli_with_class (pSearch->cClass);
+		Icon *pIcon = (pApplis ? pApplis->data : NULL);
+		GldiContainer *pContainer = (pIcon ? cairo_dock_get_icon_container (pIcon) : NULL);
+		if (pContainer != NULL)
+			gldi_dialog_show_temporary_with_default_icon (cMessage, pIcon, pContainer, 8000);
+		else
+			gldi_dialog_show_general_message (cMessage, 8000);
+	}
+	gldi_task_discard (s_pDesktopFileSearchTask);
+	s_pDesktopFileSearchTask = NULL;
+	return FALSE;
+}
+static void _free_desktop_file_search (CDDesktopFileSearch *pSearch)
+{
+	g_free (pSearch->cClass);
+	g_free (pSearch->cDesktopFilePath);
+	g_free (pSearch);
+}
+
 static void _cairo_dock_make_launcher_from_appli (G_GNUC_UNUSED GtkMenuItem *pMenuItem, gpointer *data)
 {
 	Icon *icon = data[0];
-	CairoDock *pDock = data[1];
 	g_return_if_fail (icon->cClass != NULL);
 	
 	// look for the .desktop file of the program
 	cd_debug ("%s (%s)", __func__, icon->cClass);
-	gchar *cDesktopFilePath = g_strdup (cairo_dock_get_class_desktop_file (icon->cClass));
-	if (cDesktopFilePath == NULL)  // empty class
+	const gchar *cDesktopFilePath = cairo_dock_get_class_desktop_file (icon->cClass);
+	if (cDesktopFilePath != NULL)  // make a new launcher from this desktop file
 	{
-		gchar *cCommand = g_strdup_printf ("find /usr/share/applications /usr/local/share/applications -iname \"*%s*.desktop\"", icon->cClass);  // look for a desktop file from their file name
-		gchar *cResult = cairo_dock_launch_command_sync (cCommand);
-		if (cResult == NULL || *cResult == '\0')  // no luck, search harder
-		{
-			g_free (cCommand);
-			cCommand = g_strdup_printf ("find /usr/share/applications /usr/local/share/applications -name \"*.desktop\" -exec grep -qi '%s' {} \\; -print", icon->cClass);  // look for a desktop file from their content
-			cResult = cairo_dock_launch_command_sync (cCommand);
-		}
-		if (cResult != NULL && *cResult != '\0')
-		{
-			gchar *str = strchr (cResult, '\n');  // remove the trailing linefeed, and only take the first result
-			if (str)
-				*str = '\0';
-			cDesktopFilePath = cResult;
-		}
-		g_free (cCommand);
+		_add_launcher_from_desktop_file (cDesktopFilePath);
 	}
-	
-	// make a new launcher from this desktop file
-	if (cDesktopFilePath != NULL)
-	{
-		cd_message ("found desktop file : %s", cDesktopFilePath);
-		// place it after the last launcher, since the user will probably want to move this new launcher amongst the already existing ones.
-		double fOrder = CAIRO_DOCK_LAST_ORDER;
-		Icon *pIcon;
-		GList *ic, *last_launcher_ic = NULL;
-		for (ic = g_pMainDock->icons; ic != NULL; ic = ic->next)
-		{
-			pIcon = ic->data;
-			if (CAIRO_DOCK_ICON_TYPE_IS_LAUNCHER (pIcon)
-			|| CAIRO_DOCK_ICON_TYPE_IS_CONTAINER (pIcon))
-			{
-				last_launcher_ic = ic;
-			}
-		}
-		if (last_launcher_ic != NULL)
-		{
-			ic = last_launcher_ic;
-			pIcon = ic->data;
-			Icon *next_icon = (ic->next ? ic->next->data : NULL);
-			if (next_icon != NULL && cairo_dock_get_icon_order (next_icon) == cairo_dock_get_icon_order (pIcon))
-				fOrder = (pIcon->fOrder + next_icon->fOrder) / 2;
-			else
-				fOrder = pIcon->fOrder + 1;
-		}
-		gldi_launcher_add_new (cDesktopFilePath, g_pMainDock, fOrder);  // add in the main dock
-	}
-	else
+	else  // empty class, search its desktop file.
 	{
-		gldi_dialog_show_temporary_with_default_icon (_("Sorry, couldn't find the corresponding description file.\nConsider dragging and dropping the launcher from the Applications Menu."), icon, CAIRO_CONTAINER (pDock), 8000);
+		gldi_task_discard (s_pDesktopFileSearchTask);
+		CDDesktopFileSearch *pSearch = g_new0 (CDDesktopFileSearch, 1);
+		pSearch->cClass = g_strdup (icon->cClass);
+		s_pDesktopFileSearchTask = gldi_task_new_full (0,
+			(GldiGetDataAsyncFunc) _search_desktop_file_async,
+			(GldiUpdateSyncFunc) _on_desktop_file_found,
+			(GFreeFunc) _free_desktop_file_search,
+			pSearch);
+		gldi_task_launch (s_pDesktopFileSearchTask);
 	}
-	g_free (cDesktopFilePath);
 }
 
   //////////////////////////////////////////////////////////////////
@@ -1050,6 +1095,7 @@ gboolean cairo_dock_notification_build_container_menu (G_GNUC_UNUSED gpointer *p
 		gtk_check_menu_item_set_active (GTK_CHECK_MENU_ITEM (pMenuItem), myDocksParam.bLockIcons);
 		gtk_menu_shell_append  (GTK_MENU_SHELL (pSubMenu), pMenuItem);
 		g_signal_connect (G_OBJECT (pMenuItem), "toggled", G_CALLBACK (_cairo_dock_lock_icons), NULL);
+		gldi_menu_item_set_update_func (pMenuItem, _update_lock_icons_item, NULL);
 		gtk_widget_set_tooltip_text (pMenuItem, _("This will (un)lock the position of the icons."));
 	}
 
@@ -1580,6 +1626,33 @@ static void _cairo_dock_lock_position (GtkMenuItem *pMenuItem, gpointer *data)
 }
 
 
+static void _update_desklet_visibility_item (GtkWidget *pMenuItem, gpointer *data)
+{
+	CairoDesklet *pDesklet = data[1];
+	CairoDeskletVisibility iVisibility = GPOINTER_TO_INT (g_object_get_data (G_OBJECT (pMenuItem), "cd-visibility"));
+	if (pDesklet->iVisibility == iVisibility)  // the previous item of the group is unchecked by GTK, and does nothing in this case.
+		_set_check_item_state (pMenuItem, TRUE, data);
+}
+
+static void _update_desklet_sticky_item (GtkWidget *pMenuItem, gpointer *data)
+{
+	CairoDesklet *pDesklet = data[1];
+	_set_check_item_state (pMenuItem, gldi_desklet_is_sticky (pDesklet), data);
+}
+
+static void _update_desklet_lock_item (GtkWidget *pMenuItem, gpointer *data)
+{
+	CairoDesklet *pDesklet = data[1];
+	_set_check_item_state (pMenuItem, pDesklet->bPositionLocked, data);
+}
+
+static inline void _set_desklet_visibility_item (GtkWidget *pMenuItem, CairoDeskletVisibility iVisibility, gpointer *data)
+{
+	g_object_set_data (G_OBJECT (pMenuItem), "cd-visibility", GINT_TO_POINTER (iVisibility));
+	gldi_menu_item_set_update_func (pMenuItem, (GldiMenuItemUpdateFunc) _update_desklet_visibility_item, data);
+}
+
+
   ////////////////////////////////////
  /// BUILD ICON MENU NOTIFICATION ///
 ////////////////////////////////////
@@ -1716,9 +1789,12 @@ static GtkWidget *_add_new_button_to_hbox (const gchar *gtkStock, const gchar *c
 		if (*gtkStock == '/')
 		{
 			int size = cairo_dock_search_icon_size (GTK_ICON_SIZE_MENU);
-			GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file_at_size (gtkStock, size, size, NULL);
-			pImage = gtk_image_new_from_pixbuf (pixbuf);
-			g_object_unref (pixbuf);
+			GdkPixbuf *pixbuf = gldi_menu_get_image_pixbuf (gtkStock, size);
+			if (pixbuf)
+			{
+				pImage = gtk_image_new_from_pixbuf (pixbuf);
+				g_object_unref (pixbuf);
+			}
 		}
 		else
 		{
@@ -1988,6 +2064,7 @@ gboolean cairo_dock_notification_build_icon_menu (G_GNUC_UNUSED gpointer *pUserD
 		gtk_menu_shell_append(GTK_MENU_SHELL(pSubMenuAccessibility), pMenuItem);
 		gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), iVisibility == CAIRO_DESKLET_NORMAL/*bIsNormal*/);  // on coche celui-ci par defaut, il sera decoche par les suivants eventuellement.
 		g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_keep_normal), data);
+		_set_desklet_visibility_item (pMenuItem, CAIRO_DESKLET_NORMAL, data);
 		
 		pMenuItem = gtk_radio_menu_item_new_with_label(group, _("Always on top"));
 		group = gtk_radio_menu_item_get_group(GTK_RADIO_MENU_ITEM(pMenuItem));
@@ -1995,6 +2072,7 @@ gboolean cairo_dock_notification_build_icon_menu (G_GNUC_UNUSED gpointer *pUserD
 		if (iVisibility == CAIRO_DESKLET_KEEP_ABOVE)
 			gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), TRUE);
 		g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_keep_above), data);
+		_set_desklet_visibility_item (pMenuItem, CAIRO_DESKLET_KEEP_ABOVE, data);
 		
 		pMenuItem = gtk_radio_menu_item_new_with_label(group, _("Always below"));
 		group = gtk_radio_menu_item_get_group(GTK_RADIO_MENU_ITEM(pMenuItem));
@@ -2002,6 +2080,7 @@ gboolean cairo_dock_notification_build_icon_menu (G_GNUC_UNUSED gpointer *pUserD
 		if (iVisibility == CAIRO_DESKLET_KEEP_BELOW)
 			gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), TRUE);
 		g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_keep_below), data);
+		_set_desklet_visibility_item (pMenuItem, CAIRO_DESKLET_KEEP_BELOW, data);
 		
 		if (gldi_desktop_can_set_on_widget_layer ())
 		{
@@ -2011,6 +2090,7 @@ gboolean cairo_dock_notification_build_icon_menu (G_GNUC_UNUSED gpointer *pUserD
 			if (iVisibility == CAIRO_DESKLET_ON_WIDGET_LAYER)
 				gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), TRUE);
 			g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_keep_on_widget_layer), data);
+			_set_desklet_visibility_item (pMenuItem, CAIRO_DESKLET_ON_WIDGET_LAYER, data);
 		}
 		
 		pMenuItem = gtk_radio_menu_item_new_with_label(group, _("Reserve space"));
@@ -2019,18 +2099,21 @@ gboolean cairo_dock_notification_build_icon_menu (G_GNUC_UNUSED gpointer *pUserD
 		if (iVisibility == CAIRO_DESKLET_RESERVE_SPACE)
 			gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), TRUE);
 		g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_keep_space), data);
+		_set_desklet_visibility_item (pMenuItem, CAIRO_DESKLET_RESERVE_SPACE, data);
 		
 		pMenuItem = gtk_check_menu_item_new_with_label(_("On all desktops"));
 		gtk_menu_shell_append (GTK_MENU_SHELL (menu), pMenuItem);
 		if (bIsSticky)
 			gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), TRUE);
 		g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_set_on_all_desktop), data);
+		gldi_menu_item_set_update_func (pMenuItem, (GldiMenuItemUpdateFunc) _update_desklet_sticky_item, data);
 		
 		pMenuItem = gtk_check_menu_item_new_with_label(_("Lock position"));
 		gtk_menu_shell_append (GTK_MENU_SHELL (menu), pMenuItem);
 		if (pDesklet->bPositionLocked)
 			gtk_check_menu_item_set_active(GTK_CHECK_MENU_ITEM(pMenuItem), TRUE);
 		g_signal_connect(G_OBJECT(pMenuItem), "toggled", G_CALLBACK(_cairo_dock_lock_position), data);
+		gldi_menu_item_set_update_func (pMenuItem, (GldiMenuItemUpdateFunc) _update_desklet_lock_item, data);
 	}
 	
 	return GLDI_NOTIFICATION_LET_PASS;
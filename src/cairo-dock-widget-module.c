@@ -122,24 +122,22 @@ static void _build_module_widget (ModuleWidget *pModuleWidget)
 	GKeyFile* pKeyFile = cairo_dock_open_key_file (pModuleWidget->cConfFilePath);
 	g_return_if_fail (pKeyFile != NULL);
 	
-	GSList *pWidgetList = NULL;
-	GPtrArray *pDataGarbage = g_ptr_array_new ();
+	pModuleWidget->widget.pWidgetList = NULL;
+	pModuleWidget->widget.pDataGarbage = g_ptr_array_new ();
 	gchar *cOriginalConfFilePath = g_strdup_printf ("%s/%s", pModuleWidget->pModule->pVisitCard->cShareDataDir, pModuleWidget->pModule->pVisitCard->cConfFileName);
-	pModuleWidget->widget.pWidget = cairo_dock_build_key_file_widget (pKeyFile,
+	pModuleWidget->widget.pWidget = cairo_dock_build_key_file_widget_lazy (pKeyFile,
 		pModuleWidget->pModule->pVisitCard->cGettextDomain,
 		pModuleWidget->pMainWindow,
-		&pWidgetList,
-		pDataGarbage,
+		&pModuleWidget->widget.pWidgetList,  // the other groups will be built later into this list
+		pModuleWidget->widget.pDataGarbage,
 		cOriginalConfFilePath);  // cOriginalConfFilePath is taken by the function
-	pModuleWidget->widget.pWidgetList = pWidgetList;
-	pModuleWidget->widget.pDataGarbage = pDataGarbage;
 	
 	if (pModuleWidget->pModule->pInterface->load_custom_widget != NULL)
 	{
-		pModuleWidget->pModule->pInterface->load_custom_widget (pModuleWidget->pModuleInstance, pKeyFile, pWidgetList);
+		pModuleWidget->pModule->pInterface->load_custom_widget (pModuleWidget->pModuleInstance, pKeyFile, pModuleWidget->widget.pWidgetList);
 	}
 	
-	g_key_file_free (pKeyFile);
+	g_key_file_unref (pKeyFile);  // the groups not yet built keep a reference on it.
 }
 
 static void _set_module_instance (ModuleWidget *pModuleWidget, GldiModuleInstance *pModuleInstance)
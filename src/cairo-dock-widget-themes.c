@@ -143,6 +143,13 @@ static void on_cancel_dl (G_GNUC_UNUSED GtkButton *button, ThemesWidget *pThemes
 static gboolean _pulse_bar (GtkWidget *pBar)
 {
 	gtk_progress_bar_pulse (GTK_PROGRESS_BAR (pBar));
+	gint iNbFiles = cairo_dock_get_theme_import_progress ();
+	if (iNbFiles > 0)  // the files are being copied
+	{
+		gchar *cText = g_strdup_printf ("%d", iNbFiles);
+		gtk_progress_bar_set_text (GTK_PROGRESS_BAR (pBar), cText);
+		g_free (cText);
+	}
 	return TRUE;
 }
 static void on_waiting_dialog_destroyed (G_GNUC_UNUSED GtkWidget *pWidget, ThemesWidget *pThemesWidget)
@@ -201,58 +208,42 @@ static gboolean _cairo_dock_load_theme (GKeyFile* pKeyFile, ThemesWidget *pTheme
 	}
 	
 	//\___________________ On charge le nouveau theme choisi.
-	gchar *tmp = g_strdup (cNewThemeName);
-	CairoDockPackageType iType = cairo_dock_extract_package_type_from_name (tmp);
-	g_free (tmp);
-	
-	gboolean bThemeImported = FALSE;
-	if (iType != CAIRO_DOCK_LOCAL_PACKAGE && iType != CAIRO_DOCK_USER_PACKAGE)
-	{
-		GtkWidget *pWaitingDialog = gtk_window_new (GTK_WINDOW_TOPLEVEL);
-		pThemesWidget->pWaitingDialog = pWaitingDialog;
-		gtk_window_set_decorated (GTK_WINDOW (pWaitingDialog), FALSE);
-		gtk_window_set_skip_taskbar_hint (GTK_WINDOW (pWaitingDialog), TRUE);
-		gtk_window_set_skip_pager_hint (GTK_WINDOW (pWaitingDialog), TRUE);
-		gtk_window_set_transient_for (GTK_WINDOW (pWaitingDialog), pMainWindow);
-		gtk_window_set_modal (GTK_WINDOW (pWaitingDialog), TRUE);
+	// even a local theme is imported asynchronously, since copying a big theme can take a while.
+	GtkWidget *pWaitingDialog = gtk_window_new (GTK_WINDOW_TOPLEVEL);
+	pThemesWidget->pWaitingDialog = pWaitingDialog;
+	gtk_window_set_decorated (GTK_WINDOW (pWaitingDialog), FALSE);
+	gtk_window_set_skip_taskbar_hint (GTK_WINDOW (pWaitingDialog), TRUE);
+	gtk_window_set_skip_pager_hint (GTK_WINDOW (pWaitingDialog), TRUE);
+	gtk_window_set_transient_for (GTK_WINDOW (pWaitingDialog), pMainWindow);
+	gtk_window_set_modal (GTK_WINDOW (pWaitingDialog), TRUE);
 
-		GtkWidget *pMainVBox = gtk_box_new (GTK_ORIENTATION_VERTICAL, CAIRO_DOCK_FRAME_MARGIN);
-		gtk_container_add (GTK_CONTAINER (pWaitingDialog), pMainVBox);
-		
-		GtkWidget *pLabel = gtk_label_new (_("Please wait while importing the theme..."));
-		gtk_box_pack_start(GTK_BOX (pMainVBox), pLabel, FALSE, FALSE, 0);
-		
-		GtkWidget *pBar = gtk_progress_bar_new ();
-		gtk_progress_bar_pulse (GTK_PROGRESS_BAR (pBar));
-		gtk_box_pack_start (GTK_BOX (pMainVBox), pBar, FALSE, FALSE, 0);
-		pThemesWidget->iSidPulse = g_timeout_add (100, (GSourceFunc)_pulse_bar, pBar);
-		g_signal_connect (G_OBJECT (pWaitingDialog),
-			"destroy",
-			G_CALLBACK (on_waiting_dialog_destroyed),
-			pThemesWidget);
-		
-		GtkWidget *pCancelButton = gtk_button_new_with_label (_("Cancel"));
-		g_signal_connect (G_OBJECT (pCancelButton), "clicked", G_CALLBACK(on_cancel_dl), pWaitingDialog);
-		gtk_box_pack_start (GTK_BOX (pMainVBox), pCancelButton, FALSE, FALSE, 0);
-		
-		gtk_widget_show_all (pWaitingDialog);
-		
-		cd_debug ("start importation...");
-		pThemesWidget->pImportTask = cairo_dock_import_theme_async (cNewThemeName, bLoadBehavior, bLoadLaunchers, (GFunc)_load_theme, pThemesWidget);  // if 'pThemesWidget' is destroyed, the 'reset' callback will be called and will cancel the task.
-	}
-	else  // if the theme is already local and uptodate, there is really no need to show a progressbar, because only the download/unpacking is done asynchonously (and the copy of the files is fast enough).
-	{
-		bThemeImported = cairo_dock_import_theme (cNewThemeName, bLoadBehavior, bLoadLaunchers);
-		
-		//\_______________ load it.
-		if (bThemeImported)
-		{
-			cairo_dock_load_current_theme ();
-			cairo_dock_reload_gui ();
-		}
-	}
+	GtkWidget *pMainVBox = gtk_box_new (GTK_ORIENTATION_VERTICAL, CAIRO_DOCK_FRAME_MARGIN);
+	gtk_container_add (GTK_CONTAINER (pWaitingDialog), pMainVBox);
+	
+	GtkWidget *pLabel = gtk_label_new (_("Please wait while importing the theme..."));
+	gtk_box_pack_start(GTK_BOX (pMainVBox), pLabel, FALSE, FALSE, 0);
+	
+	GtkWidget *pBar = gtk_progress_bar_new ();
+	gtk_progress_bar_set_show_text (GTK_PROGRESS_BAR (pBar), TRUE);
+	gtk_progress_bar_set_text (GTK_PROGRESS_BAR (pBar), "");
+	gtk_progress_bar_pulse (GTK_PROGRESS_BAR (pBar));
+	gtk_box_pack_start (GTK_BOX (pMainVBox), pBar, FALSE, FALSE, 0);
+	pThemesWidget->iSidPulse = g_timeout_add (100, (GSourceFunc)_pulse_bar, pBar);
+	g_signal_connect (G_OBJECT (pWaitingDialog),
+		"destroy",
+		G_CALLBACK (on_waiting_dialog_destroyed),
+		pThemesWidget);
+	
+	GtkWidget *pCancelButton = gtk_button_new_with_label (_("Cancel"));
+	g_signal_connect (G_OBJECT (pCancelButton), "clicked", G_CALLBACK(on_cancel_dl), pThemesWidget);
+	gtk_box_pack_start (GTK_BOX (pMainVBox), pCancelButton, FALSE, FALSE, 0);
+	
+	gtk_widget_show_all (pWaitingDialog);
+	
+	cd_debug ("start importation...");
+	pThemesWidget->pImportTask = cairo_dock_import_theme_async (cNewThemeName, bLoadBehavior, bLoadLaunchers, (GFunc)_load_theme, pThemesWidget);  // if 'pThemesWidget' is destroyed, the 'reset' callback will be called and will cancel the task.
 	g_free (cNewThemeName);
-	return bThemeImported;
+	return FALSE;  // the theme will be loaded once it's imported.
 }
 
 
@@ -53,6 +53,7 @@ void cairo_dock_widget_free (CDWidget *pCdWidget)  // doesn't destroy the GTK wi
 	if (pCdWidget->reset)
 		pCdWidget->reset (pCdWidget);
 	
+	cairo_dock_gui_cancel_lazy_groups (&pCdWidget->pWidgetList);  // the GTK widget may outlive us.
 	cairo_dock_free_generated_widget_list (pCdWidget->pWidgetList);
 	pCdWidget->pWidgetList = NULL;
 	
@@ -68,6 +69,7 @@ void cairo_dock_widget_destroy_widget (CDWidget *pCdWidget)
 	if (!pCdWidget)
 		return;
 	
+	cairo_dock_gui_cancel_lazy_groups (&pCdWidget->pWidgetList);
 	gtk_widget_destroy (pCdWidget->pWidget);
 	pCdWidget->pWidget = NULL;
 	
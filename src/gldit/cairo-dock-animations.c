@@ -135,17 +135,188 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex)  // merci a Robrob
 }
 
 
+  ///////////////////
+ /// FRAME CLOCK ///
+///////////////////
+
+// All the animated containers are driven by a single clock: at each tick, every container whose interval has elapsed runs one step of its animation loop. The clock is a source with an absolute ready-time, so it doesn't drift like chained timeouts, and it sleeps when nothing is animated.
+
+typedef struct {
+	GldiContainer *pContainer;
+	gint64 iLastStep;  // time of the last step (µs, monotonic)
+	gint iNbMissedFrames;
+} CDAnimatedContainer;
+
+#define CD_ANIMATION_TOKEN G_MAXUINT  // value of 'iSidGLAnimation' while a container is animated. It's not a source ID (they start from 1 and never reach it), so a plug-in that still calls g_source_remove() on it can't destroy the frame clock.
+
+static GSource *s_pFrameClock = NULL;
+static gint64 s_iNextTick = 0;
+static GList *s_pAnimatedContainers = NULL;  // list of CDAnimatedContainer
+static GList *s_pNextAnimated = NULL;  // next element to run during a tick, so that containers can be removed meanwhile.
+static GldiContainer *s_pCurrentContainer = NULL;  // container currently running its step
+static gboolean s_bCurrentRemoved = FALSE;
+
+static gint64 _get_frame_interval (void)  // µs
+{
+	gint iMinDeltaT = G_MAXINT;
+	CDAnimatedContainer *pAnimated;
+	GList *a;
+	for (a = s_pAnimatedContainers; a != NULL; a = a->next)
+	{
+		pAnimated = a->data;
+		iMinDeltaT = MIN (iMinDeltaT, cairo_dock_get_animation_delta_t (pAnimated->pContainer));
+	}
+	return (gint64) MAX (iMinDeltaT, 1) * 1000;
+}
+
+static void _schedule_next_tick (gint64 iNow)
+{
+	if (s_pAnimatedContainers == NULL)  // nothing to animate, sleep until the next animation is launched.
+	{
+		g_source_set_ready_time (s_pFrameClock, -1);
+		s_iNextTick = 0;
+		return;
+	}
+	gint64 iInterval = _get_frame_interval ();
+	if (s_iNextTick == 0 || s_iNextTick + iInterval <= iNow)  // first tick, or we're late: restart from now rather than trying to catch up.
+		s_iNextTick = iNow + iInterval;
+	else
+		s_iNextTick += iInterval;
+	g_source_set_ready_time (s_pFrameClock, s_iNextTick);
+}
+
+static GList *_find_animated_container (GldiContainer *pContainer)
+{
+	GList *a;
+	for (a = s_pAnimatedContainers; a != NULL; a = a->next)
+	{
+		if (((CDAnimatedContainer*)a->data)->pContainer == pContainer)
+			return a;
+	}
+	return NULL;
+}
+
+static void _remove_animated_container (GList *a)
+{
+	CDAnimatedContainer *pAnimated = a->data;
+	if (pAnimated->iNbMissedFrames != 0)
+		cd_debug ("%d frame(s) missed during the animation of %p", pAnimated->iNbMissedFrames, pAnimated->pContainer);
+	pAnimated->pContainer->iSidGLAnimation = 0;
+	if (pAnimated->pContainer == s_pCurrentContainer)
+		s_bCurrentRemoved = TRUE;
+	if (a == s_pNextAnimated)
+		s_pNextAnimated = a->next;
+	s_pAnimatedContainers = g_list_delete_link (s_pAnimatedContainers, a);
+	g_free (pAnimated);
+}
+
+static gboolean _on_frame_clock_tick (G_GNUC_UNUSED gpointer data)
+{
+	gint64 iNow = g_get_monotonic_time ();
+	gint64 iInterval, dt;
+	CDAnimatedContainer *pAnimated;
+	GldiContainer *pContainer;
+	gboolean bContinue;
+	GList *a = s_pAnimatedContainers;
+	while (a != NULL)
+	{
+		s_pNextAnimated = a->next;
+		pAnimated = a->data;
+		pContainer = pAnimated->pContainer;
+		if (pContainer->iSidGLAnimation != CD_ANIMATION_TOKEN)  // its animation has been stopped from outside (by resetting its source ID).
+		{
+			_remove_animated_container (a);
+			a = s_pNextAnimated;
+			continue;
+		}
+		iInterval = (gint64) cairo_dock_get_animation_delta_t (pContainer) * 1000;
+		dt = iNow - pAnimated->iLastStep;
+		if (dt + 1000 >= iInterval)  // 1ms of tolerance, the clock may run at the pace of a faster container.
+		{
+			if (dt >= 2 * iInterval)
+			{
+				pAnimated->iNbMissedFrames += dt / iInterval - 1;
+				pContainer->iNbMissedFrames += dt / iInterval - 1;
+				pAnimated->iLastStep = iNow;
+			}
+			else
+				pAnimated->iLastStep += iInterval;  // keep the phase.
+			
+			s_pCurrentContainer = pContainer;
+			s_bCurrentRemoved = FALSE;
+			bContinue = pContainer->iface.animation_loop (pContainer);  // may destroy the container.
+			if (! s_bCurrentRemoved && ! bContinue)
+				_remove_animated_container (a);
+			s_pCurrentContainer = NULL;
+		}
+		a = s_pNextAnimated;
+	}
+	s_pNextAnimated = NULL;
+	
+	_schedule_next_tick (iNow);
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean _frame_clock_dispatch (G_GNUC_UNUSED GSource *source, GSourceFunc callback, gpointer data)
+{
+	return callback (data);
+}
+
+static GSourceFuncs s_FrameClockFuncs = {
+	NULL,  // prepare: the ready-time is enough
+	NULL,  // check
+	_frame_clock_dispatch,
+	NULL,  // finalize
+	NULL, NULL
+};
+
 void cairo_dock_launch_animation (GldiContainer *pContainer)
 {
 	if (pContainer->iSidGLAnimation == 0 && pContainer->iface.animation_loop != NULL)
 	{
-		int iAnimationDeltaT = cairo_dock_get_animation_delta_t (pContainer);
 		pContainer->bKeepSlowAnimation = TRUE;
 		
-		pContainer->iSidGLAnimation = g_timeout_add (iAnimationDeltaT, (GSourceFunc)pContainer->iface.animation_loop, pContainer);
+		if (s_pFrameClock != NULL && g_source_is_destroyed (s_pFrameClock))  // someone has removed the clock from the main loop; we still hold a reference on it, so just replace it.
+		{
+			g_source_unref (s_pFrameClock);
+			s_pFrameClock = NULL;
+			s_iNextTick = 0;
+		}
+		if (s_pFrameClock == NULL)
+		{
+			s_pFrameClock = g_source_new (&s_FrameClockFuncs, sizeof (GSource));
+			g_source_set_callback (s_pFrameClock, _on_frame_clock_tick, NULL, NULL);
+			g_source_set_ready_time (s_pFrameClock, -1);
+			g_source_attach (s_pFrameClock, NULL);
+		}
+		
+		pContainer->iSidGLAnimation = CD_ANIMATION_TOKEN;
+		gint64 iNow = g_get_monotonic_time ();
+		if (_find_animated_container (pContainer) == NULL)  // else its token had been reset from outside before the clock noticed it, just keep animating it.
+		{
+			CDAnimatedContainer *pAnimated = g_new0 (CDAnimatedContainer, 1);
+			pAnimated->pContainer = pContainer;
+			pAnimated->iLastStep = iNow;  // its first step will come after its interval, like a timeout.
+			s_pAnimatedContainers = g_list_prepend (s_pAnimatedContainers, pAnimated);  // it will not run during the current tick, if any.
+		}
+		
+		if (s_iNextTick == 0 || s_iNextTick - iNow > _get_frame_interval ())  // the clock was sleeping, or runs slower than this container.
+		{
+			s_iNextTick = 0;
+			if (s_pCurrentContainer == NULL)  // not during a tick (it reschedules itself at the end).
+				_schedule_next_tick (iNow);
+		}
 	}
 }
 
+void cairo_dock_stop_animation (GldiContainer *pContainer)
+{
+	GList *a = _find_animated_container (pContainer);
+	if (a != NULL)
+		_remove_animated_container (a);
+	pContainer->iSidGLAnimation = 0;
+}
+
 void cairo_dock_start_shrinking (CairoDock *pDock)
 {
 	if (! pDock->bIsShrinkingDown)  // on lance l'animation.
@@ -187,6 +358,7 @@ void cairo_dock_start_hiding (CairoDock *pDock)
 		}
 		
 		// init the animation
+		gldi_dock_invalidate_hiding_snapshot (pDock);  // the icons will be drawn again at the first step
 		if (g_pHidingBackend != NULL && g_pHidingBackend->init)
 			g_pHidingBackend->init (pDock);
 		
@@ -226,6 +398,7 @@ void cairo_dock_start_showing (CairoDock *pDock)
 		}
 		
 		// init the animation
+		gldi_dock_invalidate_hiding_snapshot (pDock);  // the icons will be drawn again at the first step
 		if (g_pHidingBackend != NULL && g_pHidingBackend->init)
 			g_pHidingBackend->init (pDock);
 		
@@ -83,11 +83,16 @@ struct _CairoDockHidingEffect {
 	
 #define CAIRO_DOCK_MIN_SLOW_DELTA_T 90
 
-/** Say if a container is currently animated.
+/** Say if a container is currently animated (ie, driven by the frame clock).
 *@param pContainer a Container
 */
 #define cairo_dock_container_is_animating(pContainer) (CAIRO_CONTAINER(pContainer)->iSidGLAnimation != 0)
 
+/** Get the number of animation steps of a container that couldn't run on time, since it was created. A frame is missed when the main loop is too busy to run a step at its interval.
+*@param pContainer a Container
+*/
+#define cairo_dock_container_get_nb_missed_frames(pContainer) (CAIRO_CONTAINER(pContainer)->iNbMissedFrames)
+
 /** Say if it's usefull to launch an animation on a Dock (indeed, it's useless to launch it if it will be invisible).
 *@param pDock the Dock to animate.
 */
@@ -110,11 +115,16 @@ void cairo_dock_pop_down (CairoDock *pDock);
 
 gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex);
 
-/** Launch the animation of a Container.
+/** Launch the animation of a Container. All the animated containers are driven by a single frame clock, which runs the animation loop of each container at its own interval (\ref cairo_dock_get_animation_delta_t), until the loop returns FALSE.
 *@param pContainer the container to animate.
 */
 void cairo_dock_launch_animation (GldiContainer *pContainer);
 
+/** Stop the animation of a Container, without waiting for its animation loop to end.
+*@param pContainer the container.
+*/
+void cairo_dock_stop_animation (GldiContainer *pContainer);
+
 void cairo_dock_start_shrinking (CairoDock *pDock);
 
 void cairo_dock_start_growing (CairoDock *pDock);
@@ -444,6 +444,12 @@ CD_APPLET_ON_UPDATE_ICON_PROTO \
 /** Desabonne l'applet aux notifications de construction du menu. A effectuer lors de l'arret de l'applet.
 */
 #define CD_APPLET_UNREGISTER_FOR_BUILD_MENU_EVENT gldi_object_remove_notification (&myContainerObjectMgr, NOTIFICATION_BUILD_ICON_MENU, (GldiNotificationFunc) CD_APPLET_ON_BUILD_MENU_FUNC, myApplet);
+/** Let the menu of the applet be kept between 2 right-clicks. Only do it if the applet calls CD_APPLET_MENU_CHANGED each time its items change.
+*/
+#define CD_APPLET_ENABLE_MENU_CACHE gldi_module_instance_set_menu_cached (myApplet, TRUE)
+/** Tell that the items of the applet's menu have changed; the menu will be built again on the next right-click.
+*/
+#define CD_APPLET_MENU_CHANGED gldi_module_instance_menu_changed (myApplet)
 
 //\______________________ notification clic milieu.
 /** Abonne l'applet aux notifications du clic du milieu. A effectuer lors de l'init de l'applet.
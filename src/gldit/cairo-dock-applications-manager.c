@@ -167,7 +167,7 @@ static gboolean _on_window_icon_changed (G_GNUC_UNUSED gpointer data, GldiWindow
 			{
 				CairoDock *pDock = CAIRO_DOCK (pContainer);
 				if (pDock->iRefCount != 0)
-					cairo_dock_trigger_redraw_subdock_content (pDock);
+					cairo_dock_trigger_redraw_subdock_content_for_icon (pDock, icon);
 			}
 			cairo_dock_redraw_icon (icon);
 		}
@@ -298,7 +298,7 @@ static gboolean _on_window_state_changed (G_GNUC_UNUSED gpointer data, GldiWindo
 				cairo_dock_redraw_icon (icon);
 				if (pParentDock->iRefCount != 0)  // on prevoit le redessin de l'icone pointant sur le sous-dock.
 				{
-					cairo_dock_trigger_redraw_subdock_content (pParentDock);
+					cairo_dock_trigger_redraw_subdock_content_for_icon (pParentDock, icon);
 				}
 			}
 		}
@@ -390,12 +390,80 @@ static gboolean _on_window_desktop_changed (G_GNUC_UNUSED gpointer data, GldiWin
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+typedef struct {
+	GList *pIconsToShow;
+	GList *pIconsToHide;
+	gint iNbShownAfter;  // number of applis of the class that will be in a dock once the changes are applied.
+	} CDClassDesktopChanges;
+
+static void _free_class_desktop_changes (CDClassDesktopChanges *pChanges)
+{
+	g_list_free (pChanges->pIconsToShow);
+	g_list_free (pChanges->pIconsToHide);
+	g_free (pChanges);
+}
+static void _collect_appli_desktop_changes (GldiWindowActor *pAppli, Icon *icon, GHashTable *pClassChanges)
+{
+	if (! myTaskbarParam.bHideVisibleApplis || pAppli->bIsHidden)
+	{
+		gboolean bIsInDock = (cairo_dock_get_icon_container (icon) != NULL);
+		gboolean bOnCurrentDesktop = gldi_window_is_on_current_desktop (pAppli);
+		if (! bOnCurrentDesktop && ! bIsInDock)  // not in a dock, maybe inhibited: detach it from its inhibitor, no dock is changed.
+		{
+			gldi_window_detach_from_inhibitors (icon->pAppli);
+			return;
+		}
+		
+		const gchar *cClass = (icon->cClass ? icon->cClass : "");
+		CDClassDesktopChanges *pChanges = g_hash_table_lookup (pClassChanges, cClass);
+		if (pChanges == NULL)
+		{
+			pChanges = g_new0 (CDClassDesktopChanges, 1);
+			g_hash_table_insert (pClassChanges, (gpointer)cClass, pChanges);
+		}
+		if (bOnCurrentDesktop)
+		{
+			pChanges->iNbShownAfter ++;
+			if (! bIsInDock)
+				pChanges->pIconsToShow = g_list_prepend (pChanges->pIconsToShow, icon);
+		}
+		else
+		{
+			pChanges->pIconsToHide = g_list_prepend (pChanges->pIconsToHide, icon);
+		}
+	}
+}
+static void _apply_class_desktop_changes (G_GNUC_UNUSED const gchar *cClass, CDClassDesktopChanges *pChanges, G_GNUC_UNUSED gpointer data)
+{
+	GList *ic;
+	// if the class will still be grouped in a sub-dock, insert the new applis before removing the old ones, so that the sub-dock is never emptied; otherwise remove them first, so that a sub-dock is not created just to be destroyed right after.
+	gboolean bInsertFirst = (myTaskbarParam.bGroupAppliByClass && pChanges->iNbShownAfter > 1);
+	if (! bInsertFirst)
+	{
+		for (ic = pChanges->pIconsToHide; ic != NULL; ic = ic->next)
+			gldi_appli_icon_detach (ic->data);
+	}
+	for (ic = pChanges->pIconsToShow; ic != NULL; ic = ic->next)
+		gldi_appli_icon_insert_in_dock (ic->data, g_pMainDock, ! CAIRO_DOCK_ANIMATE_ICON);
+	if (bInsertFirst)
+	{
+		for (ic = pChanges->pIconsToHide; ic != NULL; ic = ic->next)
+			gldi_appli_icon_detach (ic->data);
+	}
+}
 static gboolean _on_desktop_changed (G_GNUC_UNUSED gpointer data)
 {
 	// applis du bureau courant seulement.
 	if (myTaskbarParam.bAppliOnCurrentDesktopOnly && myTaskbarParam.bShowAppli)
 	{
-		g_hash_table_foreach (s_hAppliIconsTable, (GHFunc) _hide_show_appli_icons_on_other_desktops, g_pMainDock);
+		// compute the new set of applis of each class (and therefore of each class sub-dock), then apply all the changes at once.
+		GHashTable *pClassChanges = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, (GDestroyNotify) _free_class_desktop_changes);
+		g_hash_table_foreach (s_hAppliIconsTable, (GHFunc) _collect_appli_desktop_changes, pClassChanges);
+		g_hash_table_foreach (pClassChanges, (GHFunc) _apply_class_desktop_changes, NULL);
+		g_hash_table_destroy (pClassChanges);
+		
+		// lay out and redraw each dock once, with all the changes.
+		cairo_dock_flush_update_dock_size ();
 	}
 	
 	return GLDI_NOTIFICATION_LET_PASS;
@@ -48,7 +48,9 @@ static GHashTable *s_hDeskletDecorationsTable = NULL;  // table des decorations
 static GHashTable *s_hAnimationsTable = NULL;  // table des animations disponibles.
 static GHashTable *s_hDialogDecoratorTable = NULL;  // table des decorateurs de dialogues disponibles.
 static GHashTable *s_hHidingEffectTable = NULL;  // table des effets de cachage des docks.
+static GList *s_pSnapshotHidingEffects = NULL;  // effects that can be applied on a snapshot of the dock (kept aside so that CairoDockHidingEffect doesn't grow).
 static GHashTable *s_hIconContainerTable = NULL;  // table des rendus d'icones de container.
+static GHashTable *s_hIconContainerNbIcons = NULL;  // renderer -> number of icons it draws (kept aside so that CairoIconContainerRenderer doesn't grow).
 /*
 typedef struct _CairoBackendMgr CairoBackendMgr;
 struct _CairoBackendMgr {
@@ -215,9 +217,23 @@ void cairo_dock_register_hiding_effect (const gchar *cHidingEffect, CairoDockHid
 
 void cairo_dock_remove_hiding_effect (const gchar *cHidingEffect)
 {
+	CairoDockHidingEffect *pEffect = g_hash_table_lookup (s_hHidingEffectTable, cHidingEffect);
+	if (pEffect != NULL)
+		s_pSnapshotHidingEffects = g_list_remove (s_pSnapshotHidingEffects, pEffect);
 	g_hash_table_remove (s_hHidingEffectTable, cHidingEffect);
 }
 
+void cairo_dock_set_hiding_effect_can_use_snapshot (CairoDockHidingEffect *pEffect)
+{
+	if (g_list_find (s_pSnapshotHidingEffects, pEffect) == NULL)
+		s_pSnapshotHidingEffects = g_list_prepend (s_pSnapshotHidingEffects, pEffect);
+}
+
+gboolean cairo_dock_hiding_effect_can_use_snapshot (CairoDockHidingEffect *pEffect)
+{
+	return (pEffect != NULL && g_list_find (s_pSnapshotHidingEffects, pEffect) != NULL);
+}
+
 
 // Icon-Container renderers
 CairoIconContainerRenderer *cairo_dock_get_icon_container_renderer (const gchar *cRendererName)
@@ -236,9 +252,26 @@ void cairo_dock_register_icon_container_renderer (const gchar *cRendererName, Ca
 
 void cairo_dock_remove_icon_container_renderer (const gchar *cRendererName)
 {
+	CairoIconContainerRenderer *pRenderer = g_hash_table_lookup (s_hIconContainerTable, cRendererName);
+	if (pRenderer != NULL)
+		g_hash_table_remove (s_hIconContainerNbIcons, pRenderer);
 	g_hash_table_remove (s_hIconContainerTable, cRendererName);
 }
 
+void cairo_dock_set_icon_container_renderer_nb_icons (CairoIconContainerRenderer *pRenderer, int iNbIcons)
+{
+	g_return_if_fail (pRenderer != NULL);
+	if (iNbIcons > 0)
+		g_hash_table_insert (s_hIconContainerNbIcons, pRenderer, GINT_TO_POINTER (iNbIcons));
+	else
+		g_hash_table_remove (s_hIconContainerNbIcons, pRenderer);
+}
+
+int cairo_dock_get_icon_container_renderer_nb_icons (CairoIconContainerRenderer *pRenderer)
+{
+	return (pRenderer != NULL ? GPOINTER_TO_INT (g_hash_table_lookup (s_hIconContainerNbIcons, pRenderer)) : 0);
+}
+
 void cairo_dock_foreach_icon_container_renderer (GHFunc pCallback, gpointer data)
 {
 	g_hash_table_foreach (s_hIconContainerTable, pCallback, data);
@@ -260,16 +293,10 @@ void cairo_dock_set_renderer (CairoDock *pDock, const gchar *cRendererName)
 	pDock->fMagnitudeMax = 1.;
 	pDock->container.bUseReflect = pDock->pRenderer->bUseReflect;
 	
-	int iAnimationDeltaT = pDock->container.iAnimationDeltaT;
 	pDock->container.iAnimationDeltaT = (g_bUseOpenGL && pDock->pRenderer->render_opengl != NULL ? myContainersParam.iGLAnimationDeltaT : myContainersParam.iCairoAnimationDeltaT);
 	if (pDock->container.iAnimationDeltaT == 0)
 		pDock->container.iAnimationDeltaT = 30;  // le main dock est cree avant meme qu'on ait recupere la valeur en conf. Lorsqu'une vue lui sera attribuee, la bonne valeur sera renseignee, en attendant on met un truc non nul.
-	if (iAnimationDeltaT != pDock->container.iAnimationDeltaT && pDock->container.iSidGLAnimation != 0)
-	{
-		g_source_remove (pDock->container.iSidGLAnimation);
-		pDock->container.iSidGLAnimation = 0;
-		cairo_dock_launch_animation (CAIRO_CONTAINER (pDock));
-	}
+	// if the dock is being animated, the frame clock will use the new interval from its next tick.
 	if (pDock->cRendererName != cRendererName)  // NULL ecrase le nom de l'ancienne vue.
 	{
 		g_free (pDock->cRendererName);
@@ -605,6 +632,8 @@ static void init (void)
 		g_str_equal,
 		g_free,
 		g_free);
+	
+	s_hIconContainerNbIcons = g_hash_table_new (g_direct_hash, g_direct_equal);
 }
 
 
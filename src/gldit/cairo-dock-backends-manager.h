@@ -84,12 +84,23 @@ void cairo_dock_remove_desklet_decoration (const gchar *cDecorationName);
 CairoDockHidingEffect *cairo_dock_get_hiding_effect (const gchar *cHidingEffect);
 void cairo_dock_register_hiding_effect (const gchar *cHidingEffect, CairoDockHidingEffect *pEffect);
 void cairo_dock_remove_hiding_effect (const gchar *cHidingEffect);
+/** Declare that a hiding effect only transforms the drawing of the dock: in OpenGL it draws the dock's redirected texture in post_render_opengl, and in cairo its pre_render/post_render work on any drawing. In this case the icons are drawn only once for the whole animation, and the effect is applied on this snapshot.
+*@param pEffect a registered effect.
+*/
+void cairo_dock_set_hiding_effect_can_use_snapshot (CairoDockHidingEffect *pEffect);
+gboolean cairo_dock_hiding_effect_can_use_snapshot (CairoDockHidingEffect *pEffect);
 
 // Container Icon renderer
 CairoIconContainerRenderer *cairo_dock_get_icon_container_renderer (const gchar *cRendererName);
 void cairo_dock_register_icon_container_renderer (const gchar *cRendererName, CairoIconContainerRenderer *pRenderer);
 void cairo_dock_remove_icon_container_renderer (const gchar *cRendererName);
 void cairo_dock_foreach_icon_container_renderer (GHFunc pCallback, gpointer data);
+/** Declare how many icons of the sub-dock a renderer draws on the icon (the first ones, separators excluded). Changes of the other icons then don't redraw the icon.
+*@param pRenderer a registered renderer.
+*@param iNbIcons number of icons drawn, or 0 if the renderer depends on all the icons (the default).
+*/
+void cairo_dock_set_icon_container_renderer_nb_icons (CairoIconContainerRenderer *pRenderer, int iNbIcons);
+int cairo_dock_get_icon_container_renderer_nb_icons (CairoIconContainerRenderer *pRenderer);
 
 
 void cairo_dock_set_renderer (CairoDock *pDock, const gchar *cRendererName);
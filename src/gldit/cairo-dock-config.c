@@ -49,6 +49,7 @@ static char DES_crypt_key[64] =
 #include "cairo-dock-file-manager.h"  // cairo_dock_get_file_size
 #include "cairo-dock-user-icon-manager.h"  // gldi_user_icons_new_from_directory
 #include "cairo-dock-core.h"  // gldi_free_all
+#include "cairo-dock-menu.h"  // gldi_menu_clear_image_cache
 #include "cairo-dock-config.h"
 
 gboolean g_bEasterEggs = FALSE;
@@ -451,6 +452,7 @@ void cairo_dock_load_current_theme (void)
 	
 	//\___________________ Free everything.
 	gldi_free_all ();  // do nothing if there is nothing to unload.
+	gldi_menu_clear_image_cache ();  // the images of the previous theme are not needed any more.
 		
 	//\___________________ Get all managers config.
 	gldi_managers_get_config (g_cConfFile, GLDI_VERSION);  /// en fait, CAIRO_DOCK_VERSION ...
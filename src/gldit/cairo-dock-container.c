@@ -36,6 +36,11 @@
 #include "cairo-dock-animations.h"  // cairo_dock_animation_will_be_visible
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get_width
 #include "cairo-dock-menu.h"  // gldi_menu_new
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_blank_surface
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_surface
+#include "cairo-dock-icon-manager.h"  // myIconObjectMgr
+#include "cairo-dock-desklet-factory.h"  // CAIRO_DOCK_IS_DESKLET
+#include "cairo-dock-module-instance-manager.h"  // gldi_module_instance_menu_is_cached
 #define _MANAGER_DEF_
 #include "cairo-dock-container.h"
 
@@ -57,6 +62,17 @@ static gboolean s_bSticky = TRUE;
 static gboolean s_bInitialOpacity0 = TRUE;  // set initial window opacity to 0, to avoid grey rectangles.
 static gboolean s_bNoComposite = FALSE;
 static GldiContainerManagerBackend s_backend;
+static gboolean s_bDesktopBgHeld = FALSE;  // TRUE if we hold a reference on g_pFakeTransparencyDesktopBg
+static gint s_iNbBgSlices = 0;  // number of containers having a slice of the wallpaper
+
+// the part of the wallpaper that is behind a container, when there is no composite.
+typedef struct {
+	cairo_surface_t *pSurface;  // in cairo mode.
+	GLuint iTexture;  // in OpenGL mode.
+	gint x, y, w, h;  // area of the screen that it covers.
+	guint iStamp;  // stamp of the wallpaper it comes from.
+} GldiContainerBgSlice;
+#define _get_bg_slice(pContainer) ((GldiContainerBgSlice*)(pContainer)->pBgSlice)
 
 
 void cairo_dock_set_containers_non_sticky (void)
@@ -216,6 +232,8 @@ void cairo_dock_redraw_icon (Icon *icon)
 	GdkRectangle rect;
 	cairo_dock_compute_icon_area (icon, pContainer, &rect);
 	
+	if (CAIRO_DOCK_IS_DOCK (pContainer))
+		gldi_dock_invalidate_hiding_snapshot (CAIRO_DOCK (pContainer));  // the icon has changed, even if the dock is not redrawn now.
 	if (CAIRO_DOCK_IS_DOCK (pContainer) &&
 		( (cairo_dock_is_hidden (CAIRO_DOCK (pContainer)) && ! icon->bIsDemandingAttention && ! icon->bAlwaysVisible)
 		|| (CAIRO_DOCK (pContainer)->iRefCount != 0 && ! gldi_container_is_visible (pContainer)) ) )  // inutile de redessiner.
@@ -370,14 +388,64 @@ gboolean cairo_dock_emit_enter_signal (GldiContainer *pContainer)
 
 
 static GtkWidget *s_pMenu = NULL;  // right-click menu
+static GldiContainer *s_pMenuContainer = NULL;  // container and icon it was built for
+static Icon *s_pMenuIcon = NULL;
+static gboolean s_bMenuIsValid = FALSE;  // TRUE if it can be shown again on the next right-click
+static gint64 s_iLastMenuBuildTime = 0;  // in us
+static gint64 s_iMaxMenuBuildTime = 0;
+
+static GldiModuleInstance *_get_menu_instance (GldiContainer *pContainer, Icon *icon)
+{
+	// the instance that puts its items in the menu: the one of the icon, or the one owning the container (the items of an applet are also added on the icons of its sub-dock or its desklet).
+	if (icon != NULL && icon->pModuleInstance != NULL)
+		return icon->pModuleInstance;
+	if (CAIRO_DOCK_IS_DESKLET (pContainer))
+	{
+		Icon *pMainIcon = CAIRO_DESKLET (pContainer)->pIcon;
+		return (pMainIcon ? pMainIcon->pModuleInstance : NULL);
+	}
+	if (CAIRO_DOCK_IS_DOCK (pContainer) && CAIRO_DOCK (pContainer)->iRefCount > 0)
+	{
+		Icon *pPointingIcon = cairo_dock_search_icon_pointing_on_dock (CAIRO_DOCK (pContainer), NULL);
+		return (pPointingIcon ? pPointingIcon->pModuleInstance : NULL);
+	}
+	return NULL;
+}
+
+static inline gboolean _menu_depends_on_windows (void)
+{
+	return (s_pMenuIcon != NULL && (s_pMenuIcon->pAppli != NULL || s_pMenuIcon->cClass != NULL));
+}
+
+void gldi_container_invalidate_menu (void)
+{
+	s_bMenuIsValid = FALSE;  // it will be destroyed on the next right-click, like any previous menu (it may be running an action right now).
+}
+
 GtkWidget *gldi_container_build_menu (GldiContainer *pContainer, Icon *icon)
 {
+	g_return_val_if_fail (pContainer != NULL, NULL);
+	gint64 t0 = g_get_monotonic_time ();
+	
+	//\_________________________ If the previous menu was built on the same icon, and nothing has changed since then, show it again.
+	if (s_pMenu != NULL
+	&& s_bMenuIsValid
+	&& pContainer == s_pMenuContainer
+	&& icon == s_pMenuIcon
+	&& (icon == NULL || cairo_dock_get_icon_container (icon) == pContainer)
+	&& ! gtk_widget_get_visible (s_pMenu))
+	{
+		gldi_menu_update_items (s_pMenu);  // only the volatile items are updated.
+		s_iLastMenuBuildTime = g_get_monotonic_time () - t0;
+		cd_debug ("menu reused in %.2fms", s_iLastMenuBuildTime / 1000.);
+		return s_pMenu;
+	}
+	
 	if (s_pMenu != NULL)
 	{
 		//g_print ("previous menu still alive\n");
 		gtk_widget_destroy (GTK_WIDGET (s_pMenu));  // -> 's_pMenu' becomes NULL thanks to the weak pointer.
 	}
-	g_return_val_if_fail (pContainer != NULL, NULL);
 	
 	//\_________________________ On construit le menu.
 	GtkWidget *menu = gldi_menu_new (icon);
@@ -393,11 +461,61 @@ GtkWidget *gldi_container_build_menu (GldiContainer *pContainer, Icon *icon)
 	
 	gldi_object_notify (pContainer, NOTIFICATION_BUILD_ICON_MENU, icon, pContainer, menu);
 	
+	//\_________________________ On mesure le temps de construction, c'est lui qui fait le delai avant l'apparition du menu.
+	s_iLastMenuBuildTime = g_get_monotonic_time () - t0;
+	if (s_iLastMenuBuildTime > s_iMaxMenuBuildTime)
+		s_iMaxMenuBuildTime = s_iLastMenuBuildTime;
+	cd_debug ("menu built in %.2fms", s_iLastMenuBuildTime / 1000.);
+	
 	s_pMenu = menu;
 	g_object_add_weak_pointer (G_OBJECT (menu), (gpointer*)&s_pMenu);  // will nullify 's_pMenu' as soon as the menu is destroyed.
+	s_pMenuContainer = pContainer;
+	s_pMenuIcon = icon;
+	GldiModuleInstance *pInstance = _get_menu_instance (pContainer, icon);
+	s_bMenuIsValid = (pInstance == NULL || gldi_module_instance_menu_is_cached (pInstance));  // the items of an applet may depend on its state, so only keep them if it tells us when they change.
 	return menu;
 }
 
+static gboolean _on_object_destroyed_for_menu (G_GNUC_UNUSED gpointer data, GldiObject *pObject)
+{
+	if (pObject == GLDI_OBJECT (s_pMenuIcon) || pObject == GLDI_OBJECT (s_pMenuContainer))
+	{
+		s_pMenuIcon = NULL;
+		s_pMenuContainer = NULL;
+		gldi_container_invalidate_menu ();
+	}
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+static gboolean _on_window_changed_for_menu (G_GNUC_UNUSED gpointer data)
+{
+	if (s_bMenuIsValid && _menu_depends_on_windows ())  // the items of an appli or a class show the state of its windows.
+		gldi_container_invalidate_menu ();
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+static gboolean _on_desktops_changed_for_menu (G_GNUC_UNUSED gpointer data)
+{
+	if (s_bMenuIsValid)  // the "move to desktop" items list the desktops.
+		gldi_container_invalidate_menu ();
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+static gboolean _on_instance_menu_changed (G_GNUC_UNUSED gpointer data, GldiModuleInstance *pInstance)
+{
+	if (s_bMenuIsValid && (s_pMenuContainer == NULL || pInstance == _get_menu_instance (s_pMenuContainer, s_pMenuIcon)))
+		gldi_container_invalidate_menu ();
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+void gldi_container_get_menu_build_time (gint64 *iLastTime, gint64 *iMaxTime)
+{
+	if (iLastTime)
+		*iLastTime = s_iLastMenuBuildTime;
+	if (iMaxTime)
+		*iMaxTime = s_iMaxMenuBuildTime;
+}
+
 
 cairo_region_t *gldi_container_create_input_shape (GldiContainer *pContainer, int x, int y, int w, int h)
 {
@@ -411,6 +529,111 @@ cairo_region_t *gldi_container_create_input_shape (GldiContainer *pContainer, in
 }
 
 
+  ////////////////////////
+ /// FAKE TRANSPARENCY ///
+////////////////////////
+
+static void _free_bg_slice (GldiContainer *pContainer)
+{
+	GldiContainerBgSlice *pSlice = _get_bg_slice (pContainer);
+	if (pSlice == NULL)
+		return;
+	if (pSlice->pSurface != NULL)
+		cairo_surface_destroy (pSlice->pSurface);
+	if (pSlice->iTexture != 0)
+		_cairo_dock_delete_texture (pSlice->iTexture);
+	g_free (pSlice);
+	pContainer->pBgSlice = NULL;
+	
+	// the full-size wallpaper is needed as long as a container may have to make its slice again; once there is no slice left, release it (the desktop manager frees it if nobody else uses it).
+	s_iNbBgSlices --;
+	if (s_iNbBgSlices == 0 && s_bDesktopBgHeld)
+	{
+		gldi_desktop_background_destroy (g_pFakeTransparencyDesktopBg);
+		s_bDesktopBgHeld = FALSE;
+	}
+}
+
+// each container keeps its own slice of the wallpaper, so that it's not cropped from the full-size image at each frame; it's made again only when the container moves, is resized, or when the wallpaper changes.
+static GldiContainerBgSlice *_get_desktop_bg_slice (GldiContainer *pContainer)
+{
+	if (g_pFakeTransparencyDesktopBg == NULL)  // composite is available
+	{
+		_free_bg_slice (pContainer);
+		return NULL;
+	}
+	
+	int x, y, w, h;  // area of the screen covered by the container.
+	if (pContainer->bIsHorizontal)
+	{
+		x = pContainer->iWindowPositionX;
+		y = pContainer->iWindowPositionY;
+		w = pContainer->iWidth;
+		h = pContainer->iHeight;
+	}
+	else
+	{
+		x = pContainer->iWindowPositionY;
+		y = pContainer->iWindowPositionX;
+		w = pContainer->iHeight;
+		h = pContainer->iWidth;
+	}
+	GldiContainerBgSlice *pSlice = _get_bg_slice (pContainer);
+	if (pSlice != NULL
+	&& pSlice->x == x && pSlice->y == y && pSlice->w == w && pSlice->h == h
+	&& pSlice->iStamp == g_pFakeTransparencyDesktopBg->iStamp)  // still valid
+		return pSlice;
+	
+	_free_bg_slice (pContainer);
+	if (w <= 0 || h <= 0)
+		return NULL;
+	if (! s_bDesktopBgHeld)  // it was released along with the last slice, take it again.
+	{
+		gldi_desktop_background_get (FALSE);  // same pointer as g_pFakeTransparencyDesktopBg
+		s_bDesktopBgHeld = TRUE;
+	}
+	cairo_surface_t *pBgSurface = gldi_desktop_background_get_surface (g_pFakeTransparencyDesktopBg);
+	if (pBgSurface == NULL)
+		return NULL;
+	
+	pSlice = g_new0 (GldiContainerBgSlice, 1);
+	pSlice->x = x;
+	pSlice->y = y;
+	pSlice->w = w;
+	pSlice->h = h;
+	pSlice->iStamp = g_pFakeTransparencyDesktopBg->iStamp;
+	pSlice->pSurface = cairo_dock_create_blank_surface (w, h);
+	cairo_t *pCairoContext = cairo_create (pSlice->pSurface);
+	cairo_set_source_surface (pCairoContext, pBgSurface, -x, -y);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	pContainer->pBgSlice = pSlice;
+	s_iNbBgSlices ++;
+	return pSlice;
+}
+
+cairo_surface_t *gldi_container_get_desktop_bg_surface (GldiContainer *pContainer)
+{
+	GldiContainerBgSlice *pSlice = _get_desktop_bg_slice (pContainer);
+	return (pSlice ? pSlice->pSurface : NULL);
+}
+
+GLuint gldi_container_get_desktop_bg_texture (GldiContainer *pContainer)
+{
+	GldiContainerBgSlice *pSlice = _get_desktop_bg_slice (pContainer);
+	if (pSlice == NULL)
+		return 0;
+	if (pSlice->iTexture == 0 && pSlice->pSurface != NULL)  // in OpenGL, only the texture is needed.
+	{
+		pSlice->iTexture = cairo_dock_create_texture_from_surface (pSlice->pSurface);
+		cairo_surface_destroy (pSlice->pSurface);
+		pSlice->pSurface = NULL;
+	}
+	return pSlice->iTexture;
+}
+
+
   ////////////
  /// INIT ///
 ////////////
@@ -420,9 +643,20 @@ static void _set_visibility (CairoDock *pDock, gpointer data)
 {
 	gldi_dock_set_visibility (pDock, GPOINTER_TO_INT (data));
 }
+static void _release_desktop_bg (void)
+{
+	if (s_bDesktopBgHeld)
+		gldi_desktop_background_destroy (g_pFakeTransparencyDesktopBg);
+	s_bDesktopBgHeld = FALSE;
+	g_pFakeTransparencyDesktopBg = NULL;  // the remaining slices will be freed on their next use.
+}
 static void _enable_fake_transparency (void)
 {
-	g_pFakeTransparencyDesktopBg = gldi_desktop_background_get (g_bUseOpenGL);
+	if (! s_bDesktopBgHeld)
+	{
+		g_pFakeTransparencyDesktopBg = gldi_desktop_background_get (FALSE);  // the containers make their own texture from it.
+		s_bDesktopBgHeld = TRUE;
+	}
 	s_bNoComposite = TRUE;
 	s_iPrevVisibility = g_pMainDock->iVisibility;
 	gldi_docks_foreach_root ((GFunc)_set_visibility, GINT_TO_POINTER (CAIRO_DOCK_VISI_KEEP_BELOW));  // set the visibility to 'keep below'; that's the best compromise between accessibility and visual annoyance.
@@ -435,9 +669,8 @@ static void _on_composited_changed (GdkScreen *pScreen, G_GNUC_UNUSED gpointer d
 	}
 	else  // composite is now ON => disable fake transparency
 	{
-		gldi_desktop_background_destroy (g_pFakeTransparencyDesktopBg);
+		_release_desktop_bg ();
 		s_bNoComposite = FALSE;
-		g_pFakeTransparencyDesktopBg = NULL;
 		if (s_iPrevVisibility < CAIRO_DOCK_NB_VISI)
 			gldi_docks_foreach_root ((GFunc)_set_visibility, GINT_TO_POINTER (s_iPrevVisibility));  // restore the previous visibility.
 	}
@@ -462,6 +695,35 @@ static gboolean _check_composite_delayed (G_GNUC_UNUSED gpointer data)
 static void init (void)
 {
 	g_timeout_add_seconds (4, _check_composite_delayed, NULL);  // we don't want to be annoyed by the activation of the composite on startup
+	
+	// invalidate the menu kept between 2 right-clicks when what it shows changes.
+	gldi_object_register_notification (&myIconObjectMgr,
+		NOTIFICATION_DESTROY,
+		(GldiNotificationFunc) _on_object_destroyed_for_menu,
+		GLDI_RUN_AFTER, NULL);
+	gldi_object_register_notification (&myContainerObjectMgr,
+		NOTIFICATION_DESTROY,
+		(GldiNotificationFunc) _on_object_destroyed_for_menu,
+		GLDI_RUN_AFTER, NULL);
+	int iNotifications[] = {NOTIFICATION_WINDOW_CREATED, NOTIFICATION_WINDOW_DESTROYED, NOTIFICATION_WINDOW_NAME_CHANGED, NOTIFICATION_WINDOW_STATE_CHANGED, NOTIFICATION_WINDOW_CLASS_CHANGED, NOTIFICATION_WINDOW_DESKTOP_CHANGED};
+	guint i;
+	for (i = 0; i < G_N_ELEMENTS (iNotifications); i ++)
+		gldi_object_register_notification (&myWindowObjectMgr,
+			iNotifications[i],
+			(GldiNotificationFunc) _on_window_changed_for_menu,
+			GLDI_RUN_AFTER, NULL);
+	gldi_object_register_notification (&myDesktopMgr,
+		NOTIFICATION_DESKTOP_GEOMETRY_CHANGED,
+		(GldiNotificationFunc) _on_desktops_changed_for_menu,
+		GLDI_RUN_AFTER, NULL);
+	gldi_object_register_notification (&myDesktopMgr,
+		NOTIFICATION_DESKTOP_NAMES_CHANGED,
+		(GldiNotificationFunc) _on_desktops_changed_for_menu,
+		GLDI_RUN_AFTER, NULL);
+	gldi_object_register_notification (&myModuleInstanceObjectMgr,
+		NOTIFICATION_MODULE_INSTANCE_MENU_CHANGED,
+		(GldiNotificationFunc) _on_instance_menu_changed,
+		GLDI_RUN_AFTER, NULL);
 }
 
   //////////////////
@@ -487,9 +749,10 @@ static gboolean get_config (GKeyFile *pKeyFile, GldiContainersParam *pContainers
 
 static void load (void)
 {
-	if (s_bNoComposite)
+	if (s_bNoComposite && ! s_bDesktopBgHeld)
 	{
-		g_pFakeTransparencyDesktopBg = gldi_desktop_background_get (g_bUseOpenGL);
+		g_pFakeTransparencyDesktopBg = gldi_desktop_background_get (FALSE);
+		s_bDesktopBgHeld = TRUE;
 	}
 }
 
@@ -499,8 +762,7 @@ static void load (void)
 
 static void unload (void)
 {
-	gldi_desktop_background_destroy (g_pFakeTransparencyDesktopBg);  // destroy it, since it will be unloaded anyway by the desktop-manager
-	g_pFakeTransparencyDesktopBg = NULL;
+	_release_desktop_bg ();  // destroy it, since it will be unloaded anyway by the desktop-manager
 }
 
   ///////////////
@@ -578,6 +840,11 @@ static void reset_object (GldiObject *obj)
 {
 	GldiContainer *pContainer = (GldiContainer*)obj;
 	
+	// free the background (before the opengl context, since the texture was made with it)
+	if (_get_bg_slice (pContainer) && _get_bg_slice (pContainer)->iTexture != 0)
+		gldi_gl_container_make_current (pContainer);
+	_free_bg_slice (pContainer);
+	
 	// destroy the opengl context
 	gldi_gl_container_finish (pContainer);
 	
@@ -587,10 +854,7 @@ static void reset_object (GldiObject *obj)
 	
 	// stop the animation loop
 	if (pContainer->iSidGLAnimation != 0)
-	{
-		g_source_remove (pContainer->iSidGLAnimation);
-		pContainer->iSidGLAnimation = 0;
-	}
+		cairo_dock_stop_animation (pContainer);
 	
 	if (g_pPrimaryContainer == pContainer)
 		g_pPrimaryContainer = NULL;
@@ -131,7 +131,7 @@ struct _GldiContainer {
 	CairoDockTypeHorizontality bIsHorizontal;
 	/// TRUE if the container is oriented upwards, FALSE if downwards.
 	gboolean bDirectionUp;
-	/// Source ID of the animation loop.
+	/// non-zero while the container is animated, 0 otherwise. It's not the ID of a source (all the containers are driven by the same frame clock, see cairo-dock-animations.h): don't remove it, use cairo_dock_stop_animation().
 	guint iSidGLAnimation;
 	/// interval of time between 2 animation steps.
 	gint iAnimationDeltaT;
@@ -162,7 +162,11 @@ struct _GldiContainer {
 	GldiContainerInterface iface;
 	
 	gboolean bIgnoreNextReleaseEvent;
-	gpointer reserved[4];
+	/// private data: the part of the wallpaper behind the container, when there is no composite.
+	gpointer pBgSlice;
+	/// number of animation steps that couldn't run on time since the container was created (the main loop was too busy).
+	gint iNbMissedFrames;
+	gpointer reserved[2];
 };
 
 
@@ -194,6 +198,18 @@ void cairo_dock_set_containers_non_sticky (void);
 
 void cairo_dock_disable_containers_opacity (void);
 
+/** Get the part of the wallpaper that is behind a container, to simulate the transparency when there is no composite. It is kept by the container, and only made again when the container moves, is resized, or when the wallpaper changes.
+*@param pContainer the container
+*@return a surface of the size of the container (in screen orientation), or NULL if the transparency doesn't need to be simulated.
+*/
+cairo_surface_t *gldi_container_get_desktop_bg_surface (GldiContainer *pContainer);
+
+/** Same as above, for an OpenGL container.
+*@param pContainer the container
+*@return a texture of the size of the container (in screen orientation), or 0 if the transparency doesn't need to be simulated.
+*/
+GLuint gldi_container_get_desktop_bg_texture (GldiContainer *pContainer);
+
 #define gldi_container_get_gdk_window(pContainer) gtk_widget_get_window ((pContainer)->pWidget)
 
 #define gldi_container_get_Xid(pContainer) GDK_WINDOW_XID (gldi_container_get_gdk_window(pContainer))
@@ -306,6 +322,16 @@ gboolean cairo_dock_emit_enter_signal (GldiContainer *pContainer);
 */
 GtkWidget *gldi_container_build_menu (GldiContainer *pContainer, Icon *icon);
 
+/** Drop the menu kept from the last right-click, so that it's built again the next time. The menu is kept when it's opened again on the same icon and nothing it shows has changed (icons, windows, desktops, applets that enabled it); call this if something else it shows has changed.
+*/
+void gldi_container_invalidate_menu (void);
+
+/** Get the time it took to build the main menu of a Container, which is the latency before it pops up.
+*@param iLastTime returns the time of the last build, in microseconds (can be NULL).
+*@param iMaxTime returns the longest build time so far, in microseconds (can be NULL).
+*/
+void gldi_container_get_menu_build_time (gint64 *iLastTime, gint64 *iMaxTime);
+
 
   /////////////////
  // INPUT SHAPE //
@@ -45,7 +45,7 @@ static CairoDockGLFont *s_pFont = NULL;
  /// FONT ///
 ////////////
 
-#define _init_data_renderer_font(...) s_pFont = cairo_dock_load_textured_font ("Monospace Bold 12", 0, 184)  // on va jusqu'a ø
+#define _init_data_renderer_font(...) s_pFont = cairo_dock_load_atlas_font ("Monospace Bold 12")  // any character the values are formatted with (units, %, ...) will be rendered on demand.
 
 CairoDockGLFont *cairo_dock_get_default_data_renderer_font (void)
 {
@@ -49,19 +49,175 @@ extern gboolean g_bUseOpenGL;
 #define cairo_dock_set_data_renderer_on_icon(pIcon, pRenderer) (pIcon)->pDataRenderer = pRenderer
 #define CD_MIN_TEXT_WITH 24
 
+// static layer of a renderer: the parts drawn above the moving ones, kept in a texture during the smooth animation.
+typedef struct {
+	GLuint iTexture;
+	gint iWidth, iHeight;
+	gint iIndex;  // index of the sample it was drawn for
+} CDDataRendererStaticLayer;
+static GHashTable *s_pStaticLayers = NULL;  // renderer -> CDDataRendererStaticLayer
+static CairoDataRendererPass s_iRenderPass = CAIRO_DATA_RENDERER_PASS_ALL;  // only used from the main thread
+
+// private history of a renderer: its samples as floats, and for each value the candidates for the min and the max over the history (monotonic deques), so that they are maintained in O(1) amortised.
+typedef struct {
+	gint64 *pSamples;  // numbers of the candidate samples, oldest first, in a ring of iMemorySize
+	gint iHead, iCount;
+} CDHistoryDeque;
+typedef struct {
+	gint iNbValues, iMemorySize;
+	gfloat *pValues;  // same layout as pValuesBuffer: value i of the sample at index t is pValues[t*iNbValues+i]
+	gint64 iNbSamples;  // number of samples pushed so far; sample n is at index n % iMemorySize
+	CDHistoryDeque *pMin, *pMax;  // one per value
+} CDDataHistory;
+static GHashTable *s_pHistories = NULL;  // CairoDataToRenderer -> CDDataHistory
+
+static void _free_history (CDDataHistory *pHistory)
+{
+	int i;
+	for (i = 0; i < pHistory->iNbValues; i ++)
+	{
+		g_free (pHistory->pMin[i].pSamples);
+		g_free (pHistory->pMax[i].pSamples);
+	}
+	g_free (pHistory->pMin);
+	g_free (pHistory->pMax);
+	g_free (pHistory->pValues);
+	g_free (pHistory);
+}
+
+static inline void _push_history_candidate (CDDataHistory *pHistory, CDHistoryDeque *d, int i, gint64 n, gfloat x, gboolean bMax)
+{
+	int iSize = pHistory->iMemorySize;
+	while (d->iCount != 0 && d->pSamples[d->iHead] <= n - iSize)  // out of the history now.
+	{
+		d->iHead = (d->iHead + 1 == iSize ? 0 : d->iHead + 1);
+		d->iCount --;
+	}
+	if (x <= CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+		return;
+	gint64 m;
+	gfloat y;
+	while (d->iCount != 0)  // the candidates that are not better than the new value will never be the extremum again.
+	{
+		m = d->pSamples[(d->iHead + d->iCount - 1) % iSize];
+		y = pHistory->pValues[(m % iSize) * pHistory->iNbValues + i];
+		if (bMax ? y > x : y < x)
+			break;
+		d->iCount --;
+	}
+	d->pSamples[(d->iHead + d->iCount) % iSize] = n;
+	d->iCount ++;
+}
+
+static void _push_history_sample (CDDataHistory *pHistory, const gdouble *pNewValues)
+{
+	gint64 n = pHistory->iNbSamples ++;
+	gfloat *v = &pHistory->pValues[(n % pHistory->iMemorySize) * pHistory->iNbValues];
+	int i;
+	for (i = 0; i < pHistory->iNbValues; i ++)
+	{
+		v[i] = pNewValues[i];
+		_push_history_candidate (pHistory, &pHistory->pMin[i], i, n, v[i], FALSE);
+		_push_history_candidate (pHistory, &pHistory->pMax[i], i, n, v[i], TRUE);
+	}
+}
+
+// get the private history of some data; it's built from the public ring if it doesn't exist or doesn't match it anymore (new size, or modified from outside).
+static CDDataHistory *_get_history (CairoDataToRenderer *pData)
+{
+	CDDataHistory *pHistory = (s_pHistories != NULL ? g_hash_table_lookup (s_pHistories, pData) : NULL);
+	if (pHistory != NULL
+	&& pHistory->iNbValues == pData->iNbValues
+	&& pHistory->iMemorySize == pData->iMemorySize
+	&& (pHistory->iNbSamples == 0 ? pData->iCurrentIndex == -1 : (pHistory->iNbSamples - 1) % pHistory->iMemorySize == pData->iCurrentIndex))
+		return pHistory;
+	
+	if (s_pHistories == NULL)
+		s_pHistories = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify)_free_history);
+	pHistory = g_new0 (CDDataHistory, 1);
+	pHistory->iNbValues = pData->iNbValues;
+	pHistory->iMemorySize = pData->iMemorySize;
+	pHistory->pValues = g_new0 (gfloat, pData->iNbValues * pData->iMemorySize);
+	pHistory->pMin = g_new0 (CDHistoryDeque, pData->iNbValues);
+	pHistory->pMax = g_new0 (CDHistoryDeque, pData->iNbValues);
+	int i;
+	for (i = 0; i < pData->iNbValues; i ++)
+	{
+		pHistory->pMin[i].pSamples = g_new (gint64, pData->iMemorySize);
+		pHistory->pMax[i].pSamples = g_new (gint64, pData->iMemorySize);
+	}
+	// the samples 0 to iCurrentIndex are the most recent ones (this is how the ring is after a resize); the rest of the ring is copied as is.
+	int t;
+	for (t = 0; t <= pData->iCurrentIndex; t ++)
+		_push_history_sample (pHistory, &pData->pValuesBuffer[t * pData->iNbValues]);
+	for (; t < pData->iMemorySize; t ++)
+		for (i = 0; i < pData->iNbValues; i ++)
+			pHistory->pValues[t * pData->iNbValues + i] = pData->pValuesBuffer[t * pData->iNbValues + i];
+	g_hash_table_insert (s_pHistories, pData, pHistory);  // replaces the previous one, if any.
+	return pHistory;
+}
+
+static void _move_history (CairoDataToRenderer *pOldData, CairoDataToRenderer *pNewData)
+{
+	CDDataHistory *pHistory = (s_pHistories != NULL ? g_hash_table_lookup (s_pHistories, pOldData) : NULL);
+	if (pHistory == NULL)
+		return;
+	g_hash_table_steal (s_pHistories, pOldData);
+	g_hash_table_insert (s_pHistories, pNewData, pHistory);
+}
+
+static void _cairo_dock_set_history_rows (CairoDataToRenderer *pData)
+{
+	g_free (pData->pTabValues);
+	pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
+	int t;
+	for (t = 0; t < pData->iMemorySize; t ++)
+	{
+		pData->pTabValues[t] = &pData->pValuesBuffer[t*pData->iNbValues];
+	}
+}
+
+static void _cairo_dock_resize_data_history (CairoDataToRenderer *pData, int iNewMemorySize)
+{
+	int iOldMemorySize = pData->iMemorySize;
+	int iNbValues = pData->iNbValues;
+	gdouble *pNewBuffer = g_new0 (gdouble, iNewMemorySize * iNbValues);
+	
+	//\_______________ copy the most recent samples, the oldest first, so that the new ring starts at 0.
+	int iNbKept = 0;
+	if (pData->iCurrentIndex >= 0)
+	{
+		iNbKept = MIN (iOldMemorySize, iNewMemorySize);
+		int t, n = pData->iCurrentIndex - iNbKept + 1;
+		if (n < 0)
+			n += iOldMemorySize;
+		for (t = 0; t < iNbKept; t ++)
+		{
+			memcpy (&pNewBuffer[t*iNbValues], &pData->pValuesBuffer[n*iNbValues], iNbValues * sizeof (gdouble));
+			n ++;
+			if (n == iOldMemorySize)
+				n = 0;
+		}
+	}
+	g_free (pData->pValuesBuffer);
+	pData->pValuesBuffer = pNewBuffer;
+	pData->iMemorySize = iNewMemorySize;
+	pData->iCurrentIndex = iNbKept - 1;
+	_cairo_dock_set_history_rows (pData);
+	if (s_pHistories != NULL)
+		g_hash_table_remove (s_pHistories, pData);  // it will be built again from the kept samples.
+}
+
 static void _cairo_dock_init_data_renderer (CairoDataRenderer *pRenderer, CairoDataRendererAttribute *pAttribute)
 {
 	//\_______________ On alloue la structure des donnees.
 	pRenderer->data.iNbValues = MAX (1, pAttribute->iNbValues);
 	pRenderer->data.iMemorySize = MAX (2, pAttribute->iMemorySize);  // au moins la derniere valeur et la nouvelle.
 	pRenderer->data.pValuesBuffer = g_new0 (gdouble, pRenderer->data.iNbValues * pRenderer->data.iMemorySize);
-	pRenderer->data.pTabValues = g_new (gdouble *, pRenderer->data.iMemorySize);
-	int i;
-	for (i = 0; i < pRenderer->data.iMemorySize; i ++)
-	{
-		pRenderer->data.pTabValues[i] = &pRenderer->data.pValuesBuffer[i*pRenderer->data.iNbValues];
-	}
+	pRenderer->data.pTabValues = NULL;
+	_cairo_dock_set_history_rows (&pRenderer->data);
 	pRenderer->data.iCurrentIndex = -1;
+	int i;
 	pRenderer->data.pMinMaxValues = g_new (gdouble, 2 * pRenderer->data.iNbValues);
 	if (pAttribute->pMinMaxValues != NULL)
 	{
@@ -134,6 +290,101 @@ void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, g
 }
 
 
+int cairo_data_renderer_downsample_history (CairoDataRenderer *pRenderer, int iNumValue, int iNbColumns, gfloat *pColumns)
+{
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int n = pData->iMemorySize;
+	int iNbValues = pData->iNbValues;
+	int iNbFilled = MIN (n, iNbColumns);
+	if (iNbFilled <= 0)
+		return 0;
+	double fMinValue = cairo_data_renderer_get_min_value (pRenderer, iNumValue);
+	double fRange = cairo_data_renderer_get_max_value (pRenderer, iNumValue) - fMinValue;
+	if (fRange == 0)
+		fRange = 1.;
+	
+	// walk the ring from the most recent sample to the oldest one; each column gathers n/iNbFilled consecutive samples.
+	CDDataHistory *pHistory = _get_history (pData);
+	int t = (pData->iCurrentIndex >= 0 ? pData->iCurrentIndex : n - 1);
+	const gfloat *v = &pHistory->pValues[t * iNbValues + iNumValue];
+	const gfloat *pLast = &pHistory->pValues[iNumValue];
+	gfloat x, fMin, fMax;
+	int c, iAge = 0, iColumnEnd;
+	for (c = 0; c < iNbFilled; c ++)
+	{
+		fMin = G_MAXFLOAT;
+		fMax = - G_MAXFLOAT;
+		iColumnEnd = (c + 1) * n / iNbFilled;
+		for (; iAge < iColumnEnd; iAge ++)
+		{
+			x = *v;
+			if (x > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+			{
+				if (x < fMin)
+					fMin = x;
+				if (x > fMax)
+					fMax = x;
+			}
+			if (v == pLast)
+				v = &pHistory->pValues[(n - 1) * iNbValues + iNumValue];
+			else
+				v -= iNbValues;
+		}
+		if (fMax < fMin)  // only undefined values in this column.
+		{
+			pColumns[2*c] = pColumns[2*c+1] = CAIRO_DATA_RENDERER_UNDEF_VALUE;
+		}
+		else
+		{
+			pColumns[2*c] = MAX (0, MIN (1, (fMin - fMinValue) / fRange));
+			pColumns[2*c+1] = MAX (0, MIN (1, (fMax - fMinValue) / fRange));
+		}
+	}
+	return iNbFilled;
+}
+
+gboolean cairo_data_renderer_get_history_extrema (CairoDataRenderer *pRenderer, int iNumValue, double *fMin, double *fMax)
+{
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	g_return_val_if_fail (iNumValue >= 0 && iNumValue < pData->iNbValues, FALSE);
+	CDDataHistory *pHistory = _get_history (pData);
+	CDHistoryDeque *pMin = &pHistory->pMin[iNumValue], *pMax = &pHistory->pMax[iNumValue];
+	if (pMin->iCount == 0)  // no defined value in the history.
+		return FALSE;
+	int iSize = pHistory->iMemorySize;
+	if (fMin)
+		*fMin = pHistory->pValues[(pMin->pSamples[pMin->iHead] % iSize) * pHistory->iNbValues + iNumValue];
+	if (fMax)
+		*fMax = pHistory->pValues[(pMax->pSamples[pMax->iHead] % iSize) * pHistory->iNbValues + iNumValue];
+	return TRUE;
+}
+
+void cairo_data_renderer_push_values (CairoDataRenderer *pRenderer, const double *pNewValues)
+{
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	CDDataHistory *pHistory = _get_history (pData);  // get it before the public ring moves.
+	pData->iCurrentIndex ++;
+	if (pData->iCurrentIndex >= pData->iMemorySize)
+		pData->iCurrentIndex -= pData->iMemorySize;
+	double fNewValue;
+	int i;
+	for (i = 0; i < pData->iNbValues; i ++)
+	{
+		fNewValue = pNewValues[i];
+		if (pRenderer->bUpdateMinMax && fNewValue > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+		{
+			if (fNewValue < pData->pMinMaxValues[2*i])
+				pData->pMinMaxValues[2*i] = fNewValue;
+			if (fNewValue > pData->pMinMaxValues[2*i+1])
+				pData->pMinMaxValues[2*i+1] = MAX (fNewValue, pData->pMinMaxValues[2*i]+.1);
+		}
+		pData->pTabValues[pData->iCurrentIndex][i] = fNewValue;
+	}
+	_push_history_sample (pHistory, pNewValues);
+	pData->bHasValue = TRUE;
+}
+
+
 void cairo_dock_render_overlays_to_texture (CairoDataRenderer *pRenderer, int iNumValue)
 {
 	gint iWidth = pRenderer->iWidth, iHeight = pRenderer->iHeight;
@@ -351,6 +602,22 @@ static void _cairo_dock_render_to_context (CairoDataRenderer *pRenderer, Icon *p
 		cairo_destroy (ctx);
 }
 
+static void _cairo_dock_render_pass_opengl (CairoDataRenderer *pRenderer, GldiContainer *pContainer, CairoDataRendererPass iPass)
+{
+	glPushMatrix ();
+	if ((pRenderer->iRotateTheme == CD_RENDERER_ROTATE_WITH_CONTAINER && pContainer->bIsHorizontal == CAIRO_DOCK_VERTICAL) || pRenderer->iRotateTheme == CD_RENDERER_ROTATE_YES)
+	{
+		glRotatef (-90., 0., 0., 1.);
+		pRenderer->bisRotate = TRUE;
+	}
+	
+	s_iRenderPass = iPass;
+	pRenderer->interface.render_opengl (pRenderer);
+	s_iRenderPass = CAIRO_DATA_RENDERER_PASS_ALL;
+	
+	glPopMatrix ();
+}
+
 static void _cairo_dock_render_to_texture (CairoDataRenderer *pRenderer, Icon *pIcon, GldiContainer *pContainer)
 {
 	if (pRenderer->bUseOverlay)
@@ -371,34 +638,133 @@ static void _cairo_dock_render_to_texture (CairoDataRenderer *pRenderer, Icon *p
 	}
 	
 	//\________________ On dessine.
-	glPushMatrix ();
-	if ((pRenderer->iRotateTheme == CD_RENDERER_ROTATE_WITH_CONTAINER && pContainer->bIsHorizontal == CAIRO_DOCK_VERTICAL) || pRenderer->iRotateTheme == CD_RENDERER_ROTATE_YES)
+	_cairo_dock_render_pass_opengl (pRenderer, pContainer, CAIRO_DATA_RENDERER_PASS_ALL);
+	
+	if (pRenderer->bUseOverlay)
 	{
-		glRotatef (-90., 0., 0., 1.);
-		pRenderer->bisRotate = TRUE;
+		cairo_dock_end_draw_image_buffer_opengl (&pRenderer->pOverlay->image, pContainer);
 	}
+	else
+	{
+		cairo_dock_end_draw_icon (pIcon);
+	}
+}
+
+// draw an intermediate frame of the smooth animation: the static layer is only drawn once per value, then each frame only draws the moving parts under it. Returns FALSE if the renderer doesn't have a static layer.
+static gboolean _cairo_dock_render_to_texture_with_static_layer (CairoDataRenderer *pRenderer, Icon *pIcon, GldiContainer *pContainer)
+{
+	CDDataRendererStaticLayer *pLayer = (s_pStaticLayers != NULL ? g_hash_table_lookup (s_pStaticLayers, pRenderer) : NULL);
+	if (pLayer == NULL)
+		return FALSE;
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	if (pRenderer->bUseOverlay && ! pData->bHasValue)
+		return TRUE;
 	
-	//glPushMatrix ();
-	pRenderer->interface.render_opengl (pRenderer);
-	//glPopMatrix ();
+	CairoDockImageBuffer *pImage = (pRenderer->bUseOverlay ? &pRenderer->pOverlay->image : &pIcon->image);
+	int iWidth, iHeight;  // size of the drawing space (see cairo_dock_begin_draw_image_buffer_opengl)
+	if (CAIRO_DOCK_IS_DESKLET (pContainer))
+	{
+		iWidth = pContainer->iWidth;
+		iHeight = pContainer->iHeight;
+	}
+	else
+	{
+		iWidth = pImage->iWidth;
+		iHeight = pImage->iHeight;
+	}
 	
-	//\________________ On dessine les overlays.
-	/**int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
-	int i;
-	for (i = 0; i < iNbValues; i ++)
+	//\________________ draw the static layer, and copy it into its texture.
+	if (pLayer->iTexture == 0 || pLayer->iIndex != pData->iCurrentIndex || pLayer->iWidth != iWidth || pLayer->iHeight != iHeight)
 	{
-		cairo_dock_render_overlays_to_texture (pRenderer, i);
-	}*/
-	glPopMatrix ();
+		if (! cairo_dock_begin_draw_image_buffer_opengl (pImage, pContainer, 0))  // not cairo_dock_begin_draw_icon, the background of the icon goes under the moving parts.
+		{
+			pIcon->bDamaged = TRUE;
+			return TRUE;
+		}
+		_cairo_dock_render_pass_opengl (pRenderer, pContainer, CAIRO_DATA_RENDERER_PASS_STATIC);
+		
+		if (pLayer->iTexture == 0)
+			glGenTextures (1, &pLayer->iTexture);
+		glBindTexture (GL_TEXTURE_2D, pLayer->iTexture);
+		if (pLayer->iWidth != iWidth || pLayer->iHeight != iHeight)
+		{
+			glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glCopyTexImage2D (GL_TEXTURE_2D, 0, GL_RGBA, 0, 0, iWidth, iHeight, 0);
+		}
+		else
+			glCopyTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, 0, 0, iWidth, iHeight);
+		glBindTexture (GL_TEXTURE_2D, 0);
+		cairo_dock_end_draw_image_buffer_opengl (pImage, pContainer);
+		
+		pLayer->iWidth = iWidth;
+		pLayer->iHeight = iHeight;
+		pLayer->iIndex = pData->iCurrentIndex;
+	}
 	
+	//\________________ draw the moving parts, then the static layer in one quad.
 	if (pRenderer->bUseOverlay)
 	{
-		cairo_dock_end_draw_image_buffer_opengl (&pRenderer->pOverlay->image, pContainer);
+		if (! cairo_dock_begin_draw_image_buffer_opengl (pImage, pContainer, 0))
+		{
+			pIcon->bDamaged = TRUE;
+			return TRUE;
+		}
 	}
+	else if (! cairo_dock_begin_draw_icon (pIcon, 0))
+		return TRUE;
+	
+	_cairo_dock_render_pass_opengl (pRenderer, pContainer, CAIRO_DATA_RENDERER_PASS_DYNAMIC);
+	
+	_cairo_dock_enable_texture ();
+	_cairo_dock_set_blend_pbuffer ();  // the layer is premultiplied, like the icon's texture.
+	_cairo_dock_set_alpha (1.);
+	_cairo_dock_apply_texture_at_size (pLayer->iTexture, iWidth, iHeight);
+	_cairo_dock_disable_texture ();
+	
+	if (pRenderer->bUseOverlay)
+		cairo_dock_end_draw_image_buffer_opengl (pImage, pContainer);
 	else
-	{
 		cairo_dock_end_draw_icon (pIcon);
+	return TRUE;
+}
+
+static void _invalidate_static_layer (CairoDataRenderer *pRenderer)
+{
+	CDDataRendererStaticLayer *pLayer = (s_pStaticLayers != NULL ? g_hash_table_lookup (s_pStaticLayers, pRenderer) : NULL);
+	if (pLayer != NULL)
+		pLayer->iIndex = -2;  // never a valid index
+}
+
+static void _free_static_layer (CDDataRendererStaticLayer *pLayer)
+{
+	if (pLayer->iTexture != 0)
+		_cairo_dock_delete_texture (pLayer->iTexture);
+	g_free (pLayer);
+}
+
+void cairo_data_renderer_enable_static_layer (CairoDataRenderer *pRenderer, gboolean bEnable)
+{
+	if (bEnable)
+	{
+		if (s_pStaticLayers == NULL)
+			s_pStaticLayers = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify)_free_static_layer);
+		if (g_hash_table_lookup (s_pStaticLayers, pRenderer) == NULL)
+		{
+			CDDataRendererStaticLayer *pLayer = g_new0 (CDDataRendererStaticLayer, 1);
+			pLayer->iIndex = -2;
+			g_hash_table_insert (s_pStaticLayers, pRenderer, pLayer);
+		}
 	}
+	else if (s_pStaticLayers != NULL)
+	{
+		g_hash_table_remove (s_pStaticLayers, pRenderer);
+	}
+}
+
+CairoDataRendererPass cairo_data_renderer_get_render_pass (void)
+{
+	return s_iRenderPass;
 }
 
 static inline void _refresh (CairoDataRenderer *pRenderer, Icon *pIcon, GldiContainer *pContainer)
@@ -426,7 +792,8 @@ static gboolean cairo_dock_update_icon_data_renderer_notification (G_GNUC_UNUSED
 		int iNbIterations = pRenderer->iLatencyTime / iDeltaT;
 		
 		pRenderer->fLatency = (double) pRenderer->iSmoothAnimationStep / iNbIterations;
-		_cairo_dock_render_to_texture (pRenderer, pIcon, pContainer);
+		if (! _cairo_dock_render_to_texture_with_static_layer (pRenderer, pIcon, pContainer))
+			_cairo_dock_render_to_texture (pRenderer, pIcon, pContainer);
 		cairo_dock_redraw_icon (pIcon);
 		
 		if (pRenderer->iSmoothAnimationStep < iNbIterations)
@@ -538,6 +905,7 @@ static void _cairo_dock_finish_load_data_renderer (CairoDataRenderer *pRenderer,
 		cairo_surface_t *pSurface = cairo_dock_create_blank_surface (pRenderer->iWidth, pRenderer->iHeight);
 		pRenderer->pOverlay = cairo_dock_add_overlay_from_surface (pIcon, pSurface, pRenderer->iWidth, pRenderer->iHeight, pRenderer->iOverlayPosition, (gpointer)"data-renderer");  // this string is constant; any previous overlay will be removed.
 		cairo_dock_set_overlay_scale (pRenderer->pOverlay, 0);  // keep the original size of the image
+		pRenderer->pOverlay->bDynamic = TRUE;  // redrawn on each update, don't composite it with the other overlays.
 	}
 }
 
@@ -555,28 +923,11 @@ void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pCont
 		{
 			pData = g_memdup (&pRenderer->data, sizeof (CairoDataToRenderer));
 			memset (&pRenderer->data, 0, sizeof (CairoDataToRenderer));
+			_move_history (&pRenderer->data, pData);
 			
 			pAttribute->iMemorySize = MAX (2, pAttribute->iMemorySize);
 			if (pData->iMemorySize != pAttribute->iMemorySize)  // on redimensionne le tampon des valeurs.
-			{
-				int iOldMemorySize = pData->iMemorySize;
-				pData->iMemorySize = pAttribute->iMemorySize;
-				pData->pValuesBuffer = g_realloc (pData->pValuesBuffer, pData->iMemorySize * pData->iNbValues * sizeof (gdouble));
-				if (pData->iMemorySize > iOldMemorySize)
-				{
-					memset (&pData->pValuesBuffer[iOldMemorySize * pData->iNbValues], 0, (pData->iMemorySize - iOldMemorySize) * pData->iNbValues * sizeof (gdouble));
-				}
-				
-				g_free (pData->pTabValues);
-				pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
-				int i;
-				for (i = 0; i < pData->iMemorySize; i ++)
-				{
-					pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
-				}
-				if (pData->iCurrentIndex >= pData->iMemorySize)
-					pData->iCurrentIndex = pData->iMemorySize - 1;
-			}
+				_cairo_dock_resize_data_history (pData, pAttribute->iMemorySize);
 		}
 		
 		//\_____________ remove the current data-renderer
@@ -615,7 +966,11 @@ void cairo_dock_add_new_data_renderer_on_icon (Icon *pIcon, GldiContainer *pCont
 	//\_____________ set back the previous data, if any.
 	if (pData != NULL)
 	{
+		g_free (pRenderer->data.pValuesBuffer);
+		g_free (pRenderer->data.pTabValues);
+		g_free (pRenderer->data.pMinMaxValues);
 		memcpy (&pRenderer->data, pData, sizeof (CairoDataToRenderer));
+		_move_history (pData, &pRenderer->data);
 		g_free (pData);
 		_refresh (pRenderer, pIcon, pContainer);
 	}
@@ -648,24 +1003,7 @@ void cairo_dock_render_new_data_on_icon (Icon *pIcon, GldiContainer *pContainer,
 	
 	//\___________________ On met a jour les valeurs du renderer.
 	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
-	pData->iCurrentIndex ++;
-	if (pData->iCurrentIndex >= pData->iMemorySize)
-		pData->iCurrentIndex -= pData->iMemorySize;
-	double fNewValue;
-	int i;
-	for (i = 0; i < pData->iNbValues; i ++)
-	{
-		fNewValue = pNewValues[i];
-		if (pRenderer->bUpdateMinMax && fNewValue > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
-		{
-			if (fNewValue < pData->pMinMaxValues[2*i])
-				pData->pMinMaxValues[2*i] = fNewValue;
-			if (fNewValue > pData->pMinMaxValues[2*i+1])
-				pData->pMinMaxValues[2*i+1] = MAX (fNewValue, pData->pMinMaxValues[2*i]+.1);
-		}
-		pData->pTabValues[pData->iCurrentIndex][i] = fNewValue;
-	}
-	pData->bHasValue = TRUE;
+	cairo_data_renderer_push_values (pRenderer, pNewValues);
 	
 	//\___________________ On met a jour le dessin de l'icone.
 	if (CAIRO_DOCK_CONTAINER_IS_OPENGL (pContainer) && pRenderer->interface.render_opengl)
@@ -733,6 +1071,10 @@ void cairo_dock_free_data_renderer (CairoDataRenderer *pRenderer)
 	if (pRenderer->interface.unload)
 		pRenderer->interface.unload (pRenderer);
 	
+	cairo_data_renderer_enable_static_layer (pRenderer, FALSE);
+	if (s_pHistories != NULL)
+		g_hash_table_remove (s_pHistories, &pRenderer->data);
+	
 	g_free (pRenderer->data.pValuesBuffer);
 	g_free (pRenderer->data.pTabValues);
 	g_free (pRenderer->data.pMinMaxValues);
@@ -805,6 +1147,7 @@ void cairo_dock_reload_data_renderer_on_icon (Icon *pIcon, GldiContainer *pConta
 	
 	gboolean bLoadTextures = (CAIRO_DOCK_CONTAINER_IS_OPENGL (pContainer) && pRenderer->interface.render_opengl);
 	_cairo_dock_finish_load_data_renderer (pRenderer, bLoadTextures, pIcon);
+	_invalidate_static_layer (pRenderer);  // its emblems and labels have been reloaded.
 	
 	//\_____________ redraw.
 	_refresh (pRenderer, pIcon, pContainer);
@@ -822,23 +1165,7 @@ void cairo_dock_resize_data_renderer_history (Icon *pIcon, int iNewMemorySize)
 	if (pData->iMemorySize == iNewMemorySize)
 		return ;
 	
-	int iOldMemorySize = pData->iMemorySize;
-	pData->iMemorySize = iNewMemorySize;
-	pData->pValuesBuffer = g_realloc (pData->pValuesBuffer, pData->iMemorySize * pData->iNbValues * sizeof (gdouble));
-	if (iNewMemorySize > iOldMemorySize)
-	{
-		memset (&pData->pValuesBuffer[iOldMemorySize * pData->iNbValues], 0, (iNewMemorySize - iOldMemorySize) * pData->iNbValues * sizeof (gdouble));
-	}
-	
-	g_free (pData->pTabValues);
-	pData->pTabValues = g_new (gdouble *, pData->iMemorySize);
-	int i;
-	for (i = 0; i < pData->iMemorySize; i ++)
-	{
-		pData->pTabValues[i] = &pData->pValuesBuffer[i*pData->iNbValues];
-	}
-	if (pData->iCurrentIndex >= pData->iMemorySize)
-		pData->iCurrentIndex = pData->iMemorySize - 1;
+	_cairo_dock_resize_data_history (pData, iNewMemorySize);
 }
 
 void cairo_dock_refresh_data_renderer (Icon *pIcon, GldiContainer *pContainer)
@@ -846,6 +1173,7 @@ void cairo_dock_refresh_data_renderer (Icon *pIcon, GldiContainer *pContainer)
 	CairoDataRenderer *pRenderer = cairo_dock_get_icon_data_renderer (pIcon);
 	g_return_if_fail (pRenderer != NULL);
 	
+	_invalidate_static_layer (pRenderer);
 	_refresh (pRenderer, pIcon, pContainer);
 }
 
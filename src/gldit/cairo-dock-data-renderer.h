@@ -50,6 +50,13 @@ typedef enum _RendererRotateTheme {
 
 #define CAIRO_DATA_RENDERER_UNDEF_VALUE ((double)-1.e9)
 
+/// Part of the drawing that a renderer is asked to draw, see \ref cairo_data_renderer_enable_static_layer.
+typedef enum {
+	CAIRO_DATA_RENDERER_PASS_ALL=0,  // everything
+	CAIRO_DATA_RENDERER_PASS_STATIC,  // only what is drawn above the moving parts and doesn't depend on the interpolated values
+	CAIRO_DATA_RENDERER_PASS_DYNAMIC  // only what is drawn under it (background and moving parts)
+	} CairoDataRendererPass;
+
 //
 // Structures
 //
@@ -57,8 +64,8 @@ typedef enum _RendererRotateTheme {
 struct _CairoDataToRenderer {
 	gint iNbValues;
 	gint iMemorySize;
-	gdouble *pValuesBuffer;
-	gdouble **pTabValues;
+	gdouble *pValuesBuffer;  // ring of iMemorySize samples, stored contiguously: value i of the sample at index t is pValuesBuffer[t*iNbValues+i].
+	gdouble **pTabValues;  // rows of pValuesBuffer, one per sample.
 	gdouble *pMinMaxValues;
 	gint iCurrentIndex;
 	gboolean bHasValue;  // TRUE as soon as a value has been set in the history
@@ -247,6 +254,36 @@ void cairo_dock_render_overlays_to_texture (CairoDataRenderer *pRenderer, int iN
 
 void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, gint *iHeight);
 
+/**Let the renderer draw the intermediate frames of its smooth animation in 2 passes (OpenGL only). The static layer (what lies above the moving parts: foreground, emblems, labels, values as text) is drawn once per new value and kept in a texture; each frame then only draws the moving parts and applies this texture on top of them. A renderer that enables it must look at \ref cairo_data_renderer_get_render_pass in its render_opengl function.
+*@param pRenderer a data renderer
+*@param bEnable whether to use a static layer or not*/
+void cairo_data_renderer_enable_static_layer (CairoDataRenderer *pRenderer, gboolean bEnable);
+
+/**Get the pass being drawn, inside the render_opengl function of a renderer.
+*@return the current pass; CAIRO_DATA_RENDERER_PASS_ALL if the renderer has no static layer or is drawn in one go.*/
+CairoDataRendererPass cairo_data_renderer_get_render_pass (void);
+
+/**Add a set of values to the history of a DataRenderer, without drawing it (\ref cairo_dock_render_new_data_on_icon does it, and then draws the icon).
+*@param pRenderer a data renderer
+*@param pNewValues the new values, as many as the renderer has*/
+void cairo_data_renderer_push_values (CairoDataRenderer *pRenderer, const double *pNewValues);
+
+/**Get the minimum and the maximum of a value over its history. They are maintained each time a value is added, so this doesn't go through the history.
+*@param pRenderer a data renderer
+*@param iNumValue the number of the value
+*@param fMin returns the minimum (can be NULL)
+*@param fMax returns the maximum (can be NULL)
+*@return FALSE if the history doesn't contain any defined value yet.*/
+gboolean cairo_data_renderer_get_history_extrema (CairoDataRenderer *pRenderer, int iNumValue, double *fMin, double *fMax);
+
+/**Reduce the history of a value to a given number of columns, keeping the extrema of each column. This way a renderer never has to process more points than it has pixels, and peaks are not lost when the history is longer than the drawing.
+*@param pRenderer a data renderer
+*@param iNumValue the number of the value
+*@param iNbColumns the number of columns wanted
+*@param pColumns a buffer of at least 2*iNbColumns floats, filled with the (min,max) normalized values of each column, the most recent column first. A column that holds only undefined values is set to CAIRO_DATA_RENDERER_UNDEF_VALUE.
+*@return the number of columns actually filled, which is less than iNbColumns if the history is shorter.*/
+int cairo_data_renderer_downsample_history (CairoDataRenderer *pRenderer, int iNumValue, int iNbColumns, gfloat *pColumns);
+
 ///
 /// Structure Access
 ///
@@ -293,17 +330,18 @@ void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, g
 *@param i the number of the value
 *@return a double*/
 #define cairo_data_renderer_get_max_value(pRenderer, i) (pRenderer)->data.pMinMaxValues[2*i+1]
+#define _cairo_data_renderer_get_ring_index(pRenderer, t) ((pRenderer)->data.iCurrentIndex+(t) >= (pRenderer)->data.iMemorySize ? (pRenderer)->data.iCurrentIndex+(t)-(pRenderer)->data.iMemorySize : (pRenderer)->data.iCurrentIndex+(t) < 0 ? (pRenderer)->data.iCurrentIndex+(t)+(pRenderer)->data.iMemorySize : (pRenderer)->data.iCurrentIndex+(t))
 /**Get the i-th value at the time t.
 *@param pRenderer a data renderer
 *@param i the number of the value
 *@param t the time (in number of steps)
 *@return a double*/
-#define cairo_data_renderer_get_value(pRenderer, i, t) pRenderer->data.pTabValues[pRenderer->data.iCurrentIndex+t > pRenderer->data.iMemorySize ? pRenderer->data.iCurrentIndex+t-pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t < 0 ? pRenderer->data.iCurrentIndex+t+pRenderer->data.iMemorySize : pRenderer->data.iCurrentIndex+t][i]
+#define cairo_data_renderer_get_value(pRenderer, i, t) (pRenderer)->data.pTabValues[_cairo_data_renderer_get_ring_index (pRenderer, t)][i]
 /**Get the current i-th value.
 *@param pRenderer a data renderer
 *@param i the number of the value
 *@return a double*/
-#define cairo_data_renderer_get_current_value(pRenderer, i) pRenderer->data.pTabValues[pRenderer->data.iCurrentIndex][i]
+#define cairo_data_renderer_get_current_value(pRenderer, i) cairo_data_renderer_get_value (pRenderer, i, 0)
 /**Get the previous i-th value.
 *@param pRenderer a data renderer
 *@param i the number of the value
@@ -19,6 +19,7 @@
 
 #include <string.h>
 #include <glib.h>
+#include <gio/gio.h>
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-dbus.h"
@@ -29,6 +30,24 @@ static DBusGProxy *s_pDBusSessionProxy = NULL;
 static DBusGProxy *s_pDBusSystemProxy = NULL;
 static GHashTable *s_pFilterTable = NULL;
 static GList *s_pFilterList = NULL;
+static gint s_iSyncCallThreshold = CAIRO_DOCK_DBUS_SYNC_CALL_THRESHOLD;
+
+// a synchronous call blocks the main loop until the service answers; warn about the ones that take too long, so that they can be made asynchronous.
+static void _check_sync_call (gint64 t0, DBusGProxy *pProxy, const gchar *cMethod)
+{
+	gint64 dt = (g_get_monotonic_time () - t0) / 1000;
+	if (s_iSyncCallThreshold > 0 && dt >= s_iSyncCallThreshold)
+		cd_warning ("synchronous D-Bus call %s.%s on %s blocked the main loop for %dms",
+			dbus_g_proxy_get_interface (pProxy),
+			cMethod,
+			dbus_g_proxy_get_bus_name (pProxy),
+			(int) dt);
+}
+
+void cairo_dock_dbus_set_sync_call_threshold (gint iThreshold)
+{
+	s_iSyncCallThreshold = iThreshold;
+}
 
 DBusGConnection *cairo_dock_get_session_connection (void)
 {
@@ -91,7 +110,9 @@ gboolean cairo_dock_register_service_name (const gchar *cServiceName)
 		return FALSE;
 	GError *erreur = NULL;
 	guint request_ret;
+	gint64 t0 = g_get_monotonic_time ();
 	org_freedesktop_DBus_request_name (pProxy, cServiceName, 0, &request_ret, &erreur);
+	_check_sync_call (t0, pProxy, "RequestName");
 	if (erreur != NULL)
 	{
 		cd_warning ("Unable to register service: %s", erreur->message);
@@ -331,11 +352,14 @@ static inline gboolean _dbus_detect_application (const gchar *cName, DBusGProxy
 	gchar **name_list = NULL;
 	gboolean bPresent = FALSE;
 	
-	if(dbus_g_proxy_call (pProxy, "ListNames", NULL,
+	gint64 t0 = g_get_monotonic_time ();
+	gboolean bSuccess = dbus_g_proxy_call (pProxy, "ListNames", NULL,
 		G_TYPE_INVALID,
 		G_TYPE_STRV,
 		&name_list,
-		G_TYPE_INVALID))
+		G_TYPE_INVALID);
+	_check_sync_call (t0, pProxy, "ListNames");
+	if (bSuccess)
 	{
 		cd_message ("detection du service %s ...", cName);
 		int i;
@@ -371,11 +395,14 @@ gchar **cairo_dock_dbus_get_services (void)
 {
 	DBusGProxy *pProxy = cairo_dock_get_main_proxy ();
 	gchar **name_list = NULL;
-	if(dbus_g_proxy_call (pProxy, "ListNames", NULL,
+	gint64 t0 = g_get_monotonic_time ();
+	gboolean bSuccess = dbus_g_proxy_call (pProxy, "ListNames", NULL,
 		G_TYPE_INVALID,
 		G_TYPE_STRV,
 		&name_list,
-		G_TYPE_INVALID))
+		G_TYPE_INVALID);
+	_check_sync_call (t0, pProxy, "ListNames");
+	if (bSuccess)
 		return name_list;
 	else
 		return NULL;
@@ -387,10 +414,12 @@ gboolean cairo_dock_dbus_get_boolean (DBusGProxy *pDbusProxy, const gchar *cAcce
 {
 	GError *erreur = NULL;
 	gboolean bValue = FALSE;
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_BOOLEAN, &bValue,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -403,10 +432,12 @@ int cairo_dock_dbus_get_integer (DBusGProxy *pDbusProxy, const gchar *cAccessor)
 {
 	GError *erreur = NULL;
 	int iValue = -1;
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_INT, &iValue,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -420,10 +451,12 @@ guint cairo_dock_dbus_get_uinteger (DBusGProxy *pDbusProxy, const gchar *cAccess
 {
 	GError *erreur = NULL;
 	guint iValue = -1;
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_UINT, &iValue,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -437,10 +470,12 @@ gchar *cairo_dock_dbus_get_string (DBusGProxy *pDbusProxy, const gchar *cAccesso
 {
 	GError *erreur = NULL;
 	gchar *cValue = NULL;
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_STRING, &cValue,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -454,10 +489,12 @@ guchar *cairo_dock_dbus_get_uchar (DBusGProxy *pDbusProxy, const gchar *cAccesso
 	GError *erreur = NULL;
 	guchar* uValue = NULL;
 	
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_UCHAR, &uValue,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -472,10 +509,12 @@ gdouble cairo_dock_dbus_get_double (DBusGProxy *pDbusProxy, const gchar *cAccess
 	GError *erreur = NULL;
 	gdouble fValue = 0.;
 	
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_DOUBLE, &fValue,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -489,10 +528,12 @@ gchar **cairo_dock_dbus_get_string_list (DBusGProxy *pDbusProxy, const gchar *cA
 {
 	GError *erreur = NULL;
 	gchar **cValues = NULL;
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		G_TYPE_STRV, &cValues,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -505,10 +546,12 @@ GPtrArray *cairo_dock_dbus_get_array (DBusGProxy *pDbusProxy, const gchar *cAcce
 {
 	GError *erreur = NULL;
 	GPtrArray *pArray = NULL;
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call (pDbusProxy, cAccessor, &erreur,
 		G_TYPE_INVALID,
 		dbus_g_type_get_collection ("GPtrArray", DBUS_TYPE_G_OBJECT_PATH), &pArray,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cAccessor);
 	if (erreur != NULL)
 	{
 		cd_warning (erreur->message);
@@ -531,12 +574,14 @@ void cairo_dock_dbus_get_properties (DBusGProxy *pDbusProxy, const gchar *cComma
 {
 	GError *erreur=NULL;
 	
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call(pDbusProxy, cCommand, &erreur,
 		G_TYPE_STRING, cInterface,
 		G_TYPE_STRING, cProperty,
 		G_TYPE_INVALID,
 		G_TYPE_VALUE, vProperties,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, cCommand);
 	
 	if (erreur != NULL)
 	{
@@ -551,12 +596,14 @@ void cairo_dock_dbus_get_property_in_value_with_timeout (DBusGProxy *pDbusProxy,
 {
 	GError *erreur=NULL;
 	
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call_with_timeout (pDbusProxy, "Get", iTimeOut, &erreur,
 		G_TYPE_STRING, cInterface,
 		G_TYPE_STRING, cProperty,
 		G_TYPE_INVALID,
 		G_TYPE_VALUE, pProperty,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, "Get");
 	
 	if (erreur != NULL)
 	{
@@ -672,11 +719,13 @@ GHashTable *cairo_dock_dbus_get_all_properties_with_timeout (DBusGProxy *pDbusPr
 	GError *erreur=NULL;
 	GHashTable *hProperties = NULL;
 	
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call_with_timeout (pDbusProxy, "GetAll", iTimeOut, &erreur,
 		G_TYPE_STRING, cInterface,
 		G_TYPE_INVALID,
 		(dbus_g_type_get_map("GHashTable", G_TYPE_STRING, G_TYPE_VALUE)), &hProperties,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, "GetAll");
 	
 	if (erreur != NULL)
 	{
@@ -695,12 +744,14 @@ void cairo_dock_dbus_set_property_with_timeout (DBusGProxy *pDbusProxy, const gc
 {
 	GError *erreur=NULL;
 	
+	gint64 t0 = g_get_monotonic_time ();
 	dbus_g_proxy_call_with_timeout (pDbusProxy, "Set", iTimeOut, &erreur,
 		G_TYPE_STRING, cInterface,
 		G_TYPE_STRING, cProperty,
 		G_TYPE_VALUE, pProperty,
 		G_TYPE_INVALID,
 		G_TYPE_INVALID);
+	_check_sync_call (t0, pDbusProxy, "Set");
 	
 	if (erreur != NULL)
 	{
@@ -717,3 +768,215 @@ void cairo_dock_dbus_set_boolean_property_with_timeout (DBusGProxy *pDbusProxy,
 	cairo_dock_dbus_set_property_with_timeout (pDbusProxy, cInterface, cProperty, &v, iTimeOut);
 }
 
+
+
+  ///////////////////////////
+ /// ASYNCHRONOUS CALLS ///
+///////////////////////////
+
+typedef struct {
+	CairoDockDbusReplyFunc pCallback;
+	gpointer data;
+	gboolean bUnboxProperty;  // the reply of Properties.Get is a (v), give the value directly.
+	// the call itself, kept until the connection to the bus is made.
+	gchar *cService;
+	gchar *cPath;
+	gchar *cInterface;
+	gchar *cMethod;
+	GVariant *pParams;
+	GVariantType *pReplyType;
+	gint iTimeOut;
+	GCancellable *pCancellable;
+} CDDbusAsyncCall;
+
+typedef struct {
+	GDBusConnection *pConnection;
+	gboolean bConnecting;
+	gboolean bFailed;
+	GList *pPendingCalls;  // calls waiting for the connection.
+} CDDbusBus;
+
+static CDDbusBus s_bus[2];  // session and system
+
+static void _free_async_call (CDDbusAsyncCall *pCall)
+{
+	g_free (pCall->cService);
+	g_free (pCall->cPath);
+	g_free (pCall->cInterface);
+	g_free (pCall->cMethod);
+	if (pCall->pParams != NULL)
+		g_variant_unref (pCall->pParams);
+	if (pCall->pReplyType != NULL)
+		g_variant_type_free (pCall->pReplyType);
+	if (pCall->pCancellable != NULL)
+		g_object_unref (pCall->pCancellable);
+	g_free (pCall);
+}
+
+static void _on_async_reply (GDBusConnection *pBus, GAsyncResult *pResult, CDDbusAsyncCall *pCall)
+{
+	GError *erreur = NULL;
+	GVariant *pReply = g_dbus_connection_call_finish (pBus, pResult, &erreur);
+	
+	if (erreur != NULL && g_error_matches (erreur, G_IO_ERROR, G_IO_ERROR_CANCELLED))  // the caller doesn't want the answer any more, and its data may not be valid any more.
+	{
+		g_error_free (erreur);
+		_free_async_call (pCall);
+		return;
+	}
+	
+	GVariant *pValue = pReply;
+	if (pReply != NULL && pCall->bUnboxProperty)
+	{
+		GVariant *v = NULL;
+		g_variant_get (pReply, "(v)", &v);
+		pValue = v;
+	}
+	
+	if (pCall->pCallback)
+		pCall->pCallback (pValue, erreur, pCall->data);
+	else if (erreur != NULL)
+		cd_warning (erreur->message);
+	
+	if (pValue != pReply)
+		g_variant_unref (pValue);
+	if (pReply != NULL)
+		g_variant_unref (pReply);
+	if (erreur != NULL)
+		g_error_free (erreur);
+	_free_async_call (pCall);
+}
+
+static void _send_async_call (GDBusConnection *pConnection, CDDbusAsyncCall *pCall)
+{
+	g_dbus_connection_call (pConnection,
+		pCall->cService,
+		pCall->cPath,
+		pCall->cInterface,
+		pCall->cMethod,
+		pCall->pParams,
+		pCall->pReplyType,
+		G_DBUS_CALL_FLAGS_NONE,
+		pCall->iTimeOut,
+		pCall->pCancellable,
+		(GAsyncReadyCallback) _on_async_reply,
+		pCall);
+}
+
+static void _fail_async_call (CDDbusAsyncCall *pCall, const GError *pError)
+{
+	if (pCall->pCallback != NULL && (pCall->pCancellable == NULL || ! g_cancellable_is_cancelled (pCall->pCancellable)))
+		pCall->pCallback (NULL, pError, pCall->data);
+	_free_async_call (pCall);
+}
+
+static void _on_got_bus (G_GNUC_UNUSED GObject *pSource, GAsyncResult *pResult, CDDbusBus *pBus)
+{
+	GError *erreur = NULL;
+	pBus->pConnection = g_bus_get_finish (pResult, &erreur);  // the connection is shared with the rest of the process, and only made once.
+	pBus->bConnecting = FALSE;
+	if (erreur != NULL)
+	{
+		cd_warning (erreur->message);
+		pBus->pConnection = NULL;
+		pBus->bFailed = TRUE;
+	}
+	
+	GList *pCalls = g_list_reverse (pBus->pPendingCalls);  // keep the order of the calls.
+	pBus->pPendingCalls = NULL;
+	GList *c;
+	for (c = pCalls; c != NULL; c = c->next)
+	{
+		if (pBus->pConnection != NULL)
+			_send_async_call (pBus->pConnection, c->data);
+		else
+			_fail_async_call (c->data, erreur);
+	}
+	g_list_free (pCalls);
+	if (erreur != NULL)
+		g_error_free (erreur);
+}
+
+static gboolean _call_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cMethod, GVariant *pParams, const GVariantType *pReplyType, gboolean bUnboxProperty, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data)
+{
+	CDDbusBus *pBus = &s_bus[iBusType == G_BUS_TYPE_SYSTEM ? 1 : 0];
+	if (pBus->bFailed)
+	{
+		if (pParams != NULL)
+			g_variant_unref (g_variant_ref_sink (pParams));
+		return FALSE;
+	}
+	
+	CDDbusAsyncCall *pCall = g_new0 (CDDbusAsyncCall, 1);
+	pCall->pCallback = pCallback;
+	pCall->data = data;
+	pCall->bUnboxProperty = bUnboxProperty;
+	pCall->cService = g_strdup (cService);
+	pCall->cPath = g_strdup (cPath);
+	pCall->cInterface = g_strdup (cInterface);
+	pCall->cMethod = g_strdup (cMethod);
+	pCall->pParams = (pParams != NULL ? g_variant_ref_sink (pParams) : NULL);  // the floating reference is consumed.
+	pCall->pReplyType = (pReplyType != NULL ? g_variant_type_copy (pReplyType) : NULL);
+	pCall->iTimeOut = iTimeOut;
+	pCall->pCancellable = (pCancellable != NULL ? g_object_ref (pCancellable) : NULL);
+	
+	if (pBus->pConnection != NULL)
+	{
+		_send_async_call (pBus->pConnection, pCall);
+	}
+	else  // the first call on this bus: connect to it without blocking, and send the call once connected.
+	{
+		pBus->pPendingCalls = g_list_prepend (pBus->pPendingCalls, pCall);
+		if (! pBus->bConnecting)
+		{
+			pBus->bConnecting = TRUE;
+			g_bus_get (iBusType, NULL, (GAsyncReadyCallback) _on_got_bus, pBus);
+		}
+	}
+	return TRUE;
+}
+
+gboolean cairo_dock_dbus_call_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cMethod, GVariant *pParams, const GVariantType *pReplyType, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data)
+{
+	g_return_val_if_fail (cService != NULL && cPath != NULL && cMethod != NULL, FALSE);
+	return _call_async (iBusType, cService, cPath, cInterface, cMethod, pParams, pReplyType, FALSE, iTimeOut, pCancellable, pCallback, data);
+}
+
+gboolean cairo_dock_dbus_get_property_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cProperty, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data)
+{
+	g_return_val_if_fail (cService != NULL && cPath != NULL && cInterface != NULL && cProperty != NULL, FALSE);
+	return _call_async (iBusType, cService, cPath, "org.freedesktop.DBus.Properties", "Get",
+		g_variant_new ("(ss)", cInterface, cProperty),
+		G_VARIANT_TYPE ("(v)"),
+		TRUE,
+		iTimeOut, pCancellable, pCallback, data);
+}
+
+gboolean cairo_dock_dbus_get_all_properties_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data)
+{
+	g_return_val_if_fail (cService != NULL && cPath != NULL && cInterface != NULL, FALSE);
+	return _call_async (iBusType, cService, cPath, "org.freedesktop.DBus.Properties", "GetAll",
+		g_variant_new ("(s)", cInterface),
+		G_VARIANT_TYPE ("(a{sv})"),
+		FALSE,
+		iTimeOut, pCancellable, pCallback, data);
+}
+
+gboolean cairo_dock_dbus_set_property_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cProperty, GVariant *pValue, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data)
+{
+	g_return_val_if_fail (cService != NULL && cPath != NULL && cInterface != NULL && cProperty != NULL && pValue != NULL, FALSE);
+	return _call_async (iBusType, cService, cPath, "org.freedesktop.DBus.Properties", "Set",
+		g_variant_new ("(ssv)", cInterface, cProperty, pValue),
+		NULL,
+		FALSE,
+		iTimeOut, pCancellable, pCallback, data);
+}
+
+gboolean cairo_dock_dbus_list_names_async (GBusType iBusType, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data)
+{
+	return _call_async (iBusType, "org.freedesktop.DBus", "/org/freedesktop/DBus", "org.freedesktop.DBus", "ListNames",
+		NULL,
+		G_VARIANT_TYPE ("(as)"),
+		FALSE,
+		-1, pCancellable, pCallback, data);
+}
@@ -22,6 +22,7 @@
 #define  __CAIRO_DOCK_DBUS__
 
 #include <glib.h>
+#include <gio/gio.h>
 #include <dbus/dbus-glib.h>
 #include <dbus/dbus-glib-bindings.h>
 G_BEGIN_DECLS
@@ -37,6 +38,9 @@ G_BEGIN_DECLS
 
 typedef void (*CairoDockDbusNameOwnerChangedFunc) (const gchar *cName, gboolean bOwned, gpointer data);
 
+/// Duration (in ms) above which a synchronous call is reported in the log.
+#define CAIRO_DOCK_DBUS_SYNC_CALL_THRESHOLD 100
+
 /** Get the connection to the 'session' Bus.
 *@return the connection to the bus.
 */
@@ -198,5 +202,58 @@ void cairo_dock_dbus_set_property_with_timeout (DBusGProxy *pDbusProxy, const gc
 void cairo_dock_dbus_set_boolean_property_with_timeout (DBusGProxy *pDbusProxy, const gchar *cInterface, const gchar *cProperty, gboolean bValue, gint iTimeOut);
 
 
+/** Set the duration above which a synchronous call is reported in the log, since it blocks the main loop (and therefore the animations) while waiting for the answer. By default it's CAIRO_DOCK_DBUS_SYNC_CALL_THRESHOLD.
+*@param iThreshold the duration in ms, or 0 to disable the warnings.
+*/
+void cairo_dock_dbus_set_sync_call_threshold (gint iThreshold);
+
+
+  ///////////////////////////
+ /// ASYNCHRONOUS CALLS ///
+///////////////////////////
+// These functions don't block the main loop: the answer is given to a callback once it arrives.
+// They can be cancelled with the GCancellable, in which case the callback is not called at all (so it's safe to cancel them before destroying the data given to the callback).
+
+/** Function called with the answer of an asynchronous call.
+*@param pReply the answer (a tuple for a method call, the value itself for a property), or NULL in case of error. It's only valid during the callback, use g_variant_ref to keep it.
+*@param pError the error, or NULL if the call succeeded.
+*@param data the data passed to the call.
+*/
+typedef void (*CairoDockDbusReplyFunc) (GVariant *pReply, const GError *pError, gpointer data);
+
+/** Call a method on the bus asynchronously.
+*@param iBusType G_BUS_TYPE_SESSION or G_BUS_TYPE_SYSTEM
+*@param cService name of the service
+*@param cPath path of the object
+*@param cInterface name of the interface
+*@param cMethod name of the method
+*@param pParams a tuple of parameters, or NULL (a floating reference is consumed)
+*@param pReplyType expected type of the answer, or NULL to accept anything
+*@param iTimeOut timeout in ms, or -1 for the default one
+*@param pCancellable a GCancellable to cancel the call, or NULL
+*@param pCallback function called with the answer, or NULL to ignore it
+*@param data data passed to the callback
+*@return TRUE if the call has been sent (or will be, once connected to the bus: the connection is made asynchronously on the first call), FALSE if the bus is not available.
+*/
+gboolean cairo_dock_dbus_call_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cMethod, GVariant *pParams, const GVariantType *pReplyType, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data);
+
+/** Get a property asynchronously. The callback receives the value of the property (not wrapped in a tuple or a variant).
+*/
+gboolean cairo_dock_dbus_get_property_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cProperty, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data);
+
+/** Get all the properties of an interface asynchronously. The callback receives a tuple holding a dictionary (a{sv}).
+*/
+gboolean cairo_dock_dbus_get_all_properties_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data);
+
+/** Set a property asynchronously.
+*@param pValue the new value (a floating reference is consumed)
+*/
+gboolean cairo_dock_dbus_set_property_async (GBusType iBusType, const gchar *cService, const gchar *cPath, const gchar *cInterface, const gchar *cProperty, GVariant *pValue, gint iTimeOut, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data);
+
+/** Get the list of the names on a bus asynchronously. The callback receives a tuple holding an array of strings (as). This is the asynchronous version of \ref cairo_dock_dbus_get_services.
+*/
+gboolean cairo_dock_dbus_list_names_async (GBusType iBusType, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback, gpointer data);
+
+
 G_END_DECLS
 #endif
@@ -740,6 +740,7 @@ static void _detach_icon (GldiContainer *pContainer, Icon *pIcon)
 	CairoDesklet *pDesklet = CAIRO_DESKLET (pContainer);
 	// remove icon
 	pDesklet->icons = g_list_remove (pDesklet->icons, pIcon);
+	gldi_desklet_forget_picked_icon (pDesklet);
 	
 	// calculate icons
 	_update_desklet_icons (pDesklet);
@@ -195,7 +195,8 @@ struct _CairoDesklet {
 	guint time;  // date du clic.
 	
 	CairoDeskletVisibility iVisibility;
-	gpointer reserved[4];
+	gpointer pPickingData;  // matrices and last result of the picking in OpenGL, see gldi_desklet_find_clicked_icon().
+	gpointer reserved[3];
 };
 
 /** Say if an object is a Desklet.
@@ -401,12 +401,17 @@ static void _render_desklet_opengl (CairoDesklet *pDesklet)
 	glPopMatrix ();
 }
 
+static void _invalidate_picking_result (CairoDesklet *pDesklet);
+
 static gboolean _on_render_desklet_notification (G_GNUC_UNUSED gpointer pUserData, CairoDesklet *pDesklet, cairo_t *pCairoContext)
 {
 	if (pCairoContext != NULL)
 		_render_desklet_cairo (pDesklet, pCairoContext);
 	else
+	{
 		_render_desklet_opengl (pDesklet);
+		_invalidate_picking_result (pDesklet);  // the objects drawn by the desklet may have moved.
+	}
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
@@ -461,8 +466,187 @@ static gboolean _on_update_desklet_notification (G_GNUC_UNUSED gpointer data, Ca
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+// The picking is done from the mouse motion, so it must be cheap: instead of rendering the desklet again in selection mode, the matrices of the desklet are computed once, and the icons are tested on the CPU by projecting their quads on the screen.
+// The matrices are only computed again when the geometry or the 3D rotation of the desklet changes.
+typedef struct {
+	// state of the desklet for which the matrices were computed
+	gint iWidth, iHeight;
+	gdouble fRatio;
+	gdouble fRotation, fDepthRotationX, fDepthRotationY;
+	gint iLeftSurfaceOffset, iTopSurfaceOffset, iRightSurfaceOffset, iBottomSurfaceOffset;
+	GLdouble modelview[16], projection[16];
+	GLint viewport[4];
+	gboolean bMatricesValid;
+	// last result of a picking with GL_SELECT, valid until the desklet is drawn again or the mouse moves.
+	gint iMouseX, iMouseY;
+	Icon *pPickedIcon;
+	GLuint iPickedObject;
+	gboolean bResultValid;
+} CDDeskletPicking;
+
+static inline CDDeskletPicking *_get_picking_data (CairoDesklet *pDesklet)
+{
+	if (pDesklet->pPickingData == NULL)
+		pDesklet->pPickingData = g_new0 (CDDeskletPicking, 1);
+	return pDesklet->pPickingData;
+}
+
+static void _invalidate_picking_result (CairoDesklet *pDesklet)
+{
+	if (pDesklet->pPickingData != NULL)
+		((CDDeskletPicking*)pDesklet->pPickingData)->bResultValid = FALSE;
+}
+
+void gldi_desklet_forget_picked_icon (CairoDesklet *pDesklet)
+{
+	if (pDesklet->pPickingData != NULL)
+	{
+		CDDeskletPicking *pPicking = pDesklet->pPickingData;
+		pPicking->pPickedIcon = NULL;  // the icon may be destroyed right after.
+		pPicking->bResultValid = FALSE;
+	}
+}
+
+static gboolean _picking_state_has_changed (CairoDesklet *pDesklet, CDDeskletPicking *pPicking)
+{
+	return (pPicking->iWidth != pDesklet->container.iWidth
+		|| pPicking->iHeight != pDesklet->container.iHeight
+		|| pPicking->fRatio != pDesklet->container.fRatio
+		|| pPicking->fRotation != pDesklet->fRotation
+		|| pPicking->fDepthRotationX != pDesklet->fDepthRotationX
+		|| pPicking->fDepthRotationY != pDesklet->fDepthRotationY
+		|| pPicking->iLeftSurfaceOffset != pDesklet->iLeftSurfaceOffset
+		|| pPicking->iTopSurfaceOffset != pDesklet->iTopSurfaceOffset
+		|| pPicking->iRightSurfaceOffset != pDesklet->iRightSurfaceOffset
+		|| pPicking->iBottomSurfaceOffset != pDesklet->iBottomSurfaceOffset);
+}
+
+static void _save_picking_state (CairoDesklet *pDesklet, CDDeskletPicking *pPicking)
+{
+	pPicking->iWidth = pDesklet->container.iWidth;
+	pPicking->iHeight = pDesklet->container.iHeight;
+	pPicking->fRatio = pDesklet->container.fRatio;
+	pPicking->fRotation = pDesklet->fRotation;
+	pPicking->fDepthRotationX = pDesklet->fDepthRotationX;
+	pPicking->fDepthRotationY = pDesklet->fDepthRotationY;
+	pPicking->iLeftSurfaceOffset = pDesklet->iLeftSurfaceOffset;
+	pPicking->iTopSurfaceOffset = pDesklet->iTopSurfaceOffset;
+	pPicking->iRightSurfaceOffset = pDesklet->iRightSurfaceOffset;
+	pPicking->iBottomSurfaceOffset = pDesklet->iBottomSurfaceOffset;
+}
+
+static inline void _set_picking_matrix (CairoDesklet *pDesklet)
+{
+	_set_desklet_matrix (pDesklet);
+	
+	if (pDesklet->iLeftSurfaceOffset != 0 || pDesklet->iTopSurfaceOffset != 0 || pDesklet->iRightSurfaceOffset != 0 || pDesklet->iBottomSurfaceOffset != 0)
+	{
+		glTranslatef ((pDesklet->iLeftSurfaceOffset - pDesklet->iRightSurfaceOffset)/2, (pDesklet->iBottomSurfaceOffset - pDesklet->iTopSurfaceOffset)/2, 0.);
+		glScalef (1. - (double)(pDesklet->iLeftSurfaceOffset + pDesklet->iRightSurfaceOffset) / pDesklet->container.iWidth,
+			1. - (double)(pDesklet->iTopSurfaceOffset + pDesklet->iBottomSurfaceOffset) / pDesklet->container.iHeight,
+			1.);
+	}
+}
+
+static gboolean _compute_picking_matrices (CairoDesklet *pDesklet, CDDeskletPicking *pPicking)
+{
+	if (! gldi_gl_container_make_current (CAIRO_CONTAINER (pDesklet)))
+		return FALSE;
+	
+	glGetIntegerv (GL_VIEWPORT, pPicking->viewport);
+	
+	glMatrixMode (GL_PROJECTION);
+	glPushMatrix ();
+	glLoadIdentity ();
+	gluPerspective (60.0, 1.0*(GLfloat)pDesklet->container.iWidth/(GLfloat)pDesklet->container.iHeight, 1., 4*pDesklet->container.iHeight);
+	glGetDoublev (GL_PROJECTION_MATRIX, pPicking->projection);
+	glPopMatrix ();
+	
+	glMatrixMode (GL_MODELVIEW);
+	glPushMatrix ();
+	glLoadIdentity ();
+	_set_picking_matrix (pDesklet);
+	glTranslatef (-pDesklet->container.iWidth/2, -pDesklet->container.iHeight/2, 0.);
+	glGetDoublev (GL_MODELVIEW_MATRIX, pPicking->modelview);
+	glPopMatrix ();
+	
+	_save_picking_state (pDesklet, pPicking);
+	pPicking->bMatricesValid = TRUE;
+	return TRUE;
+}
+
+static gboolean _icon_is_under_mouse (Icon *pIcon, CairoDesklet *pDesklet, CDDeskletPicking *pPicking, double xm, double ym)
+{
+	// project the 4 corners of the icon's quad (same as the one drawn with the icon).
+	double x = pIcon->fDrawX, y = pDesklet->container.iHeight - pIcon->fDrawY - pIcon->fHeight;
+	double px[4] = {x, x + pIcon->fWidth, x + pIcon->fWidth, x};
+	double py[4] = {y + pIcon->fHeight, y + pIcon->fHeight, y, y};
+	GLdouble wx[4], wy[4], wz;
+	int i;
+	for (i = 0; i < 4; i ++)
+	{
+		if (! gluProject (px[i], py[i], 0., pPicking->modelview, pPicking->projection, pPicking->viewport, &wx[i], &wy[i], &wz))
+			return FALSE;
+	}
+	
+	// the projection of a rectangle is a convex quad: the point is inside if it's on the same side of each edge.
+	int iSign = 0, s;
+	double c;
+	for (i = 0; i < 4; i ++)
+	{
+		c = (wx[(i+1)%4] - wx[i]) * (ym - wy[i]) - (wy[(i+1)%4] - wy[i]) * (xm - wx[i]);
+		if (c == 0)
+			continue;
+		s = (c > 0 ? 1 : -1);
+		if (iSign == 0)
+			iSign = s;
+		else if (s != iSign)
+			return FALSE;
+	}
+	return (iSign != 0);
+}
+
 static Icon *_cairo_dock_pick_icon_on_opengl_desklet (CairoDesklet *pDesklet)
 {
+	CDDeskletPicking *pPicking = _get_picking_data (pDesklet);
+	if (! pPicking->bMatricesValid || _picking_state_has_changed (pDesklet, pPicking))
+	{
+		if (! _compute_picking_matrices (pDesklet, pPicking))
+			return NULL;
+	}
+	
+	double xm = pDesklet->container.iMouseX;
+	double ym = pPicking->viewport[3] - pDesklet->container.iMouseY;
+	
+	Icon *pIcon = pDesklet->pIcon;
+	if (pIcon != NULL && pIcon->image.iTexture != 0 && _icon_is_under_mouse (pIcon, pDesklet, pPicking, xm, ym))
+		return pIcon;
+	
+	GList *ic;
+	for (ic = pDesklet->icons; ic != NULL; ic = ic->next)
+	{
+		pIcon = ic->data;
+		if (pIcon->image.iTexture == 0)
+			continue;
+		if (_icon_is_under_mouse (pIcon, pDesklet, pPicking, xm, ym))
+			return pIcon;
+	}
+	return NULL;
+}
+
+// When the desklet draws its own bounding boxes, we can't know its geometry, so we have to use the selection mode of OpenGL; but the result is kept as long as the mouse doesn't move and the desklet is not drawn again (a click calls the picking several times).
+static Icon *_cairo_dock_pick_object_on_opengl_desklet (CairoDesklet *pDesklet)
+{
+	CDDeskletPicking *pPicking = _get_picking_data (pDesklet);
+	if (pPicking->bResultValid
+	&& pPicking->iMouseX == pDesklet->container.iMouseX
+	&& pPicking->iMouseY == pDesklet->container.iMouseY
+	&& ! _picking_state_has_changed (pDesklet, pPicking))
+	{
+		pDesklet->iPickedObject = pPicking->iPickedObject;
+		return pPicking->pPickedIcon;
+	}
+	
 	GLuint selectBuf[4];
 	GLint hits=0;
 	GLint viewport[4];
@@ -487,15 +671,7 @@ static Icon *_cairo_dock_pick_icon_on_opengl_desklet (CairoDesklet *pDesklet)
 	glPushMatrix ();
 	glLoadIdentity ();
 	
-	_set_desklet_matrix (pDesklet);
-	
-	if (pDesklet->iLeftSurfaceOffset != 0 || pDesklet->iTopSurfaceOffset != 0 || pDesklet->iRightSurfaceOffset != 0 || pDesklet->iBottomSurfaceOffset != 0)
-	{
-		glTranslatef ((pDesklet->iLeftSurfaceOffset - pDesklet->iRightSurfaceOffset)/2, (pDesklet->iBottomSurfaceOffset - pDesklet->iTopSurfaceOffset)/2, 0.);
-		glScalef (1. - (double)(pDesklet->iLeftSurfaceOffset + pDesklet->iRightSurfaceOffset) / pDesklet->container.iWidth,
-			1. - (double)(pDesklet->iTopSurfaceOffset + pDesklet->iBottomSurfaceOffset) / pDesklet->container.iHeight,
-			1.);
-	}
+	_set_picking_matrix (pDesklet);
 	
 	glPolygonMode (GL_FRONT, GL_FILL);
 	glColor4f (1., 1., 1., 1.);
@@ -505,57 +681,10 @@ static Icon *_cairo_dock_pick_icon_on_opengl_desklet (CairoDesklet *pDesklet)
 	{
 		pDesklet->render_bounding_box (pDesklet);
 	}
-	else if (pDesklet->pRenderer && pDesklet->pRenderer->render_bounding_box != NULL)
+	else
 	{
 		pDesklet->pRenderer->render_bounding_box (pDesklet);
 	}
-	else  // on le fait nous-memes a partir des coordonnees des icones.
-	{
-		glTranslatef (-pDesklet->container.iWidth/2, -pDesklet->container.iHeight/2, 0.);
-		
-		double x, y, w, h;
-		Icon *pIcon;
-		
-		pIcon = pDesklet->pIcon;
-		if (pIcon != NULL && pIcon->image.iTexture != 0)
-		{
-			w = pIcon->fWidth/2;
-			h = pIcon->fHeight/2;
-			x = pIcon->fDrawX + w;
-			y = pDesklet->container.iHeight - pIcon->fDrawY - h;
-			
-			glLoadName(pIcon->image.iTexture);
-			
-			glBegin(GL_QUADS);
-			glVertex3f(x-w, y+h, 0.);
-			glVertex3f(x+w, y+h, 0.);
-			glVertex3f(x+w, y-h, 0.);
-			glVertex3f(x-w, y-h, 0.);
-			glEnd();
-		}
-		
-		GList *ic;
-		for (ic = pDesklet->icons; ic != NULL; ic = ic->next)
-		{
-			pIcon = ic->data;
-			if (pIcon->image.iTexture == 0)
-				continue;
-			
-			w = pIcon->fWidth/2;
-			h = pIcon->fHeight/2;
-			x = pIcon->fDrawX + w;
-			y = pDesklet->container.iHeight - pIcon->fDrawY - h;
-			
-			glLoadName(pIcon->image.iTexture);
-			
-			glBegin(GL_QUADS);
-			glVertex3f(x-w, y+h, 0.);
-			glVertex3f(x+w, y+h, 0.);
-			glVertex3f(x+w, y-h, 0.);
-			glVertex3f(x-w, y-h, 0.);
-			glEnd();
-		}
-	}
 	
 	glPopName();
 	
@@ -605,13 +734,24 @@ static Icon *_cairo_dock_pick_icon_on_opengl_desklet (CairoDesklet *pDesklet)
 		}
 	}
 	
+	// keep the result until something changes.
+	_save_picking_state (pDesklet, pPicking);
+	pPicking->iMouseX = pDesklet->container.iMouseX;
+	pPicking->iMouseY = pDesklet->container.iMouseY;
+	pPicking->pPickedIcon = pFoundIcon;
+	pPicking->iPickedObject = pDesklet->iPickedObject;
+	pPicking->bResultValid = TRUE;
+	
 	return pFoundIcon;
 }
 Icon *gldi_desklet_find_clicked_icon (CairoDesklet *pDesklet)
 {
 	if (g_bUseOpenGL && pDesklet->pRenderer && pDesklet->pRenderer->render_opengl)
 	{
-		return _cairo_dock_pick_icon_on_opengl_desklet (pDesklet);
+		if (pDesklet->render_bounding_box != NULL || pDesklet->pRenderer->render_bounding_box != NULL)
+			return _cairo_dock_pick_object_on_opengl_desklet (pDesklet);
+		else
+			return _cairo_dock_pick_icon_on_opengl_desklet (pDesklet);
 	}
 	
 	int iMouseX = pDesklet->container.iMouseX, iMouseY = pDesklet->container.iMouseY;
@@ -1039,6 +1179,8 @@ static void reset_object (GldiObject *obj)
 	cairo_dock_unload_image_buffer (&pDesklet->backGroundImageBuffer);
 	cairo_dock_unload_image_buffer (&pDesklet->foreGroundImageBuffer);
 	
+	g_free (pDesklet->pPickingData);
+	
 	// unregister the desklet
 	s_pDeskletList = g_list_remove (s_pDeskletList, pDesklet);
 }
@@ -101,6 +101,7 @@ gboolean gldi_desklet_manager_is_ready (void);  // internals for the factory
 
 
 Icon *gldi_desklet_find_clicked_icon (CairoDesklet *pDesklet);  // internals for the factory; placed here because it uses the same code as the rendering
+void gldi_desklet_forget_picked_icon (CairoDesklet *pDesklet);  // internals for the factory
 
 
 void gldi_register_desklets_manager (void);
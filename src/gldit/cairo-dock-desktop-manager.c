@@ -289,12 +289,20 @@ void gldi_desktop_background_destroy (GldiDesktopBackground *pDesktopBg)
 cairo_surface_t *gldi_desktop_background_get_surface (GldiDesktopBackground *pDesktopBg)
 {
 	g_return_val_if_fail (pDesktopBg != NULL, NULL);
+	if (pDesktopBg->pSurface == NULL && pDesktopBg->iRefCount > 0)  // it has been unloaded, load it again.
+		pDesktopBg->pSurface = _get_desktop_bg_surface ();
 	return pDesktopBg->pSurface;
 }
 
 GLuint gldi_desktop_background_get_texture (GldiDesktopBackground *pDesktopBg)
 {
 	g_return_val_if_fail (pDesktopBg != NULL, 0);
+	if (pDesktopBg->iTexture == 0 && pDesktopBg->iRefCount > 0)
+	{
+		cairo_surface_t *pSurface = gldi_desktop_background_get_surface (pDesktopBg);
+		if (pSurface != NULL)
+			pDesktopBg->iTexture = cairo_dock_create_texture_from_surface (pSurface);
+	}
 	return pDesktopBg->iTexture;
 }
 
@@ -303,6 +311,7 @@ static void _reload_desktop_background (void)
 	//g_print ("%s ()\n", __func__);
 	if (s_pDesktopBg == NULL)  // rien a recharger.
 		return ;
+	s_pDesktopBg->iStamp ++;  // the copies of the wallpaper will be updated, even if it's not loaded currently.
 	if (s_pDesktopBg->pSurface == NULL && s_pDesktopBg->iTexture == 0)  // rien a recharger.
 		return ;
 	
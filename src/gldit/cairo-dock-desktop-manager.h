@@ -95,6 +95,8 @@ struct _GldiDesktopBackground {
 	GLuint iTexture;
 	guint iSidDestroyBg;
 	gint iRefCount;
+	/// incremented each time the wallpaper changes, so that copies of it can be updated.
+	guint iStamp;
 	} ;
 
 
@@ -182,8 +184,16 @@ GldiDesktopBackground *gldi_desktop_background_get (gboolean bWithTextureToo);
 
 void gldi_desktop_background_destroy (GldiDesktopBackground *pDesktopBg);
 
+/** Get the surface of the wallpaper. It is loaded again if it has been unloaded.
+*@param pDesktopBg the desktop background
+*@return the surface, at the size of the screen.
+*/
 cairo_surface_t *gldi_desktop_background_get_surface (GldiDesktopBackground *pDesktopBg);
 
+/** Get the texture of the wallpaper. It is loaded again if it has been unloaded.
+*@param pDesktopBg the desktop background
+*@return the texture, at the size of the screen.
+*/
 GLuint gldi_desktop_background_get_texture (GldiDesktopBackground *pDesktopBg);
 
 
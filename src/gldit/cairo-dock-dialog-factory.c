@@ -278,8 +278,9 @@ static cairo_surface_t *_cairo_dock_create_dialog_text_surface (const gchar *cTe
 		return NULL;
 	
 	myDialogsParam.dialogTextDescription.bUseMarkup = bUseMarkup;  // slight optimization, rather than duplicating the TextDescription each time.
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text (cText,
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_cached (cText,
 		&myDialogsParam.dialogTextDescription,
+		1., 0,
 		iTextWidth,
 		iTextHeight);
 	myDialogsParam.dialogTextDescription.bUseMarkup = FALSE;  // by default
@@ -36,6 +36,7 @@
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get*
 #include "cairo-dock-data-renderer.h"  // cairo_dock_reload_data_renderer_on_icon
 #include "cairo-dock-opengl.h"  // gldi_gl_container_begin_draw
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_render_dock_opengl
 
 extern CairoDockGLConfig g_openglConfig;
 #include "cairo-dock-dock-facility.h"
@@ -201,6 +202,19 @@ void cairo_dock_trigger_update_dock_size (CairoDock *pDock)
 	}
 }
 
+static void _flush_update_dock_size (G_GNUC_UNUSED const gchar *cDockName, CairoDock *pDock, G_GNUC_UNUSED gpointer data)
+{
+	if (pDock->iSidUpdateDockSize != 0)
+	{
+		g_source_remove (pDock->iSidUpdateDockSize);
+		_update_dock_size_idle (pDock);
+	}
+}
+void cairo_dock_flush_update_dock_size (void)
+{
+	gldi_docks_foreach ((GHFunc) _flush_update_dock_size, NULL);
+}
+
 static gboolean _emit_leave_signal_delayed (CairoDock *pDock)
 {
 	cairo_dock_emit_leave_signal (CAIRO_CONTAINER (pDock));
@@ -289,6 +303,7 @@ static void cairo_dock_manage_mouse_position (CairoDock *pDock)
 Icon *cairo_dock_calculate_dock_icons (CairoDock *pDock)
 {
 	Icon *pPointedIcon = pDock->pRenderer->calculate_icons (pDock);
+	gldi_dock_invalidate_hiding_snapshot (pDock);  // icons have moved
 	cairo_dock_manage_mouse_position (pDock);
 	return pPointedIcon;
 	/**if (pDock->iMousePositionType == CAIRO_DOCK_MOUSE_INSIDE)
@@ -1157,26 +1172,49 @@ static gboolean _redraw_subdock_content_idle (Icon *pIcon)
 	pIcon->iSidRedrawSubdockContent = 0;
 	return FALSE;
 }
+static void _schedule_redraw_subdock_content (Icon *pIcon)
+{
+	/* all the changes that happen until the next frame are drawn at once (when many icons of a sub-dock change together, like when a class gets its windows),
+	 * so if a redraw is already pending, it will take this change into account too.
+	 */
+	if (pIcon->iSidRedrawSubdockContent != 0)
+		return;
+	GldiContainer *pContainer = cairo_dock_get_icon_container (pIcon);
+	int iDeltaT = (pContainer != NULL ? pContainer->iAnimationDeltaT : 0);
+	if (iDeltaT > 0)
+		pIcon->iSidRedrawSubdockContent = g_timeout_add (iDeltaT, (GSourceFunc) _redraw_subdock_content_idle, pIcon);
+	else
+		pIcon->iSidRedrawSubdockContent = g_idle_add ((GSourceFunc) _redraw_subdock_content_idle, pIcon);
+}
+
+static inline gboolean _subdock_content_is_drawn_on_icon (Icon *pPointingIcon)
+{
+	return (pPointingIcon->iSubdockViewType != 0 || (pPointingIcon->cClass != NULL && ! myIndicatorsParam.bUseClassIndic && (CAIRO_DOCK_ICON_TYPE_IS_CLASS_CONTAINER (pPointingIcon) || GLDI_OBJECT_IS_LAUNCHER_ICON (pPointingIcon))));
+}
+
 void cairo_dock_trigger_redraw_subdock_content (CairoDock *pDock)
 {
 	Icon *pPointingIcon = cairo_dock_search_icon_pointing_on_dock (pDock, NULL);
 	//g_print ("%s (%s, %d)\n", __func__, pPointingIcon?pPointingIcon->cName:NULL, pPointingIcon?pPointingIcon->iSubdockViewType:0);
-	if (pPointingIcon != NULL && (pPointingIcon->iSubdockViewType != 0 || (pPointingIcon->cClass != NULL && ! myIndicatorsParam.bUseClassIndic && (CAIRO_DOCK_ICON_TYPE_IS_CLASS_CONTAINER (pPointingIcon) || GLDI_OBJECT_IS_LAUNCHER_ICON (pPointingIcon)))))
+	if (pPointingIcon != NULL && _subdock_content_is_drawn_on_icon (pPointingIcon))
 	{
-		/* if we already have an expected re-draw, we go to the end in order to
-		 * not do it before the redraw of icon linked to this trigger
-		 */
-		if (pPointingIcon->iSidRedrawSubdockContent != 0)
-			g_source_remove (pPointingIcon->iSidRedrawSubdockContent);
-		pPointingIcon->iSidRedrawSubdockContent = g_idle_add ((GSourceFunc) _redraw_subdock_content_idle, pPointingIcon);
+		_schedule_redraw_subdock_content (pPointingIcon);
+	}
+}
+
+void cairo_dock_trigger_redraw_subdock_content_for_icon (CairoDock *pDock, Icon *pIcon)
+{
+	Icon *pPointingIcon = cairo_dock_search_icon_pointing_on_dock (pDock, NULL);
+	if (pPointingIcon != NULL && _subdock_content_is_drawn_on_icon (pPointingIcon)
+	&& cairo_dock_subdock_content_shows_icon (pPointingIcon, pIcon))  // if the icon is not drawn on the pointing icon, no need to redraw it.
+	{
+		_schedule_redraw_subdock_content (pPointingIcon);
 	}
 }
 
 void cairo_dock_trigger_redraw_subdock_content_on_icon (Icon *icon)
 {
-	if (icon->iSidRedrawSubdockContent != 0)
-		g_source_remove (icon->iSidRedrawSubdockContent);
-	icon->iSidRedrawSubdockContent = g_idle_add ((GSourceFunc) _redraw_subdock_content_idle, icon);
+	_schedule_redraw_subdock_content (icon);
 }
 
 void cairo_dock_redraw_subdock_content (CairoDock *pDock)
@@ -1431,7 +1469,7 @@ void cairo_dock_make_preview (CairoDock *pDock, const gchar *cPreviewPath)
 		{
 			if (gldi_gl_container_begin_draw (CAIRO_CONTAINER (pDock)))
 			{
-				pDock->pRenderer->render_opengl (pDock);
+				cairo_dock_render_dock_opengl (pDock);
 			}
 			int s = 4;  // 4 channels of 1 byte each (rgba).
 			GLubyte *buffer = (GLubyte *) g_malloc (w * h * s);
@@ -61,6 +61,10 @@ void cairo_dock_update_dock_size (CairoDock *pDock);
 
 void cairo_dock_trigger_update_dock_size (CairoDock *pDock);
 
+/** Apply right away the size updates that have been scheduled on the docks by \ref cairo_dock_trigger_update_dock_size, and redraw these docks. Call it at the end of a batch of insertions/removals, so that each dock is laid out and redrawn only once, with all the changes.
+*/
+void cairo_dock_flush_update_dock_size (void);
+
 /** Calculate the position of all icons inside a dock, and triggers the enter/leave events according to the position of the mouse.
 *@param pDock the dock.
 *@return the pointed icon, or NULL if none is pointed.
@@ -177,6 +181,11 @@ GList *cairo_dock_get_first_drawn_element_linear (GList *icons);
 
 
 void cairo_dock_trigger_redraw_subdock_content (CairoDock *pDock);
+/** Like \ref cairo_dock_trigger_redraw_subdock_content, but only if the given icon of the sub-dock is visible on the icon pointing on it. Use it when only this icon has changed.
+*@param pDock a sub-dock.
+*@param pIcon the icon of the sub-dock that has changed.
+*/
+void cairo_dock_trigger_redraw_subdock_content_for_icon (CairoDock *pDock, Icon *pIcon);
 void cairo_dock_trigger_redraw_subdock_content_on_icon (Icon *icon);
 
 void cairo_dock_redraw_subdock_content (CairoDock *pDock);
@@ -150,6 +150,7 @@ static gboolean _on_expose (G_GNUC_UNUSED GtkWidget *pWidget, cairo_t *pCairoCon
 		else if (cairo_dock_is_hidden (pDock) && (g_pHidingBackend == NULL || !g_pHidingBackend->bCanDisplayHiddenDock))
 		{
 			cairo_dock_render_hidden_dock_opengl (pDock);
+			gldi_indicators_render_batch_opengl (pDock);
 		}
 		else
 		{
@@ -1164,6 +1165,7 @@ static gboolean _on_configure (GtkWidget* pWidget, GdkEventConfigure* pEvent, Ca
 				pDock->iRedirectedTexture = cairo_dock_create_texture_from_raw_data (NULL, pEvent->width, pEvent->height);
 			}
 		}
+		gldi_dock_invalidate_hiding_snapshot (pDock);
 		
 		cairo_dock_calculate_dock_icons (pDock);
 		//g_print ("configure size %s\n", pDock->cDockName);
@@ -1770,6 +1772,8 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 	gboolean bContinue = FALSE;
 	gboolean bUpdateSlowAnimation = FALSE;
 	pContainer->iAnimationStep ++;
+	if (pDock->bIsShrinkingDown || pDock->bIsGrowingUp)  // the icons change, the hiding effect can't use its snapshot of them.
+		gldi_dock_invalidate_hiding_snapshot (pDock);
 	if (pContainer->iAnimationStep * pContainer->iAnimationDeltaT >= CAIRO_DOCK_MIN_SLOW_DELTA_T)
 	{
 		bUpdateSlowAnimation = TRUE;
@@ -1824,6 +1828,8 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 			pContainer->bKeepSlowAnimation |= bIconIsAnimating;
 		}
 		gldi_object_notify (icon, NOTIFICATION_UPDATE_ICON, icon, pDock, &bIconIsAnimating);
+		if (bIconIsAnimating)
+			gldi_dock_invalidate_hiding_snapshot (pDock);
 		
 		if ((icon->bIsDemandingAttention || icon->bAlwaysVisible) && cairo_dock_is_hidden (pDock))  // animation d'une icone demandant l'attention dans un dock cache => on force le dessin qui normalement ne se fait pas.
 		{
@@ -2144,7 +2150,7 @@ static void _insert_icon (GldiContainer *pContainer, Icon *icon, gboolean bAnima
 	
 	if (pDock->iRefCount != 0 && ! CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon))  // on prevoit le redessin de l'icone pointant sur le sous-dock.
 	{
-		cairo_dock_trigger_redraw_subdock_content (pDock);
+		cairo_dock_trigger_redraw_subdock_content_for_icon (pDock, icon);  // the icon is already in the list, so we can know if it's visible on the pointing icon.
 	}
 	
 	if (icon->pSubDock != NULL)
@@ -290,7 +290,9 @@ struct _CairoDock {
 	GLuint iRedirectedTexture;
 	GLuint iFboId;
 	
-	gpointer reserved[4];
+	/// private data: the icons drawn once for the whole hiding animation, see \ref gldi_dock_invalidate_hiding_snapshot.
+	gpointer pHidingSnapshot;
+	gpointer reserved[3];
 };
 
 
@@ -47,6 +47,7 @@
 #include "cairo-dock-dock-facility.h"
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_blank_surface
 #include "cairo-dock-animations.h"
 #include "cairo-dock-container.h"
 #include "cairo-dock-keybinder.h"
@@ -1284,10 +1285,88 @@ static gboolean _on_new_dialog (G_GNUC_UNUSED gpointer data, CairoDialog *pDialo
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+typedef struct {
+	gboolean bReady;  // TRUE if the icons are already drawn in the redirected texture (opengl) or the surface (cairo), so that the hiding effect can be applied on it without drawing them again.
+	cairo_surface_t *pSurface;  // cairo only
+	gint iWidth, iHeight;  // size of pSurface (it's not necessarily an image surface).
+	} CDHidingSnapshot;
+
+static inline CDHidingSnapshot *_get_hiding_snapshot (CairoDock *pDock)
+{
+	if (pDock->pHidingSnapshot == NULL)
+		pDock->pHidingSnapshot = g_new0 (CDHidingSnapshot, 1);
+	return pDock->pHidingSnapshot;
+}
+static void _free_hiding_snapshot_surface (CairoDock *pDock)
+{
+	CDHidingSnapshot *pSnapshot = pDock->pHidingSnapshot;
+	if (pSnapshot != NULL && pSnapshot->pSurface != NULL)
+	{
+		cairo_surface_destroy (pSnapshot->pSurface);
+		pSnapshot->pSurface = NULL;
+		pSnapshot->bReady = FALSE;
+	}
+}
+void gldi_dock_invalidate_hiding_snapshot (CairoDock *pDock)
+{
+	CDHidingSnapshot *pSnapshot = pDock->pHidingSnapshot;
+	if (pSnapshot != NULL)
+		pSnapshot->bReady = FALSE;
+}
+
+static inline gboolean _hiding_snapshot_can_be_used (CairoDock *pDock)
+{
+	return (pDock->fHideOffset > 0 && pDock->fHideOffset < 1  // the hiding/showing animation is running (once hidden, the dock can still be drawn by some effects, and its content can change).
+		&& pDock->iFadeCounter == 0  // the keeping-below effect would draw on the same buffer.
+		&& cairo_dock_hiding_effect_can_use_snapshot (g_pHidingBackend));  // the effect only transforms what is drawn, it doesn't draw the icons itself.
+}
+static void _render_dock_with_hiding_snapshot (CairoDock *pDock, cairo_t *pCairoContext)
+{
+	//\_____________ draw the icons once on the snapshot.
+	CDHidingSnapshot *pSnapshot = _get_hiding_snapshot (pDock);
+	int iWidth = (pDock->container.bIsHorizontal ? pDock->container.iWidth : pDock->container.iHeight);
+	int iHeight = (pDock->container.bIsHorizontal ? pDock->container.iHeight : pDock->container.iWidth);
+	if (pSnapshot->pSurface != NULL && (pSnapshot->iWidth != iWidth || pSnapshot->iHeight != iHeight))
+		_free_hiding_snapshot_surface (pDock);
+	if (pSnapshot->pSurface == NULL)
+	{
+		pSnapshot->pSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+		pSnapshot->iWidth = iWidth;
+		pSnapshot->iHeight = iHeight;
+		pSnapshot->bReady = FALSE;
+	}
+	if (! pSnapshot->bReady)
+	{
+		cairo_t *pSnapshotContext = cairo_create (pSnapshot->pSurface);
+		cairo_set_operator (pSnapshotContext, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (pSnapshotContext);
+		cairo_set_operator (pSnapshotContext, CAIRO_OPERATOR_OVER);
+		pDock->pRenderer->render (pSnapshotContext, pDock);
+		cairo_destroy (pSnapshotContext);
+		pSnapshot->bReady = TRUE;
+	}
+	
+	//\_____________ apply the effect on it.
+	if (g_pHidingBackend->pre_render)
+		g_pHidingBackend->pre_render (pDock, pDock->fHideOffset, pCairoContext);
+	
+	cairo_set_source_surface (pCairoContext, pSnapshot->pSurface, 0., 0.);
+	cairo_paint (pCairoContext);
+	
+	if (g_pHidingBackend->post_render)
+		g_pHidingBackend->post_render (pDock, pDock->fHideOffset, pCairoContext);
+}
+
 static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, CairoDock *pDock, cairo_t *pCairoContext)
 {
-	if (pCairoContext)  // cairo
+	if (pCairoContext && _hiding_snapshot_can_be_used (pDock))  // cairo, hiding animation
+	{
+		_render_dock_with_hiding_snapshot (pDock, pCairoContext);
+	}
+	else if (pCairoContext)  // cairo
 	{
+		_free_hiding_snapshot_surface (pDock);  // the animation is over, free the snapshot.
+		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->pre_render)
 			g_pHidingBackend->pre_render (pDock, pDock->fHideOffset, pCairoContext);
 	
@@ -1306,19 +1385,31 @@ static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, Cai
 	}
 	else  // opengl
 	{
+		gboolean bUseSnapshot = (_hiding_snapshot_can_be_used (pDock) && pDock->iFboId != 0);
+		if (bUseSnapshot && _get_hiding_snapshot (pDock)->bReady)  // the icons are still in the redirected texture, just apply the effect on it.
+		{
+			g_pHidingBackend->post_render_opengl (pDock, pDock->fHideOffset);
+			return GLDI_NOTIFICATION_LET_PASS;
+		}
+		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->pre_render_opengl)
 			g_pHidingBackend->pre_render_opengl (pDock, pDock->fHideOffset);
 		
 		if (pDock->iFadeCounter != 0 && g_pKeepingBelowBackend != NULL && g_pKeepingBelowBackend->pre_render_opengl)
 			g_pKeepingBelowBackend->pre_render_opengl (pDock, (double) pDock->iFadeCounter / myBackendsParam.iHideNbSteps);
 		
-		pDock->pRenderer->render_opengl (pDock);
+		cairo_dock_render_dock_opengl (pDock);  // before the post-render, so that the indicators get the same effect as their icons.
 		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->post_render_opengl)
 			g_pHidingBackend->post_render_opengl (pDock, pDock->fHideOffset);
 		
 		if (pDock->iFadeCounter != 0 && g_pKeepingBelowBackend != NULL && g_pKeepingBelowBackend->post_render_opengl)
 			g_pKeepingBelowBackend->post_render_opengl (pDock, (double) pDock->iFadeCounter / myBackendsParam.iHideNbSteps);
+		
+		if (bUseSnapshot)
+			_get_hiding_snapshot (pDock)->bReady = TRUE;
+		else
+			gldi_dock_invalidate_hiding_snapshot (pDock);
 	}
 	return GLDI_NOTIFICATION_LET_PASS;
 }
@@ -2126,6 +2217,8 @@ static void reset_object (GldiObject *obj)
 		glDeleteFramebuffersEXT (1, &pDock->iFboId);
 	if (pDock->iRedirectedTexture != 0)
 		_cairo_dock_delete_texture (pDock->iRedirectedTexture);
+	_free_hiding_snapshot_surface (pDock);
+	g_free (pDock->pHidingSnapshot);
 	g_free (pDock->cDockName);
 }
 
@@ -2162,6 +2255,7 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReloadConf, G_GNUC_UN
 	
 	if (bReloadConf)  // maybe we should update the parameters that have the global value ?...
 		_get_root_dock_config (pDock);
+	gldi_container_invalidate_menu ();  // the menu of a dock depends on its config (auto-hide, ...)
 	
 	cairo_dock_set_default_renderer (pDock);
 	
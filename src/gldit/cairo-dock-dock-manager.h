@@ -220,6 +220,11 @@ gchar *gldi_dock_add_conf_file (void);
 */
 void gldi_docks_redraw_all_root (void);
 
+/** Tell that the icons of a dock have changed, so that they must be drawn again during the hiding animation, instead of reusing the previous drawing.
+*@param pDock the dock.
+*/
+void gldi_dock_invalidate_hiding_snapshot (CairoDock *pDock);
+
 
 void cairo_dock_quick_hide_all_docks (void);
 void cairo_dock_stop_quick_hide (void);
@@ -28,6 +28,132 @@
 #include "cairo-dock-dock-visibility.h"
 
 
+  /////////////////////
+ // Overlap caches  //
+/////////////////////
+
+// For each root dock that has been queried, the set of windows currently overlapping it.
+// Each window event only re-tests the window that changed against each dock, instead of scanning all the windows;
+// the set is rebuilt from scratch only when the dock's zone changes or the current desktop/viewport changes.
+typedef struct {
+	GtkAllocation zone;  // zone of the dock the set was computed for
+	GHashTable *pWindows;  // set of overlapping windows
+} GldiDockOverlaps;
+
+static GHashTable *s_pOverlaps = NULL;  // dock -> GldiDockOverlaps
+
+static void _get_dock_zone (CairoDock *pDock, GtkAllocation *pZone)
+{
+	if (pDock->container.bIsHorizontal)
+	{
+		pZone->width = pDock->iMinDockWidth;
+		pZone->height = pDock->iMinDockHeight;
+		pZone->x = pDock->container.iWindowPositionX + (pDock->container.iWidth - pZone->width)/2;
+		pZone->y = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
+	}
+	else
+	{
+		pZone->width = pDock->iMinDockHeight;
+		pZone->height = pDock->iMinDockWidth;
+		pZone->x = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
+		pZone->y = pDock->container.iWindowPositionX + (pDock->container.iWidth - pZone->height)/2;
+	}
+}
+
+static inline gboolean _window_overlaps_zone (GtkAllocation *pWindowGeometry, gboolean bIsHidden, GtkAllocation *pZone)
+{
+	if (pWindowGeometry->width != 0 && pWindowGeometry->height != 0)
+	{
+		if (! bIsHidden && pWindowGeometry->x < pZone->x + pZone->width && pWindowGeometry->x + pWindowGeometry->width > pZone->x && pWindowGeometry->y < pZone->y + pZone->height && pWindowGeometry->y + pWindowGeometry->height > pZone->y)
+		{
+			return TRUE;
+		}
+	}
+	else
+	{
+		cd_warning (" unknown window geometry");
+	}
+	return FALSE;
+}
+
+static inline gboolean _window_is_overlapping_zone (GldiWindowActor *actor, GtkAllocation *pZone)
+{
+	return (! actor->bIsHidden && gldi_window_is_on_current_desktop (actor) && _window_overlaps_zone (&actor->windowGeometry, actor->bIsHidden, pZone));
+}
+
+static gboolean _add_if_overlapping (GldiWindowActor *actor, gpointer data)
+{
+	GldiDockOverlaps *pOverlaps = data;
+	if (_window_is_overlapping_zone (actor, &pOverlaps->zone))
+		g_hash_table_add (pOverlaps->pWindows, actor);
+	return FALSE;  // go through all the windows.
+}
+
+static void _free_overlaps (GldiDockOverlaps *pOverlaps)
+{
+	g_hash_table_destroy (pOverlaps->pWindows);
+	g_free (pOverlaps);
+}
+
+static GldiDockOverlaps *_get_dock_overlaps (CairoDock *pDock)
+{
+	if (s_pOverlaps == NULL)
+		s_pOverlaps = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify)_free_overlaps);
+	
+	GtkAllocation zone;
+	_get_dock_zone (pDock, &zone);
+	
+	GldiDockOverlaps *pOverlaps = g_hash_table_lookup (s_pOverlaps, pDock);
+	if (pOverlaps == NULL)
+	{
+		pOverlaps = g_new0 (GldiDockOverlaps, 1);
+		pOverlaps->pWindows = g_hash_table_new (NULL, NULL);
+		g_hash_table_insert (s_pOverlaps, pDock, pOverlaps);
+	}
+	else if (zone.x == pOverlaps->zone.x && zone.y == pOverlaps->zone.y && zone.width == pOverlaps->zone.width && zone.height == pOverlaps->zone.height)
+	{
+		return pOverlaps;  // up-to-date
+	}
+	else  // the dock has moved or changed its size.
+	{
+		g_hash_table_remove_all (pOverlaps->pWindows);
+	}
+	
+	pOverlaps->zone = zone;
+	gldi_windows_find (_add_if_overlapping, pOverlaps);
+	return pOverlaps;
+}
+
+static void _update_window_in_overlaps (G_GNUC_UNUSED CairoDock *pDock, GldiDockOverlaps *pOverlaps, GldiWindowActor *actor)
+{
+	if (_window_is_overlapping_zone (actor, &pOverlaps->zone))
+		g_hash_table_add (pOverlaps->pWindows, actor);
+	else
+		g_hash_table_remove (pOverlaps->pWindows, actor);
+}
+static inline void _update_window (GldiWindowActor *actor)
+{
+	if (s_pOverlaps != NULL)
+		g_hash_table_foreach (s_pOverlaps, (GHFunc)_update_window_in_overlaps, actor);
+}
+
+static void _remove_window_from_overlaps (G_GNUC_UNUSED CairoDock *pDock, GldiDockOverlaps *pOverlaps, GldiWindowActor *actor)
+{
+	g_hash_table_remove (pOverlaps->pWindows, actor);
+}
+static inline void _remove_window (GldiWindowActor *actor)
+{
+	if (s_pOverlaps != NULL)
+		g_hash_table_foreach (s_pOverlaps, (GHFunc)_remove_window_from_overlaps, actor);
+}
+
+static inline void _invalidate_all_overlaps (void)
+{
+	if (s_pOverlaps != NULL)
+		g_hash_table_remove_all (s_pOverlaps);  // they will be rebuilt on the next query.
+}
+
+
   /////////////////////
  // Dock visibility //
 /////////////////////
@@ -146,6 +272,8 @@ static void _hide_if_any_overlap_or_show (CairoDock *pDock, G_GNUC_UNUSED gpoint
 
 static gboolean _on_window_created (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	_update_window (actor);
+	
 	// docks visibility on overlap any
 	/// see how to handle modal dialogs ...
 	gldi_docks_foreach_root ((GFunc)_hide_if_overlap, actor);
@@ -156,6 +284,7 @@ static gboolean _on_window_created (G_GNUC_UNUSED gpointer data, GldiWindowActor
 static gboolean _on_window_destroyed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
 	// docks visibility on overlap any
+	_remove_window (actor);
 	gboolean bIsHidden = actor->bIsHidden;  // the window is already destroyed, but the actor is still valid (it represents the last state of the window); temporarily make it hidden so that it doesn't overlap the dock (that's a bit tricky, we could also add an "except-this-window" parameter to 'gldi_dock_search_overlapping_window()')
 	actor->bIsHidden = TRUE;
 	gldi_docks_foreach_root ((GFunc)_show_if_no_overlapping_window, NULL);
@@ -166,6 +295,8 @@ static gboolean _on_window_destroyed (G_GNUC_UNUSED gpointer data, GldiWindowAct
 
 static gboolean _on_window_size_position_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	_update_window (actor);
+	
 	// docks visibility on overlap any
 	if (! gldi_window_is_on_current_desktop (actor))  // not on this desktop/viewport any more
 	{
@@ -187,6 +318,8 @@ static gboolean _on_window_size_position_changed (G_GNUC_UNUSED gpointer data, G
 
 static gboolean _on_window_state_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor, gboolean bHiddenChanged, G_GNUC_UNUSED gboolean bMaximizedChanged, gboolean bFullScreenChanged)
 {
+	_update_window (actor);
+	
 	// docks visibility on overlap active
 	if (actor == gldi_windows_get_active())  // c'est la fenetre courante qui a change d'etat.
 	{
@@ -210,6 +343,8 @@ static gboolean _on_window_state_changed (G_GNUC_UNUSED gpointer data, GldiWindo
 
 static gboolean _on_window_desktop_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
+	_update_window (actor);
+	
 	// docks visibility on overlap active
 	if (actor == gldi_windows_get_active())  // c'est la fenetre courante qui a change de bureau.
 	{
@@ -231,6 +366,8 @@ static gboolean _on_window_desktop_changed (G_GNUC_UNUSED gpointer data, GldiWin
 
 static gboolean _on_desktop_changed (G_GNUC_UNUSED gpointer data)
 {
+	_invalidate_all_overlaps ();  // the set of visible windows is completely different.
+	
 	// docks visibility on overlap active
 	GldiWindowActor *pCurrentAppli = gldi_windows_get_active ();
 	gldi_docks_foreach_root ((GFunc)_hide_show_if_on_our_way, pCurrentAppli);
@@ -242,6 +379,21 @@ static gboolean _on_desktop_changed (G_GNUC_UNUSED gpointer data)
 }
 
 
+static gboolean _on_desktop_geometry_changed (G_GNUC_UNUSED gpointer data)
+{
+	_invalidate_all_overlaps ();  // windows may have been moved to other viewports.
+	
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+static gboolean _on_dock_destroyed (G_GNUC_UNUSED gpointer data, CairoDock *pDock)
+{
+	if (s_pOverlaps != NULL)
+		g_hash_table_remove (s_pOverlaps, pDock);
+	
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
 static gboolean _on_active_window_changed (G_GNUC_UNUSED gpointer data, GldiWindowActor *actor)
 {
 	// docks visibility on overlap active
@@ -265,57 +417,25 @@ void gldi_dock_hide_if_any_window_overlap_or_show (CairoDock *pDock)
 	_hide_if_any_overlap_or_show (pDock, NULL);
 }
 
-static inline gboolean _window_overlaps_dock (GtkAllocation *pWindowGeometry, gboolean bIsHidden, CairoDock *pDock)
-{
-	if (pWindowGeometry->width != 0 && pWindowGeometry->height != 0)
-	{
-		int iDockX, iDockY, iDockWidth, iDockHeight;
-		if (pDock->container.bIsHorizontal)
-		{
-			iDockWidth = pDock->iMinDockWidth;
-			iDockHeight = pDock->iMinDockHeight;
-			iDockX = pDock->container.iWindowPositionX + (pDock->container.iWidth - iDockWidth)/2;
-			iDockY = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
-		}
-		else
-		{
-			iDockWidth = pDock->iMinDockHeight;
-			iDockHeight = pDock->iMinDockWidth;
-			iDockX = pDock->container.iWindowPositionY + (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight : 0);
-			iDockY = pDock->container.iWindowPositionX + (pDock->container.iWidth - iDockHeight)/2;
-		}
-		
-		if (! bIsHidden && pWindowGeometry->x < iDockX + iDockWidth && pWindowGeometry->x + pWindowGeometry->width > iDockX && pWindowGeometry->y < iDockY + iDockHeight && pWindowGeometry->y + pWindowGeometry->height > iDockY)
-		{
-			return TRUE;
-		}
-	}
-	else
-	{
-		cd_warning (" unknown window geometry");
-	}
-	return FALSE;
-}
 gboolean gldi_dock_overlaps_window (CairoDock *pDock, GldiWindowActor *actor)
 {
-	return _window_overlaps_dock (&actor->windowGeometry, actor->bIsHidden, pDock);
+	GtkAllocation zone;
+	_get_dock_zone (pDock, &zone);
+	return _window_overlaps_zone (&actor->windowGeometry, actor->bIsHidden, &zone);
 }
 
-static gboolean _window_is_overlapping_dock (GldiWindowActor *actor, gpointer data)
+GldiWindowActor *gldi_dock_search_overlapping_window (CairoDock *pDock)
 {
-	CairoDock *pDock = CAIRO_DOCK (data);
-	if (gldi_window_is_on_current_desktop (actor) && ! actor->bIsHidden)
+	GldiDockOverlaps *pOverlaps = _get_dock_overlaps (pDock);
+	GHashTableIter iter;
+	gpointer actor;
+	g_hash_table_iter_init (&iter, pOverlaps->pWindows);
+	while (g_hash_table_iter_next (&iter, &actor, NULL))
 	{
-		if (gldi_dock_overlaps_window (pDock, actor))
-		{
-			return TRUE;
-		}
+		if (! ((GldiWindowActor*)actor)->bIsHidden)  // the actor may be temporarily hidden, see '_on_window_destroyed'.
+			return actor;
 	}
-	return FALSE;
-}
-GldiWindowActor *gldi_dock_search_overlapping_window (CairoDock *pDock)
-{
-	return gldi_windows_find (_window_is_overlapping_dock, pDock);
+	return NULL;
 }
 
 
@@ -359,6 +479,14 @@ void gldi_docks_visibility_start (void)
 			NOTIFICATION_WINDOW_ACTIVATED,
 			(GldiNotificationFunc) _on_active_window_changed,
 			GLDI_RUN_FIRST, NULL);
+		gldi_object_register_notification (&myDesktopMgr,
+			NOTIFICATION_DESKTOP_GEOMETRY_CHANGED,
+			(GldiNotificationFunc) _on_desktop_geometry_changed,
+			GLDI_RUN_FIRST, NULL);
+		gldi_object_register_notification (&myDockObjectMgr,
+			NOTIFICATION_DESTROY,
+			(GldiNotificationFunc) _on_dock_destroyed,
+			GLDI_RUN_AFTER, NULL);
 	}
 	
 	// handle current docks visibility
@@ -376,4 +504,10 @@ static void _unhide_all_docks (CairoDock *pDock, G_GNUC_UNUSED Icon *icon)
 void gldi_docks_visibility_stop (void)  // not used yet
 {
 	gldi_docks_foreach_root ((GFunc)_unhide_all_docks, NULL);
+	
+	if (s_pOverlaps != NULL)
+	{
+		g_hash_table_destroy (s_pOverlaps);
+		s_pOverlaps = NULL;
+	}
 }
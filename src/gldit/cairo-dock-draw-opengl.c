@@ -32,6 +32,7 @@
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl-path.h"
+#include "cairo-dock-indicator-manager.h"  // gldi_indicators_render_batch_opengl
 
 #include "cairo-dock-draw-opengl.h"
 
@@ -595,6 +596,12 @@ void cairo_dock_render_hidden_dock_opengl (CairoDock *pDock)
 	} while (ic != pFirstDrawnElement);
 }
 
+void cairo_dock_render_dock_opengl (CairoDock *pDock)
+{
+	pDock->pRenderer->render_opengl (pDock);
+	gldi_indicators_render_batch_opengl (pDock);  // the indicators above the icons are only collected by the renderer.
+}
+
 
 GLuint cairo_dock_create_texture_from_surface (cairo_surface_t *pImageSurface)
 {
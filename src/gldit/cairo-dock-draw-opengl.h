@@ -55,6 +55,11 @@ void cairo_dock_render_one_icon_opengl (Icon *icon, CairoDock *pDock, double fDo
 
 void cairo_dock_render_hidden_dock_opengl (CairoDock *pDock);
 
+/** Draw a dock with its renderer, then the indicators that have been collected while drawing its icons. Always use it rather than calling the renderer's render_opengl directly, otherwise these indicators would be missing.
+*@param pDock the dock.
+*/
+void cairo_dock_render_dock_opengl (CairoDock *pDock);
+
   //////////////////
  // LOAD TEXTURE //
 //////////////////
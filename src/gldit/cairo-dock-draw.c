@@ -31,7 +31,7 @@
 #include "cairo-dock-backends-manager.h"
 #include "cairo-dock-container.h"
 #include "cairo-dock-image-buffer.h"
-#include "cairo-dock-desktop-manager.h"  // g_pFakeTransparencyDesktopBg
+#include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-windows-manager.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-draw-opengl.h"  // pour cairo_dock_render_one_icon
@@ -40,7 +40,6 @@
 
 extern CairoDockImageBuffer g_pVisibleZoneBuffer;
 
-extern GldiDesktopBackground *g_pFakeTransparencyDesktopBg;
 extern gboolean g_bUseOpenGL;
 
 
@@ -61,13 +60,9 @@ cairo_t *cairo_dock_create_drawing_context_on_container (GldiContainer *pContain
 
 void cairo_dock_init_drawing_context_on_container (GldiContainer *pContainer, cairo_t *pCairoContext)
 {
-	if (g_pFakeTransparencyDesktopBg && g_pFakeTransparencyDesktopBg->pSurface)
-	{
-		if (pContainer->bIsHorizontal)
-			cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionX, - pContainer->iWindowPositionY);
-		else
-			cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionY, - pContainer->iWindowPositionX);
-	}
+	cairo_surface_t *pBgSurface = gldi_container_get_desktop_bg_surface (pContainer);  // already cropped to the container.
+	if (pBgSurface != NULL)
+		cairo_set_source_surface (pCairoContext, pBgSurface, 0, 0);
 	else
 		cairo_set_source_rgba (pCairoContext, 0.0, 0.0, 0.0, 0.0);
 	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
@@ -91,14 +86,12 @@ cairo_t *cairo_dock_create_drawing_context_on_area (GldiContainer *pContainer, G
 		cairo_clip (pCairoContext);
 	}
 	
+	cairo_surface_t *pBgSurface = gldi_container_get_desktop_bg_surface (pContainer);  // already cropped to the container.
 	///if (myContainersParam.bUseFakeTransparency)
 	///{
-		if (g_pFakeTransparencyDesktopBg && g_pFakeTransparencyDesktopBg->pSurface)
+		if (pBgSurface != NULL)
 		{
-			if (pContainer->bIsHorizontal)
-				cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionX, - pContainer->iWindowPositionY);
-			else
-				cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionY, - pContainer->iWindowPositionX);
+			cairo_set_source_surface (pCairoContext, pBgSurface, 0, 0);
 		}
 		/**else
 			cairo_set_source_rgba (pCairoContext, 0.8, 0.8, 0.8, 0.0);
@@ -23,6 +23,14 @@
 #include <fcntl.h>  // open
 #include <sys/sendfile.h>  // sendfile
 #include <errno.h>  // errno
+#include <unistd.h>  // close, getpid, syscall
+#include <sys/syscall.h>  // SYS_pidfd_open
+#include <stdio.h>  // snprintf
+#include <sys/ioctl.h>  // ioctl
+#ifdef __linux__
+#include <linux/fs.h>  // FICLONE
+#endif
+#include <glib/gstdio.h>  // g_remove, g_rmdir
 
 #include "gldi-config.h"
 #include "cairo-dock-dock-factory.h"
@@ -486,66 +494,241 @@ int cairo_dock_get_file_size (const gchar *cFilePath)
 		return 0;
 }
 
-gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
+  /////////////
+ /// FILES ///
+/////////////
+
+// copy the content of a file into another one with the fastest method available: a reflink first (the blocks are shared until one of the files is modified; btrfs, xfs), then an in-kernel copy (copy_file_range, Linux >= 4.5, which can also be offloaded to the server on NFS/SMB), then sendfile, and finally a mere read/write.
+// each method continues from where the previous one stopped, since they all advance the files offsets.
+static gboolean _copy_file_content (int src_fd, int dest_fd, off_t iSize)
+{
+	#ifdef FICLONE
+	if (ioctl (dest_fd, FICLONE, src_fd) == 0)
+		return TRUE;
+	#endif
+	off_t iDone = 0;
+	ssize_t n;
+	#ifdef SYS_copy_file_range
+	while (iDone < iSize)
+	{
+		n = syscall (SYS_copy_file_range, src_fd, NULL, dest_fd, NULL, (size_t)(iSize - iDone), 0);
+		if (n <= 0)  // not supported (ENOSYS, EXDEV before Linux 5.3, etc), or the file has shrunk.
+			break;
+		iDone += n;
+	}
+	#endif
+	#ifndef __FreeBSD__
+	while (iDone < iSize)
+	{
+		n = sendfile (dest_fd, src_fd, NULL, iSize - iDone);  // Linux >= 2.6.33 for being able to have a regular file as the output
+		if (n <= 0)
+			break;
+		iDone += n;
+	}
+	#endif
+	if (iDone < iSize)  // fallback to a read-write method
+	{
+		char buf[65536];
+		ssize_t w;
+		while ((n = read (src_fd, buf, sizeof (buf))) != 0)
+		{
+			if (n < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				return FALSE;
+			}
+			for (w = 0; w < n; )
+			{
+				ssize_t r = write (dest_fd, buf + w, n - w);
+				if (r < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					return FALSE;
+				}
+				w += r;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static gboolean _copy_file (const gchar *cFilePath, const gchar *cDestPath, const struct stat *pStat, gboolean bPreserve)
 {
-	gboolean ret = TRUE;
 	// open both files
 	int src_fd = open (cFilePath, O_RDONLY);
-	int dest_fd;
+	if (src_fd < 0)
+	{
+		cd_warning ("couldn't open file '%s' (%s)", cFilePath, strerror(errno));
+		return FALSE;
+	}
+	struct stat st;
+	if (pStat == NULL)  // get data size to be copied
+	{
+		if (fstat (src_fd, &st) < 0)
+		{
+			cd_warning ("couldn't get info of file '%s' (%s)", cFilePath, strerror(errno));
+			close (src_fd);
+			return FALSE;
+		}
+		pStat = &st;
+	}
+	int dest_fd = open (cDestPath, O_CREAT | O_WRONLY | O_TRUNC, bPreserve ? (pStat->st_mode & 0777) : (S_IRUSR|S_IWUSR | S_IRGRP | S_IROTH));  // mode=644
+	if (dest_fd < 0)
+	{
+		cd_warning ("couldn't create file '%s' (%s)", cDestPath, strerror(errno));
+		close (src_fd);
+		return FALSE;
+	}
+	
+	// perform the copy
+	gboolean ret = _copy_file_content (src_fd, dest_fd, pStat->st_size);
+	if (! ret)
+		cd_warning ("couldn't copy file '%s' to '%s' (%s)", cFilePath, cDestPath, strerror(errno));
+	else if (bPreserve)  // keep the date, so that we can know later if the file has changed (and the mode, in case the file already existed).
+	{
+		struct timespec times[2] = {pStat->st_atim, pStat->st_mtim};
+		futimens (dest_fd, times);
+		fchmod (dest_fd, pStat->st_mode & 07777);
+	}
+	close (dest_fd);
+	close (src_fd);
+	return ret;
+}
+
+gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
+{
+	gboolean ret;
 	if (g_file_test (cDestPath, G_FILE_TEST_IS_DIR))
 	{
 		const gchar *cFileName = strrchr(cFilePath, '/');
-		gchar *cFileDest = g_strdup_printf("%s/%s", cDestPath, cFileName ? cFileName : cFilePath);
-		dest_fd = open (cFileDest, O_CREAT | O_WRONLY, S_IRUSR|S_IWUSR | S_IRGRP | S_IROTH);  // mode=644
+		gchar *cFileDest = g_strdup_printf("%s/%s", cDestPath, cFileName ? cFileName+1 : cFilePath);
+		ret = _copy_file (cFilePath, cFileDest, NULL, FALSE);
 		g_free(cFileDest);
 	}
 	else
 	{
-		dest_fd = open (cDestPath, O_CREAT | O_WRONLY, S_IRUSR|S_IWUSR | S_IRGRP | S_IROTH);  // mode=644
+		ret = _copy_file (cFilePath, cDestPath, NULL, FALSE);
 	}
-	struct stat stat;
-	// get data size to be copied
-	if (fstat (src_fd, &stat) < 0)
+	return ret;
+}
+
+static inline gboolean _is_cancelled (gint *pCancel)
+{
+	return (pCancel != NULL && g_atomic_int_get (pCancel) != 0);
+}
+
+gboolean cairo_dock_copy_tree (const gchar *cSrcPath, const gchar *cDestPath, gboolean bSkipUnchanged, gint *pCancel, gint *pNbFiles)
+{
+	if (_is_cancelled (pCancel))
+		return FALSE;
+	struct stat st, dest_st;
+	if (lstat (cSrcPath, &st) < 0)
 	{
-		cd_warning ("couldn't get info of file '%s' (%s)", cFilePath, strerror(errno));
-		ret = FALSE;
+		cd_warning ("couldn't get info of file '%s' (%s)", cSrcPath, strerror(errno));
+		return FALSE;
 	}
-	else
+	gboolean bDestExists = (lstat (cDestPath, &dest_st) == 0);
+	gboolean ret = TRUE;
+	
+	if (S_ISDIR (st.st_mode))
 	{
-		// perform in-kernel transfer (zero copy to user space)
-		int size;
-		#ifdef __FreeBSD__
-		size = sendfile (src_fd, dest_fd, 0, stat.st_size, NULL, NULL, 0);
-		#else  // Linux >= 2.6.33 for being able to have a regular file as the output socket
-		size = sendfile (dest_fd, src_fd, NULL, stat.st_size);  // note the inversion between both calls ^_^;
-		#endif
-		if (size < 0)  // error, fallback to a read-write method
+		if (bDestExists && ! S_ISDIR (dest_st.st_mode))
+			g_remove (cDestPath);
+		if (g_mkdir_with_parents (cDestPath, (st.st_mode & 0777) | 0700) != 0)
 		{
-			cd_debug ("couldn't fast-copy file '%s' to '%s' (%s)", cFilePath, cDestPath, strerror(errno));
-			// read data
-			char *buf = g_new (char, stat.st_size);
-			size = read (src_fd, buf, stat.st_size);
-			if (size < 0)
-			{
-				cd_warning ("couldn't read file '%s' (%s)", cFilePath, strerror(errno));
+			cd_warning ("couldn't create directory '%s' (%s)", cDestPath, strerror(errno));
+			return FALSE;
+		}
+		GDir *dir = g_dir_open (cSrcPath, 0, NULL);
+		if (dir == NULL)
+			return FALSE;
+		const gchar *cFileName;
+		gchar *cFilePath, *cFileDest;
+		while ((cFileName = g_dir_read_name (dir)) != NULL && ! _is_cancelled (pCancel))
+		{
+			cFilePath = g_strdup_printf ("%s/%s", cSrcPath, cFileName);
+			cFileDest = g_strdup_printf ("%s/%s", cDestPath, cFileName);
+			if (! cairo_dock_copy_tree (cFilePath, cFileDest, bSkipUnchanged, pCancel, pNbFiles))
 				ret = FALSE;
-			}
-			else
+			g_free (cFileDest);
+			g_free (cFilePath);
+		}
+		g_dir_close (dir);
+		return ret && ! _is_cancelled (pCancel);
+	}
+	else if (S_ISLNK (st.st_mode))  // links are copied as links, like 'cp -r' does.
+	{
+		gchar *cTarget = g_file_read_link (cSrcPath, NULL);
+		gchar *cDestTarget = (bSkipUnchanged && bDestExists && S_ISLNK (dest_st.st_mode) ? g_file_read_link (cDestPath, NULL) : NULL);
+		if (cTarget != NULL && g_strcmp0 (cTarget, cDestTarget) != 0)
+		{
+			if (bDestExists)
+				cairo_dock_remove_tree (cDestPath, NULL, NULL);
+			ret = (symlink (cTarget, cDestPath) == 0);
+		}
+		g_free (cDestTarget);
+		g_free (cTarget);
+	}
+	else if (S_ISREG (st.st_mode))
+	{
+		if (! bSkipUnchanged || ! bDestExists
+		|| ! S_ISREG (dest_st.st_mode)
+		|| dest_st.st_size != st.st_size
+		|| dest_st.st_mtime != st.st_mtime)  // the date is preserved by the copy, so if size and date are the same, the file has not changed since the last time it was copied.
+		{
+			if (bDestExists && ! S_ISREG (dest_st.st_mode))  // don't write through a link, and don't try to write on a folder.
+				cairo_dock_remove_tree (cDestPath, NULL, NULL);
+			ret = _copy_file (cSrcPath, cDestPath, &st, TRUE);
+		}
+	}  // other files (fifo, sockets, etc) are ignored.
+	
+	if (pNbFiles)
+		g_atomic_int_inc (pNbFiles);
+	return ret;
+}
+
+gboolean cairo_dock_remove_tree (const gchar *cPath, gint *pCancel, gint *pNbFiles)
+{
+	if (_is_cancelled (pCancel))
+		return FALSE;
+	struct stat st;
+	if (lstat (cPath, &st) < 0)
+		return (errno == ENOENT);
+	
+	gboolean ret = TRUE;
+	if (S_ISDIR (st.st_mode))
+	{
+		GDir *dir = g_dir_open (cPath, 0, NULL);
+		if (dir != NULL)
+		{
+			const gchar *cFileName;
+			gchar *cFilePath;
+			while ((cFileName = g_dir_read_name (dir)) != NULL && ! _is_cancelled (pCancel))
 			{
-				// copy data
-				size = write (dest_fd, buf, stat.st_size);
-				if (size < 0)
-				{
-					cd_warning ("couldn't write to file '%s' (%s)", cDestPath, strerror(errno));
+				cFilePath = g_strdup_printf ("%s/%s", cPath, cFileName);
+				if (! cairo_dock_remove_tree (cFilePath, pCancel, pNbFiles))
 					ret = FALSE;
-				}
+				g_free (cFilePath);
 			}
-			g_free (buf);
+			g_dir_close (dir);
+		}
+		if (ret && ! _is_cancelled (pCancel) && g_rmdir (cPath) != 0)
+		{
+			cd_warning ("couldn't remove directory '%s' (%s)", cPath, strerror(errno));
+			ret = FALSE;
 		}
 	}
-	close (dest_fd);
-	close (src_fd);
-	return ret;
+	else if (g_unlink (cPath) != 0)
+	{
+		cd_warning ("couldn't remove file '%s' (%s)", cPath, strerror(errno));
+		ret = FALSE;
+	}
+	
+	if (pNbFiles)
+		g_atomic_int_inc (pNbFiles);
+	return ret && ! _is_cancelled (pCancel);
 }
 
 
@@ -553,43 +736,207 @@ gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
  /// PID ///
 ///////////
 
-int cairo_dock_fm_get_pid (const gchar *cProcessName)
-{
-	int iPID = -1;
-	gchar *cCommand = g_strdup_printf ("pidof %s", cProcessName);
-	gchar *cPID = cairo_dock_launch_command_sync (cCommand);
+// the processes are found by scanning /proc (rather than launching 'pidof' each time), and are watched with a pidfd when the kernel supports it (Linux >= 5.3): it becomes readable as soon as the process exits.
+// all the watches share the same source (and the same timer when polling is needed).
+#define CD_PID_POLLING_INTERVAL 1000  // ms, only used without pidfd.
 
-	if (cPID != NULL && *cPID != '\0')
-		iPID = atoi (cPID);
+typedef struct {
+	gchar *cProcessName;  // NULL if we watch a given process, else any process with this name.
+	int iPID;
+	int iPidFd;  // -1 if not available.
+	gpointer pFdTag;
+	GSourceFunc pCallback;
+	gpointer pUserData;
+} CDPidWatch;
 
-	g_free (cPID);
-	g_free (cCommand);
+static GSList *s_pPidWatches = NULL;
+static GSource *s_pPidSource = NULL;
+static guint s_iSidPidPolling = 0;
 
+static gboolean _process_name_matches (int iPID, gchar **cNames)
+{
+	gchar *cPath, *cContent = NULL;
+	gsize length = 0;
+	gboolean bMatch = FALSE;
+	int i;
+	
+	// program name, as 'pidof' does.
+	cPath = g_strdup_printf ("/proc/%d/cmdline", iPID);
+	if (g_file_get_contents (cPath, &cContent, &length, NULL) && length != 0)
+	{
+		const gchar *cProg = strrchr (cContent, '/');  // cmdline is nul-separated, so it only looks into argv[0].
+		cProg = (cProg ? cProg + 1 : cContent);
+		for (i = 0; cNames[i] != NULL && ! bMatch; i ++)
+			bMatch = (*cNames[i] != '\0' && strcmp (cProg, cNames[i]) == 0);
+	}
+	g_free (cContent);
+	g_free (cPath);
+	if (bMatch || length != 0)
+		return bMatch;
+	
+	// no command line (e.g. zombie or kernel thread), use the short name.
+	cContent = NULL;
+	cPath = g_strdup_printf ("/proc/%d/comm", iPID);
+	if (g_file_get_contents (cPath, &cContent, NULL, NULL))
+	{
+		g_strchomp (cContent);
+		for (i = 0; cNames[i] != NULL && ! bMatch; i ++)
+			bMatch = (*cNames[i] != '\0' && strncmp (cContent, cNames[i], 15) == 0);  // comm is truncated to 15 chars.
+	}
+	g_free (cContent);
+	g_free (cPath);
+	return bMatch;
+}
+
+int cairo_dock_fm_get_pid (const gchar *cProcessName)
+{
+	g_return_val_if_fail (cProcessName != NULL, -1);
+	GDir *dir = g_dir_open ("/proc", 0, NULL);
+	if (dir == NULL)
+		return -1;
+	
+	gchar **cNames = g_strsplit (cProcessName, " ", -1);  // like 'pidof', several names can be given.
+	int iOwnPID = getpid ();
+	int iPID = -1, n;
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		if (! g_ascii_isdigit (*cFileName))
+			continue;
+		n = atoi (cFileName);
+		if (n <= iPID || n == iOwnPID)  // keep the most recent one, as 'pidof' lists it first.
+			continue;
+		if (_process_name_matches (n, cNames))
+			iPID = n;
+	}
+	g_strfreev (cNames);
+	g_dir_close (dir);
 	return iPID;
 }
 
-static gboolean _wait_pid (gpointer *pData)
+static int _open_pidfd (int iPID)
 {
-	gboolean bCheckSameProcess = GPOINTER_TO_INT (pData[0]);
-	gchar *cProcess = pData[1];
+	#ifdef SYS_pidfd_open
+	int fd = syscall (SYS_pidfd_open, iPID, 0);
+	if (fd >= 0)
+		fcntl (fd, F_SETFD, FD_CLOEXEC);
+	else if (errno == ESRCH)
+		return -2;  // the process is already gone.
+	return fd;
+	#else
+	(void)iPID;
+	return -1;
+	#endif
+}
+
+static gboolean _pid_watches_dispatch (GSource *pSource, GSourceFunc pCallback, gpointer data);
+static GSourceFuncs s_PidSourceFuncs = {NULL, NULL, _pid_watches_dispatch, NULL, NULL, NULL};
 
-	// check if /proc/%d dir exists or the process is running
-	if ((bCheckSameProcess && ! g_file_test (cProcess, G_FILE_TEST_EXISTS))
-		|| (! bCheckSameProcess && cairo_dock_fm_get_pid (cProcess) == -1))
+static gboolean _check_pid_watches (gpointer data);
+
+// start watching the process, return FALSE if it's not running any more.
+static gboolean _watch_process (CDPidWatch *pWatch)
+{
+	pWatch->iPidFd = _open_pidfd (pWatch->iPID);
+	if (pWatch->iPidFd == -2)
 	{
-		GSourceFunc pCallback = pData[2];
-		gpointer pUserData = pData[3];
+		pWatch->iPidFd = -1;
+		return FALSE;
+	}
+	if (pWatch->iPidFd >= 0)
+	{
+		if (s_pPidSource == NULL)
+		{
+			s_pPidSource = g_source_new (&s_PidSourceFuncs, sizeof (GSource));
+			g_source_attach (s_pPidSource, NULL);
+		}
+		pWatch->pFdTag = g_source_add_unix_fd (s_pPidSource, pWatch->iPidFd, G_IO_IN | G_IO_HUP | G_IO_ERR);
+	}
+	else if (s_iSidPidPolling == 0)  // no pidfd, check regularly if the process is still alive.
+	{
+		s_iSidPidPolling = g_timeout_add (CD_PID_POLLING_INTERVAL, _check_pid_watches, NULL);
+	}
+	return TRUE;
+}
 
-		pCallback (pUserData);
+static void _unwatch_process (CDPidWatch *pWatch)
+{
+	if (pWatch->pFdTag != NULL)
+	{
+		g_source_remove_unix_fd (s_pPidSource, pWatch->pFdTag);
+		pWatch->pFdTag = NULL;
+	}
+	if (pWatch->iPidFd >= 0)
+	{
+		close (pWatch->iPidFd);
+		pWatch->iPidFd = -1;
+	}
+}
+
+static void _on_process_exited (CDPidWatch *pWatch)
+{
+	_unwatch_process (pWatch);
+	
+	// if we watch a process name, wait for the other processes with this name.
+	if (pWatch->cProcessName != NULL)
+	{
+		pWatch->iPID = cairo_dock_fm_get_pid (pWatch->cProcessName);
+		if (pWatch->iPID != -1 && _watch_process (pWatch))
+			return;
+	}
+	
+	s_pPidWatches = g_slist_remove (s_pPidWatches, pWatch);
+	pWatch->pCallback (pWatch->pUserData);
+	g_free (pWatch->cProcessName);
+	g_free (pWatch);
+}
 
-		// free allocated ressources just used for this function
-		g_free (cProcess);
-		g_free (pData);
+static gboolean _pid_watches_dispatch (GSource *pSource, G_GNUC_UNUSED GSourceFunc pCallback, G_GNUC_UNUSED gpointer data)
+{
+	GSList *w, *next_w;
+	CDPidWatch *pWatch;
+	for (w = s_pPidWatches; w != NULL; w = next_w)
+	{
+		next_w = w->next;  // the watch can be removed.
+		pWatch = w->data;
+		if (pWatch->pFdTag != NULL && g_source_query_unix_fd (pSource, pWatch->pFdTag) != 0)
+			_on_process_exited (pWatch);
+	}
+	return G_SOURCE_CONTINUE;
+}
 
-		return FALSE;
+static gboolean _check_pid_watches (G_GNUC_UNUSED gpointer data)
+{
+	gchar cPath[32];
+	GSList *w, *next_w;
+	CDPidWatch *pWatch;
+	for (w = s_pPidWatches; w != NULL; w = next_w)
+	{
+		next_w = w->next;
+		pWatch = w->data;
+		if (pWatch->iPidFd >= 0)
+			continue;
+		snprintf (cPath, sizeof (cPath), "/proc/%d", pWatch->iPID);
+		if (! g_file_test (cPath, G_FILE_TEST_EXISTS))
+			_on_process_exited (pWatch);  // the watch may be re-used for another process with the same name.
 	}
+	
+	// keep polling as long as some processes can't be watched otherwise.
+	for (w = s_pPidWatches; w != NULL; w = w->next)
+	{
+		pWatch = w->data;
+		if (pWatch->iPidFd < 0)
+			return TRUE;
+	}
+	s_iSidPidPolling = 0;
+	return FALSE;
+}
 
-	return TRUE;
+static gboolean _notify_process_exited_idle (CDPidWatch *pWatch)
+{
+	s_pPidWatches = g_slist_prepend (s_pPidWatches, pWatch);
+	_on_process_exited (pWatch);
+	return FALSE;
 }
 
 gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSameProcess, GSourceFunc pCallback, gboolean bAlwaysLaunch, gpointer pUserData)
@@ -602,23 +949,17 @@ gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSa
 		return FALSE;
 	}
 
-	gpointer *pData = g_new (gpointer, 4);
-	pData[0] = GINT_TO_POINTER (bCheckSameProcess);
-	if (bCheckSameProcess)
-		pData[1] = g_strdup_printf ("/proc/%d", iPID);
-	else
-		pData[1] = g_strdup (cProcessName);
-	pData[2] = pCallback;
-	pData[3] = pUserData;
-
-	/* It's not easy to be notified when a non child process is stopped...
-	 * We can't use waitpid (not a child process) or monitor /proc/PID dir (or a
-	 * file into it) with g_file_monitor, poll or inotify => it's not working...
-	 * And for apt-get/dpkg, we can't monitor the lock file with fcntl because
-	 * we need root rights to do that.
-	 * Let's just check every 5 seconds if the PID is still running
-	 */
-	g_timeout_add_seconds (5, (GSourceFunc)_wait_pid, pData);
+	CDPidWatch *pWatch = g_new0 (CDPidWatch, 1);
+	pWatch->cProcessName = (bCheckSameProcess ? NULL : g_strdup (cProcessName));
+	pWatch->iPID = iPID;
+	pWatch->iPidFd = -1;
+	pWatch->pCallback = pCallback;
+	pWatch->pUserData = pUserData;
+	
+	if (_watch_process (pWatch))
+		s_pPidWatches = g_slist_prepend (s_pPidWatches, pWatch);
+	else  // already gone in the meantime: notify it from the main loop, as if it was watched.
+		g_idle_add ((GSourceFunc) _notify_process_exited_idle, pWatch);
 
 	return TRUE;
 }
@@ -255,8 +255,31 @@ gboolean cairo_dock_fm_move_into_directory (const gchar *cURI, Icon *icon, GldiC
 */
 int cairo_dock_get_file_size (const gchar *cFilePath);
 
+/** Copy a local file, with the fastest method available (reflink, in-kernel copy, or a plain copy as a last resort).
+*@param cFilePath path of the file.
+*@param cDestPath path of the copy, or of the directory where to copy it.
+*@return TRUE on success.
+*/
 gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath);
 
+/** Recursively copy a file or a folder, like 'cp -r' would do. Dates and permissions are preserved. It can be called from a thread.
+*@param cSrcPath path of the file or folder to copy.
+*@param cDestPath path of the copy (not its parent folder); missing folders are created.
+*@param bSkipUnchanged TRUE to not copy again the files whose copy already has the same size and date (for instance when a theme is imported again).
+*@param pCancel if not NULL, the copy stops as soon as it becomes non-null (it is read atomically).
+*@param pNbFiles if not NULL, it is atomically incremented for each file processed, to display a progress.
+*@return TRUE if everything has been copied.
+*/
+gboolean cairo_dock_copy_tree (const gchar *cSrcPath, const gchar *cDestPath, gboolean bSkipUnchanged, gint *pCancel, gint *pNbFiles);
+
+/** Recursively remove a file or a folder, like 'rm -rf' would do. It can be called from a thread.
+*@param cPath path of the file or folder to remove.
+*@param pCancel if not NULL, the removal stops as soon as it becomes non-null.
+*@param pNbFiles if not NULL, it is atomically incremented for each file removed.
+*@return TRUE if everything has been removed (or didn't exist).
+*/
+gboolean cairo_dock_remove_tree (const gchar *cPath, gint *pCancel, gint *pNbFiles);
+
 
 /** Get process ID given its name
  * @param cProcessName name of the process
@@ -264,7 +287,7 @@ gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath);
  */
 int cairo_dock_fm_get_pid (const gchar *cProcessName);
 
-/** Monitor a process. Call a function when the process is no longer running
+/** Monitor a process. Call a function when the process is no longer running. The main loop is not blocked; on Linux >= 5.3 the exit is noticed immediately, otherwise within a second.
  * @param cProcessName name(es) of the process(es)
  * @param bCheckSameProcess TRUE to check if first match is running. FALSE to
  *        check every time if this process name is running even if it's not the
@@ -30,7 +30,7 @@
 #include "cairo-dock-struct.h"
 #include "cairo-dock-module-manager.h"
 #include "cairo-dock-log.h"
-#include "cairo-dock-utils.h"  // cairo_dock_launch_command_sync
+#include "cairo-dock-utils.h"  // cairo_dock_launch_command_async
 #include "cairo-dock-animations.h"
 #include "cairo-dock-gui-manager.h"
 #include "cairo-dock-icon-facility.h"  // gldi_icons_get_any_without_dialog
@@ -936,17 +936,15 @@ static void _cairo_dock_key_grab_clicked (G_GNUC_UNUSED GtkButton *button, gpoin
 	g_signal_connect (G_OBJECT(pParentWindow), "key-press-event", G_CALLBACK(_cairo_dock_key_grab_cb), pEntry);
 }
 
-static void _cairo_dock_key_grab_class (G_GNUC_UNUSED GtkButton *button, gpointer *data)
+static void _on_window_picked_for_class (GldiWindowActor *actor, GtkEntry **pEntryPtr)
 {
-	GtkEntry *pEntry = data[0];
-	// GtkWindow *pParentWindow = data[1];
-
-	cd_debug ("clicked");
-	gtk_widget_set_sensitive (GTK_WIDGET(pEntry), FALSE);  // lock the widget during the grab (it makes it more comprehensive).
+	GtkEntry *pEntry = *pEntryPtr;
+	g_free (pEntryPtr);
+	if (pEntry == NULL)  // the config window has been closed meanwhile.
+		return;
+	g_object_remove_weak_pointer (G_OBJECT (pEntry), (gpointer*)pEntryPtr);
 	
 	const gchar *cResult = NULL;
-	GldiWindowActor *actor = gldi_window_pick ();
-	
 	if (actor && actor->bIsTransientFor)
 		actor = gldi_window_get_transient_for (actor);
 	
@@ -956,7 +954,24 @@ static void _cairo_dock_key_grab_class (G_GNUC_UNUSED GtkButton *button, gpointe
 		cd_warning ("couldn't get a window actor");
 	
 	gtk_widget_set_sensitive (GTK_WIDGET(pEntry), TRUE);  // unlock the widget
-	gtk_entry_set_text (pEntry, cResult);  // write the result in the entry-box
+	if (cResult != NULL)  // the picking may have been cancelled.
+		gtk_entry_set_text (pEntry, cResult);  // write the result in the entry-box
+}
+
+static void _cairo_dock_key_grab_class (G_GNUC_UNUSED GtkButton *button, gpointer *data)
+{
+	GtkEntry *pEntry = data[0];
+	// GtkWindow *pParentWindow = data[1];
+
+	cd_debug ("clicked");
+	if (! gtk_widget_get_sensitive (GTK_WIDGET(pEntry)))  // already picking a window.
+		return;
+	gtk_widget_set_sensitive (GTK_WIDGET(pEntry), FALSE);  // lock the widget during the grab (it makes it more comprehensive).
+	
+	GtkEntry **pEntryPtr = g_new (GtkEntry*, 1);  // the window may be closed before the click.
+	*pEntryPtr = pEntry;
+	g_object_add_weak_pointer (G_OBJECT (pEntry), (gpointer*)pEntryPtr);
+	gldi_window_pick_async ((GldiWindowPickFunc) _on_window_picked_for_class, pEntryPtr);
 }
 
 void _cairo_dock_set_value_in_pair (GtkSpinButton *pSpinButton, gpointer *data)
@@ -1245,7 +1260,8 @@ static void _cairo_dock_add_one_icon_theme_item (const gchar *cDisplayedName, co
 static GtkListStore *_cairo_dock_build_icon_theme_list_for_gui (GHashTable *pHashTable)
 {
 	GtkListStore *pIconThemeListStore = _build_list_for_gui (NULL, (GHFunc)_cairo_dock_add_one_icon_theme_item, "");
-	g_hash_table_foreach (pHashTable, (GHFunc)_cairo_dock_add_one_icon_theme_item, pIconThemeListStore);
+	if (pHashTable != NULL)
+		g_hash_table_foreach (pHashTable, (GHFunc)_cairo_dock_add_one_icon_theme_item, pIconThemeListStore);
 	return pIconThemeListStore;
 }
 
@@ -1323,6 +1339,68 @@ static gboolean _cairo_dock_find_iter_from_name_full (GtkListStore *pModele, con
  
 #define _cairo_dock_find_iter_from_name(pModele, cName, iter) _cairo_dock_find_iter_from_name_full (pModele, cName, iter, FALSE)
 
+// the icon themes are listed in a thread, since it means reading an index file for each folder of /usr/share/icons; until then, the combo only holds the current value.
+typedef struct {
+	gchar *cUserPath;  // ~/.icons
+	GHashTable *pThemeTable;  // result of the thread
+	GtkWidget *pCombo;
+	} CDIconThemesListing;
+
+static void _list_icon_themes (CDIconThemesListing *pListing)
+{
+	const gchar *path[3];
+	path[0] = (const gchar *)pListing->cUserPath;
+	path[1] = "/usr/share/icons";
+	path[2] = NULL;
+	pListing->pThemeTable = _cairo_dock_build_icon_themes_list (path);
+}
+
+static gboolean _got_icon_themes_list (CDIconThemesListing *pListing)
+{
+	GtkWidget *pCombo = pListing->pCombo;
+	GldiTask *pTask = g_object_get_data (G_OBJECT (pCombo), "cd-task");
+	if (pTask != NULL)
+	{
+		gldi_task_discard (pTask);  // pas de gldi_task_free dans la callback de la tache.
+		g_object_set_data (G_OBJECT (pCombo), "cd-task", NULL);
+	}
+	
+	// keep the value currently selected (the user may have changed it in the meantime).
+	GtkTreeModel *pModel = gtk_combo_box_get_model (GTK_COMBO_BOX (pCombo));
+	g_return_val_if_fail (pModel != NULL, TRUE);
+	gchar *cValue = NULL;
+	GtkTreeIter iter;
+	if (gtk_combo_box_get_active_iter (GTK_COMBO_BOX (pCombo), &iter))
+		gtk_tree_model_get (pModel, &iter, CAIRO_DOCK_MODEL_RESULT, &cValue, -1);
+	
+	gtk_list_store_clear (GTK_LIST_STORE (pModel));
+	_cairo_dock_add_one_icon_theme_item ("", NULL, GTK_LIST_STORE (pModel));
+	g_hash_table_foreach (pListing->pThemeTable, (GHFunc)_cairo_dock_add_one_icon_theme_item, pModel);
+	if (_cairo_dock_find_iter_from_name (GTK_LIST_STORE (pModel), cValue, &iter))
+		gtk_combo_box_set_active_iter (GTK_COMBO_BOX (pCombo), &iter);
+	g_free (cValue);
+	return TRUE;
+}
+
+static void _free_icon_themes_listing (CDIconThemesListing *pListing)
+{
+	g_free (pListing->cUserPath);
+	if (pListing->pThemeTable != NULL)
+		g_hash_table_destroy (pListing->pThemeTable);
+	g_free (pListing);
+}
+
+static void _list_icon_themes_async (GtkWidget *pCombo)
+{
+	CDIconThemesListing *pListing = g_new0 (CDIconThemesListing, 1);
+	pListing->cUserPath = g_strdup_printf ("%s/.icons", g_getenv ("HOME"));
+	pListing->pCombo = pCombo;
+	GldiTask *pTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc)_list_icon_themes, (GldiUpdateSyncFunc)_got_icon_themes_list, (GFreeFunc)_free_icon_themes_listing, pListing);
+	g_object_set_data (G_OBJECT (pCombo), "cd-task", pTask);
+	g_signal_connect (G_OBJECT (pCombo), "destroy", G_CALLBACK (on_delete_async_widget), NULL);
+	gldi_task_launch (pTask);
+}
+
 static void cairo_dock_fill_combo_with_themes (GtkWidget *pCombo, GHashTable *pThemeTable, gchar *cActiveTheme, gchar *cHint)
 {
 	cd_debug ("%s (%s, %s)", __func__, cActiveTheme, cHint);
@@ -1417,12 +1495,39 @@ static void _cairo_dock_configure_module (G_GNUC_UNUSED GtkButton *button, const
 	g_free (cMessage);
 }
 
-static void _cairo_dock_widget_launch_command (G_GNUC_UNUSED GtkButton *button, const gchar *cCommandToLaunch)
+static void _on_widget_command_finished (const gchar *cResult, gchar *cCommand)
 {
-	gchar *cResult = cairo_dock_launch_command_sync (cCommandToLaunch);
 	if (cResult != NULL)
-		cd_debug ("%s: %s => %s", __func__, cCommandToLaunch, cResult);
-	g_free (cResult);
+		cd_debug ("%s => %s", cCommand, cResult);
+	g_free (cCommand);
+}
+static void _cairo_dock_widget_launch_command (G_GNUC_UNUSED GtkButton *button, const gchar *cCommandToLaunch)
+{
+	cairo_dock_launch_command_async (cCommandToLaunch, 0, (CairoDockCommandResultFunc) _on_widget_command_finished, g_strdup (cCommandToLaunch));
+}
+
+#define CAIRO_DOCK_CONDITION_TIMEOUT 10  // s
+typedef struct {
+	GtkWidget *pLabel;
+	GtkWidget *pButton;
+} CDWidgetCondition;
+static void _on_widget_condition_checked (const gchar *cResult, CDWidgetCondition *pCondition)
+{
+	// the widgets may have been destroyed in the meantime (weak pointers).
+	if (cResult == NULL || *cResult == '0')  // result is 'fail': the button stays insensitive.
+	{
+		if (pCondition->pLabel)
+			gtk_widget_set_sensitive (pCondition->pLabel, FALSE);
+	}
+	else if (pCondition->pButton)
+	{
+		gtk_widget_set_sensitive (pCondition->pButton, TRUE);
+	}
+	if (pCondition->pLabel)
+		g_object_remove_weak_pointer (G_OBJECT (pCondition->pLabel), (gpointer*)&pCondition->pLabel);
+	if (pCondition->pButton)
+		g_object_remove_weak_pointer (G_OBJECT (pCondition->pButton), (gpointer*)&pCondition->pButton);
+	g_free (pCondition);
 }
 
 static void _on_text_changed (GtkWidget *pEntry, gchar *cDefaultValue);
@@ -2491,21 +2596,16 @@ GtkWidget *cairo_dock_build_group_widget (GKeyFile *pKeyFile, const gchar *cGrou
 			
 			case CAIRO_DOCK_WIDGET_ICON_THEME_LIST :
 			{
-				gchar *cUserPath = g_strdup_printf ("%s/.icons", g_getenv ("HOME"));
-				const gchar *path[3];
-				path[0] = (const gchar *)cUserPath;
-				path[1] = "/usr/share/icons";
-				path[2] = NULL;
-				
-				GHashTable *pHashTable = _cairo_dock_build_icon_themes_list (path);
-				
-				GtkListStore *pIconThemeListStore = _cairo_dock_build_icon_theme_list_for_gui (pHashTable);
+				GtkListStore *pIconThemeListStore = _cairo_dock_build_icon_theme_list_for_gui (NULL);
+				cValue = g_key_file_get_string (pKeyFile, cGroupName, cKeyName, NULL);
+				if (cValue != NULL && *cValue != '\0')  // the current value, so that it's displayed (and saved) as is until the list is there.
+					_cairo_dock_add_one_icon_theme_item (cValue, cValue, pIconThemeListStore);
+				g_free (cValue);
 				
 				_add_combo_from_modele (pIconThemeListStore, FALSE, FALSE, FALSE);
+				_list_icon_themes_async (pOneWidget);
 				
 				g_object_unref (pIconThemeListStore);
-				g_free (cUserPath);
-				g_hash_table_destroy (pHashTable);
 			}
 			break ;
 			
@@ -2689,16 +2789,6 @@ GtkWidget *cairo_dock_build_group_widget (GKeyFile *pKeyFile, const gchar *cGrou
 						gtk_widget_set_sensitive (pLabel, FALSE);
 						break ;
 					}
-					gchar *cSecondCommand = pAuthorizedValuesList[1];
-					gchar *cResult = cairo_dock_launch_command_sync (cSecondCommand);
-					cd_debug ("%s: %s => %s", __func__, cSecondCommand, cResult);
-					if (cResult == NULL || *cResult == '0' || *cResult == '\0')  // result is 'fail'
-					{
-						gtk_widget_set_sensitive (pLabel, FALSE);
-						g_free (cResult);
-						break ;
-					}
-					g_free (cResult);
 				}
 				pOneWidget = gtk_button_new_from_icon_name (GLDI_ICON_NAME_JUMP_TO, GTK_ICON_SIZE_BUTTON);
 				g_signal_connect (G_OBJECT (pOneWidget),
@@ -2706,6 +2796,17 @@ GtkWidget *cairo_dock_build_group_widget (GKeyFile *pKeyFile, const gchar *cGrou
 					G_CALLBACK (_cairo_dock_widget_launch_command),
 					g_strdup (cFirstCommand));
 				_pack_subwidget (pOneWidget);
+				if (iElementType == CAIRO_DOCK_WIDGET_LAUNCH_COMMAND_IF_CONDITION)  // check the condition without blocking the building of the widgets; the button is usable once it's checked.
+				{
+					gtk_widget_set_sensitive (pOneWidget, FALSE);
+					CDWidgetCondition *pCondition = g_new0 (CDWidgetCondition, 1);
+					pCondition->pLabel = pLabel;
+					pCondition->pButton = pOneWidget;
+					if (pLabel)
+						g_object_add_weak_pointer (G_OBJECT (pLabel), (gpointer*)&pCondition->pLabel);
+					g_object_add_weak_pointer (G_OBJECT (pOneWidget), (gpointer*)&pCondition->pButton);
+					cairo_dock_launch_command_async (pAuthorizedValuesList[1], CAIRO_DOCK_CONDITION_TIMEOUT, (CairoDockCommandResultFunc) _on_widget_condition_checked, pCondition);
+				}
 			break ;
 			
 			case CAIRO_DOCK_WIDGET_LIST :  // a list of strings.
@@ -3327,7 +3428,144 @@ GtkWidget *cairo_dock_build_group_widget (GKeyFile *pKeyFile, const gchar *cGrou
 }
 
 
-GtkWidget *cairo_dock_build_key_file_widget_full (GKeyFile* pKeyFile, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath, GtkWidget *pCurrentNoteBook)
+  /////////////////
+ // LAZY GROUPS //
+/////////////////
+
+#define CAIRO_DOCK_LAZY_BUILD_BUDGET 8  // time (in ms) spent on building hidden groups per iteration of the main loop, ie half a frame at 60 fps.
+
+// a group whose widgets are not built yet; they will be when its page is displayed, when one of them is searched, or in the background.
+typedef struct {
+	GtkWidget *pScrolledWindow;  // page of the group in the notebook
+	GKeyFile *pKeyFile;  // a reference on the key-file
+	gchar *cGroupName;
+	gchar *cGettextDomain;
+	GtkWidget *pMainWindow;
+	GSList **pWidgetList;  // NULL if the build has been cancelled
+	GPtrArray *pDataGarbage;
+	const gchar *cOriginalConfFilePath;  // not duplicated, like in the widgets.
+	} CairoDockLazyGroup;
+
+static GList *s_pLazyGroups = NULL;
+
+static void _free_lazy_group (CairoDockLazyGroup *pGroup)
+{
+	s_pLazyGroups = g_list_remove (s_pLazyGroups, pGroup);
+	g_key_file_unref (pGroup->pKeyFile);
+	g_free (pGroup->cGroupName);
+	g_free (pGroup->cGettextDomain);
+	g_free (pGroup);
+}
+
+static inline void _add_group_widget_to_page (GtkWidget *pScrolledWindow, GtkWidget *pGroupWidget)
+{
+	#if GTK_CHECK_VERSION (3, 8, 0)
+	gtk_container_add (GTK_CONTAINER (pScrolledWindow), pGroupWidget);
+	#else
+	gtk_scrolled_window_add_with_viewport (GTK_SCROLLED_WINDOW (pScrolledWindow), pGroupWidget);
+	#endif
+}
+
+static void _build_lazy_group (CairoDockLazyGroup *pGroup)
+{
+	GtkWidget *pScrolledWindow = pGroup->pScrolledWindow;
+	if (pGroup->pWidgetList != NULL)
+	{
+		s_pLazyGroups = g_list_remove (s_pLazyGroups, pGroup);  // before building, so that a search inside the build doesn't come back here.
+		cd_debug ("build group '%s'", pGroup->cGroupName);
+		GtkWidget *pGroupWidget = cairo_dock_build_group_widget (pGroup->pKeyFile, pGroup->cGroupName, pGroup->cGettextDomain, pGroup->pMainWindow, pGroup->pWidgetList, pGroup->pDataGarbage, pGroup->cOriginalConfFilePath);
+		if (pGroupWidget != NULL)
+		{
+			_add_group_widget_to_page (pScrolledWindow, pGroupWidget);
+			if (gtk_widget_get_visible (pScrolledWindow))  // the notebook is already displayed.
+				gtk_widget_show_all (pGroupWidget);
+		}
+	}
+	g_object_set_data (G_OBJECT (pScrolledWindow), "cd-lazy-group", NULL);  // frees the group.
+}
+
+static void _on_switch_page (GtkNotebook *pNoteBook, GtkWidget *pPage, G_GNUC_UNUSED guint iNumPage, G_GNUC_UNUSED gpointer data)
+{
+	if (gtk_widget_in_destruction (GTK_WIDGET (pNoteBook)))
+		return;
+	CairoDockLazyGroup *pGroup = g_object_get_data (G_OBJECT (pPage), "cd-lazy-group");
+	if (pGroup != NULL)
+		_build_lazy_group (pGroup);
+}
+
+// the first group of a notebook that is still to be built; the groups are prepended, so it's the last one in the list.
+static CairoDockLazyGroup *_find_next_lazy_group (GtkWidget *pNoteBook)
+{
+	CairoDockLazyGroup *pGroup;
+	GList *gr;
+	for (gr = g_list_last (s_pLazyGroups); gr != NULL; gr = gr->prev)
+	{
+		pGroup = gr->data;
+		if (gtk_widget_get_parent (pGroup->pScrolledWindow) == pNoteBook)
+			return pGroup;
+	}
+	return NULL;
+}
+
+// once the first page is displayed, the other ones are built in the background, a few at a time, so that they're ready when the user opens them without making the window stall.
+static gboolean _build_lazy_groups_in_background (GtkWidget *pNoteBook)
+{
+	gint64 t0 = g_get_monotonic_time ();
+	CairoDockLazyGroup *pGroup;
+	while ((pGroup = _find_next_lazy_group (pNoteBook)) != NULL)
+	{
+		_build_lazy_group (pGroup);
+		if (g_get_monotonic_time () - t0 > CAIRO_DOCK_LAZY_BUILD_BUDGET * 1000)
+			return TRUE;  // let the main loop draw the window and handle the events; go on at its next iteration.
+	}
+	g_object_set_data (G_OBJECT (pNoteBook), "cd-lazy-sid", NULL);
+	return FALSE;
+}
+
+static void _on_lazy_notebook_destroyed (GtkWidget *pNoteBook, G_GNUC_UNUSED gpointer data)
+{
+	guint iSidBuild = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (pNoteBook), "cd-lazy-sid"));
+	if (iSidBuild != 0)
+	{
+		g_source_remove (iSidBuild);
+		g_object_set_data (G_OBJECT (pNoteBook), "cd-lazy-sid", NULL);
+	}
+}
+
+static CairoDockLazyGroup *_find_lazy_group (GSList *pWidgetList, const gchar *cGroupName)
+{
+	CairoDockLazyGroup *pGroup;
+	GList *gr;
+	for (gr = s_pLazyGroups; gr != NULL; gr = gr->next)
+	{
+		pGroup = gr->data;
+		if (pGroup->pWidgetList == NULL || strcmp (pGroup->cGroupName, cGroupName) != 0)
+			continue;
+		// the list may have grown since the caller got it, but widgets are prepended, so it's still the tail of the current list.
+		if (*pGroup->pWidgetList == pWidgetList || (pWidgetList != NULL && g_slist_position (*pGroup->pWidgetList, pWidgetList) >= 0))
+			return pGroup;
+	}
+	return NULL;
+}
+
+void cairo_dock_gui_cancel_lazy_groups (GSList **pWidgetList)
+{
+	CairoDockLazyGroup *pGroup;
+	GList *gr = s_pLazyGroups;
+	while (gr != NULL)
+	{
+		pGroup = gr->data;
+		gr = gr->next;
+		if (pGroup->pWidgetList == pWidgetList)
+		{
+			pGroup->pWidgetList = NULL;  // the group will be freed with its page.
+			s_pLazyGroups = g_list_remove (s_pLazyGroups, pGroup);
+		}
+	}
+}
+
+
+static GtkWidget *_build_key_file_widget (GKeyFile* pKeyFile, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath, GtkWidget *pCurrentNoteBook, gboolean bLazy)
 {
 	gsize length = 0;
 	gchar **pGroupList = g_key_file_get_groups (pKeyFile, &length);
@@ -3341,6 +3579,14 @@ GtkWidget *cairo_dock_build_key_file_widget_full (GKeyFile* pKeyFile, const gcha
 		gtk_notebook_popup_enable (GTK_NOTEBOOK (pNoteBook));
 		g_object_set (G_OBJECT (pNoteBook), "tab-pos", GTK_POS_TOP, NULL);
 	}
+	if (bLazy && g_object_get_data (G_OBJECT (pNoteBook), "cd-lazy") == NULL)
+	{
+		g_signal_connect (pNoteBook, "switch-page", G_CALLBACK (_on_switch_page), NULL);
+		g_signal_connect (pNoteBook, "destroy", G_CALLBACK (_on_lazy_notebook_destroyed), NULL);
+		g_object_set_data (G_OBJECT (pNoteBook), "cd-lazy", GINT_TO_POINTER (1));
+	}
+	gboolean bBuildNow = TRUE;  // the first group is always built, it's the one displayed.
+	gint64 t0 = g_get_monotonic_time ();
 	
 	GtkWidget *pGroupWidget, *pLabel, *pLabelContainer, *pAlign;
 	gchar *cGroupName, *cGroupComment, *cIcon, *cDisplayedGroupName;
@@ -3389,23 +3635,59 @@ GtkWidget *cairo_dock_build_key_file_widget_full (GKeyFile* pKeyFile, const gcha
 		}
 		g_free (cGroupComment);
 		
-		pGroupWidget = cairo_dock_build_group_widget (pKeyFile, cGroupName, cGettextDomain, pMainWindow, pWidgetList, pDataGarbage, cOriginalConfFilePath);
-		
 		GtkWidget *pScrolledWindow = gtk_scrolled_window_new (NULL, NULL);
 		gtk_scrolled_window_set_policy (GTK_SCROLLED_WINDOW (pScrolledWindow), GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
-		#if GTK_CHECK_VERSION (3, 8, 0)
-		gtk_container_add (GTK_CONTAINER (pScrolledWindow), pGroupWidget);
-		#else
-		gtk_scrolled_window_add_with_viewport (GTK_SCROLLED_WINDOW (pScrolledWindow), pGroupWidget);
-		#endif
+		if (bBuildNow || ! bLazy)
+		{
+			pGroupWidget = cairo_dock_build_group_widget (pKeyFile, cGroupName, cGettextDomain, pMainWindow, pWidgetList, pDataGarbage, cOriginalConfFilePath);
+			_add_group_widget_to_page (pScrolledWindow, pGroupWidget);
+			bBuildNow = FALSE;
+		}
+		else
+		{
+			CairoDockLazyGroup *pGroup = g_new0 (CairoDockLazyGroup, 1);
+			pGroup->pScrolledWindow = pScrolledWindow;
+			pGroup->pKeyFile = g_key_file_ref (pKeyFile);
+			pGroup->cGroupName = g_strdup (cGroupName);
+			pGroup->cGettextDomain = g_strdup (cGettextDomain);
+			pGroup->pMainWindow = pMainWindow;
+			pGroup->pWidgetList = pWidgetList;
+			pGroup->pDataGarbage = pDataGarbage;
+			pGroup->cOriginalConfFilePath = cOriginalConfFilePath;
+			g_object_set_data_full (G_OBJECT (pScrolledWindow), "cd-lazy-group", pGroup, (GDestroyNotify)_free_lazy_group);
+			s_pLazyGroups = g_list_prepend (s_pLazyGroups, pGroup);
+		}
 		
 		gtk_notebook_append_page (GTK_NOTEBOOK (pNoteBook), pScrolledWindow, (pAlign != NULL ? pAlign : pLabel));
 	}
 	
+	if (bLazy)
+	{
+		cd_debug ("first page built in %.1fms", (g_get_monotonic_time () - t0) / 1e3);
+		if (g_object_get_data (G_OBJECT (pNoteBook), "cd-lazy-sid") == NULL && _find_next_lazy_group (pNoteBook) != NULL)
+		{
+			guint iSidBuild = g_idle_add_full (G_PRIORITY_LOW,  // after the window has been drawn.
+				(GSourceFunc) _build_lazy_groups_in_background,
+				pNoteBook,
+				NULL);
+			g_object_set_data (G_OBJECT (pNoteBook), "cd-lazy-sid", GUINT_TO_POINTER (iSidBuild));
+		}
+	}
+	
 	g_strfreev (pGroupList);
 	return pNoteBook;
 }
 
+GtkWidget *cairo_dock_build_key_file_widget_full (GKeyFile* pKeyFile, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath, GtkWidget *pCurrentNoteBook)
+{
+	return _build_key_file_widget (pKeyFile, cGettextDomain, pMainWindow, pWidgetList, pDataGarbage, cOriginalConfFilePath, pCurrentNoteBook, FALSE);
+}
+
+GtkWidget *cairo_dock_build_key_file_widget_lazy (GKeyFile* pKeyFile, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath)
+{
+	return _build_key_file_widget (pKeyFile, cGettextDomain, pMainWindow, pWidgetList, pDataGarbage, cOriginalConfFilePath, NULL, TRUE);
+}
+
 GtkWidget *cairo_dock_build_conf_file_widget (const gchar *cConfFilePath, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath)
 {
 	//\_____________ On recupere les groupes du fichier.
@@ -3792,7 +4074,16 @@ CairoDockGroupKeyWidget *cairo_dock_gui_find_group_key_widget_in_list (GSList *p
 	const gchar *data[2] = {cGroupName, cKeyName};
 	GSList *pElement = g_slist_find_custom (pWidgetList, data, (GCompareFunc) _find_widget_from_name);
 	if (pElement == NULL)
-		return NULL;
+	{
+		CairoDockLazyGroup *pGroup = _find_lazy_group (pWidgetList, cGroupName);  // the group may not be built yet.
+		if (pGroup == NULL)
+			return NULL;
+		GSList **pCurrentWidgetList = pGroup->pWidgetList;
+		_build_lazy_group (pGroup);
+		pElement = g_slist_find_custom (*pCurrentWidgetList, data, (GCompareFunc) _find_widget_from_name);
+		if (pElement == NULL)
+			return NULL;
+	}
 	return pElement->data;
 }
 
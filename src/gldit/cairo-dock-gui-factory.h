@@ -205,6 +205,16 @@ GtkWidget *cairo_dock_build_key_file_widget_full (GKeyFile* pKeyFile, const gcha
 
 #define cairo_dock_build_key_file_widget(pKeyFile, cGettextDomain, pMainWindow, pWidgetList, pDataGarbage, cOriginalConfFilePath) cairo_dock_build_key_file_widget_full (pKeyFile, cGettextDomain, pMainWindow, pWidgetList, pDataGarbage, cOriginalConfFilePath, NULL)
 
+/** Like \ref cairo_dock_build_key_file_widget, but only the first group is built now. The other groups are built the first time their page is displayed, or one of their widgets is searched with \ref cairo_dock_gui_find_group_key_widget_in_list; otherwise they are built in the background once the main loop is idle, a few milliseconds at a time.
+* Therefore 'pWidgetList' must stay valid as long as the widget is alive (use the list of the structure holding the widget, not a local variable), or the pending groups must be cancelled with \ref cairo_dock_gui_cancel_lazy_groups before it becomes invalid. A reference is taken on the key-file, so it must be released with g_key_file_unref and not g_key_file_free.
+*/
+GtkWidget *cairo_dock_build_key_file_widget_lazy (GKeyFile* pKeyFile, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath);
+
+/** Don't build the pending groups of a widget built with \ref cairo_dock_build_key_file_widget_lazy; to be called before its list of widgets is freed.
+*@param pWidgetList the list given when building the widget.
+*/
+void cairo_dock_gui_cancel_lazy_groups (GSList **pWidgetList);
+
 GtkWidget *cairo_dock_build_conf_file_widget (const gchar *cConfFilePath, const gchar *cGettextDomain, GtkWidget *pMainWindow, GSList **pWidgetList, GPtrArray *pDataGarbage, const gchar *cOriginalConfFilePath);
 
 
@@ -193,8 +193,9 @@ void cairo_dock_load_icon_text (Icon *icon)
 	}
 	
 	int iWidth, iHeight;
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_cached ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
 		&myIconsParam.iconTextDescription,
+		1., 0,
 		&iWidth,
 		&iHeight);
 	cairo_dock_load_image_buffer_from_surface (&icon->label, pSurface, iWidth, iHeight);
@@ -215,7 +216,7 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 		if (iHeight / (myIconsParam.quickInfoTextDescription.iSize * fMaxScale) > 5)  // if the icon is very height (the text occupies less than 20% of the icon)
 			fMaxScale = MIN ((double)iHeight / (myIconsParam.quickInfoTextDescription.iSize * 5), MAX (1., 16./myIconsParam.quickInfoTextDescription.iSize) * fMaxScale);  // let's make it use 20% of the icon's height, limited to 16px
 		int w, h;
-		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (icon->cQuickInfo,
+		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_cached (icon->cQuickInfo,
 			&myIconsParam.quickInfoTextDescription,
 			fMaxScale,
 			iWidth,  // limit the text to the width of the icon
@@ -285,11 +286,16 @@ void cairo_dock_trigger_load_icon_buffers (Icon *pIcon)
  /// CONTAINER ICONS ///
 ///////////////////////
 
+static inline CairoIconContainerRenderer *_get_subdock_content_renderer (Icon *pIcon)
+{
+	return cairo_dock_get_icon_container_renderer (pIcon->cClass != NULL ? "Stack" : s_cRendererNames[pIcon->iSubdockViewType]);
+}
+
 void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock)
 {
 	g_return_if_fail (pIcon != NULL && pIcon->pSubDock != NULL && (pIcon->image.pSurface != NULL || pIcon->image.iTexture != 0));
 	
-	CairoIconContainerRenderer *pRenderer = cairo_dock_get_icon_container_renderer (pIcon->cClass != NULL ? "Stack" : s_cRendererNames[pIcon->iSubdockViewType]);
+	CairoIconContainerRenderer *pRenderer = _get_subdock_content_renderer (pIcon);
 	if (pRenderer == NULL)
 		return;
 	cd_debug ("%s (%s)", __func__, pIcon->cName);
@@ -350,3 +356,28 @@ void gldi_icon_insert_in_container (Icon *pIcon, GldiContainer *pContainer, gboo
 	cairo_dock_set_icon_container (pIcon, pContainer);  // set the container already, the icon might need it to set its size.
 	pContainer->iface.insert_icon (pContainer, pIcon, bAnimateIcon);
 }
+
+gboolean cairo_dock_subdock_content_shows_icon (Icon *pPointingIcon, Icon *pIcon)
+{
+	g_return_val_if_fail (pPointingIcon != NULL && pIcon != NULL, TRUE);
+	if (pPointingIcon->pSubDock == NULL)
+		return TRUE;
+	CairoIconContainerRenderer *pRenderer = _get_subdock_content_renderer (pPointingIcon);
+	int iNbIcons = cairo_dock_get_icon_container_renderer_nb_icons (pRenderer);
+	if (iNbIcons <= 0)
+		return TRUE;
+	
+	// the renderers draw the first icons of the sub-dock, skipping the separators (and the icons without image, so don't count them, to stay on the safe side).
+	int i = 0;
+	Icon *icon;
+	GList *ic;
+	for (ic = pPointingIcon->pSubDock->icons; ic != NULL && i < iNbIcons; ic = ic->next)
+	{
+		icon = ic->data;
+		if (icon == pIcon)
+			return TRUE;
+		if (! CAIRO_DOCK_ICON_TYPE_IS_SEPARATOR (icon) && (icon->image.pSurface != NULL || icon->image.iTexture != 0))
+			i ++;
+	}
+	return FALSE;
+}
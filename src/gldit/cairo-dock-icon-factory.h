@@ -175,7 +175,8 @@ struct _Icon {
 	gint iThumbnailWidth, iThumbnailHeight;
 	
 	gboolean bIsLaunching;  // a mere recopy of gldi_class_is_starting()
-	gpointer reserved[4];
+	gpointer pOverlayCache;  // composite of the static overlays, see cairo-dock-overlay.c
+	gpointer reserved[3];
 };
 
 typedef void (*CairoIconContainerLoadFunc) (void);
@@ -298,6 +299,13 @@ void cairo_dock_trigger_load_icon_buffers (Icon *pIcon);
 
 void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock);
 
+/** Say if an icon of a sub-dock is visible in the preview drawn on the icon pointing on this sub-dock, so that a change of this icon requires to redraw the preview.
+*@param pPointingIcon the icon pointing on the sub-dock.
+*@param pIcon an icon of the sub-dock.
+*@return TRUE if the icon is drawn in the preview (or if it can't be known).
+*/
+gboolean cairo_dock_subdock_content_shows_icon (Icon *pPointingIcon, Icon *pIcon);
+
 #define cairo_dock_set_subdock_content_renderer(pIcon, view) (pIcon)->iSubdockViewType = view
 
 
@@ -36,6 +36,7 @@
 #include "cairo-dock-dock-manager.h"  // gldi_icons_foreach_in_docks
 #include "cairo-dock-dialog-manager.h"  // cairo_dock_remove_dialog_if_any
 #include "cairo-dock-data-renderer.h"  // cairo_dock_remove_data_renderer_on_icon
+#include "cairo-dock-system-metrics.h"  // gldi_system_metrics_unwatch_icon
 #include "cairo-dock-animations.h"  // cairo_dock_animation_will_be_visible
 #include "cairo-dock-dock-facility.h"  // cairo_dock_update_dock_size
 #include "cairo-dock-icon-facility.h"  // gldi_icons_foreach_of_type
@@ -163,6 +164,9 @@ void cairo_dock_hide_show_launchers_on_other_desktops (void )  /// TODO: add a m
 		_show_launcher_on_this_desktop (icon, index);
 		ic = next_ic;
 	}
+	
+	// lay out and redraw each dock once, with all the changes.
+	cairo_dock_flush_update_dock_size ();
 }
 
 static gboolean _on_change_current_desktop_viewport_notification (G_GNUC_UNUSED gpointer data)
@@ -987,6 +991,7 @@ static void reset_object (GldiObject *obj)
 	
 	gldi_object_notify (icon, NOTIFICATION_STOP_ICON, icon);
 	cairo_dock_remove_transition_on_icon (icon);
+	gldi_system_metrics_unwatch_icon (icon);
 	cairo_dock_remove_data_renderer_on_icon (icon);
 	
 	if (icon->pSubDock != NULL)
@@ -56,6 +56,17 @@ extern CairoDock *g_pMainDock;
 static CairoDockImageBuffer s_indicatorBuffer;
 static CairoDockImageBuffer s_activeIndicatorBuffer;
 static CairoDockImageBuffer s_classIndicatorBuffer;
+typedef struct {
+	GArray *pCoords;  // 2 floats per vertex
+	GArray *pVertices;  // 4 floats per vertex, already transformed by the modelview of the icon
+	} CDIndicatorBatch;
+static CDIndicatorBatch s_activeBatch;  // indicators drawn above the icons are only collected during the icons pass, and drawn at once at the end of the dock's rendering.
+static CDIndicatorBatch s_indicatorBatch;
+static CDIndicatorBatch s_classBatch;
+static CairoDock *s_pBatchDock = NULL;  // dock the batches are being collected for
+static GLfloat s_batchBox[4];  // x1, y1, x2, y2: area covered by the collected indicators, in the container
+static gboolean s_bBatchBoxIsEmpty = TRUE;
+static guint s_iNbBatchedQuads = 0, s_iNbBatchDrawCalls = 0;  // for the current frame, to see what the batching saves in the debug log.
 
 static gboolean cairo_dock_pre_render_indicator_notification (gpointer pUserData, Icon *icon, CairoDock *pDock, cairo_t *pCairoContext);
 static gboolean cairo_dock_render_indicator_notification (gpointer pUserData, Icon *icon, CairoDock *pDock, gboolean *bHasBeenRendered, cairo_t *pCairoContext);
@@ -75,7 +86,153 @@ static inline double _compute_delta_y (Icon *icon, double py, gboolean bOnIcon,
 	return dy;
 }
 
-static void _cairo_dock_draw_appli_indicator_opengl (Icon *icon, CairoDock *pDock)
+static void _add_quad_to_batch (CDIndicatorBatch *pBatch, double w, double h)
+{
+	static const GLfloat s_pCorners[4][4] = {  // s, t, x, y; same quad as _cairo_dock_apply_current_texture_at_size
+		{0., 0., -.5,  .5},
+		{1., 0.,  .5,  .5},
+		{1., 1.,  .5, -.5},
+		{0., 1., -.5, -.5}};
+	if (pBatch->pVertices == NULL)
+	{
+		pBatch->pCoords = g_array_new (FALSE, FALSE, sizeof (GLfloat));
+		pBatch->pVertices = g_array_new (FALSE, FALSE, sizeof (GLfloat));
+	}
+	GLfloat m[16];  // column-major
+	glGetFloatv (GL_MODELVIEW_MATRIX, m);
+	GLfloat v[4];
+	double x, y;
+	int i;
+	for (i = 0; i < 4; i ++)
+	{
+		g_array_append_vals (pBatch->pCoords, s_pCorners[i], 2);
+		x = s_pCorners[i][2] * w;
+		y = s_pCorners[i][3] * h;
+		v[0] = m[0] * x + m[4] * y + m[12];
+		v[1] = m[1] * x + m[5] * y + m[13];
+		v[2] = m[2] * x + m[6] * y + m[14];
+		v[3] = m[3] * x + m[7] * y + m[15];
+		g_array_append_vals (pBatch->pVertices, v, 4);
+		
+		if (s_bBatchBoxIsEmpty)
+		{
+			s_batchBox[0] = s_batchBox[2] = v[0];
+			s_batchBox[1] = s_batchBox[3] = v[1];
+			s_bBatchBoxIsEmpty = FALSE;
+		}
+		else
+		{
+			s_batchBox[0] = MIN (s_batchBox[0], v[0]);
+			s_batchBox[1] = MIN (s_batchBox[1], v[1]);
+			s_batchBox[2] = MAX (s_batchBox[2], v[0]);
+			s_batchBox[3] = MAX (s_batchBox[3], v[1]);
+		}
+	}
+	s_iNbBatchedQuads ++;
+}
+
+// TRUE if a square of side s, centered on the current position, covers some of the collected indicators.
+static gboolean _overlaps_batch (double s)
+{
+	if (s_bBatchBoxIsEmpty)
+		return FALSE;
+	GLfloat m[16];
+	glGetFloatv (GL_MODELVIEW_MATRIX, m);
+	double r = s / 2 * G_SQRT2 * MAX (hypot (m[0], m[1]), hypot (m[4], m[5]));  // half of the diagonal once scaled, so that it covers the icon whatever its rotation.
+	return (m[12] - r < s_batchBox[2] && m[12] + r > s_batchBox[0]
+		&& m[13] - r < s_batchBox[3] && m[13] + r > s_batchBox[1]);
+}
+
+static void _reset_batch (CDIndicatorBatch *pBatch)
+{
+	if (pBatch->pVertices != NULL)
+	{
+		g_array_set_size (pBatch->pCoords, 0);
+		g_array_set_size (pBatch->pVertices, 0);
+	}
+}
+
+static void _free_batch (CDIndicatorBatch *pBatch)
+{
+	if (pBatch->pVertices != NULL)
+	{
+		g_array_free (pBatch->pCoords, TRUE);
+		g_array_free (pBatch->pVertices, TRUE);
+		pBatch->pCoords = NULL;
+		pBatch->pVertices = NULL;
+	}
+}
+
+static void _reset_batches (void)
+{
+	_reset_batch (&s_activeBatch);
+	_reset_batch (&s_indicatorBatch);
+	_reset_batch (&s_classBatch);
+	s_bBatchBoxIsEmpty = TRUE;
+}
+
+static inline gboolean _batch_is_empty (CDIndicatorBatch *pBatch)
+{
+	return (pBatch->pVertices == NULL || pBatch->pVertices->len == 0);
+}
+
+static void _draw_batch (CDIndicatorBatch *pBatch, GLuint iTexture)
+{
+	if (_batch_is_empty (pBatch))
+		return;
+	if (iTexture != 0)
+	{
+		glBindTexture (GL_TEXTURE_2D, iTexture);
+		glTexCoordPointer (2, GL_FLOAT, 2 * sizeof(GLfloat), pBatch->pCoords->data);
+		glVertexPointer (4, GL_FLOAT, 4 * sizeof(GLfloat), pBatch->pVertices->data);
+		glDrawArrays (GL_QUADS, 0, pBatch->pVertices->len / 4);
+		s_iNbBatchDrawCalls ++;
+	}
+	_reset_batch (pBatch);
+}
+
+static void _flush_batches (void)
+{
+	s_bBatchBoxIsEmpty = TRUE;
+	if (_batch_is_empty (&s_activeBatch) && _batch_is_empty (&s_indicatorBatch) && _batch_is_empty (&s_classBatch))
+		return;
+	
+	glPushMatrix ();
+	glLoadIdentity ();  // the vertices are already placed.
+	_cairo_dock_enable_texture ();
+	_cairo_dock_set_alpha (1.);
+	glEnableClientState (GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState (GL_VERTEX_ARRAY);
+	
+	// same order and blending as when they were drawn icon by icon.
+	_cairo_dock_set_blend_pbuffer ();
+	_draw_batch (&s_activeBatch, s_activeIndicatorBuffer.iTexture);
+	_cairo_dock_set_blend_over ();
+	_draw_batch (&s_indicatorBatch, s_indicatorBuffer.iTexture);
+	_draw_batch (&s_classBatch, s_classIndicatorBuffer.iTexture);
+	
+	glDisableClientState (GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState (GL_VERTEX_ARRAY);
+	_cairo_dock_disable_texture ();
+	glPopMatrix ();
+}
+
+void gldi_indicators_render_batch_opengl (CairoDock *pDock)
+{
+	if (s_pBatchDock != pDock)  // nothing was collected for this dock (anything else is stale).
+	{
+		_reset_batches ();
+		s_pBatchDock = NULL;
+		return;
+	}
+	s_pBatchDock = NULL;
+	_flush_batches ();
+	if (s_iNbBatchedQuads != 0)
+		cd_debug ("indicators of %p: %d quads in %d draw calls", pDock, s_iNbBatchedQuads, s_iNbBatchDrawCalls);
+	s_iNbBatchedQuads = s_iNbBatchDrawCalls = 0;
+}
+
+static void _cairo_dock_draw_appli_indicator_opengl (Icon *icon, CairoDock *pDock, CDIndicatorBatch *pBatch)
 {
 	gboolean bIsHorizontal = pDock->container.bIsHorizontal;
 	gboolean bDirectionUp = pDock->container.bDirectionUp;
@@ -109,16 +266,26 @@ static void _cairo_dock_draw_appli_indicator_opengl (Icon *icon, CairoDock *pDoc
 	glScalef (w * z, (bDirectionUp ? 1:-1) * h * z, 1.);
 	
 	//\__________________ On dessine l'indicateur.
-	cairo_dock_draw_texture_with_alpha (s_indicatorBuffer.iTexture, 1., 1., 1.);
+	if (pBatch != NULL)
+		_add_quad_to_batch (pBatch, 1., 1.);
+	else
+		cairo_dock_draw_texture_with_alpha (s_indicatorBuffer.iTexture, 1., 1., 1.);
 	glPopMatrix ();
 }
-static void _cairo_dock_draw_active_window_indicator_opengl (Icon *icon, CairoDock *pDock, G_GNUC_UNUSED double fRatio)
+static void _cairo_dock_draw_active_window_indicator_opengl (Icon *icon, CairoDock *pDock, G_GNUC_UNUSED double fRatio, CDIndicatorBatch *pBatch)
 {
 	if (s_activeIndicatorBuffer.iTexture == 0)
 		return ;
 	glPushMatrix ();
 	cairo_dock_set_icon_scale (icon, CAIRO_CONTAINER (pDock), 1.);
 	
+	if (pBatch != NULL)
+	{
+		_add_quad_to_batch (pBatch, 1., 1.);
+		glPopMatrix ();
+		return;
+	}
+	
 	_cairo_dock_enable_texture ();
 	
 	_cairo_dock_set_blend_pbuffer ();  // rend mieux que les 2 autres.
@@ -129,7 +296,7 @@ static void _cairo_dock_draw_active_window_indicator_opengl (Icon *icon, CairoDo
 	glPopMatrix ();
 	
 }
-static void _cairo_dock_draw_class_indicator_opengl (Icon *icon, gboolean bIsHorizontal, double fRatio, gboolean bDirectionUp)
+static void _cairo_dock_draw_class_indicator_opengl (Icon *icon, gboolean bIsHorizontal, double fRatio, gboolean bDirectionUp, CDIndicatorBatch *pBatch)
 {
 	glPushMatrix ();
 	if (myIndicatorsParam.bZoomClassIndicator)
@@ -145,10 +312,13 @@ static void _cairo_dock_draw_class_indicator_opengl (Icon *icon, gboolean bIsHor
 		icon->fHeight * icon->fScale/2 - h/2,
 		0.);
 	
-	cairo_dock_draw_texture_with_alpha (s_classIndicatorBuffer.iTexture,
-		w,
-		h,
-		1.);
+	if (pBatch != NULL)
+		_add_quad_to_batch (pBatch, w, h);
+	else
+		cairo_dock_draw_texture_with_alpha (s_classIndicatorBuffer.iTexture,
+			w,
+			h,
+			1.);
 	glPopMatrix ();
 }
 
@@ -285,14 +455,18 @@ static gboolean cairo_dock_pre_render_indicator_notification (G_GNUC_UNUSED gpoi
 	}
 	else
 	{
+		// the icons are drawn from the sides to the pointed one, and a zoomed icon can cover the indicators of its neighbours, as when they were drawn icon by icon: draw the ones collected so far before it. Icons that don't overlap still share the same draw calls.
+		if (s_pBatchDock == pDock && _overlaps_batch (MAX (icon->fWidth * icon->fWidthFactor, icon->fHeight * icon->fHeightFactor) * icon->fScale))
+			_flush_batches ();
+		
 		if (icon->bHasIndicator && ! myIndicatorsParam.bIndicatorAbove)
 		{
-			_cairo_dock_draw_appli_indicator_opengl (icon, pDock);
+			_cairo_dock_draw_appli_indicator_opengl (icon, pDock, NULL);  // below the icon, so it can't wait for the end of the frame.
 		}
 		
 		if (bIsActive)
 		{
-			_cairo_dock_draw_active_window_indicator_opengl (icon, pDock, pDock->container.fRatio);
+			_cairo_dock_draw_active_window_indicator_opengl (icon, pDock, pDock->container.fRatio, NULL);
 		}
 	}
 	return GLDI_NOTIFICATION_LET_PASS;
@@ -317,23 +491,28 @@ static gboolean cairo_dock_render_indicator_notification (G_GNUC_UNUSED gpointer
 			_cairo_dock_draw_class_indicator (pCairoContext, icon, pDock->container.bIsHorizontal, pDock->container.fRatio, pDock->container.bDirectionUp);
 		}
 	}
-	else
+	else  // these ones are drawn above the icon, collect them and draw them all at once in gldi_indicators_render_batch_opengl().
 	{
+		if (s_pBatchDock != pDock)  // leftovers from a dock that was not flushed, drop them.
+		{
+			_reset_batches ();
+			s_pBatchDock = pDock;
+		}
 		if (icon->bHasIndicator && myIndicatorsParam.bIndicatorAbove)
 		{
 			glPushMatrix ();
 			glLoadIdentity();
 			cairo_dock_translate_on_icon_opengl (icon, CAIRO_CONTAINER (pDock), 1.);
-			_cairo_dock_draw_appli_indicator_opengl (icon, pDock);
+			_cairo_dock_draw_appli_indicator_opengl (icon, pDock, &s_indicatorBatch);
 			glPopMatrix ();
 		}
 		if (bIsActive)
 		{
-			_cairo_dock_draw_active_window_indicator_opengl (icon, pDock, pDock->container.fRatio);
+			_cairo_dock_draw_active_window_indicator_opengl (icon, pDock, pDock->container.fRatio, &s_activeBatch);
 		}
 		if (icon->pSubDock != NULL && icon->cClass != NULL && s_classIndicatorBuffer.iTexture != 0 && icon->pAppli == NULL)  // le dernier test est de la paranoia.
 		{
-			_cairo_dock_draw_class_indicator_opengl (icon, pDock->container.bIsHorizontal, pDock->container.fRatio, pDock->container.bDirectionUp);
+			_cairo_dock_draw_class_indicator_opengl (icon, pDock->container.bIsHorizontal, pDock->container.fRatio, pDock->container.bDirectionUp, &s_classBatch);
 		}
 	}
 	return GLDI_NOTIFICATION_LET_PASS;
@@ -732,6 +911,10 @@ static void unload (void)
 	cairo_dock_unload_image_buffer (&s_indicatorBuffer);
 	cairo_dock_unload_image_buffer (&s_activeIndicatorBuffer);
 	cairo_dock_unload_image_buffer (&s_classIndicatorBuffer);
+	_free_batch (&s_activeBatch);
+	_free_batch (&s_indicatorBatch);
+	_free_batch (&s_classBatch);
+	s_pBatchDock = NULL;
 }
 
 
@@ -75,6 +75,11 @@ typedef enum {
 	} CairoIndicatorsNotifications;
 
 
+/** Draw the indicators that were collected above the icons of a dock during its rendering, in one draw call per kind of indicator. Must be called once the icons of the dock have been drawn, in its OpenGL context.
+*@param pDock the dock being rendered.
+*/
+void gldi_indicators_render_batch_opengl (CairoDock *pDock);
+
 void gldi_register_indicators_manager (void);
 
 G_END_DECLS
@@ -25,29 +25,39 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
 #include <unistd.h>
 
 #include "cairo-dock-log.h"
 
+#define CD_LOG_QUEUE_MAX 10000  // beyond this number of pending records, new records are dropped rather than blocking the caller.
+
+typedef struct {
+	const gchar *cDomain;
+	const char *cFile;
+	const char *cFunc;
+	int iLine;
+} CDLogLocation;
+
 static char s_iLogColor = '0';
 static GLogLevelFlags s_gLogLevel = G_LOG_LEVEL_WARNING;
 static gboolean s_bUseColors = TRUE;
 gboolean bForceColors = FALSE;
-
-/* #    'default'     => "\033[1m", */
-
-/* #    'black'     => "\033[30m", */
-/* #    'red'       => "\033[31m", */
-/* #    'green'     => "\033[32m", */
-/* #    'yellow'    => "\033[33m", */
-/* #    'blue'      => "\033[34m", */
-/* #    'magenta'   => "\033[35m", */
-/* #    'cyan'      => "\033[36m", */
-/* #    'white'     => "\033[37m", */
-
-
+gint g_iCdLogMaxLevel = G_LOG_LEVEL_WARNING;  // max of the global level and of all the filters, this is the only thing a log call checks before being discarded.
+static gboolean s_bJsonOutput = FALSE;
+// per-file/per-domain filters
+static GHashTable *s_pFilters = NULL;  // name -> level; created once under the lock and published atomically, it's only read or modified under the lock.
+G_LOCK_DEFINE_STATIC (s_Filters);
+// asynchronous output
+static GAsyncQueue *s_pQueue = NULL;  // formatted records waiting to be written
+static gint s_iNbDropped = 0;
+static GThread *s_pWriterThread = NULL;
+static gchar s_cStopRecord[] = "";  // pushed to stop the writer thread
+static gint s_bWriterStopped = FALSE;  // once stopped (at exit), records are written by the caller.
+static GMutex s_OutputMutex;  // serializes the writes on stdout
+static GPrivate s_Location;  // location of the message being sent to g_logv by the current thread
 const char *_cd_log_level_to_string (const GLogLevelFlags loglevel)
 {
   if (s_bUseColors || bForceColors)
@@ -97,6 +107,364 @@ const char *_cd_log_level_to_string (const GLogLevelFlags loglevel)
   return "";
 }
 
+static inline gboolean _use_colors (void)
+{
+	return (s_bUseColors || bForceColors);
+}
+
+static const char *_get_level_name (GLogLevelFlags loglevel)
+{
+	switch (loglevel & G_LOG_LEVEL_MASK)
+	{
+		case G_LOG_LEVEL_ERROR: return "error";
+		case G_LOG_LEVEL_CRITICAL: return "critical";
+		case G_LOG_LEVEL_WARNING: return "warning";
+		case G_LOG_LEVEL_MESSAGE: return "message";
+		case G_LOG_LEVEL_INFO: return "info";
+		case G_LOG_LEVEL_DEBUG: return "debug";
+		default: return "fatal";
+	}
+}
+
+static GLogLevelFlags _get_level_from_name (const gchar *cVerbosity)
+{
+	if (!strcmp (cVerbosity, "debug"))
+		return G_LOG_LEVEL_DEBUG;
+	if (!strcmp (cVerbosity, "info"))
+		return G_LOG_LEVEL_INFO;
+	if (!strcmp (cVerbosity, "message"))
+		return G_LOG_LEVEL_MESSAGE;
+	if (!strcmp (cVerbosity, "warning"))
+		return G_LOG_LEVEL_WARNING;
+	if (!strcmp (cVerbosity, "critical"))
+		return G_LOG_LEVEL_CRITICAL;
+	if (!strcmp (cVerbosity, "error"))
+		return G_LOG_LEVEL_ERROR;
+	return 0;
+}
+
+static inline const char *_get_basename (const char *file)
+{
+	const char *str = strrchr (file, '/');
+	return (str ? str + 1 : file);
+}
+
+
+  ///////////////
+ /// FILTERS ///
+///////////////
+
+static void _update_max_level (void)
+{
+	gint iMaxLevel = s_gLogLevel;
+	if (s_pFilters != NULL)
+	{
+		GHashTableIter iter;
+		gpointer key, value;
+		g_hash_table_iter_init (&iter, s_pFilters);
+		while (g_hash_table_iter_next (&iter, &key, &value))
+		{
+			if (GPOINTER_TO_INT (value) > iMaxLevel)
+				iMaxLevel = GPOINTER_TO_INT (value);
+		}
+	}
+	g_atomic_int_set (&g_iCdLogMaxLevel, iMaxLevel);
+}
+
+// the file's filter wins over the domain's one, which wins over the global level.
+static gboolean _level_is_enabled (GLogLevelFlags loglevel, const gchar *cDomain, const char *file)
+{
+	if (g_atomic_pointer_get (&s_pFilters) == NULL)  // no filter, the global level is also the max level.
+		return (loglevel <= s_gLogLevel);
+	
+	gint iLevel = s_gLogLevel;
+	gpointer value = NULL;
+	G_LOCK (s_Filters);
+	if (file != NULL)
+		value = g_hash_table_lookup (s_pFilters, _get_basename (file));
+	if (value == NULL && cDomain != NULL)
+		value = g_hash_table_lookup (s_pFilters, cDomain);
+	G_UNLOCK (s_Filters);
+	if (value != NULL)
+		iLevel = GPOINTER_TO_INT (value);
+	return ((gint)loglevel <= iLevel);
+}
+
+void cd_log_set_filter (const gchar *cName, GLogLevelFlags loglevel)
+{
+	g_return_if_fail (cName != NULL);
+	G_LOCK (s_Filters);
+	if (loglevel == 0)
+	{
+		if (s_pFilters != NULL)
+			g_hash_table_remove (s_pFilters, cName);
+	}
+	else
+	{
+		if (s_pFilters == NULL)
+			g_atomic_pointer_set (&s_pFilters, g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL));
+		g_hash_table_insert (s_pFilters, g_strdup (cName), GINT_TO_POINTER (loglevel));
+	}
+	_update_max_level ();
+	G_UNLOCK (s_Filters);
+}
+
+static void _set_filters_from_string (const gchar *cFilters)  // "name=level,name=level,..."
+{
+	gchar **pFilters = g_strsplit (cFilters, ",", -1);
+	gchar *str;
+	int i;
+	for (i = 0; pFilters[i] != NULL; i ++)
+	{
+		str = strchr (pFilters[i], '=');
+		if (str == NULL)
+			continue;
+		*str = '\0';
+		g_strstrip (pFilters[i]);
+		GLogLevelFlags iLevel = _get_level_from_name (g_strstrip (str+1));
+		if (*pFilters[i] != '\0' && iLevel != 0)
+			cd_log_set_filter (pFilters[i], iLevel);
+		else
+			cd_warning ("bad log filter '%s=%s'", pFilters[i], str+1);
+	}
+	g_strfreev (pFilters);
+}
+
+
+  //////////////
+ /// FORMAT ///
+//////////////
+
+static void _append_json_string (GString *sRecord, const gchar *str)
+{
+	g_string_append_c (sRecord, '"');
+	if (str != NULL)
+	{
+		const guchar *c;
+		for (c = (const guchar *)str; *c != '\0'; c ++)
+		{
+			switch (*c)
+			{
+				case '"': g_string_append (sRecord, "\\\""); break;
+				case '\\': g_string_append (sRecord, "\\\\"); break;
+				case '\n': g_string_append (sRecord, "\\n"); break;
+				case '\t': g_string_append (sRecord, "\\t"); break;
+				case '\r': g_string_append (sRecord, "\\r"); break;
+				default:
+					if (*c < 0x20)
+						g_string_append_printf (sRecord, "\\u%04x", *c);
+					else
+						g_string_append_c (sRecord, *c);
+			}
+		}
+	}
+	g_string_append_c (sRecord, '"');
+}
+
+// format a complete record (terminated by a new line); the location may be NULL for messages not emitted by us (glib, gtk, etc).
+static gchar *_format_record (GLogLevelFlags loglevel, const CDLogLocation *pLocation, const gchar *cDomain, const gchar *cMessage)
+{
+	GString *sRecord = g_string_sized_new (128);
+	if (s_bJsonOutput)
+	{
+		g_string_append_printf (sRecord, "{\"ts\":%" G_GINT64_FORMAT ",\"level\":\"%s\"", g_get_real_time (), _get_level_name (loglevel));
+		if (cDomain != NULL)
+		{
+			g_string_append (sRecord, ",\"domain\":");
+			_append_json_string (sRecord, cDomain);
+		}
+		if (pLocation != NULL)
+		{
+			g_string_append (sRecord, ",\"file\":");
+			_append_json_string (sRecord, _get_basename (pLocation->cFile));
+			g_string_append (sRecord, ",\"func\":");
+			_append_json_string (sRecord, pLocation->cFunc);
+			g_string_append_printf (sRecord, ",\"line\":%d", pLocation->iLine);
+		}
+		g_string_append_printf (sRecord, ",\"thread\":\"%p\",\"msg\":", (gpointer)g_thread_self ());
+		_append_json_string (sRecord, cMessage);
+		g_string_append (sRecord, "}\n");
+	}
+	else if (pLocation != NULL)
+	{
+		g_string_append (sRecord, _cd_log_level_to_string (loglevel));
+		if (_use_colors ())
+			g_string_append_printf (sRecord, "\033[0;37m(%s:%s:%d) \033[%cm \n  %s\n", pLocation->cFile, pLocation->cFunc, pLocation->iLine, s_iLogColor, cMessage);
+		else
+			g_string_append_printf (sRecord, "(%s:%s:%d)\n  %s\n", pLocation->cFile, pLocation->cFunc, pLocation->iLine, cMessage);
+	}
+	else
+	{
+		g_string_append (sRecord, cMessage);
+		g_string_append_c (sRecord, '\n');
+	}
+	return g_string_free (sRecord, FALSE);
+}
+
+
+  //////////////
+ /// OUTPUT ///
+//////////////
+
+// must be called with the output mutex locked.
+static void _write_dropped_notice (void)
+{
+	gint iNbDropped;
+	do
+		iNbDropped = g_atomic_int_get (&s_iNbDropped);
+	while (! g_atomic_int_compare_and_exchange (&s_iNbDropped, iNbDropped, 0));
+	if (iNbDropped != 0)
+		fprintf (stdout, "%s%d log messages were dropped\n", _cd_log_level_to_string (G_LOG_LEVEL_WARNING), iNbDropped);
+}
+
+// take all the records in the queue, after cFirst if not NULL; must be called with the queue locked.
+static GPtrArray *_take_queued_records_unlocked (gchar *cFirst)
+{
+	GPtrArray *pRecords = g_ptr_array_new ();
+	if (cFirst != NULL)
+		g_ptr_array_add (pRecords, cFirst);
+	gchar *cRecord;
+	while ((cRecord = g_async_queue_try_pop_unlocked (s_pQueue)) != NULL)
+	{
+		if (cRecord == s_cStopRecord)  // leave it to the writer, and what comes after too.
+		{
+			g_async_queue_push_front_unlocked (s_pQueue, cRecord);
+			break;
+		}
+		g_ptr_array_add (pRecords, cRecord);
+	}
+	return pRecords;
+}
+
+// write and free the records; must be called with the output mutex locked.
+static void _write_records_locked (GPtrArray *pRecords)
+{
+	guint i;
+	for (i = 0; i < pRecords->len; i ++)
+	{
+		fputs (g_ptr_array_index (pRecords, i), stdout);
+		g_free (g_ptr_array_index (pRecords, i));
+	}
+	g_ptr_array_free (pRecords, TRUE);
+	_write_dropped_notice ();
+}
+
+// Records are taken out of the queue and the output is locked before the queue is released, so that whoever writes them (the writer thread, or a thread emitting a warning), they come out in the order they were pushed.
+static gpointer _log_writer_thread (G_GNUC_UNUSED gpointer data)
+{
+	gchar *cRecord;
+	GPtrArray *pRecords;
+	while (TRUE)
+	{
+		g_async_queue_lock (s_pQueue);
+		cRecord = g_async_queue_pop_unlocked (s_pQueue);  // sleep until there is something to write
+		if (cRecord == s_cStopRecord)  // everything pushed before has been written.
+		{
+			g_async_queue_unlock (s_pQueue);
+			break;
+		}
+		pRecords = _take_queued_records_unlocked (cRecord);  // take everything that piled up meanwhile in the same batch, so that we flush once.
+		g_mutex_lock (&s_OutputMutex);
+		g_async_queue_unlock (s_pQueue);
+		
+		_write_records_locked (pRecords);
+		fflush (stdout);
+		g_mutex_unlock (&s_OutputMutex);
+	}
+	return NULL;
+}
+
+// write the queued records, then the given one if any, from the caller's thread.
+static void _write_now (const gchar *cRecord)
+{
+	GAsyncQueue *pQueue = g_atomic_pointer_get (&s_pQueue);
+	if (pQueue != NULL)
+	{
+		g_async_queue_lock (pQueue);
+		GPtrArray *pRecords = _take_queued_records_unlocked (NULL);
+		g_mutex_lock (&s_OutputMutex);
+		g_async_queue_unlock (pQueue);
+		_write_records_locked (pRecords);
+	}
+	else
+		g_mutex_lock (&s_OutputMutex);
+	if (cRecord != NULL)
+		fputs (cRecord, stdout);
+	fflush (stdout);
+	g_mutex_unlock (&s_OutputMutex);
+}
+
+static void _flush_at_exit (void)
+{
+	// let the writer output what is queued, then stop it.
+	g_async_queue_push (s_pQueue, s_cStopRecord);
+	g_thread_join (s_pWriterThread);
+	s_pWriterThread = NULL;
+	g_atomic_int_set (&s_bWriterStopped, TRUE);
+	
+	// records pushed by other threads meanwhile are written here.
+	_write_now (NULL);
+}
+
+static void _init_async_output (void)
+{
+	static gsize s_bInit = 0;
+	if (g_once_init_enter (&s_bInit))
+	{
+		g_atomic_pointer_set (&s_pQueue, g_async_queue_new ());
+		s_pWriterThread = g_thread_new ("cd-log", _log_writer_thread, NULL);
+		atexit (_flush_at_exit);
+		g_once_init_leave (&s_bInit, 1);
+	}
+}
+
+static void _push_record (gchar *cRecord)
+{
+	_init_async_output ();
+	if (g_async_queue_length (s_pQueue) >= CD_LOG_QUEUE_MAX)  // the output can't follow, don't stall the caller.
+	{
+		g_atomic_int_inc (&s_iNbDropped);
+		g_free (cRecord);
+		return;
+	}
+	g_async_queue_push (s_pQueue, cRecord);
+	if (G_UNLIKELY (g_atomic_int_get (&s_bWriterStopped)))  // nobody to write it any more.
+		_write_now (NULL);
+}
+
+void cd_log_location_full (const gchar *cDomain,
+	const GLogLevelFlags loglevel,
+	const char *file,
+	const char *func,
+	const int line,
+	const char *format,
+	...)
+{
+	if (! _level_is_enabled (loglevel, cDomain, file))
+		return;
+	
+	va_list args;
+	CDLogLocation location = {cDomain, file, func, line};
+	if (loglevel & (G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL | G_LOG_LEVEL_WARNING))
+	{
+		// go through glib, so that these messages keep their semantic (fatal errors, G_DEBUG=fatal-warnings, etc); the handler writes them synchronously.
+		g_private_set (&s_Location, &location);
+		va_start (args, format);
+		g_logv (cDomain, loglevel, format, args);
+		va_end (args);
+		g_private_set (&s_Location, NULL);
+	}
+	else
+	{
+		// format here (the arguments may not live longer than this call), and let the writer thread do the I/O.
+		va_start (args, format);
+		gchar *cMessage = g_strdup_vprintf (format, args);
+		va_end (args);
+		_push_record (_format_record (loglevel, &location, cDomain, cMessage));
+		g_free (cMessage);
+	}
+}
+
 void cd_log_location(const GLogLevelFlags loglevel,
                      const char *file,
                      const char *func,
@@ -104,28 +472,28 @@ void cd_log_location(const GLogLevelFlags loglevel,
                      const char *format,
                      ...)
 {
-  va_list args;
-
-  if (loglevel > s_gLogLevel)
-    return;
-  g_print("%s", _cd_log_level_to_string (loglevel));
-  if (s_bUseColors)
-    g_print("\033[0;37m(%s:%s:%d) \033[%cm \n  ", file, func, line, s_iLogColor);
-  else
-    g_print("(%s:%s:%d)\n  ", file, func, line);
-  va_start(args, format);
-  g_logv(G_LOG_DOMAIN, loglevel, format, args);
-  va_end(args);
+	if (! _level_is_enabled (loglevel, NULL, file))
+		return;
+	va_list args;
+	va_start (args, format);
+	gchar *cMessage = g_strdup_vprintf (format, args);
+	va_end (args);
+	cd_log_location_full (NULL, loglevel, file, func, line, "%s", cMessage);
+	g_free (cMessage);
 }
 
-static void cairo_dock_log_handler(G_GNUC_UNUSED const gchar *log_domain,
+static void cairo_dock_log_handler(const gchar *log_domain,
                                    GLogLevelFlags log_level,
                                    const gchar *message,
                                    G_GNUC_UNUSED gpointer user_data)
 {
-  if (log_level > s_gLogLevel)
-    return;
-  g_print("%s\n", message);
+	const CDLogLocation *pLocation = g_private_get (&s_Location);
+	if (pLocation == NULL && ! _level_is_enabled (log_level & G_LOG_LEVEL_MASK, log_domain, NULL))  // our own messages have already been filtered.
+		return;
+	gchar *cRecord = _format_record (log_level & G_LOG_LEVEL_MASK, pLocation, log_domain, message);
+	
+	_write_now (cRecord);  // after the messages that are still queued, to keep the order.
+	g_free (cRecord);
 }
 
 
@@ -134,27 +502,28 @@ void cd_log_init (gboolean bBlackTerminal)
 	g_log_set_default_handler(cairo_dock_log_handler, NULL);
 	s_iLogColor = (bBlackTerminal ? '1' : '0');
 	s_bUseColors = isatty (1);  // use colors iif our output is associated with a terminal (otherwise it's probably redirected into log file, color characters will be annoying).
+	
+	const gchar *cFormat = g_getenv ("CAIRO_DOCK_LOG_FORMAT");
+	if (cFormat != NULL && strcmp (cFormat, "json") == 0)
+		cd_log_set_json_output (TRUE);
+	const gchar *cFilters = g_getenv ("CAIRO_DOCK_LOG_FILTERS");
+	if (cFilters != NULL)
+		_set_filters_from_string (cFilters);
 }
 
 void cd_log_set_level (GLogLevelFlags loglevel)
 {
+	G_LOCK (s_Filters);
 	s_gLogLevel = loglevel;
+	_update_max_level ();
+	G_UNLOCK (s_Filters);
 }
 
 void cd_log_set_level_from_name (const gchar *cVerbosity)
 {
-	if (!cVerbosity)
-		cd_log_set_level(G_LOG_LEVEL_WARNING);
-	else if (!strcmp(cVerbosity, "debug"))
-		cd_log_set_level(G_LOG_LEVEL_DEBUG);
-	else if (!strcmp(cVerbosity, "message"))
-		cd_log_set_level(G_LOG_LEVEL_MESSAGE);
-	else if (!strcmp(cVerbosity, "warning"))
-		cd_log_set_level(G_LOG_LEVEL_WARNING);
-	else if (!strcmp(cVerbosity, "critical"))
-		cd_log_set_level(G_LOG_LEVEL_CRITICAL);
-	else if (!strcmp(cVerbosity, "error"))
-		cd_log_set_level(G_LOG_LEVEL_ERROR);
+	GLogLevelFlags iLevel = (cVerbosity ? _get_level_from_name (cVerbosity) : G_LOG_LEVEL_WARNING);
+	if (iLevel != 0)
+		cd_log_set_level (iLevel);
 	else {
 		cd_log_set_level(G_LOG_LEVEL_WARNING);
 		cd_warning("bad verbosity option: default to warning");
@@ -165,3 +534,8 @@ void cd_log_force_use_color (void)
 {
 	bForceColors = TRUE;
 }
+
+void cd_log_set_json_output (gboolean bJson)
+{
+	s_bJsonOutput = bJson;
+}
@@ -31,8 +31,16 @@
 G_BEGIN_DECLS
 
 /*
- * internal function
+ * internal functions
  */
+void cd_log_location_full (const gchar *cDomain,
+	const GLogLevelFlags loglevel,
+	const char *file,
+	const char *func,
+	const int line,
+	const char *format,
+	...);
+
 void cd_log_location(const GLogLevelFlags loglevel,
                      const char *file,
                      const char *func,
@@ -40,8 +48,16 @@ void cd_log_location(const GLogLevelFlags loglevel,
                      const char *format,
                      ...);
 
+/// Most verbose level currently enabled, either globally or by a filter. Only used by the log macros, to discard a message with a single test.
+extern gint g_iCdLogMaxLevel;
+
+#define _cd_log(loglevel, ...) do {\
+	if (G_UNLIKELY ((gint)(loglevel) <= g_iCdLogMaxLevel))\
+		cd_log_location_full (G_LOG_DOMAIN, loglevel, __FILE__, __PRETTY_FUNCTION__, __LINE__, __VA_ARGS__); } while (0)
+
 /**
- * Initialize the log system.
+ * Initialize the log system. The environment variables CAIRO_DOCK_LOG_FORMAT=json and CAIRO_DOCK_LOG_FILTERS="name=level,..." are read here (see \ref cd_log_set_json_output and \ref cd_log_set_filter).
+ * Messages, infos and debug messages are formatted by the caller and written by a separate thread, so that a slow output (a pipe, a journal) doesn't stall the dock; warnings and errors are written immediately, after any pending message.
  */
 void cd_log_init(gboolean bBlackTerminal);
 
@@ -60,36 +76,47 @@ void cd_log_set_level_from_name (const gchar *cVerbosity);
  */
 void cd_log_force_use_color (void);
 
+/** Set a verbosity level for a given source file or log domain, overriding the global level for the messages it emits. A file's filter wins over a domain's one.
+*@param cName name of the file (without its path, ex.: "cairo-dock-dock-factory.c") or of the log domain.
+*@param loglevel the level, or 0 to remove the filter.
+*/
+void cd_log_set_filter (const gchar *cName, GLogLevelFlags loglevel);
+
+/** Output the messages as JSON objects, one per line (with the fields ts, level, domain, file, func, line, thread and msg), instead of the human-readable format.
+*@param bJson TRUE to use JSON.
+*/
+void cd_log_set_json_output (gboolean bJson);
+
 
 /* Write an error message on the terminal. Error messages are used to indicate the cause of the program stop.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_error(...)                                                  \
-  cd_log_location(G_LOG_LEVEL_ERROR, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log(G_LOG_LEVEL_ERROR, __VA_ARGS__)
 
 /* Write a critical message on the terminal. Critical messages should be as clear as possible to be useful for end-users.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_critical(...)                                               \
-  cd_log_location(G_LOG_LEVEL_CRITICAL, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log(G_LOG_LEVEL_CRITICAL, __VA_ARGS__)
 
 /* Write a warning message on the terminal. Warnings should be as clear as possible to be useful for end-users.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_warning(...)                                                \
-  cd_log_location(G_LOG_LEVEL_WARNING, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log(G_LOG_LEVEL_WARNING, __VA_ARGS__)
 
 /* Write a message on the terminal. Messages are used to trace the sequence of functions, and may be used by users for a quick debug.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_message(...)                                                \
-  cd_log_location(G_LOG_LEVEL_MESSAGE, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log(G_LOG_LEVEL_MESSAGE, __VA_ARGS__)
 
 /* Write a debug message on the terminal. Debug message are only useful for developpers.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_debug(...)                                                  \
-  cd_log_location(G_LOG_LEVEL_DEBUG, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log(G_LOG_LEVEL_DEBUG, __VA_ARGS__)
 
 G_END_DECLS
 #endif 	    /* !CAIRO_DOCK_LOG_H_ */
@@ -23,6 +23,7 @@
 #include "cairo-dock-log.h"
 #include "cairo-dock-module-manager.h"  // GldiVisitCard (for gldi_extend_manager)
 #include "cairo-dock-keyfile-utilities.h"
+#include "cairo-dock-container.h"  // gldi_container_invalidate_menu
 #define __MANAGER_DEF__
 #include "cairo-dock-manager.h"
 
@@ -238,6 +239,8 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReloadConf, GKeyFile
 	
 	_gldi_manager_reload_from_keyfile (pManager, pKeyFile);
 	
+	gldi_container_invalidate_menu ();  // the core items of the menu depend on the global config.
+	
 	return pKeyFile;
 }
 
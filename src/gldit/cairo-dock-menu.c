@@ -26,6 +26,7 @@
 #include "gtk3imagemenuitem.h"
 #endif
 
+#include "gldi-config.h"  // GLDI_SHARE_DATA_DIR
 #include "cairo-dock-container.h"
 #include "cairo-dock-icon-factory.h"
 #include "cairo-dock-icon-facility.h"  // cairo_dock_get_icon_container
@@ -587,6 +588,14 @@ static void _place_menu_on_icon (GtkMenu *menu, gint *x, gint *y, gboolean *push
 	pParams->iAimedY = iAimedY;
 }
 
+static gboolean s_bUpdatingItems = FALSE;  // TRUE while the volatile items of a menu are being updated
+
+static void _on_menu_item_activated (G_GNUC_UNUSED GtkMenuItem *pMenuItem, G_GNUC_UNUSED gpointer data)
+{
+	if (! s_bUpdatingItems)  // (un)checking an item activates it.
+		gldi_container_invalidate_menu ();  // an action has been done, what the menu shows may not be true anymore.
+}
+
 static void _init_menu_item (GtkWidget *pMenuItem)
 {
 	GtkWidget *pSubMenu = gtk_menu_item_get_submenu (GTK_MENU_ITEM (pMenuItem));
@@ -600,6 +609,10 @@ static void _init_menu_item (GtkWidget *pMenuItem)
 			"draw",
 			G_CALLBACK (_draw_menu_item),
 			NULL);
+		g_signal_connect (G_OBJECT (pMenuItem),
+			"activate",
+			G_CALLBACK (_on_menu_item_activated),
+			NULL);
 		
 		gtk_style_context_add_class (gtk_widget_get_style_context (pMenuItem), "gldimenuitem");
 		
@@ -723,6 +736,48 @@ static gboolean _draw_menu_item (GtkWidget *widget,
 	return TRUE;  // intercept
 }
 
+#define CD_MENU_IMAGE_CACHE_MAX 128
+static GHashTable *s_pMenuImages = NULL;  // "size:path" -> pixbuf (NULL if the file couldn't be loaded)
+
+static void _unref_menu_image (GdkPixbuf *pixbuf)
+{
+	if (pixbuf)
+		g_object_unref (pixbuf);
+}
+
+GdkPixbuf *gldi_menu_get_image_pixbuf (const gchar *cImagePath, int iSize)
+{
+	g_return_val_if_fail (cImagePath != NULL, NULL);
+	// the same applet/launcher images are loaded each time a menu is built; the installed ones don't change while the dock is running, so keep them decoded until the theme is reloaded.
+	if (! g_str_has_prefix (cImagePath, GLDI_SHARE_DATA_DIR"/"))  // any other file may be modified at any time (a cover, a user icon, ...).
+		return gdk_pixbuf_new_from_file_at_size (cImagePath, iSize, iSize, NULL);
+	
+	gchar *cKey = g_strdup_printf ("%d:%s", iSize, cImagePath);
+	GdkPixbuf *pixbuf = NULL;
+	if (s_pMenuImages != NULL && g_hash_table_lookup_extended (s_pMenuImages, cKey, NULL, (gpointer*)&pixbuf))
+	{
+		g_free (cKey);
+	}
+	else
+	{
+		if (s_pMenuImages == NULL)
+			s_pMenuImages = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_unref_menu_image);
+		else if (g_hash_table_size (s_pMenuImages) >= CD_MENU_IMAGE_CACHE_MAX)  // too many different images, start again from scratch.
+			g_hash_table_remove_all (s_pMenuImages);
+		
+		pixbuf = gdk_pixbuf_new_from_file_at_size (cImagePath, iSize, iSize, NULL);
+		g_hash_table_insert (s_pMenuImages, cKey, pixbuf);  // takes the key
+	}
+	
+	return (pixbuf ? g_object_ref (pixbuf) : NULL);
+}
+
+void gldi_menu_clear_image_cache (void)
+{
+	if (s_pMenuImages)
+		g_hash_table_remove_all (s_pMenuImages);
+}
+
 GtkWidget *gldi_menu_item_new_full (const gchar *cLabel, const gchar *cImage, gboolean bUseMnemonic, GtkIconSize iSize)
 {
 	if (iSize == 0)
@@ -744,7 +799,7 @@ GtkWidget *gldi_menu_item_new_full (const gchar *cLabel, const gchar *cImage, gb
 		{
 			int size;
 			gtk_icon_size_lookup (iSize, &size, NULL);
-			GdkPixbuf *pixbuf = gdk_pixbuf_new_from_file_at_size (cImage, size, size, NULL);
+			GdkPixbuf *pixbuf = gldi_menu_get_image_pixbuf (cImage, size);
 			if (pixbuf)
 			{
 				image = gtk_image_new_from_pixbuf (pixbuf);
@@ -862,6 +917,30 @@ void gldi_menu_add_separator (GtkWidget *pMenu)
 	_init_menu_item (pMenuItem);
 }
 
+void gldi_menu_item_set_update_func (GtkWidget *pMenuItem, GldiMenuItemUpdateFunc pUpdateFunc, gpointer data)
+{
+	g_object_set_data (G_OBJECT (pMenuItem), "gldi-update-func", pUpdateFunc);
+	g_object_set_data (G_OBJECT (pMenuItem), "gldi-update-data", data);
+}
+
+static void _update_menu_item (GtkWidget *pMenuItem, G_GNUC_UNUSED gpointer data)
+{
+	GldiMenuItemUpdateFunc pUpdateFunc = g_object_get_data (G_OBJECT (pMenuItem), "gldi-update-func");
+	if (pUpdateFunc != NULL)
+		pUpdateFunc (pMenuItem, g_object_get_data (G_OBJECT (pMenuItem), "gldi-update-data"));
+	
+	GtkWidget *pSubMenu = (GTK_IS_MENU_ITEM (pMenuItem) ? gtk_menu_item_get_submenu (GTK_MENU_ITEM (pMenuItem)) : NULL);
+	if (pSubMenu != NULL)
+		gtk_container_foreach (GTK_CONTAINER (pSubMenu), (GtkCallback) _update_menu_item, NULL);
+}
+
+void gldi_menu_update_items (GtkWidget *pMenu)
+{
+	s_bUpdatingItems = TRUE;
+	gtk_container_foreach (GTK_CONTAINER (pMenu), (GtkCallback) _update_menu_item, NULL);
+	s_bUpdatingItems = FALSE;
+}
+
 gboolean GLDI_IS_IMAGE_MENU_ITEM (GtkWidget *pMenuItem)  // defined as a function to not export gtk3imagemenuitem.h
 {
 	#if GTK_CHECK_VERSION (3, 10, 0)
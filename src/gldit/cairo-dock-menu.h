@@ -70,6 +70,17 @@ void gldi_menu_init (GtkWidget *pMenu, Icon *pIcon);
 void gldi_menu_popup (GtkWidget *menu);
 
 
+/** Get the pixbuf of an image file, to be used in a menu. Installed images (of the dock and its plug-ins) are kept in memory between 2 menus without checking the file again, until \ref gldi_menu_clear_image_cache is called (when the theme is loaded); other files are loaded each time.
+ * @param cImagePath path of the image
+ * @param iSize size of the image, in pixels
+ * @return a new reference on the pixbuf, or NULL if the file couldn't be loaded. Unref it when you're done.
+ */
+GdkPixbuf *gldi_menu_get_image_pixbuf (const gchar *cImagePath, int iSize);
+
+/** Forget all the images loaded by \ref gldi_menu_get_image_pixbuf.
+ */
+void gldi_menu_clear_image_cache (void);
+
 /** Creates a menu-item, with a label and an image. The child widget of the menu-item is a gtk-label.
  * If the label is NULL, the child widget will be NULL too (this is useful if the menu-item will hold a custom widget).
  * @param cLabel the label, or NULL
@@ -152,6 +163,21 @@ GtkWidget *gldi_menu_add_sub_menu_full (GtkWidget *pMenu, const gchar *cLabel, c
  */
 void gldi_menu_add_separator (GtkWidget *pMenu);
 
+/// Function that brings a menu-item up-to-date with the current state, when its menu is shown again.
+typedef void (*GldiMenuItemUpdateFunc) (GtkWidget *pMenuItem, gpointer data);
+
+/** Mark a menu-item as volatile: when the menu is kept and shown again, the function is called to update it, instead of building the whole menu again. Typically used for check-items.
+ * @param pMenuItem the menu-item
+ * @param pUpdateFunc function called to update the item
+ * @param data data passed to the function
+ */
+void gldi_menu_item_set_update_func (GtkWidget *pMenuItem, GldiMenuItemUpdateFunc pUpdateFunc, gpointer data);
+
+/** Update the volatile items of a menu and its sub-menus (see \ref gldi_menu_item_set_update_func).
+ * @param pMenu the menu
+ */
+void gldi_menu_update_items (GtkWidget *pMenu);
+
 gboolean GLDI_IS_IMAGE_MENU_ITEM (GtkWidget *pMenuItem);
 
 G_END_DECLS
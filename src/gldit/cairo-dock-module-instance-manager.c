@@ -45,6 +45,7 @@ extern CairoDock *g_pMainDock;
 extern gchar *g_cCurrentThemePath;
 
 // private
+static GHashTable *s_pMenuCachedInstances = NULL;  // instances whose menu can be kept (see gldi_module_instance_set_menu_cached)
 static int s_iNbUsedSlots = 0;
 static GldiModuleInstance *s_pUsedSlots[CAIRO_DOCK_NB_DATA_SLOT+1];
 
@@ -367,6 +368,35 @@ void gldi_module_instance_release_data_slot (GldiModuleInstance *pInstance)
 }
 
 
+void gldi_module_instance_set_menu_cached (GldiModuleInstance *pInstance, gboolean bCached)
+{
+	g_return_if_fail (pInstance != NULL);
+	if (bCached)
+	{
+		if (s_pMenuCachedInstances == NULL)
+			s_pMenuCachedInstances = g_hash_table_new (NULL, NULL);
+		g_hash_table_add (s_pMenuCachedInstances, pInstance);
+	}
+	else
+	{
+		if (s_pMenuCachedInstances != NULL)
+			g_hash_table_remove (s_pMenuCachedInstances, pInstance);
+		gldi_module_instance_menu_changed (pInstance);
+	}
+}
+
+gboolean gldi_module_instance_menu_is_cached (GldiModuleInstance *pInstance)
+{
+	return (s_pMenuCachedInstances != NULL && g_hash_table_contains (s_pMenuCachedInstances, pInstance));
+}
+
+void gldi_module_instance_menu_changed (GldiModuleInstance *pInstance)
+{
+	g_return_if_fail (pInstance != NULL);
+	gldi_object_notify (pInstance, NOTIFICATION_MODULE_INSTANCE_MENU_CHANGED, pInstance);
+}
+
+
   ///////////////
  /// MANAGER ///
 ///////////////
@@ -507,6 +537,9 @@ static void reset_object (GldiObject *obj)
 	
 	gldi_module_instance_release_data_slot (pInstance);
 	
+	if (s_pMenuCachedInstances != NULL)
+		g_hash_table_remove (s_pMenuCachedInstances, pInstance);
+	
 	g_free (pInstance->cConfFilePath);
 	
 	// remove from the module
@@ -556,6 +589,8 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReadConfig, GKeyFile
 	GldiModule *module = pInstance->pModule;
 	cd_message ("%s (%s, %d)", __func__, module->pVisitCard->cModuleName, bReadConfig);
 	
+	gldi_module_instance_menu_changed (pInstance);  // its items may depend on its config and its container.
+	
 	GldiContainer *pCurrentContainer = pInstance->pContainer;
 	pInstance->pContainer = NULL;
 	CairoDock *pCurrentDock = pInstance->pDock;
@@ -629,6 +664,7 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReadConfig, GKeyFile
 			else if (pCurrentDesklet != NULL && ! pMinimalConfig->bIsDetached)  // was in a desklet, now is in a dock
 			{
 				pCurrentDesklet->pIcon = NULL;
+				gldi_desklet_forget_picked_icon (pCurrentDesklet);
 				cairo_dock_set_icon_container (pIcon, NULL);
 			}
 			
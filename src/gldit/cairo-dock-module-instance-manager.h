@@ -43,6 +43,8 @@ extern GldiObjectManager myModuleInstanceObjectMgr;
 // signals
 typedef enum {
 	NOTIFICATION_MODULE_INSTANCE_DETACHED = NB_NOTIFICATIONS_OBJECT,
+	/// notification called when the items an instance adds in the menu have changed, so that a menu kept for its icons is built again. data : the instance
+	NOTIFICATION_MODULE_INSTANCE_MENU_CHANGED,
 	NB_NOTIFICATIONS_MODULE_INSTANCES
 	} GldiModuleInstancesNotifications;
 
@@ -106,6 +108,23 @@ void gldi_module_instance_popup_description (GldiModuleInstance *pModuleInstance
 gboolean gldi_module_instance_reserve_data_slot (GldiModuleInstance *pInstance);
 void gldi_module_instance_release_data_slot (GldiModuleInstance *pInstance);
 
+/** Let the menu built on the icons of an instance be kept and shown again on the next right-click, instead of being built each time. An instance that enables it must call \ref gldi_module_instance_menu_changed as soon as one of its items is not up-to-date anymore. It's disabled by default, because the items of an applet can depend on its state.
+*@param pInstance the instance
+*@param bCached TRUE to keep its menu
+*/
+void gldi_module_instance_set_menu_cached (GldiModuleInstance *pInstance, gboolean bCached);
+
+/** Say if the menu built on the icons of an instance can be kept.
+*@param pInstance the instance
+*@return TRUE if the instance has enabled it with \ref gldi_module_instance_set_menu_cached
+*/
+gboolean gldi_module_instance_menu_is_cached (GldiModuleInstance *pInstance);
+
+/** Tell that the items an instance adds in the menu have changed. The menu that may have been kept for its icons will be built again.
+*@param pInstance the instance
+*/
+void gldi_module_instance_menu_changed (GldiModuleInstance *pInstance);
+
 #define gldi_module_instance_get_icon_data(pIcon, pInstance) ((pIcon)->pDataSlot[pInstance->iSlotID])
 #define gldi_module_instance_get_container_data(pContainer, pInstance) ((pContainer)->pDataSlot[pInstance->iSlotID])
 
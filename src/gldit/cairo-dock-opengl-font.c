@@ -254,6 +254,252 @@ CairoDockGLFont *cairo_dock_load_textured_font_from_image (const gchar *cImagePa
 	return pFont;
 }
 
+  //////////////////
+ /// GLYPH ATLAS ///
+//////////////////
+
+#define ATLAS_TEXTURE_SIZE 512
+#define ATLAS_GLYPH_PADDING 1  // transparent border around each glyph, so that the linear filtering doesn't take the neighbours.
+
+typedef struct {
+	gint x, y;  // position of the cell in the texture
+	gint iWidth, iHeight;  // size of the cell, padding included
+	gint iAdvance;  // horizontal advance of the glyph
+	} CairoDockGLGlyph;
+
+struct _CairoDockGLGlyphAtlas {
+	PangoFontDescription *pDesc;
+	GHashTable *pGlyphs;  // gunichar -> CairoDockGLGlyph
+	gint iLineHeight;
+	gint x, y, iRowHeight;  // where to put the next glyph (the texture is filled row by row)
+	};
+
+static void _clear_atlas (CairoDockGLFont *pFont)
+{
+	CairoDockGLGlyphAtlas *pAtlas = pFont->pAtlas;
+	g_hash_table_remove_all (pAtlas->pGlyphs);
+	pAtlas->x = pAtlas->y = pAtlas->iRowHeight = 0;
+	
+	guchar *pBlank = g_new0 (guchar, ATLAS_TEXTURE_SIZE * ATLAS_TEXTURE_SIZE * 4);
+	glBindTexture (GL_TEXTURE_2D, pFont->iTexture);
+	glTexImage2D (GL_TEXTURE_2D, 0, 4, ATLAS_TEXTURE_SIZE, ATLAS_TEXTURE_SIZE, 0, GL_BGRA, GL_UNSIGNED_BYTE, pBlank);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	g_free (pBlank);
+}
+
+static PangoLayout *_create_atlas_layout (CairoDockGLGlyphAtlas *pAtlas, cairo_t *ctx)
+{
+	PangoLayout *pLayout = pango_cairo_create_layout (ctx);
+	pango_layout_set_font_description (pLayout, pAtlas->pDesc);
+	return pLayout;
+}
+
+// render a glyph into the atlas texture; this is the only upload, done once per character.
+static CairoDockGLGlyph *_add_glyph (CairoDockGLFont *pFont, gunichar c)
+{
+	CairoDockGLGlyphAtlas *pAtlas = pFont->pAtlas;
+	gchar utf8[8];
+	utf8[g_unichar_to_utf8 (c, utf8)] = '\0';
+	
+	//\_________________ measure the glyph.
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *ctx = cairo_create (pSurface);
+	PangoLayout *pLayout = _create_atlas_layout (pAtlas, ctx);
+	pango_layout_set_text (pLayout, utf8, -1);
+	PangoRectangle log;
+	pango_layout_get_pixel_extents (pLayout, NULL, &log);
+	g_object_unref (pLayout);
+	cairo_destroy (ctx);
+	cairo_surface_destroy (pSurface);
+	
+	int w = log.width + 2 * ATLAS_GLYPH_PADDING;
+	int h = pAtlas->iLineHeight + 2 * ATLAS_GLYPH_PADDING;
+	if (w > ATLAS_TEXTURE_SIZE || h > ATLAS_TEXTURE_SIZE)
+		return NULL;
+	
+	//\_________________ find a place in the texture.
+	if (pAtlas->x + w > ATLAS_TEXTURE_SIZE)  // next row
+	{
+		pAtlas->x = 0;
+		pAtlas->y += pAtlas->iRowHeight;
+		pAtlas->iRowHeight = 0;
+	}
+	if (pAtlas->y + h > ATLAS_TEXTURE_SIZE)  // the atlas is full
+		return NULL;
+	
+	//\_________________ draw the glyph in white, so that it can be colorized with a mere glColor.
+	pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, w, h);
+	ctx = cairo_create (pSurface);
+	pLayout = _create_atlas_layout (pAtlas, ctx);
+	pango_layout_set_text (pLayout, utf8, -1);
+	cairo_translate (ctx, ATLAS_GLYPH_PADDING - log.x, ATLAS_GLYPH_PADDING);
+	cairo_set_source_rgb (ctx, 1., 1., 1.);
+	cairo_move_to (ctx, 0, 0);
+	pango_cairo_show_layout (ctx, pLayout);
+	g_object_unref (pLayout);
+	cairo_destroy (ctx);
+	cairo_surface_flush (pSurface);
+	
+	glBindTexture (GL_TEXTURE_2D, pFont->iTexture);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pSurface) / 4);
+	glTexSubImage2D (GL_TEXTURE_2D, 0, pAtlas->x, pAtlas->y, w, h, GL_BGRA, GL_UNSIGNED_BYTE, cairo_image_surface_get_data (pSurface));
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	cairo_surface_destroy (pSurface);
+	
+	CairoDockGLGlyph *pGlyph = g_new0 (CairoDockGLGlyph, 1);
+	pGlyph->x = pAtlas->x;
+	pGlyph->y = pAtlas->y;
+	pGlyph->iWidth = w;
+	pGlyph->iHeight = h;
+	pGlyph->iAdvance = log.width;
+	g_hash_table_insert (pAtlas->pGlyphs, GUINT_TO_POINTER (c), pGlyph);
+	
+	pAtlas->x += w;
+	pAtlas->iRowHeight = MAX (pAtlas->iRowHeight, h);
+	return pGlyph;
+}
+
+// make sure all the glyphs of a text are in the atlas before drawing it, since making room in the atlas moves the glyphs already there.
+static void _prepare_glyphs (CairoDockGLFont *pFont, const gchar *cText, gboolean bCanClear)
+{
+	CairoDockGLGlyphAtlas *pAtlas = pFont->pAtlas;
+	const gchar *str;
+	gunichar c;
+	for (str = cText; *str != '\0'; str = g_utf8_next_char (str))
+	{
+		c = g_utf8_get_char (str);
+		if (c == '\n' || g_hash_table_lookup (pAtlas->pGlyphs, GUINT_TO_POINTER (c)) != NULL)
+			continue;
+		if (_add_glyph (pFont, c) == NULL && bCanClear)  // no more room: start again from an empty atlas, once (a single text can't fill it).
+		{
+			cd_debug ("glyph atlas is full, clear it");
+			_clear_atlas (pFont);
+			_prepare_glyphs (pFont, cText, FALSE);
+			return;
+		}
+	}
+}
+
+CairoDockGLFont *cairo_dock_load_atlas_font (const gchar *cFontDescription)
+{
+	g_return_val_if_fail (cFontDescription != NULL, NULL);
+	
+	CairoDockGLGlyphAtlas *pAtlas = g_new0 (CairoDockGLGlyphAtlas, 1);
+	pAtlas->pDesc = pango_font_description_from_string (cFontDescription);
+	pAtlas->pGlyphs = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+	
+	// all the glyphs have the height of a line, so that they are aligned on the same baseline.
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *ctx = cairo_create (pSurface);
+	PangoLayout *pLayout = _create_atlas_layout (pAtlas, ctx);
+	pango_layout_set_text (pLayout, "0", -1);
+	PangoRectangle log;
+	pango_layout_get_pixel_extents (pLayout, NULL, &log);
+	g_object_unref (pLayout);
+	cairo_destroy (ctx);
+	cairo_surface_destroy (pSurface);
+	pAtlas->iLineHeight = log.height;
+	
+	CairoDockGLFont *pFont = g_new0 (CairoDockGLFont, 1);
+	pFont->pAtlas = pAtlas;
+	pFont->iCharWidth = log.width;  // only meaningful for a mono font; the real extent of a text is given by the glyphs.
+	pFont->iCharHeight = log.height;
+	
+	glGenTextures (1, &pFont->iTexture);
+	glBindTexture (GL_TEXTURE_2D, pFont->iTexture);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	_clear_atlas (pFont);
+	
+	return pFont;
+}
+
+static void _free_atlas (CairoDockGLGlyphAtlas *pAtlas)
+{
+	pango_font_description_free (pAtlas->pDesc);
+	g_hash_table_destroy (pAtlas->pGlyphs);
+	g_free (pAtlas);
+}
+
+static void _get_atlas_text_extent (const gchar *cText, CairoDockGLFont *pFont, int *iWidth, int *iHeight)
+{
+	_prepare_glyphs (pFont, cText, TRUE);
+	CairoDockGLGlyphAtlas *pAtlas = pFont->pAtlas;
+	CairoDockGLGlyph *pGlyph;
+	int w=0, wmax=0, h=pAtlas->iLineHeight;
+	const gchar *str;
+	gunichar c;
+	for (str = cText; *str != '\0'; str = g_utf8_next_char (str))
+	{
+		c = g_utf8_get_char (str);
+		if (c == '\n')
+		{
+			h += pAtlas->iLineHeight + 1;
+			wmax = MAX (wmax, w);
+			w = 0;
+			continue;
+		}
+		pGlyph = g_hash_table_lookup (pAtlas->pGlyphs, GUINT_TO_POINTER (c));
+		if (pGlyph)
+			w += pGlyph->iAdvance;
+	}
+	*iWidth = MAX (wmax, w);
+	*iHeight = h;
+}
+
+static void _draw_atlas_text (const gchar *cText, CairoDockGLFont *pFont)
+{
+	_prepare_glyphs (pFont, cText, TRUE);
+	CairoDockGLGlyphAtlas *pAtlas = pFont->pAtlas;
+	
+	_cairo_dock_enable_texture ();
+	_cairo_dock_set_blend_pbuffer ();  // rend mieux pour les textes
+	glBindTexture (GL_TEXTURE_2D, pFont->iTexture);
+	
+	// all the glyphs in one go.
+	CairoDockGLGlyph *pGlyph;
+	double f = 1. / ATLAS_TEXTURE_SIZE;
+	double u, v, du, dv, x0, x1, y0, y1;
+	double x = 0, y = 0;  // bottom left corner of the current glyph, padding excluded
+	const gchar *str;
+	gunichar c;
+	glBegin (GL_QUADS);
+	for (str = cText; *str != '\0'; str = g_utf8_next_char (str))
+	{
+		c = g_utf8_get_char (str);
+		if (c == '\n')
+		{
+			x = 0;
+			y += pAtlas->iLineHeight + 1;
+			continue;
+		}
+		pGlyph = g_hash_table_lookup (pAtlas->pGlyphs, GUINT_TO_POINTER (c));
+		if (pGlyph == NULL)
+			continue;
+		
+		u = pGlyph->x * f;
+		v = pGlyph->y * f;
+		du = pGlyph->iWidth * f;
+		dv = pGlyph->iHeight * f;
+		x0 = x - ATLAS_GLYPH_PADDING;
+		x1 = x0 + pGlyph->iWidth;
+		y0 = y - ATLAS_GLYPH_PADDING;
+		y1 = y0 + pGlyph->iHeight;
+		glTexCoord2f (u, v); glVertex3f (x0, y1, 0.);
+		glTexCoord2f (u+du, v); glVertex3f (x1, y1, 0.);
+		glTexCoord2f (u+du, v+dv); glVertex3f (x1, y0, 0.);
+		glTexCoord2f (u, v+dv); glVertex3f (x0, y0, 0.);
+		
+		x += pGlyph->iAdvance;
+	}
+	glEnd ();
+	
+	_cairo_dock_disable_texture ();
+}
+
+
 void cairo_dock_free_gl_font (CairoDockGLFont *pFont)
 {
 	if (pFont == NULL)
@@ -262,6 +508,8 @@ void cairo_dock_free_gl_font (CairoDockGLFont *pFont)
 		glDeleteLists (pFont->iListBase, pFont->iNbChars);
 	if (pFont->iTexture != 0)
 		_cairo_dock_delete_texture (pFont->iTexture);
+	if (pFont->pAtlas != NULL)
+		_free_atlas (pFont->pAtlas);
 	g_free (pFont);
 }
 
@@ -274,6 +522,11 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 		*iHeight = 0;
 		return ;
 	}
+	if (pFont->pAtlas != NULL)
+	{
+		_get_atlas_text_extent (cText, pFont, iWidth, iHeight);
+		return ;
+	}
 	int i, w=0, wmax=0, h=pFont->iCharHeight;
 	for (i = 0; cText[i] != '\0'; i ++)
 	{
@@ -295,7 +548,11 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 void cairo_dock_draw_gl_text (const guchar *cText, CairoDockGLFont *pFont)
 {
 	int n = strlen ((char *) cText);
-	if (pFont->iListBase != 0)
+	if (pFont->pAtlas != NULL)
+	{
+		_draw_atlas_text ((const gchar *) cText, pFont);
+	}
+	else if (pFont->iListBase != 0)
 	{
 		if (pFont->iCharBase == 0 && strchr ((char *) cText, '\n') == NULL)  // version optimisee ou on a charge tous les caracteres.
 		{
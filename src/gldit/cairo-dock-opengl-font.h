@@ -34,6 +34,7 @@ G_BEGIN_DECLS
 * \ref cairo_dock_create_texture_from_text_simple lets you draw any text in any font, by creating a texture from a Pango font description. This is a convenient function but not very fast.
 * For a more efficient way, you load a font into a CairoDockGLFont with either :
 * \ref cairo_dock_load_textured_font to load a subset of a Mono font into textures.
+* \ref cairo_dock_load_atlas_font to load any font, whose glyphs are rendered on demand into a shared texture.
 * You then use \ref cairo_dock_draw_gl_text_at_position to draw the text.
 */
 
@@ -47,6 +48,8 @@ G_BEGIN_DECLS
 */
 GLuint cairo_dock_create_texture_from_text_simple (const gchar *cText, const gchar *cFontDescription, cairo_t* pSourceContext, int *iWidth, int *iHeight);
 
+typedef struct _CairoDockGLGlyphAtlas CairoDockGLGlyphAtlas;
+
 /// Structure used to load a font for OpenGL text rendering.
 struct _CairoDockGLFont {
 	GLuint iListBase;
@@ -57,6 +60,8 @@ struct _CairoDockGLFont {
 	gint iNbChars;
 	gdouble iCharWidth;
 	gdouble iCharHeight;
+	/// glyphs rendered so far, in the case of an atlas font (see \ref cairo_dock_load_atlas_font).
+	CairoDockGLGlyphAtlas *pAtlas;
 };
 
 /* Load a font into bitmaps. You can load any characters of font with this function. The drawback is that each character is a bitmap, that is to say you can't zoom them.
@@ -81,6 +86,12 @@ CairoDockGLFont *cairo_dock_load_textured_font (const gchar *cFontDescription, i
 */
 CairoDockGLFont *cairo_dock_load_textured_font_from_image (const gchar *cImagePath);
 
+/** Load a font into a glyph atlas. Each character is rendered with Pango the first time it is drawn, into a texture shared by all the characters; texts are then drawn as a batch of quads. Any font and any character can be used, and once its glyphs are known, drawing a new text doesn't upload anything to the graphic card. The glyphs are placed one after the other, so there is no kerning nor ligatures.
+*@param cFontDescription a description of the font, for instance "Sans Bold 12"
+*@return a newly allocated opengl font.
+*/
+CairoDockGLFont *cairo_dock_load_atlas_font (const gchar *cFontDescription);
+
 /** Free an opengl font.
 *@param pFont the font.
 */
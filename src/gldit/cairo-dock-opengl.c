@@ -26,6 +26,7 @@
 #include "cairo-dock-icon-facility.h"  // cairo_dock_get_icon_extent
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-desktop-manager.h"  // desktop dimensions
+#include "cairo-dock-container.h"  // gldi_container_get_desktop_bg_texture
 
 #include "cairo-dock-opengl.h"
 
@@ -34,7 +35,6 @@ CairoDockGLConfig g_openglConfig;
 gboolean g_bUseOpenGL = FALSE;
 
 // dependencies
-extern GldiDesktopBackground *g_pFakeTransparencyDesktopBg;
 extern gboolean g_bEasterEggs;
 
 // private
@@ -156,11 +156,8 @@ gboolean gldi_gl_container_make_current (GldiContainer *pContainer)
 	return FALSE;
 }
 
-static void _apply_desktop_background (GldiContainer *pContainer)
+static void _apply_desktop_background (GldiContainer *pContainer, GLuint iBgTexture)  // the texture is the part of the wallpaper behind the container; it covers it entirely, so it also replaces the previous content (no need to clear the color buffer beforehand).
 {
-	if (! g_pFakeTransparencyDesktopBg || g_pFakeTransparencyDesktopBg->iTexture == 0)
-		return ;
-	
 	glPushMatrix ();
 	gboolean bSetPerspective = pContainer->bPerspectiveView;
 	if (bSetPerspective)
@@ -169,37 +166,31 @@ static void _apply_desktop_background (GldiContainer *pContainer)
 	_cairo_dock_enable_texture ();
 	_cairo_dock_set_blend_source ();
 	_cairo_dock_set_alpha (1.);
-	glBindTexture (GL_TEXTURE_2D, g_pFakeTransparencyDesktopBg->iTexture);
+	glBindTexture (GL_TEXTURE_2D, iBgTexture);
 	
-	double x, y, w, h, W, H;
-	W = gldi_desktop_get_width();
-	H = gldi_desktop_get_height();
+	double w, h;
 	if (pContainer->bIsHorizontal)
 	{
 		w = pContainer->iWidth;
 		h = pContainer->iHeight;
-		x = pContainer->iWindowPositionX;
-		y = pContainer->iWindowPositionY;
 	}
 	else
 	{
 		h = pContainer->iWidth;
 		w = pContainer->iHeight;
-		y = pContainer->iWindowPositionX;
-		x = pContainer->iWindowPositionY;
 	}
 	
 	glBegin(GL_QUADS);
-	glTexCoord2f ((x + 0) / W, (y + 0) / H);
+	glTexCoord2f (0., 0.);
 	glVertex3f (0., h, 0.);  // Top Left.
 	
-	glTexCoord2f ((x + w) / W, (y + 0) / H);
+	glTexCoord2f (1., 0.);
 	glVertex3f (w, h, 0.);  // Top Right
 	
-	glTexCoord2f ((x + w) / W, (y + h) / H);
+	glTexCoord2f (1., 1.);
 	glVertex3f (w, 0., 0.);  // Bottom Right
 	
-	glTexCoord2f ((x + 0.) / W, (y + h) / H);
+	glTexCoord2f (0., 1.);
 	glVertex3f (0., 0., 0.);  // Bottom Left
 	glEnd();
 	
@@ -228,8 +219,14 @@ gboolean gldi_gl_container_begin_draw_full (GldiContainer *pContainer, GdkRectan
 	
 	if (bClear)
 	{
-		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-		_apply_desktop_background (pContainer);
+		GLuint iBgTexture = gldi_container_get_desktop_bg_texture (pContainer);  // only without composite
+		if (iBgTexture != 0)  // clear and draw the background in a single pass.
+		{
+			glClear (GL_DEPTH_BUFFER_BIT);
+			_apply_desktop_background (pContainer, iBgTexture);
+		}
+		else
+			glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 	
 	return TRUE;
@@ -27,6 +27,7 @@
 #include "cairo-dock-draw.h"
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-image-buffer.h"
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_blank_surface
 #include "cairo-dock-log.h"
 #define _MANAGER_DEF_
 #include "cairo-dock-overlay.h"
@@ -39,6 +40,15 @@ extern gboolean g_bUseOpenGL;
 
 // private
 #define CD_DEFAULT_SCALE 0.5
+typedef struct {
+	CairoDockImageBuffer image;  // the static overlays, drawn at the icon's rest size, exactly where they would be drawn one by one.
+	gint iWidth, iHeight;  // extent it was built for
+	gdouble fZoom;  // and zoom at rest
+	gdouble fIconWidth, fIconHeight;  // and size of the icon at rest
+	gboolean bValid;
+	} CDOverlayCache;
+
+static void _invalidate_overlay_cache (Icon *pIcon);
 
 
 CairoOverlay *gldi_overlay_new (CairoOverlayAttr *attr)
@@ -81,6 +91,7 @@ static inline void cairo_dock_add_overlay_to_icon (Icon *pIcon, CairoOverlay *pO
 	
 	// add the new overlay to the icon
 	pIcon->pOverlays = g_list_prepend (pIcon->pOverlays, pOverlay);
+	_invalidate_overlay_cache (pIcon);
 }
 
 CairoOverlay *cairo_dock_add_overlay_from_image (Icon *pIcon, const gchar *cImageFile, CairoOverlayPosition iPosition, gpointer data)
@@ -140,12 +151,48 @@ void cairo_dock_remove_overlay_at_position (Icon *pIcon, CairoOverlayPosition iP
 	}
 }
 
+CairoDockImageBuffer *cairo_dock_get_overlay_image_buffer (CairoOverlay *pOverlay)
+{
+	if (! pOverlay->bDynamic)  // the caller is going to draw on it, stop compositing it.
+	{
+		pOverlay->bDynamic = TRUE;
+		cairo_dock_update_overlay (pOverlay);
+	}
+	return &pOverlay->image;
+}
+
+void cairo_dock_update_overlay (CairoOverlay *pOverlay)
+{
+	if (pOverlay->pIcon != NULL && ! pOverlay->bDynamic)
+		_invalidate_overlay_cache (pOverlay->pIcon);
+}
+
+
   /////////////////////
  /// ICON OVERLAYS ///
 /////////////////////
 
+static void _invalidate_overlay_cache (Icon *pIcon)
+{
+	CDOverlayCache *pCache = pIcon->pOverlayCache;
+	if (pCache != NULL)
+		pCache->bValid = FALSE;
+}
+
+static void _free_overlay_cache (Icon *pIcon)
+{
+	CDOverlayCache *pCache = pIcon->pOverlayCache;
+	if (pCache != NULL)
+	{
+		cairo_dock_unload_image_buffer (&pCache->image);
+		g_free (pCache);
+		pIcon->pOverlayCache = NULL;
+	}
+}
+
 void cairo_dock_destroy_icon_overlays (Icon *pIcon)
 {
+	_free_overlay_cache (pIcon);
 	GList *pOverlays = pIcon->pOverlays;
 	pIcon->pOverlays = NULL;  // nullify the list to avoid unnecessary roundtrips.
 	g_list_foreach (pOverlays, (GFunc)gldi_object_unref, NULL);
@@ -206,6 +253,133 @@ static void _get_overlay_position_and_size (CairoOverlay *pOverlay, int w, int h
 		break;
 	}
 }
+static gboolean _overlay_can_be_baked (CairoOverlay *pOverlay, int w, int h)
+{
+	if (pOverlay->bDynamic || pOverlay->image.pSurface == NULL || pOverlay->image.iNbFrames != 0)
+		return FALSE;
+	double x, y;
+	int wo, ho;
+	_get_overlay_position_and_size (pOverlay, w, h, 1, &x, &y, &wo, &ho);
+	return (wo <= w && ho <= h);  // an overlay bigger than the icon would be cut.
+}
+
+// place the overlay on the grid to avoid scale blur (only when the icon is at rest, otherwise it makes the movement jerky).
+static inline void _snap_overlay_position (double *x, double *y, int wo, int ho)
+{
+	if (wo & 1)
+		*x = floor (*x) + .5;
+	else
+		*x = round (*x);
+	if (ho & 1)
+		*y = floor (*y) + .5;
+	else
+		*y = round (*y);
+}
+
+// composite the static overlays of an icon into one buffer, at the icon's rest size; it's only worth it if there are at least 2 of them.
+static void _build_overlay_cache (Icon *pIcon, CDOverlayCache *pCache, int w, int h, double z)
+{
+	cairo_dock_unload_image_buffer (&pCache->image);
+	pCache->iWidth = w;
+	pCache->iHeight = h;
+	pCache->fZoom = z;
+	pCache->fIconWidth = pIcon->fWidth;
+	pCache->fIconHeight = pIcon->fHeight;
+	pCache->bValid = TRUE;
+	
+	GList* ov;
+	CairoOverlay *p;
+	int iNbStatic = 0;
+	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
+	{
+		p = ov->data;
+		p->bBaked = FALSE;
+		if (_overlay_can_be_baked (p, w, h))
+			iNbStatic ++;
+	}
+	if (iNbStatic < 2)
+		return;
+	
+	int iWidth, iHeight;  // size of the composite
+	if (g_bUseOpenGL)  // drawn centered on the icon: an even size keeps its corner on the grid.
+	{
+		iWidth = ceil (w * z);
+		iWidth += (iWidth & 1);
+		iHeight = ceil (h * z);
+		iHeight += (iHeight & 1);
+	}
+	else  // drawn from the icon's top-left corner.
+	{
+		iWidth = ceil (pIcon->fWidth);
+		iHeight = ceil (pIcon->fHeight);
+	}
+	if (iWidth <= 0 || iHeight <= 0)
+		return;
+	cairo_surface_t *pSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	int wo, ho;
+	double x, y;
+	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)  // same order and same place as when they are drawn one by one.
+	{
+		p = ov->data;
+		if (! _overlay_can_be_baked (p, w, h))
+			continue;
+		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
+		if (g_bUseOpenGL)
+		{
+			_snap_overlay_position (&x, &y, wo, ho);
+			x = iWidth/2 + x - wo/2.;
+			y = iHeight/2 - y - ho/2.;
+		}
+		else
+		{
+			x += (pIcon->fWidth - wo) / 2.;
+			y = - y + (pIcon->fHeight - ho) / 2.;
+			_snap_overlay_position (&x, &y, wo, ho);
+		}
+		cairo_save (pCairoContext);
+		cairo_translate (pCairoContext, x, y);
+		cairo_scale (pCairoContext,
+			(double) wo / p->image.iWidth,
+			(double) ho / p->image.iHeight);
+		cairo_dock_apply_image_buffer_surface_with_offset (&p->image, pCairoContext, 0., 0., 1.);
+		cairo_restore (pCairoContext);
+		p->bBaked = TRUE;
+	}
+	cairo_destroy (pCairoContext);
+	
+	cairo_dock_load_image_buffer_from_surface (&pCache->image, pSurface, iWidth, iHeight);
+	if (g_bUseOpenGL && pCache->image.iTexture == 0)  // no texture, the overlays will be drawn one by one.
+	{
+		cd_warning ("couldn't load the overlays of %s into a texture", pIcon->cName);
+		cairo_dock_unload_image_buffer (&pCache->image);
+		for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
+		{
+			p = ov->data;
+			p->bBaked = FALSE;
+		}
+	}
+	else if (pCache->image.iTexture != 0)  // only the texture will be used.
+	{
+		cairo_surface_destroy (pCache->image.pSurface);
+		pCache->image.pSurface = NULL;
+	}
+}
+
+// the cache is only used when the icon is at rest, where it's drawn pixel for pixel; a zoomed icon draws its overlays one by one, from their full-size image.
+static CDOverlayCache *_get_overlay_cache (Icon *pIcon, int w, int h, double z)
+{
+	CDOverlayCache *pCache = pIcon->pOverlayCache;
+	if (pCache == NULL)
+	{
+		pCache = g_new0 (CDOverlayCache, 1);
+		pIcon->pOverlayCache = pCache;
+	}
+	if (! pCache->bValid || pCache->iWidth != w || pCache->iHeight != h || pCache->fZoom != z || pCache->fIconWidth != pIcon->fWidth || pCache->fIconHeight != pIcon->fHeight)
+		_build_overlay_cache (pIcon, pCache, w, h, z);
+	return pCache;
+}
+
 void cairo_dock_draw_icon_overlays_cairo (Icon *pIcon, double fRatio, cairo_t *pCairoContext)
 {
 	if (pIcon->pOverlays == NULL)
@@ -216,6 +390,13 @@ void cairo_dock_draw_icon_overlays_cairo (Icon *pIcon, double fRatio, cairo_t *p
 	double fMaxScale = cairo_dock_get_icon_max_scale (pIcon);
 	double z = fRatio * pIcon->fScale / fMaxScale;
 	
+	//\_____________ first the static overlays, all at once.
+	CDOverlayCache *pCache = (pIcon->fScale == 1 ? _get_overlay_cache (pIcon, w, h, z) : NULL);
+	gboolean bUseCache = (pCache != NULL && pCache->image.pSurface != NULL);
+	if (bUseCache)
+		cairo_dock_apply_image_buffer_surface_with_offset (&pCache->image, pCairoContext, 0., 0., pIcon->fAlpha);
+	
+	//\_____________ then the other ones.
 	GList* ov;
 	CairoOverlay *p;
 	int wo, ho;  // actual size at which the overlay will rendered.
@@ -223,23 +404,14 @@ void cairo_dock_draw_icon_overlays_cairo (Icon *pIcon, double fRatio, cairo_t *p
 	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
 	{
 		p = ov->data;
-		if (! p->image.pSurface)
+		if (! p->image.pSurface || (bUseCache && p->bBaked))
 			continue;
 		
 		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
 		x += (pIcon->fWidth * pIcon->fScale - wo) / 2.;
 		y = - y + (pIcon->fHeight * pIcon->fScale - ho) / 2.;
-		if (pIcon->fScale == 1)  // place the overlay on the grid to avoid scale blur (only when the icon is at rest, otherwise it makes the movement jerky).
-		{
-			if (wo & 1)
-				x = floor (x) + .5;
-			else
-				x = round (x);
-			if (ho & 1)
-				y = floor (y) + .5;
-			else
-				y = round (y);
-		}
+		if (pIcon->fScale == 1)
+			_snap_overlay_position (&x, &y, wo, ho);
 		cairo_save (pCairoContext);
 		
 		// translate to the top-left corner of the overlay.
@@ -269,6 +441,18 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 	_cairo_dock_set_blend_over ();
 	_cairo_dock_set_alpha (pIcon->fAlpha);
 	
+	//\_____________ first the static overlays, all at once.
+	CDOverlayCache *pCache = (pIcon->fScale == 1 ? _get_overlay_cache (pIcon, w, h, z) : NULL);
+	gboolean bUseCache = (pCache != NULL && pCache->image.iTexture != 0);
+	if (bUseCache)
+	{
+		glPushMatrix ();
+		glRotatef (-pIcon->fOrientation/G_PI*180., 0., 0., 1.);
+		_cairo_dock_apply_texture_at_size (pCache->image.iTexture, pCache->image.iWidth, pCache->image.iHeight);
+		glPopMatrix ();
+	}
+	
+	//\_____________ then the other ones.
 	GList* ov;
 	CairoOverlay *p;
 	int wo, ho;  // actual size at which the overlay will be rendered.
@@ -276,22 +460,13 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
 	{
 		p = ov->data;
-		if (! p->image.iTexture)
+		if (! p->image.iTexture || (bUseCache && p->bBaked))
 			continue;
 		glPushMatrix ();
 		
 		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
-		if (pIcon->fScale == 1)  // place the overlay on the grid to avoid scale blur (only when the icon is at rest, otherwise it makes the movement jerky).
-		{
-			if (wo & 1)
-				x = floor (x) + .5;
-			else
-				x = round (x);
-			if (ho & 1)
-				y = floor (y) + .5;
-			else
-				y = round (y);
-		}
+		if (pIcon->fScale == 1)
+			_snap_overlay_position (&x, &y, wo, ho);
 		
 		// translate to the overlay center.
 		glRotatef (-pIcon->fOrientation/G_PI*180., 0., 0., 1.);
@@ -444,6 +619,8 @@ static void reset_object (GldiObject *obj)
 	if (pIcon)
 	{
 		pIcon->pOverlays = g_list_remove (pIcon->pOverlays, pOverlay);
+		if (pOverlay->bBaked)
+			_invalidate_overlay_cache (pIcon);
 	}
 	
 	// free data
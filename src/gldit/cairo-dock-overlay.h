@@ -38,6 +38,8 @@ G_BEGIN_DECLS
  * 
  * Overlays are drawn at 1/2 of the icon size by default, but this can be set up with \ref cairo_dock_set_overlay_scale.
  * If you need to modify an overlay directly, you can get its image buffer with \ref cairo_dock_get_overlay_image_buffer.
+ * 
+ * The overlays that don't change are composited together into a single buffer, which is drawn at once on each frame; it is rebuilt when an overlay is added or removed, or with \ref cairo_dock_update_overlay.
  */
 
 // manager
@@ -91,6 +93,9 @@ struct _CairoOverlay {
 	Icon *pIcon;
 	/// data used to identify an overlay
 	gpointer data;
+	/// TRUE if the content of the overlay is modified regularly; it is then drawn on its own rather than composited with the other overlays.
+	gboolean bDynamic;
+	gboolean bBaked;  // whether it's currently in the composite of its icon.
 } ;
 
 
@@ -132,12 +137,20 @@ CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture,
  *@param pOverlay the overlay
  *@param _fScale the scale
  */
-#define cairo_dock_set_overlay_scale(pOverlay, _fScale) (pOverlay)->fScale = _fScale
+#define cairo_dock_set_overlay_scale(pOverlay, _fScale) do {\
+	(pOverlay)->fScale = _fScale;\
+	cairo_dock_update_overlay (pOverlay); } while (0)
+
+/** Get the image buffer of an overlay (only useful if you need to redraw the overlay). The overlay is then considered as dynamic, and is drawn on its own.
+ *@param pOverlay the overlay
+ *@return the image buffer of the overlay.
+ */
+CairoDockImageBuffer *cairo_dock_get_overlay_image_buffer (CairoOverlay *pOverlay);
 
-/** Get the image buffer of an overlay (only useful if you need to redraw the overlay).
+/** Tell that an overlay has changed (its image or its scale), so that the composite of its icon's overlays is rebuilt. Not needed for dynamic overlays.
  *@param pOverlay the overlay
  */
-#define cairo_dock_get_overlay_image_buffer(pOverlay) (&(pOverlay)->image)
+void cairo_dock_update_overlay (CairoOverlay *pOverlay);
 
 
 /** Remove an overlay from an icon, given its position and data.
@@ -19,10 +19,10 @@
 
 #include <stdlib.h>
 #include <math.h>
+#include <gio/gio.h>  // GSettings
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-file-manager.h"  // CairoDockDesktopEnv
-#include "cairo-dock-utils.h"  // cairo_dock_launch_command_sync
 #include "cairo-dock-style-manager.h"  // GldiStyleParam
 #include "cairo-dock-style-facility.h"
 
@@ -119,16 +119,24 @@ gchar *_get_default_system_font (void)
 	{
 		if (g_iDesktopEnv == CAIRO_DOCK_GNOME)
 		{
-			s_cFontName = cairo_dock_launch_command_sync ("gconftool-2 -g /desktop/gnome/interface/font_name");  // GTK2
-			if (! s_cFontName)
+			// read the setting directly rather than launching 'gsettings'; check that the schema is installed, since GSettings aborts otherwise.
+			GSettingsSchemaSource *pSource = g_settings_schema_source_get_default ();
+			GSettingsSchema *pSchema = (pSource ? g_settings_schema_source_lookup (pSource, "org.gnome.desktop.interface", TRUE) : NULL);
+			if (pSchema != NULL)
 			{
-				s_cFontName = cairo_dock_launch_command_sync ("gsettings get org.gnome.desktop.interface font-name");  // GTK3
-				cd_debug ("s_cFontName: %s", s_cFontName);
-				if (s_cFontName && *s_cFontName == '\'')  // the value may be between quotes... get rid of them!
+				if (g_settings_schema_has_key (pSchema, "font-name"))
 				{
-					s_cFontName ++;  // s_cFontName is never freeed
-					s_cFontName[strlen(s_cFontName) - 1] = '\0';
+					GSettings *pSettings = g_settings_new ("org.gnome.desktop.interface");
+					s_cFontName = g_settings_get_string (pSettings, "font-name");  // s_cFontName is never freeed
+					g_object_unref (pSettings);
+					cd_debug ("s_cFontName: %s", s_cFontName);
+					if (s_cFontName && *s_cFontName == '\0')
+					{
+						g_free (s_cFontName);
+						s_cFontName = NULL;
+					}
 				}
+				g_settings_schema_unref (pSchema);
 			}
 		}
 		if (! s_cFontName)
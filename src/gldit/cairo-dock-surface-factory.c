@@ -858,6 +858,175 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 	return pNewSurface;
 }
 
+  ////////////////
+ // TEXT CACHE //
+////////////////
+
+// Labels, quick-infos and dialogs often render the same few strings again and again (a clock or a cpu applet updates its quick-info each second);
+// keep the last rendered texts, so that they are only shaped and painted once.
+#define TEXT_CACHE_MAX_ENTRIES 64
+#define TEXT_CACHE_MAX_SIZE (4 * 1024 * 1024)  // in bytes
+
+typedef struct {
+	gchar *cText;
+	PangoFontDescription *pDesc;  // copy of the font, without its size (given by iSize)
+	GldiTextDescription desc;  // copy of the description, without its font
+	double fMaxScale;
+	gint iMaxWidth;
+	gint iMaxLineWidth;
+	cairo_surface_t *pSurface;
+	gint iWidth, iHeight;
+	GList *pLink;  // position in the LRU list
+	} CairoDockTextCacheEntry;
+
+static GHashTable *s_pTextCache = NULL;  // entry -> entry
+static GQueue s_TextCacheLRU = G_QUEUE_INIT;  // most recently used first
+static gsize s_iTextCacheSize = 0;
+static guint s_iNbTextCacheHits = 0;
+static guint s_iNbTextCacheMisses = 0;
+
+static guint _text_cache_entry_hash (const CairoDockTextCacheEntry *e)
+{
+	return g_str_hash (e->cText) ^ pango_font_description_hash (e->pDesc) ^ (e->desc.iSize << 8) ^ (e->iMaxWidth << 16) ^ (guint)(e->fMaxScale * 1000);
+}
+
+static gboolean _text_cache_entry_equal (const CairoDockTextCacheEntry *a, const CairoDockTextCacheEntry *b)
+{
+	return (a->desc.iSize == b->desc.iSize
+		&& a->desc.bNoDecorations == b->desc.bNoDecorations
+		&& a->desc.bUseDefaultColors == b->desc.bUseDefaultColors
+		&& a->desc.bOutlined == b->desc.bOutlined
+		&& a->desc.iMargin == b->desc.iMargin
+		&& a->desc.bUseMarkup == b->desc.bUseMarkup
+		&& a->fMaxScale == b->fMaxScale
+		&& a->iMaxWidth == b->iMaxWidth
+		&& a->iMaxLineWidth == b->iMaxLineWidth
+		&& (a->desc.bUseDefaultColors || (gdk_rgba_equal (&a->desc.fColorStart.rgba, &b->desc.fColorStart.rgba)
+			&& gdk_rgba_equal (&a->desc.fBackgroundColor.rgba, &b->desc.fBackgroundColor.rgba)
+			&& gdk_rgba_equal (&a->desc.fLineColor.rgba, &b->desc.fLineColor.rgba)))
+		&& strcmp (a->cText, b->cText) == 0
+		&& pango_font_description_equal (a->pDesc, b->pDesc));
+}
+
+static inline gsize _text_cache_entry_size (CairoDockTextCacheEntry *e)
+{
+	return (gsize)e->iWidth * e->iHeight * 4;
+}
+
+static void _free_text_cache_entry (CairoDockTextCacheEntry *e)
+{
+	g_free (e->cText);
+	pango_font_description_free (e->pDesc);
+	if (e->pSurface != NULL)
+		cairo_surface_destroy (e->pSurface);
+	g_free (e);
+}
+
+static void _remove_text_cache_entry (CairoDockTextCacheEntry *e)
+{
+	g_queue_delete_link (&s_TextCacheLRU, e->pLink);
+	s_iTextCacheSize -= _text_cache_entry_size (e);
+	g_hash_table_remove (s_pTextCache, e);  // frees the entry
+}
+
+void cairo_dock_reset_text_surface_cache (void)
+{
+	if (s_pTextCache == NULL)
+		return;
+	cd_debug ("text cache: %u hits, %u misses, %u entries", s_iNbTextCacheHits, s_iNbTextCacheMisses, g_hash_table_size (s_pTextCache));
+	g_queue_clear (&s_TextCacheLRU);
+	g_hash_table_remove_all (s_pTextCache);
+	s_iTextCacheSize = 0;
+}
+
+void cairo_dock_get_text_surface_cache_stats (guint *iNbHits, guint *iNbMisses)
+{
+	if (iNbHits)
+		*iNbHits = s_iNbTextCacheHits;
+	if (iNbMisses)
+		*iNbMisses = s_iNbTextCacheMisses;
+}
+
+static gboolean _on_style_changed (G_GNUC_UNUSED gpointer data)
+{
+	cairo_dock_reset_text_surface_cache ();  // default colors and corner radius may have changed.
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_text_cached (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight)
+{
+	g_return_val_if_fail (cText != NULL && pTextDescription != NULL, NULL);
+	PangoFontDescription *pFontDesc = gldi_text_description_get_description (pTextDescription);
+	if (pFontDesc == NULL)  // can't identify the font, don't cache it.
+		return cairo_dock_create_surface_from_text_full (cText, pTextDescription, fMaxScale, iMaxWidth, iTextWidth, iTextHeight);
+	
+	if (s_pTextCache == NULL)
+	{
+		s_pTextCache = g_hash_table_new_full ((GHashFunc)_text_cache_entry_hash, (GEqualFunc)_text_cache_entry_equal, (GDestroyNotify)_free_text_cache_entry, NULL);
+		gldi_object_register_notification (&myStyleMgr,
+			NOTIFICATION_STYLE_CHANGED,
+			(GldiNotificationFunc) _on_style_changed,
+			GLDI_RUN_FIRST, NULL);  // before the labels are reloaded.
+	}
+	
+	//\_________________ look for the text in the cache.
+	CairoDockTextCacheEntry key;
+	key.cText = (gchar*)cText;
+	PangoFontDescription *pDesc = pango_font_description_copy_static (pFontDesc);  // the description is shared by the caller, so work on a copy.
+	pango_font_description_unset_fields (pDesc, PANGO_FONT_MASK_SIZE);  // the font size is set at each rendering, so it is ignored in the key (see 'desc.iSize').
+	key.pDesc = pDesc;
+	key.desc = *pTextDescription;
+	key.fMaxScale = fMaxScale;
+	key.iMaxWidth = iMaxWidth;
+	key.iMaxLineWidth = (pTextDescription->fMaxRelativeWidth != 0 ? pTextDescription->fMaxRelativeWidth * gldi_desktop_get_width() / g_desktopGeometry.iNbScreens : 0);
+	
+	CairoDockTextCacheEntry *e = g_hash_table_lookup (s_pTextCache, &key);
+	if (e != NULL)
+	{
+		pango_font_description_free (pDesc);
+		s_iNbTextCacheHits ++;
+		g_queue_unlink (&s_TextCacheLRU, e->pLink);
+		g_queue_push_head_link (&s_TextCacheLRU, e->pLink);
+		*iTextWidth = e->iWidth;
+		*iTextHeight = e->iHeight;
+		return cairo_surface_reference (e->pSurface);
+	}
+	s_iNbTextCacheMisses ++;
+	
+	//\_________________ render it and keep it.
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (cText, pTextDescription, fMaxScale, iMaxWidth, iTextWidth, iTextHeight);
+	gsize iSize = (pSurface != NULL ? (gsize)*iTextWidth * *iTextHeight * 4 : 0);
+	if (pSurface == NULL || iSize > TEXT_CACHE_MAX_SIZE / 4)  // big texts (long dialogs) are rarely rendered twice.
+	{
+		pango_font_description_free (pDesc);
+		return pSurface;
+	}
+	
+	e = g_new0 (CairoDockTextCacheEntry, 1);
+	e->cText = g_strdup (cText);
+	e->pDesc = pango_font_description_copy (pDesc);  // a real copy: the strings of the static copy belong to the caller's description.
+	pango_font_description_free (pDesc);
+	e->desc = *pTextDescription;
+	e->desc.cFont = NULL;
+	e->desc.fd = NULL;
+	e->fMaxScale = fMaxScale;
+	e->iMaxWidth = iMaxWidth;
+	e->iMaxLineWidth = key.iMaxLineWidth;
+	e->pSurface = cairo_surface_reference (pSurface);
+	e->iWidth = *iTextWidth;
+	e->iHeight = *iTextHeight;
+	
+	while (s_TextCacheLRU.length != 0 && (s_TextCacheLRU.length >= TEXT_CACHE_MAX_ENTRIES || s_iTextCacheSize + iSize > TEXT_CACHE_MAX_SIZE))
+		_remove_text_cache_entry (g_queue_peek_tail (&s_TextCacheLRU));
+	g_queue_push_head (&s_TextCacheLRU, e);
+	e->pLink = s_TextCacheLRU.head;
+	s_iTextCacheSize += iSize;
+	g_hash_table_add (s_pTextCache, e);
+	
+	return pSurface;
+}
+
+
 
 cairo_surface_t * cairo_dock_duplicate_surface (cairo_surface_t *pSurface, double fWidth, double fHeight, double fDesiredWidth, double fDesiredHeight)
 {
@@ -167,6 +167,17 @@ cairo_surface_t * cairo_dock_rotate_surface (cairo_surface_t *pSurface, double f
 */
 cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, GldiTextDescription *pLabelDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight);
 
+/** Same as \ref cairo_dock_create_surface_from_text_full, but the recently rendered texts are kept in a cache, so that a text that is displayed again (a label, a quick-info that changes every second) is not rendered again.
+*@param cText the text.
+*@param pLabelDescription description of the text rendering.
+*@param fMaxScale maximum zoom of the text.
+*@param iMaxWidth maximum authorized width for the surface, or 0 for no limit.
+*@param iTextWidth will be filled the width of the resulting surface.
+*@param iTextHeight will be filled the height of the resulting surface.
+*@return a new reference on a surface that may be shared with other callers: don't draw on it, and release it with cairo_surface_destroy.
+*/
+cairo_surface_t *cairo_dock_create_surface_from_text_cached (const gchar *cText, GldiTextDescription *pLabelDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight);
+
 /** Create a surface representing a text, according to a given text description.
 *@param cText the text.
 *@param pLabelDescription description of the text rendering.
@@ -176,6 +187,16 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 */
 #define cairo_dock_create_surface_from_text(cText, pLabelDescription, iTextWidthPtr, iTextHeightPtr) cairo_dock_create_surface_from_text_full (cText, pLabelDescription, 1., 0, iTextWidthPtr, iTextHeightPtr) 
 
+/** Empty the cache of rendered texts. It is done automatically when the global style changes; call it if you change the rendering of texts in another way.
+*/
+void cairo_dock_reset_text_surface_cache (void);
+
+/** Get the number of texts that were found in the cache of rendered texts, and the number of texts that had to be rendered.
+*@param iNbHits will be filled with the number of hits, or NULL.
+*@param iNbMisses will be filled with the number of misses, or NULL.
+*/
+void cairo_dock_get_text_surface_cache_stats (guint *iNbHits, guint *iNbMisses);
+
 /** Create a surface identical to another, possibly resizing it.
 *@param pSurface surface to duplicate.
 *@param fWidth the width of the surface.
@@ -0,0 +1,461 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "cairo-dock-log.h"
+#include "cairo-dock-task.h"
+#include "cairo-dock-icon-factory.h"  // Icon
+#include "cairo-dock-icon-facility.h"  // cairo_dock_get_icon_container
+#include "cairo-dock-data-renderer.h"
+#include "cairo-dock-system-metrics.h"
+
+#define GLDI_METRICS_BUFFER_SIZE 16384
+
+typedef struct {
+	gchar *buffer;  // the files are read here; it only grows when a file doesn't fit in it, so that no memory is allocated during a measure most of the time.
+	gsize iBufferSize;
+	guint64 iCpuTotal, iCpuIdle;
+	guint64 iNetDown, iNetUp;
+	guint64 iDiskRead, iDiskWrite;
+	gint64 iTime;
+	GldiSystemMetricsSnapshot snapshot;
+	} GldiMetricsSharedMemory;
+
+typedef struct {
+	Icon *pIcon;
+	gint iMetrics[GLDI_NB_SYSTEM_METRICS];
+	gint iNbMetrics;
+	gint iPeriod;  // in s
+	gint64 iLastUpdate;  // in us
+	} GldiMetricsWatch;
+
+static const gchar *s_cMetricNames[GLDI_NB_SYSTEM_METRICS] = {
+	"cpu",
+	"memory",
+	"swap",
+	"net-down",
+	"net-up",
+	"disk-read",
+	"disk-write"};
+
+static GldiTask *s_pTask = NULL;
+static GSList *s_pWatchList = NULL;
+// last published measure, protected by a sequence counter: it's odd while the measure is being written, so that readers never have to lock anything. It's only written from the main loop, so there is a single writer even if a freed task is still measuring.
+static GldiSystemMetricsSnapshot s_snapshot;
+static gint s_iSnapshotSeq = 0;
+
+
+  ///////////////
+ /// PARSERS ///
+///////////////
+
+static gsize _read_proc_file (const gchar *cPath, GldiMetricsSharedMemory *pSharedMemory)
+{
+	int fd = open (cPath, O_RDONLY);
+	if (fd < 0)
+		return 0;
+	gsize n = 0;
+	ssize_t r;
+	do
+	{
+		if (n == pSharedMemory->iBufferSize - 1)  // the file doesn't fit (many CPUs, disks or interfaces), grow the buffer and keep reading the same file.
+		{
+			pSharedMemory->iBufferSize *= 2;
+			pSharedMemory->buffer = g_realloc (pSharedMemory->buffer, pSharedMemory->iBufferSize);
+		}
+		r = read (fd, pSharedMemory->buffer + n, pSharedMemory->iBufferSize - 1 - n);
+		if (r > 0)
+			n += r;
+	}
+	while (r > 0);
+	close (fd);
+	pSharedMemory->buffer[n] = '\0';
+	return n;
+}
+
+static inline const gchar *_parse_uint (const gchar *s, guint64 *x)
+{
+	while (*s == ' ' || *s == '\t')
+		s ++;
+	guint64 v = 0;
+	while (*s >= '0' && *s <= '9')
+	{
+		v = v * 10 + (*s - '0');
+		s ++;
+	}
+	*x = v;
+	return s;
+}
+
+static inline const gchar *_next_line (const gchar *s)
+{
+	while (*s != '\0' && *s != '\n')
+		s ++;
+	return (*s == '\n' ? s + 1 : s);
+}
+
+static inline gboolean _starts_with (const gchar *s, const gchar *cPrefix, int n)
+{
+	return (strncmp (s, cPrefix, n) == 0);
+}
+
+// /proc/stat: "cpu  user nice system idle iowait irq softirq steal guest guest_nice"
+static void _measure_cpu (GldiMetricsSharedMemory *pSharedMemory)
+{
+	double *fValue = &pSharedMemory->snapshot.fValues[GLDI_METRIC_CPU];
+	*fValue = CAIRO_DATA_RENDERER_UNDEF_VALUE;
+	if (_read_proc_file ("/proc/stat", pSharedMemory) == 0 || ! _starts_with (pSharedMemory->buffer, "cpu ", 4))
+		return;
+	
+	const gchar *s = pSharedMemory->buffer + 3;
+	guint64 x, iTotal = 0, iIdle = 0;
+	int i;
+	for (i = 0; i < 8; i ++)  // guest times are already counted in the user time.
+	{
+		s = _parse_uint (s, &x);
+		iTotal += x;
+		if (i == 3 || i == 4)  // idle and iowait
+			iIdle += x;
+	}
+	
+	if (pSharedMemory->iCpuTotal != 0 && iTotal > pSharedMemory->iCpuTotal)
+	{
+		guint64 iDeltaTotal = iTotal - pSharedMemory->iCpuTotal;
+		guint64 iDeltaIdle = (iIdle > pSharedMemory->iCpuIdle ? iIdle - pSharedMemory->iCpuIdle : 0);
+		*fValue = MIN (1., 1. - (double) iDeltaIdle / iDeltaTotal);
+	}
+	pSharedMemory->iCpuTotal = iTotal;
+	pSharedMemory->iCpuIdle = iIdle;
+}
+
+// /proc/meminfo: "MemTotal:  16314444 kB"
+static void _measure_memory (GldiMetricsSharedMemory *pSharedMemory)
+{
+	double *fMemory = &pSharedMemory->snapshot.fValues[GLDI_METRIC_MEMORY];
+	double *fSwap = &pSharedMemory->snapshot.fValues[GLDI_METRIC_SWAP];
+	*fMemory = *fSwap = CAIRO_DATA_RENDERER_UNDEF_VALUE;
+	if (_read_proc_file ("/proc/meminfo", pSharedMemory) == 0)
+		return;
+	
+	guint64 iMemTotal = 0, iMemAvailable = 0, iMemFree = 0, iBuffers = 0, iCached = 0, iSwapTotal = 0, iSwapFree = 0;
+	gboolean bHasAvailable = FALSE;
+	const gchar *s;
+	for (s = pSharedMemory->buffer; *s != '\0'; s = _next_line (s))
+	{
+		if (_starts_with (s, "MemTotal:", 9))
+			_parse_uint (s + 9, &iMemTotal);
+		else if (_starts_with (s, "MemAvailable:", 13))
+		{
+			_parse_uint (s + 13, &iMemAvailable);
+			bHasAvailable = TRUE;
+		}
+		else if (_starts_with (s, "MemFree:", 8))
+			_parse_uint (s + 8, &iMemFree);
+		else if (_starts_with (s, "Buffers:", 8))
+			_parse_uint (s + 8, &iBuffers);
+		else if (_starts_with (s, "Cached:", 7))
+			_parse_uint (s + 7, &iCached);
+		else if (_starts_with (s, "SwapTotal:", 10))
+			_parse_uint (s + 10, &iSwapTotal);
+		else if (_starts_with (s, "SwapFree:", 9))
+			_parse_uint (s + 9, &iSwapFree);
+	}
+	
+	if (! bHasAvailable)  // kernel older than 3.14
+		iMemAvailable = iMemFree + iBuffers + iCached;
+	if (iMemTotal != 0)
+		*fMemory = 1. - (double) MIN (iMemAvailable, iMemTotal) / iMemTotal;
+	*fSwap = (iSwapTotal != 0 ? 1. - (double) MIN (iSwapFree, iSwapTotal) / iSwapTotal : 0.);
+}
+
+static inline double _rate (guint64 iNew, guint64 *iOld, double fElapsedTime)
+{
+	double r = (*iOld != 0 && iNew >= *iOld && fElapsedTime > 0 ? (iNew - *iOld) / fElapsedTime : CAIRO_DATA_RENDERER_UNDEF_VALUE);
+	*iOld = iNew;
+	return r;
+}
+
+// /proc/net/dev: "  eth0: rx_bytes rx_packets rx_errs rx_drop rx_fifo rx_frame rx_compressed rx_multicast tx_bytes ..."
+static void _measure_network (GldiMetricsSharedMemory *pSharedMemory, double fElapsedTime)
+{
+	double *fDown = &pSharedMemory->snapshot.fValues[GLDI_METRIC_NET_DOWN];
+	double *fUp = &pSharedMemory->snapshot.fValues[GLDI_METRIC_NET_UP];
+	*fDown = *fUp = CAIRO_DATA_RENDERER_UNDEF_VALUE;
+	if (_read_proc_file ("/proc/net/dev", pSharedMemory) == 0)
+		return;
+	
+	guint64 x, iDown = 0, iUp = 0;
+	const gchar *s = _next_line (_next_line (pSharedMemory->buffer));  // skip the 2 header lines.
+	const gchar *colon;
+	int i;
+	for (; *s != '\0'; s = _next_line (s))
+	{
+		while (*s == ' ')
+			s ++;
+		colon = strchr (s, ':');
+		if (colon == NULL)
+			break;
+		if (colon - s == 2 && _starts_with (s, "lo", 2))  // the loopback doesn't go anywhere.
+			continue;
+		s = _parse_uint (colon + 1, &x);
+		iDown += x;
+		for (i = 1; i < 9; i ++)
+			s = _parse_uint (s, &x);
+		iUp += x;
+	}
+	
+	*fDown = _rate (iDown, &pSharedMemory->iNetDown, fElapsedTime);
+	*fUp = _rate (iUp, &pSharedMemory->iNetUp, fElapsedTime);
+}
+
+// /proc/diskstats: "   8       0 sda reads reads_merged sectors_read ms_reading writes writes_merged sectors_written ..."
+static void _measure_disks (GldiMetricsSharedMemory *pSharedMemory, double fElapsedTime)
+{
+	double *fRead = &pSharedMemory->snapshot.fValues[GLDI_METRIC_DISK_READ];
+	double *fWrite = &pSharedMemory->snapshot.fValues[GLDI_METRIC_DISK_WRITE];
+	*fRead = *fWrite = CAIRO_DATA_RENDERER_UNDEF_VALUE;
+	if (_read_proc_file ("/proc/diskstats", pSharedMemory) == 0)
+		return;
+	
+	guint64 x, iRead = 0, iWrite = 0;
+	const gchar *s, *cName, *cDisk = NULL;
+	int iNameLength, iDiskLength = 0;
+	for (s = pSharedMemory->buffer; *s != '\0'; s = _next_line (s))
+	{
+		s = _parse_uint (s, &x);  // major
+		s = _parse_uint (s, &x);  // minor
+		while (*s == ' ')
+			s ++;
+		cName = s;
+		while (*s != ' ' && *s != '\0' && *s != '\n')
+			s ++;
+		iNameLength = s - cName;
+		if (iNameLength == 0)
+			continue;
+		
+		// only count whole disks: partitions follow their disk and start with its name, and virtual devices are built over them.
+		if (_starts_with (cName, "loop", 4) || _starts_with (cName, "ram", 3) || _starts_with (cName, "zram", 4) || _starts_with (cName, "dm-", 3) || _starts_with (cName, "md", 2))
+			continue;
+		if (cDisk != NULL && iNameLength > iDiskLength && strncmp (cName, cDisk, iDiskLength) == 0)
+			continue;
+		cDisk = cName;
+		iDiskLength = iNameLength;
+		
+		s = _parse_uint (s, &x);  // reads
+		s = _parse_uint (s, &x);  // reads merged
+		s = _parse_uint (s, &x);  // sectors read
+		iRead += x;
+		s = _parse_uint (s, &x);  // time reading
+		s = _parse_uint (s, &x);  // writes
+		s = _parse_uint (s, &x);  // writes merged
+		s = _parse_uint (s, &x);  // sectors written
+		iWrite += x;
+	}
+	
+	*fRead = _rate (iRead * 512, &pSharedMemory->iDiskRead, fElapsedTime);  // sectors are always 512 bytes in this file.
+	*fWrite = _rate (iWrite * 512, &pSharedMemory->iDiskWrite, fElapsedTime);
+}
+
+
+  //////////////
+ /// SAMPLE ///
+//////////////
+
+static void _publish_snapshot (const GldiSystemMetricsSnapshot *pSnapshot)
+{
+	guint iSerial = s_snapshot.iSerial + 1;  // keep counting across tasks.
+	g_atomic_int_inc (&s_iSnapshotSeq);
+	memcpy (&s_snapshot, pSnapshot, sizeof (GldiSystemMetricsSnapshot));
+	s_snapshot.iSerial = iSerial;
+	g_atomic_int_inc (&s_iSnapshotSeq);
+}
+
+static void _get_data (GldiMetricsSharedMemory *pSharedMemory)
+{
+	gint64 iTime = g_get_monotonic_time ();
+	double fElapsedTime = (pSharedMemory->iTime != 0 ? (iTime - pSharedMemory->iTime) * 1e-6 : 0.);
+	pSharedMemory->iTime = iTime;
+	
+	_measure_cpu (pSharedMemory);
+	_measure_memory (pSharedMemory);
+	_measure_network (pSharedMemory, fElapsedTime);
+	_measure_disks (pSharedMemory, fElapsedTime);
+	
+	pSharedMemory->snapshot.iTime = iTime;
+}
+
+static gboolean _update (GldiMetricsSharedMemory *pSharedMemory)
+{
+	const GldiSystemMetricsSnapshot *pSnapshot = &pSharedMemory->snapshot;  // the thread is idle during the update, so we can read it directly.
+	_publish_snapshot (pSnapshot);
+	double fValues[GLDI_NB_SYSTEM_METRICS];
+	GldiMetricsWatch *pWatch;
+	GldiContainer *pContainer;
+	CairoDataRenderer *pRenderer;
+	GSList *w;
+	int i, iNbValues;
+	for (w = s_pWatchList; w != NULL; w = w->next)
+	{
+		pWatch = w->data;
+		if (pSnapshot->iTime - pWatch->iLastUpdate < pWatch->iPeriod * G_USEC_PER_SEC - G_USEC_PER_SEC / 10)  // not yet its turn; allow some jitter.
+			continue;
+		pContainer = cairo_dock_get_icon_container (pWatch->pIcon);
+		pRenderer = cairo_dock_get_icon_data_renderer (pWatch->pIcon);
+		if (pContainer == NULL || pRenderer == NULL)
+			continue;
+		iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+		if (iNbValues > GLDI_NB_SYSTEM_METRICS)
+			continue;
+		pWatch->iLastUpdate = pSnapshot->iTime;
+		
+		for (i = 0; i < iNbValues; i ++)
+			fValues[i] = (i < pWatch->iNbMetrics && pWatch->iMetrics[i] >= 0 ? pSnapshot->fValues[pWatch->iMetrics[i]] : CAIRO_DATA_RENDERER_UNDEF_VALUE);
+		cairo_dock_render_new_data_on_icon (pWatch->pIcon, pContainer, NULL, fValues);
+	}
+	return TRUE;
+}
+
+static void _free_shared_memory (GldiMetricsSharedMemory *pSharedMemory)
+{
+	g_free (pSharedMemory->buffer);
+	g_free (pSharedMemory);
+}
+
+static void _restart_task (void)
+{
+	if (s_pWatchList == NULL)  // nobody needs us any more, go to sleep.
+	{
+		if (s_pTask != NULL)
+		{
+			gldi_task_free (s_pTask);
+			s_pTask = NULL;
+		}
+		return;
+	}
+	
+	int iPeriod = G_MAXINT;
+	GldiMetricsWatch *pWatch;
+	GSList *w;
+	for (w = s_pWatchList; w != NULL; w = w->next)
+	{
+		pWatch = w->data;
+		iPeriod = MIN (iPeriod, pWatch->iPeriod);
+	}
+	
+	if (s_pTask == NULL)
+	{
+		// each task has its own memory: a freed task may still be measuring in its thread, and frees it once done.
+		GldiMetricsSharedMemory *pSharedMemory = g_new0 (GldiMetricsSharedMemory, 1);
+		pSharedMemory->iBufferSize = GLDI_METRICS_BUFFER_SIZE;
+		pSharedMemory->buffer = g_new (gchar, GLDI_METRICS_BUFFER_SIZE);
+		s_pTask = gldi_task_new_full (iPeriod,
+			(GldiGetDataAsyncFunc) _get_data,
+			(GldiUpdateSyncFunc) _update,
+			(GFreeFunc) _free_shared_memory,
+			pSharedMemory);
+		gldi_task_launch (s_pTask);
+	}
+	else if ((int)s_pTask->iPeriod != iPeriod)
+	{
+		gldi_task_change_frequency (s_pTask, iPeriod);
+	}
+}
+
+
+  ///////////
+ /// API ///
+///////////
+
+gint gldi_system_metrics_get_by_name (const gchar *cName)
+{
+	g_return_val_if_fail (cName != NULL, -1);
+	int i;
+	for (i = 0; i < GLDI_NB_SYSTEM_METRICS; i ++)
+	{
+		if (strcmp (cName, s_cMetricNames[i]) == 0)
+			return i;
+	}
+	return -1;
+}
+
+gboolean gldi_system_metrics_get_snapshot (GldiSystemMetricsSnapshot *pSnapshot)
+{
+	g_return_val_if_fail (pSnapshot != NULL, FALSE);
+	gint iSeq;
+	do
+	{
+		iSeq = g_atomic_int_get (&s_iSnapshotSeq);
+		memcpy (pSnapshot, &s_snapshot, sizeof (GldiSystemMetricsSnapshot));
+	}
+	while ((iSeq & 1) || iSeq != g_atomic_int_get (&s_iSnapshotSeq));  // a measure was being published, read again.
+	return (pSnapshot->iSerial != 0);
+}
+
+static GldiMetricsWatch *_find_watch (Icon *pIcon)
+{
+	GldiMetricsWatch *pWatch;
+	GSList *w;
+	for (w = s_pWatchList; w != NULL; w = w->next)
+	{
+		pWatch = w->data;
+		if (pWatch->pIcon == pIcon)
+			return pWatch;
+	}
+	return NULL;
+}
+
+void gldi_system_metrics_watch_icon (Icon *pIcon, const gchar * const *cMetricNames, int iPeriod)
+{
+	g_return_if_fail (pIcon != NULL && cMetricNames != NULL);
+	GldiMetricsWatch *pWatch = _find_watch (pIcon);
+	if (pWatch == NULL)
+	{
+		pWatch = g_new0 (GldiMetricsWatch, 1);
+		pWatch->pIcon = pIcon;
+		s_pWatchList = g_slist_prepend (s_pWatchList, pWatch);
+	}
+	pWatch->iPeriod = MAX (1, iPeriod);
+	pWatch->iLastUpdate = 0;
+	pWatch->iNbMetrics = 0;
+	int i;
+	for (i = 0; cMetricNames[i] != NULL && i < GLDI_NB_SYSTEM_METRICS; i ++)
+	{
+		pWatch->iMetrics[i] = gldi_system_metrics_get_by_name (cMetricNames[i]);
+		if (pWatch->iMetrics[i] < 0)
+			cd_warning ("unknown metric '%s'", cMetricNames[i]);
+		pWatch->iNbMetrics ++;
+	}
+	
+	_restart_task ();
+}
+
+void gldi_system_metrics_unwatch_icon (Icon *pIcon)
+{
+	GldiMetricsWatch *pWatch = _find_watch (pIcon);
+	if (pWatch == NULL)
+		return;
+	s_pWatchList = g_slist_remove (s_pWatchList, pWatch);
+	g_free (pWatch);
+	
+	_restart_task ();
+}
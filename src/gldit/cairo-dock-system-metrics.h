@@ -0,0 +1,93 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef __CAIRO_DOCK_SYSTEM_METRICS__
+#define  __CAIRO_DOCK_SYSTEM_METRICS__
+
+#include <glib.h>
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/**
+*@file cairo-dock-system-metrics.h A shared source of system measures (cpu, memory, network, disks) for the Data Renderers.
+* Instead of each applet reading /proc in its own task, the hub reads each file once per period in a single thread, and feeds the icons that watch some metrics.
+*
+* Bind metrics to an icon that has a Data Renderer with \ref gldi_system_metrics_watch_icon; the Data Renderer must have as many values as metrics.
+* The last measure can also be read at any time and from any thread with \ref gldi_system_metrics_get_snapshot.
+* The hub only runs while at least one icon watches it.
+*/
+
+/// Metrics provided by the hub.
+typedef enum {
+	/// global cpu usage, in [0;1]. name: "cpu"
+	GLDI_METRIC_CPU = 0,
+	/// used memory, in [0;1]. name: "memory"
+	GLDI_METRIC_MEMORY,
+	/// used swap, in [0;1]. name: "swap"
+	GLDI_METRIC_SWAP,
+	/// received bytes per second on all the network interfaces but the loopback. name: "net-down"
+	GLDI_METRIC_NET_DOWN,
+	/// sent bytes per second. name: "net-up"
+	GLDI_METRIC_NET_UP,
+	/// bytes read per second on all the disks. name: "disk-read"
+	GLDI_METRIC_DISK_READ,
+	/// bytes written per second. name: "disk-write"
+	GLDI_METRIC_DISK_WRITE,
+	GLDI_NB_SYSTEM_METRICS
+	} GldiSystemMetric;
+
+typedef struct _GldiSystemMetricsSnapshot GldiSystemMetricsSnapshot;
+/// A set of measures taken at the same time.
+struct _GldiSystemMetricsSnapshot {
+	/// the value of each metric (CAIRO_DATA_RENDERER_UNDEF_VALUE if it's not available).
+	gdouble fValues[GLDI_NB_SYSTEM_METRICS];
+	/// monotonic time of the measure, in microseconds.
+	gint64 iTime;
+	/// number of the measure, 0 if no measure has been done yet.
+	guint iSerial;
+};
+
+/** Get a metric from its name.
+*@param cName name of the metric, like "cpu" or "net-down"
+*@return the metric, or -1 if the name is unknown.
+*/
+gint gldi_system_metrics_get_by_name (const gchar *cName);
+
+/** Get the last measure. It doesn't lock anything and can be called from any thread.
+*@param pSnapshot a snapshot to fill
+*@return TRUE if a measure has been done already.
+*/
+gboolean gldi_system_metrics_get_snapshot (GldiSystemMetricsSnapshot *pSnapshot);
+
+/** Feed the Data Renderer of an icon with some metrics. The values are sent in the given order; if the icon was already watching some metrics, they are replaced.
+*@param pIcon an icon with a Data Renderer
+*@param cMetricNames a NULL-terminated list of names of metrics
+*@param iPeriod time between 2 updates of the icon, in seconds.
+*/
+void gldi_system_metrics_watch_icon (Icon *pIcon, const gchar * const *cMetricNames, int iPeriod);
+
+/** Stop feeding an icon. This is done automatically when the icon is destroyed.
+*@param pIcon the icon
+*/
+void gldi_system_metrics_unwatch_icon (Icon *pIcon);
+
+G_END_DECLS
+#endif
@@ -43,6 +43,7 @@
 #include "cairo-dock-core.h"
 #include "cairo-dock-applications-manager.h"  // cairo_dock_get_current_active_icon
 #include "cairo-dock-dock-facility.h"
+#include "cairo-dock-config.h"  // cairo_dock_load_current_theme
 #include "cairo-dock-themes-manager.h"
 
 // public data
@@ -96,6 +97,164 @@ static gchar * _escape_string_for_filename (const gchar *cOldName)
 	return _replace_slash_by_underscore (cNewName);
 }
 
+  ////////////////////
+ /// THEMES FILES ///
+////////////////////
+
+// the files of the themes are copied natively (no 'cp'/'rm'/'find' commands): it's much faster, files that didn't change are not copied again, and it can be done in a thread.
+static gint s_iNbProcessedFiles = 0;  // progress of the current import.
+static GMutex s_ImportMutex;  // 2 imports must not write in the current theme at the same time (a discarded import may still be finishing).
+static GCond s_ImportCond;
+static gboolean s_bImportPending = FALSE;  // TRUE from the beginning of the copy until the import is finished on the main loop; protected by s_ImportMutex.
+
+// match a file name against a shell pattern, with the same rule as the shell for hidden files. A NULL pattern matches any file.
+static gboolean _name_matches (const gchar *cFileName, const gchar *cPattern)
+{
+	if (cPattern == NULL)
+		return TRUE;
+	if (*cFileName == '.' && *cPattern != '.')
+		return FALSE;
+	return g_pattern_match_simple (cPattern, cFileName);
+}
+
+static gboolean _name_is_excluded (const gchar *cFileName, const gchar **cExcluded)
+{
+	if (cExcluded == NULL)
+		return FALSE;
+	int i;
+	for (i = 0; cExcluded[i] != NULL; i ++)
+	{
+		if (g_pattern_match_simple (cExcluded[i], cFileName))
+			return TRUE;
+	}
+	return FALSE;
+}
+
+static gboolean _is_dir (const gchar *cPath)  // doesn't follow links, like 'find -type d'
+{
+	struct stat st;
+	return (lstat (cPath, &st) == 0 && S_ISDIR (st.st_mode));
+}
+
+// copy the entries of a folder that match a pattern into another folder. Sub-folders are copied recursively if bRecursive, and ignored otherwise (like 'cp' without '-r').
+// if cDestDir is NULL, nothing is copied; the names are only added to pNames (if not NULL), so that we can know beforehand which files will be replaced.
+static void _copy_files (const gchar *cSrcDir, const gchar *cDestDir, const gchar *cPattern, const gchar **cExcluded, gboolean bRecursive, GHashTable *pNames)
+{
+	GDir *dir = g_dir_open (cSrcDir, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	gchar *cFilePath, *cFileDest;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		if (! _name_matches (cFileName, cPattern) || _name_is_excluded (cFileName, cExcluded))
+			continue;
+		cFilePath = g_strdup_printf ("%s/%s", cSrcDir, cFileName);
+		if (bRecursive || ! _is_dir (cFilePath))
+		{
+			if (pNames)
+				g_hash_table_insert (pNames, g_strdup (cFileName), GINT_TO_POINTER (1));
+			if (cDestDir)
+			{
+				cFileDest = g_strdup_printf ("%s/%s", cDestDir, cFileName);
+				cairo_dock_copy_tree (cFilePath, cFileDest, TRUE, NULL, &s_iNbProcessedFiles);  // errors are not fatal, like with 'cp'.
+				g_free (cFileDest);
+			}
+		}
+		g_free (cFilePath);
+	}
+	g_dir_close (dir);
+}
+
+// same as above, but the files of the whole tree are copied at the root of cDestDir (like 'find -exec cp'). cExcludedDir is the name of a sub-folder to ignore.
+static void _copy_files_flat (const gchar *cSrcDir, const gchar *cDestDir, const gchar *cExcludedPattern, const gchar *cExcludedDir, GHashTable *pNames)
+{
+	GDir *dir = g_dir_open (cSrcDir, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	gchar *cFilePath, *cFileDest;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		cFilePath = g_strdup_printf ("%s/%s", cSrcDir, cFileName);
+		if (_is_dir (cFilePath))
+		{
+			if (cExcludedDir == NULL || strcmp (cFileName, cExcludedDir) != 0)
+			{
+				_copy_files_flat (cFilePath, cDestDir, cExcludedPattern, NULL, pNames);
+			}
+		}
+		else if (cExcludedPattern == NULL || ! g_pattern_match_simple (cExcludedPattern, cFileName))
+		{
+			if (pNames)
+				g_hash_table_insert (pNames, g_strdup (cFileName), GINT_TO_POINTER (1));
+			if (cDestDir)
+			{
+				cFileDest = g_strdup_printf ("%s/%s", cDestDir, cFileName);
+				cairo_dock_copy_tree (cFilePath, cFileDest, TRUE, NULL, &s_iNbProcessedFiles);  // errors are not fatal, like with 'cp'.
+				g_free (cFileDest);
+			}
+		}
+		g_free (cFilePath);
+	}
+	g_dir_close (dir);
+}
+
+// remove the files (not the folders) of a folder that match a pattern, except the ones listed in pKeptNames: they are about to be replaced, and will be copied again only if they changed.
+static void _remove_files (const gchar *cDirPath, const gchar *cPattern, const gchar **cExcluded, GHashTable *pKeptNames)
+{
+	GDir *dir = g_dir_open (cDirPath, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	gchar *cFilePath;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		if (! _name_matches (cFileName, cPattern)
+		|| _name_is_excluded (cFileName, cExcluded)
+		|| (pKeptNames != NULL && g_hash_table_lookup (pKeptNames, cFileName) != NULL))
+			continue;
+		cFilePath = g_strdup_printf ("%s/%s", cDirPath, cFileName);
+		if (! _is_dir (cFilePath))
+			g_remove (cFilePath);
+		g_free (cFilePath);
+	}
+	g_dir_close (dir);
+}
+
+// remove the files of a folder, and copy the ones of another folder instead; files that are identical in both folders are kept as they are.
+static void _replace_files (const gchar *cSrcDir, const gchar *cDestDir, const gchar *cPattern)
+{
+	GHashTable *pNames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	_copy_files (cSrcDir, NULL, cPattern, NULL, FALSE, pNames);
+	_remove_files (cDestDir, cPattern, NULL, pNames);
+	g_hash_table_destroy (pNames);
+	_copy_files (cSrcDir, cDestDir, cPattern, NULL, FALSE, NULL);
+}
+
+static void _set_permissions (const gchar *cPath)  // 'chmod -R 775'
+{
+	struct stat st;
+	if (lstat (cPath, &st) != 0 || S_ISLNK (st.st_mode))
+		return;
+	g_chmod (cPath, 7*8*8+7*8+5);
+	if (! S_ISDIR (st.st_mode))
+		return;
+	GDir *dir = g_dir_open (cPath, 0, NULL);
+	if (dir == NULL)
+		return;
+	const gchar *cFileName;
+	gchar *cFilePath;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		cFilePath = g_strdup_printf ("%s/%s", cPath, cFileName);
+		_set_permissions (cFilePath);
+		g_free (cFilePath);
+	}
+	g_dir_close (dir);
+}
+
+
 static void cairo_dock_mark_current_theme_as_modified (gboolean bModified)
 {
 	static int state = -1;
@@ -174,14 +333,9 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 	
 	cairo_dock_extract_package_type_from_name (cNewThemeNameWithoutSlashes);
 
-	gchar *cNewThemeNameEscaped = g_strescape (cNewThemeNameWithoutSlashes, NULL);
-
 	cd_message ("we save in %s", cNewThemeNameWithoutSlashes);
-	GString *sCommand = g_string_new ("");
 	gboolean bThemeSaved = FALSE;
-	int r;
 	gchar *cNewThemePath = g_strdup_printf ("%s/%s", g_cThemesDirPath, cNewThemeNameWithoutSlashes);
-	gchar *cNewThemePathEscaped = g_strdup_printf ("%s/%s", g_cThemesDirPath, cNewThemeNameEscaped);
 	if (g_file_test (cNewThemePath, G_FILE_TEST_EXISTS))  // on ecrase un theme existant.
 	{
 		cd_debug ("  This theme will be updated");
@@ -211,26 +365,16 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 			//\___________________ On traite les lanceurs.
 			if (bSaveLaunchers)
 			{
-				g_string_printf (sCommand, "rm -f \"%s/%s\"/*", cNewThemePathEscaped, CAIRO_DOCK_LAUNCHERS_DIR);
-				cd_message ("%s", sCommand->str);
-				r = system (sCommand->str);
-				if (r < 0)
-					cd_warning ("Not able to launch this command: %s", sCommand->str);
-				
-				g_string_printf (sCommand, "cp \"%s\"/* \"%s/%s\"", g_cCurrentLaunchersPath, cNewThemePathEscaped, CAIRO_DOCK_LAUNCHERS_DIR);
-				cd_message ("%s", sCommand->str);
-				r = system (sCommand->str);
-				if (r < 0)
-					cd_warning ("Not able to launch this command: %s", sCommand->str);
+				gchar *cNewLaunchersPath = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_LAUNCHERS_DIR);
+				g_mkdir_with_parents (cNewLaunchersPath, 7*8*8+7*8+5);
+				_replace_files (g_cCurrentLaunchersPath, cNewLaunchersPath, "*");
+				g_free (cNewLaunchersPath);
 			}
 			
 			//\___________________ On traite tous le reste.
 			/// TODO : traiter les .conf des applets comme celui du dock...
-			g_string_printf (sCommand, "find \"%s\" -mindepth 1 -maxdepth 1  ! -name '%s' ! -name \"%s\" -exec cp -r '{}' \"%s\" \\;", g_cCurrentThemePath, CAIRO_DOCK_CONF_FILE, CAIRO_DOCK_LAUNCHERS_DIR, cNewThemePathEscaped);
-			cd_message ("%s", sCommand->str);
-			r = system (sCommand->str);
-			if (r < 0)
-				cd_warning ("Not able to launch this command: %s", sCommand->str);
+			const gchar *cExcluded[] = {CAIRO_DOCK_CONF_FILE, CAIRO_DOCK_LAUNCHERS_DIR, NULL};
+			_copy_files (g_cCurrentThemePath, cNewThemePath, NULL, cExcluded, TRUE, NULL);
 
 			bThemeSaved = TRUE;
 		}
@@ -241,11 +385,7 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 
 		if (g_mkdir (cNewThemePath, 7*8*8+7*8+5) == 0)
 		{
-			g_string_printf (sCommand, "cp -r \"%s\"/* \"%s\"", g_cCurrentThemePath, cNewThemePathEscaped);
-			cd_message ("%s", sCommand->str);
-			r = system (sCommand->str);
-			if (r < 0)
-				cd_warning ("Not able to launch this command: %s", sCommand->str);
+			_copy_files (g_cCurrentThemePath, cNewThemePath, "*", NULL, TRUE, NULL);
 
 			bThemeSaved = TRUE;
 		}
@@ -253,7 +393,6 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 			cd_warning ("couldn't create %s", cNewThemePath);
 	}
 
-	g_free (cNewThemeNameEscaped);
 	g_free (cNewThemeNameWithoutSlashes);
 
 	//\___________________ On conserve la date de derniere modif.
@@ -271,8 +410,9 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 	g_free (cReadmeFile);
 	g_free (cMessage);
 	
-	g_string_printf (sCommand, "rm -f \"%s/last-modif\"", cNewThemePathEscaped);
-	r = system (sCommand->str);
+	gchar *cLastModifFile = g_strdup_printf ("%s/last-modif", cNewThemePath);
+	g_remove (cLastModifFile);
+	g_free (cLastModifFile);
 	
 	//\___________________ make a preview of the current main dock.
 	gchar *cPreviewPath = g_strdup_printf ("%s/preview", cNewThemePath);
@@ -281,14 +421,11 @@ gboolean cairo_dock_export_current_theme (const gchar *cNewThemeName, gboolean b
 	
 	//\___________________ Le theme n'est plus en etat 'modifie'.
 	g_free (cNewThemePath);
-	g_free (cNewThemePathEscaped);
 	if (bThemeSaved)
 	{
 		cairo_dock_mark_current_theme_as_modified (FALSE);
 	}
 	
-	g_string_free (sCommand, TRUE);
-	
 	return bThemeSaved;
 }
 
@@ -365,6 +502,17 @@ gchar *cairo_dock_depackage_theme (const gchar *cPackagePath)
 	return cNewThemePath;
 }
 
+static gpointer _remove_themes_threaded (gchar **cPaths)
+{
+	int i;
+	for (i = 0; cPaths[i] != NULL; i ++)
+	{
+		cd_debug ("removing %s...", cPaths[i]);
+		cairo_dock_remove_tree (cPaths[i], NULL, NULL);
+	}
+	g_strfreev (cPaths);
+	return NULL;
+}
 gboolean cairo_dock_delete_themes (gchar **cThemesList)
 {
 	g_return_val_if_fail (cThemesList != NULL && cThemesList[0] != NULL, FALSE);
@@ -384,8 +532,9 @@ gboolean cairo_dock_delete_themes (gchar **cThemesList)
 		GLDI_SHARE_DATA_DIR"/"CAIRO_DOCK_ICON, NULL);
 	if (iClickedButton == 0 || iClickedButton == -1)  // ok button or Enter.
 	{
-		gchar *cThemeName;
-		int i, r;
+		gchar *cThemeName, *cThemePath, *cTrashPath;
+		GPtrArray *pPaths = g_ptr_array_new ();
+		int i;
 		for (i = 0; cThemesList[i] != NULL; i ++)
 		{
 			cThemeName = _escape_string_for_filename (cThemesList[i]);
@@ -397,12 +546,37 @@ gboolean cairo_dock_delete_themes (gchar **cThemesList)
 			cairo_dock_extract_package_type_from_name (cThemeName);
 			
 			bThemeDeleted = TRUE;
-			g_string_printf (sCommand, "rm -rf \"%s/%s\"", g_cThemesDirPath, cThemeName);
-			r = system (sCommand->str);  // g_rmdir only delete an empty dir...
-			if (r < 0)
-				cd_warning ("Not able to launch this command: %s", sCommand->str);
+			// the theme is first renamed into a hidden folder, so that it disappears at once from the list of themes; its files are then removed in a thread, since it can take a while for a big theme.
+			cThemePath = g_strdup_printf ("%s/%s", g_cThemesDirPath, cThemeName);
+			cTrashPath = g_strdup_printf ("%s/.%s.%ld.deleted", g_cThemesDirPath, cThemeName, (long) time (NULL));
+			if (g_rename (cThemePath, cTrashPath) == 0)
+			{
+				g_ptr_array_add (pPaths, cTrashPath);
+				g_free (cThemePath);
+			}
+			else  // remove it in place.
+			{
+				g_ptr_array_add (pPaths, cThemePath);
+				g_free (cTrashPath);
+			}
 			g_free (cThemeName);
 		}
+		g_ptr_array_add (pPaths, NULL);
+		gchar **cPaths = (gchar **) g_ptr_array_free (pPaths, FALSE);
+		GError *erreur = NULL;
+		#if (GLIB_MAJOR_VERSION == 2 && GLIB_MINOR_VERSION < 32)
+		g_thread_create ((GThreadFunc) _remove_themes_threaded, cPaths, FALSE, &erreur);
+		#else
+		GThread* pThread = g_thread_try_new ("Remove themes", (GThreadFunc) _remove_themes_threaded, cPaths, &erreur);
+		if (pThread)
+			g_thread_unref (pThread);
+		#endif
+		if (erreur != NULL)  // remove them now then.
+		{
+			cd_warning ("couldn't launch a thread to remove the themes (%s)", erreur->message);
+			g_error_free (erreur);
+			_remove_themes_threaded (cPaths);
+		}
 	}
 	
 	g_string_free (sCommand, TRUE);
@@ -442,192 +616,257 @@ static gchar *_cairo_dock_get_theme_path (const gchar *cThemeName)  // a theme n
 	return cNewThemePath;
 }
 
-static void _launch_cmd (const gchar *cCommand)
-{
-	cd_debug ("%s", cCommand);
-	int r = system (cCommand);
-	if (r < 0)
-		cd_warning ("Not able to launch this command: %s", cCommand);
-}
-
-static gboolean _cairo_dock_import_local_theme (const gchar *cNewThemePath, gboolean bLoadBehavior, gboolean bLoadLaunchers)
+// we erase double items because we could have x.png and x.svg and the dock will not know which it has to use.
+static void _remove_double_icons (const gchar *cNewIconsPath, const gchar *cIconsPath)
 {
-	g_return_val_if_fail (cNewThemePath != NULL && g_file_test (cNewThemePath, G_FILE_TEST_EXISTS), FALSE);
-	
-	//\___________________ We load global behaviour parameters for each dock.
-	GString *sCommand = g_string_new ("");
-	cd_message ("Applying changes ...");
-	if (g_pMainDock == NULL || bLoadBehavior)
+	GHashTable *pNames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	_copy_files (cNewIconsPath, NULL, "*", NULL, FALSE, pNames);
+	GHashTable *pStems = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	GHashTableIter iter;
+	gpointer key;
+	const gchar *ext;
+	g_hash_table_iter_init (&iter, pNames);
+	while (g_hash_table_iter_next (&iter, &key, NULL))
 	{
-		g_string_printf (sCommand, "rm -f \"%s\"/*.conf", g_cCurrentThemePath);
-		_launch_cmd (sCommand->str);
-
-		g_string_printf (sCommand, "cp \"%s\"/*.conf \"%s\"", cNewThemePath, g_cCurrentThemePath);
-		_launch_cmd (sCommand->str);
+		ext = strrchr (key, '.');
+		g_hash_table_insert (pStems, ext ? g_strndup (key, ext - (gchar*)key) : g_strdup (key), GINT_TO_POINTER (1));
 	}
-	else
+	
+	GDir *dir = g_dir_open (cIconsPath, 0, NULL);
+	if (dir != NULL)
 	{
-		GDir *dir = g_dir_open (cNewThemePath, 0, NULL);
-		const gchar* cDockConfFile;
-		gchar *cThemeDockConfFile, *cUserDockConfFile;
-		while ((cDockConfFile = g_dir_read_name (dir)) != NULL)
+		const gchar *cFileName;
+		gchar *cStem, *cFilePath;
+		while ((cFileName = g_dir_read_name (dir)) != NULL)
 		{
-			if (g_str_has_suffix (cDockConfFile, ".conf"))
+			if (g_hash_table_lookup (pNames, cFileName) != NULL)  // same file, it will be updated if needed.
+				continue;
+			ext = strrchr (cFileName, '.');
+			cStem = (ext ? g_strndup (cFileName, ext - cFileName) : g_strdup (cFileName));
+			if (g_hash_table_lookup (pStems, cStem) != NULL)
 			{
-				cThemeDockConfFile = g_strdup_printf ("%s/%s", cNewThemePath, cDockConfFile);
-				cUserDockConfFile = g_strdup_printf ("%s/%s", g_cCurrentThemePath, cDockConfFile);
-				if (g_file_test (cUserDockConfFile, G_FILE_TEST_EXISTS))
-				{
-					cairo_dock_merge_conf_files (cUserDockConfFile, cThemeDockConfFile, '+');
-				}
-				else
-				{
-					cairo_dock_copy_file (cThemeDockConfFile, cUserDockConfFile);
-				}
-				g_free (cUserDockConfFile);
-				g_free (cThemeDockConfFile);
+				cFilePath = g_strdup_printf ("%s/%s", cIconsPath, cFileName);
+				g_remove (cFilePath);
+				g_free (cFilePath);
 			}
+			g_free (cStem);
 		}
 		g_dir_close (dir);
 	}
+	g_hash_table_destroy (pStems);
+	g_hash_table_destroy (pNames);
+}
+
+// copy the files of a theme into the current theme. It doesn't touch the dock, so it can be done in a thread.
+static void _copy_theme_files (const gchar *cNewThemePath, gboolean bLoadBehavior, gboolean bLoadLaunchers)
+{
+	const gchar *cExcludedConf[] = {"*.conf", NULL};
+	const gchar *cExcludedConfAndLaunchers[] = {"*.conf", CAIRO_DOCK_LAUNCHERS_DIR, NULL};
+	GHashTable *pNames;
+	
+	//\___________________ We load global behaviour parameters for each dock (otherwise they will be merged at the end).
+	if (bLoadBehavior)
+	{
+		_replace_files (cNewThemePath, g_cCurrentThemePath, "*.conf");
+	}
 	
 	//\___________________ We load icons
-	if (bLoadLaunchers)
+	gchar *cNewLocalIconsPath = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_LOCAL_ICONS_DIR);
+	gchar *cNewLaunchersPath = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_LAUNCHERS_DIR);
+	gboolean bOldTheme = ! g_file_test (cNewLocalIconsPath, G_FILE_TEST_IS_DIR);  // it's an old theme: its icons are in the launchers dir, move them to the dir 'icons'.
+	if (bLoadLaunchers)  // remove the current icons and images, except the ones that will be replaced.
 	{
-		g_string_printf (sCommand, "rm -f \"%s\"/*", g_cCurrentIconsPath);
-		_launch_cmd (sCommand->str);
-		g_string_printf (sCommand, "rm -f \"%s\"/.*", g_cCurrentIconsPath);
-		_launch_cmd (sCommand->str);
+		pNames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		if (bOldTheme)
+			_copy_files_flat (cNewLaunchersPath, NULL, "*.desktop", NULL, pNames);
+		else
+			_copy_files (cNewLocalIconsPath, NULL, "*", NULL, FALSE, pNames);
+		_remove_files (g_cCurrentIconsPath, NULL, NULL, pNames);
+		g_hash_table_destroy (pNames);
 		
-		g_string_printf (sCommand, "rm -f \"%s\"/*", g_cCurrentImagesPath);
-		_launch_cmd (sCommand->str);
-		g_string_printf (sCommand, "rm -f \"%s\"/.*", g_cCurrentImagesPath);
-		_launch_cmd (sCommand->str);
+		pNames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		if (bLoadBehavior)  // the 'images' dir is copied with the other folders of the theme.
+		{
+			gchar *cNewImagesPath = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_LOCAL_IMAGES_DIR);
+			_copy_files (cNewImagesPath, NULL, NULL, NULL, TRUE, pNames);
+			g_free (cNewImagesPath);
+		}
+		_remove_files (g_cCurrentImagesPath, NULL, NULL, pNames);
+		g_hash_table_destroy (pNames);
 	}
-	gchar *cNewLocalIconsPath = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_LOCAL_ICONS_DIR);
-	if (! g_file_test (cNewLocalIconsPath, G_FILE_TEST_IS_DIR))  // it's an old theme: move icons to a new dir 'icons'.
+	if (bOldTheme)
 	{
-		g_string_printf (sCommand, "find \"%s/%s\" -mindepth 1 ! -name '*.desktop' -exec cp '{}' '%s' \\;", cNewThemePath, CAIRO_DOCK_LAUNCHERS_DIR, g_cCurrentIconsPath);
+		_copy_files_flat (cNewLaunchersPath, g_cCurrentIconsPath, "*.desktop", NULL, NULL);
 	}
 	else
 	{
-		g_string_printf (sCommand, "for f in \"%s\"/* ; do rm -f \"%s/`basename \"${f%%.*}\"`\"*; done;", cNewLocalIconsPath, g_cCurrentIconsPath);  // we erase double items because we could have x.png and x.svg and the dock will not know which it has to use.
-		_launch_cmd (sCommand->str);
-		
-		g_string_printf (sCommand, "cp \"%s\"/* \"%s\"", cNewLocalIconsPath, g_cCurrentIconsPath);
+		if (! bLoadLaunchers)
+			_remove_double_icons (cNewLocalIconsPath, g_cCurrentIconsPath);
+		_copy_files (cNewLocalIconsPath, g_cCurrentIconsPath, "*", NULL, FALSE, NULL);
 	}
-	_launch_cmd (sCommand->str);
 	g_free (cNewLocalIconsPath);
 	
 	//\___________________ We load extras.
-	g_string_printf (sCommand, "%s/%s", cNewThemePath, CAIRO_DOCK_LOCAL_EXTRAS_DIR);
-	if (g_file_test (sCommand->str, G_FILE_TEST_IS_DIR))
-	{
-		g_string_printf (sCommand, "cp -r \"%s/%s\"/* \"%s\"", cNewThemePath, CAIRO_DOCK_LOCAL_EXTRAS_DIR, g_cExtrasDirPath);
-		_launch_cmd (sCommand->str);
-	}
+	gchar *cNewExtrasPath = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_LOCAL_EXTRAS_DIR);
+	_copy_files (cNewExtrasPath, g_cExtrasDirPath, "*", NULL, TRUE, NULL);
+	g_free (cNewExtrasPath);
 	
 	//\___________________ We load launcher if needed after having removed old ones.
-	if (! g_file_test (g_cCurrentLaunchersPath, G_FILE_TEST_EXISTS))
-	{
-		g_string_printf (sCommand, "mkdir -p \"%s\"", g_cCurrentLaunchersPath);
-		_launch_cmd (sCommand->str);
-	}
-	if (g_pMainDock == NULL || bLoadLaunchers)
+	g_mkdir_with_parents (g_cCurrentLaunchersPath, 7*8*8+7*8+5);
+	if (bLoadLaunchers)
 	{
-		g_string_printf (sCommand, "rm -f \"%s\"/*.desktop", g_cCurrentLaunchersPath);
-		_launch_cmd (sCommand->str);
-
-		g_string_printf (sCommand, "cp \"%s/%s\"/*.desktop \"%s\"", cNewThemePath, CAIRO_DOCK_LAUNCHERS_DIR, g_cCurrentLaunchersPath);
-		_launch_cmd (sCommand->str);
+		_replace_files (cNewLaunchersPath, g_cCurrentLaunchersPath, "*.desktop");
 	}
+	g_free (cNewLaunchersPath);
 	
 	//\___________________ We replace all files by the new ones.
-	g_string_printf (sCommand, "find \"%s\" -mindepth 1 -maxdepth 1  ! -name '*.conf' -type f -exec rm -f '{}' \\;", g_cCurrentThemePath);  // remove all ficher of the theme except launchers and plugins.
-	_launch_cmd (sCommand->str);
-
-	if (g_pMainDock == NULL || bLoadBehavior)
-	{
-		g_string_printf (sCommand, "find \"%s\"/* -prune ! -name '*.conf' ! -name %s -exec cp -r '{}' \"%s\" \\;", cNewThemePath, CAIRO_DOCK_LAUNCHERS_DIR, g_cCurrentThemePath);  // Copy all files of the new theme except launchers and .conf files in the dir of the current theme. Overwrite files with same names
-		_launch_cmd (sCommand->str);
-	}
+	// remove all files of the theme except the .conf, launchers and plugins; the ones that are replaced are kept, and will be copied only if they changed.
+	pNames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	if (bLoadBehavior)
+		_copy_files (cNewThemePath, NULL, "*", cExcludedConfAndLaunchers, TRUE, pNames);
 	else
+		_copy_files_flat (cNewThemePath, NULL, "*.conf", CAIRO_DOCK_LAUNCHERS_DIR, pNames);
+	_remove_files (g_cCurrentThemePath, NULL, cExcludedConf, pNames);
+	g_hash_table_destroy (pNames);
+	
+	if (bLoadBehavior)  // Copy all files of the new theme except launchers and .conf files in the dir of the current theme. Overwrite files with same names
+		_copy_files (cNewThemePath, g_cCurrentThemePath, "*", cExcludedConfAndLaunchers, TRUE, NULL);
+	else  // We copy all files of the new theme except launchers and .conf files (dock and plug-ins); the .conf files are merged afterwards.
+		_copy_files_flat (cNewThemePath, g_cCurrentThemePath, "*.conf", CAIRO_DOCK_LAUNCHERS_DIR, NULL);
+}
+
+// merge the .conf files of a theme with the ones of the current theme, when we keep the current behaviour.
+static void _merge_theme_conf_files (const gchar *cNewThemePath)
+{
+	//\___________________ .conf files of the docks.
+	GDir *dir = g_dir_open (cNewThemePath, 0, NULL);
+	const gchar* cDockConfFile;
+	gchar *cThemeDockConfFile, *cUserDockConfFile;
+	while ((cDockConfFile = g_dir_read_name (dir)) != NULL)
 	{
-		// We copy all files of the new theme except launchers and .conf files (dock and plug-ins).
-		g_string_printf (sCommand, "find \"%s\" -mindepth 1 ! -name '*.conf' ! -path '%s/%s*' ! -type d -exec cp -p {} \"%s\" \\;", cNewThemePath, cNewThemePath, CAIRO_DOCK_LAUNCHERS_DIR, g_cCurrentThemePath);
-		_launch_cmd (sCommand->str);
-		
-		// iterate all .conf files of all plug-ins, then update them and merge them with the current theme.
-		gchar *cNewPlugInsDir = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_PLUG_INS_DIR);  // dir of plug-ins of the new theme.
-		GDir *dir = g_dir_open (cNewPlugInsDir, 0, NULL);  // NULL if this theme doesn't have any 'plug-ins' dir.
-		const gchar* cModuleDirName;
-		gchar *cConfFilePath, *cNewConfFilePath, *cUserDataDirPath, *cConfFileName;
-		do
+		if (g_str_has_suffix (cDockConfFile, ".conf"))
 		{
-			cModuleDirName = g_dir_read_name (dir);  // name of the dir of the theme (maybe != of theme's name)
-			if (cModuleDirName == NULL)
-				break ;
-			
-			// we create dir of the plug-in of the current theme.
-			cd_debug ("  installing %s's config", cModuleDirName);
-			cUserDataDirPath = g_strdup_printf ("%s/%s", g_cCurrentPlugInsPath, cModuleDirName);  // dir of the plug-in in the current theme.
-			if (! g_file_test (cUserDataDirPath, G_FILE_TEST_EXISTS | G_FILE_TEST_IS_DIR))
+			cThemeDockConfFile = g_strdup_printf ("%s/%s", cNewThemePath, cDockConfFile);
+			cUserDockConfFile = g_strdup_printf ("%s/%s", g_cCurrentThemePath, cDockConfFile);
+			if (g_file_test (cUserDockConfFile, G_FILE_TEST_EXISTS))
 			{
-				cd_debug ("    directory %s doesn't exist, it will be created.", cUserDataDirPath);
-				
-				g_string_printf (sCommand, "mkdir -p \"%s\"", cUserDataDirPath);
-				_launch_cmd (sCommand->str);
+				cairo_dock_merge_conf_files (cUserDockConfFile, cThemeDockConfFile, '+');
 			}
-			
-			// we find the name and path of the .conf file of the plugin in the new theme.
-			cConfFileName = g_strdup_printf ("%s.conf", cModuleDirName);
-			cNewConfFilePath = g_strdup_printf ("%s/%s/%s", cNewPlugInsDir, cModuleDirName, cConfFileName);
-			if (! g_file_test (cNewConfFilePath, G_FILE_TEST_EXISTS))
+			else
 			{
-				g_free (cConfFileName);
-				g_free (cNewConfFilePath);
-				GldiModule *pModule = gldi_module_foreach ((GHRFunc) _find_module_from_user_data_dir, (gpointer) cModuleDirName);
-				if (pModule == NULL)  // in this case, we don't load non used plugins.
-				{
-					cd_warning ("couldn't find the module owning '%s', this file will be ignored.");
-					continue;
-				}
-				cConfFileName = g_strdup (pModule->pVisitCard->cConfFileName);
-				cNewConfFilePath = g_strdup_printf ("%s/%s/%s", cNewPlugInsDir, cModuleDirName, cConfFileName);
+				cairo_dock_copy_file (cThemeDockConfFile, cUserDockConfFile);
 			}
-			cConfFilePath = g_strdup_printf ("%s/%s", cUserDataDirPath, cConfFileName);  // path of the .conf file of the current theme.
+			g_free (cUserDockConfFile);
+			g_free (cThemeDockConfFile);
+		}
+	}
+	g_dir_close (dir);
+	
+	//\___________________ iterate all .conf files of all plug-ins, then update them and merge them with the current theme.
+	gchar *cNewPlugInsDir = g_strdup_printf ("%s/%s", cNewThemePath, CAIRO_DOCK_PLUG_INS_DIR);  // dir of plug-ins of the new theme.
+	dir = g_dir_open (cNewPlugInsDir, 0, NULL);  // NULL if this theme doesn't have any 'plug-ins' dir.
+	const gchar* cModuleDirName;
+	gchar *cConfFilePath, *cNewConfFilePath, *cUserDataDirPath, *cConfFileName;
+	do
+	{
+		cModuleDirName = g_dir_read_name (dir);  // name of the dir of the theme (maybe != of theme's name)
+		if (cModuleDirName == NULL)
+			break ;
+		
+		// we create dir of the plug-in of the current theme.
+		cd_debug ("  installing %s's config", cModuleDirName);
+		cUserDataDirPath = g_strdup_printf ("%s/%s", g_cCurrentPlugInsPath, cModuleDirName);  // dir of the plug-in in the current theme.
+		if (! g_file_test (cUserDataDirPath, G_FILE_TEST_EXISTS | G_FILE_TEST_IS_DIR))
+		{
+			cd_debug ("    directory %s doesn't exist, it will be created.", cUserDataDirPath);
 			
-			// we merge these 2 .conf files.
-			if (! g_file_test (cConfFilePath, G_FILE_TEST_EXISTS))
-			{
-				cd_debug ("    no conf file %s, we will take the theme's one", cConfFilePath);
-				cairo_dock_copy_file (cNewConfFilePath, cConfFilePath);
-			}
-			else
+			g_mkdir_with_parents (cUserDataDirPath, 7*8*8+7*8+5);
+		}
+		
+		// we find the name and path of the .conf file of the plugin in the new theme.
+		cConfFileName = g_strdup_printf ("%s.conf", cModuleDirName);
+		cNewConfFilePath = g_strdup_printf ("%s/%s/%s", cNewPlugInsDir, cModuleDirName, cConfFileName);
+		if (! g_file_test (cNewConfFilePath, G_FILE_TEST_EXISTS))
+		{
+			g_free (cConfFileName);
+			g_free (cNewConfFilePath);
+			GldiModule *pModule = gldi_module_foreach ((GHRFunc) _find_module_from_user_data_dir, (gpointer) cModuleDirName);
+			if (pModule == NULL)  // in this case, we don't load non used plugins.
 			{
-				cairo_dock_merge_conf_files (cConfFilePath, cNewConfFilePath, '+');
+				cd_warning ("couldn't find the module owning '%s', this file will be ignored.", cModuleDirName);
+				g_free (cUserDataDirPath);
+				continue;
 			}
-			g_free (cNewConfFilePath);
-			g_free (cConfFilePath);
-			g_free (cUserDataDirPath);
-			g_free (cConfFileName);
+			cConfFileName = g_strdup (pModule->pVisitCard->cConfFileName);
+			cNewConfFilePath = g_strdup_printf ("%s/%s/%s", cNewPlugInsDir, cModuleDirName, cConfFileName);
 		}
-		while (1);
-		g_dir_close (dir);
-		g_free (cNewPlugInsDir);
+		cConfFilePath = g_strdup_printf ("%s/%s", cUserDataDirPath, cConfFileName);  // path of the .conf file of the current theme.
+		
+		// we merge these 2 .conf files.
+		if (! g_file_test (cConfFilePath, G_FILE_TEST_EXISTS))
+		{
+			cd_debug ("    no conf file %s, we will take the theme's one", cConfFilePath);
+			cairo_dock_copy_file (cNewConfFilePath, cConfFilePath);
+		}
+		else
+		{
+			cairo_dock_merge_conf_files (cConfFilePath, cNewConfFilePath, '+');
+		}
+		g_free (cNewConfFilePath);
+		g_free (cConfFilePath);
+		g_free (cUserDataDirPath);
+		g_free (cConfFileName);
+	}
+	while (1);
+	g_dir_close (dir);
+	g_free (cNewPlugInsDir);
+}
+
+// copy the files of a local theme into the current theme. It only deals with files, so it can be done in a thread; the import is then finished on the main loop by _finish_local_theme_import().
+// once the copy has started, it is not cancelled (the current theme would be left half-replaced), but files that didn't change are not copied again, so it's fast when switching between 2 themes.
+static gboolean _copy_local_theme (const gchar *cNewThemePath, gboolean bLoadBehavior, gboolean bLoadLaunchers, gint *pCancel)
+{
+	g_return_val_if_fail (cNewThemePath != NULL && g_file_test (cNewThemePath, G_FILE_TEST_EXISTS), FALSE);
+	
+	g_mutex_lock (&s_ImportMutex);  // 2 imports must not write in the current theme at the same time.
+	while (s_bImportPending)  // wait until the previous import has been finished on the main loop.
+		g_cond_wait (&s_ImportCond, &s_ImportMutex);
+	if (pCancel != NULL && g_atomic_int_get (pCancel))
+	{
+		g_mutex_unlock (&s_ImportMutex);
+		return FALSE;
 	}
+	s_bImportPending = TRUE;
+	g_mutex_unlock (&s_ImportMutex);
 	
-	g_string_printf (sCommand, "rm -f \"%s/last-modif\"", g_cCurrentThemePath);
-	_launch_cmd (sCommand->str);
+	cd_message ("Applying changes ...");
+	g_atomic_int_set (&s_iNbProcessedFiles, 0);
+	
+	//\___________________ We copy the files of the theme.
+	_copy_theme_files (cNewThemePath, bLoadBehavior, bLoadLaunchers);
+	
+	gchar *cLastModifFile = g_strdup_printf ("%s/last-modif", g_cCurrentThemePath);
+	g_remove (cLastModifFile);
+	g_free (cLastModifFile);
 	
 	// precaution maybe useless.
-	g_string_printf (sCommand, "chmod -R 775 \"%s\"", g_cCurrentThemePath);
-	_launch_cmd (sCommand->str);
+	_set_permissions (g_cCurrentThemePath);
+	return TRUE;
+}
+
+// finish the import of a theme whose files have been copied: it needs the modules, so it's done on the main loop.
+static void _finish_local_theme_import (const gchar *cNewThemePath, gboolean bLoadBehavior)
+{
+	//\___________________ We merge the .conf files if we keep the current behaviour.
+	if (! bLoadBehavior)
+		_merge_theme_conf_files (cNewThemePath);
 	
 	cairo_dock_mark_current_theme_as_modified (FALSE);
 	
-	g_string_free (sCommand, TRUE);
-	return TRUE;
+	g_mutex_lock (&s_ImportMutex);
+	s_bImportPending = FALSE;
+	g_cond_signal (&s_ImportCond);
+	g_mutex_unlock (&s_ImportMutex);
 }
 
 gboolean cairo_dock_import_theme (const gchar *cThemeName, gboolean bLoadBehavior, gboolean bLoadLaunchers)
@@ -637,55 +876,82 @@ gboolean cairo_dock_import_theme (const gchar *cThemeName, gboolean bLoadBehavio
 	g_return_val_if_fail (cNewThemePath != NULL && g_file_test (cNewThemePath, G_FILE_TEST_EXISTS), FALSE);
 	
 	//\___________________ import the theme in the current theme.
-	gboolean bSuccess = _cairo_dock_import_local_theme (cNewThemePath, bLoadBehavior, bLoadLaunchers);
+	if (g_pMainDock == NULL)  // first launch: everything is taken from the theme.
+		bLoadBehavior = bLoadLaunchers = TRUE;
+	gboolean bSuccess = _copy_local_theme (cNewThemePath, bLoadBehavior, bLoadLaunchers, NULL);
+	if (bSuccess)
+		_finish_local_theme_import (cNewThemePath, bLoadBehavior);
 	g_free (cNewThemePath);
 	return bSuccess;
 }
 
 
-static void _import_theme (gpointer *pSharedMemory)  // import the theme on the disk; the actual copy of the files is not done here, because we want to be able to cancel the task.
+typedef struct {
+	gchar *cThemeName;  // replaced by the local path of the theme once it has been downloaded.
+	gboolean bLoadBehavior;
+	gboolean bLoadLaunchers;
+	GFunc pCallback;
+	gpointer data;
+	gint *pCancel;  // the 'discard' flag of the task.
+	gboolean bSuccess;  // TRUE once the files have been copied into the current theme.
+	gboolean bFinished;  // TRUE once the import has been finished on the main loop.
+} CDThemeImport;
+
+static void _import_theme (CDThemeImport *pImport)  // download the theme and copy its files in the current theme.
 {
 	cd_debug ("dl start");
-	gchar *cNewThemePath = _cairo_dock_get_theme_path (pSharedMemory[0]);
-	g_free (pSharedMemory[0]);
-	pSharedMemory[0] = cNewThemePath;
+	gchar *cNewThemePath = _cairo_dock_get_theme_path (pImport->cThemeName);
+	g_free (pImport->cThemeName);
+	pImport->cThemeName = cNewThemePath;
 	cd_debug ("dl over");
+	
+	if (cNewThemePath != NULL && g_file_test (cNewThemePath, G_FILE_TEST_EXISTS))
+		pImport->bSuccess = _copy_local_theme (cNewThemePath, pImport->bLoadBehavior, pImport->bLoadLaunchers, pImport->pCancel);
 }
-static gboolean _finish_import (gpointer *pSharedMemory)  // once the theme is local, we can import it in the current theme.
+static gboolean _finish_import (CDThemeImport *pImport)  // once the files are copied, finish the import and let the caller load the theme.
 {
-	gboolean bSuccess;
-	if (! pSharedMemory[0])
-	{
+	if (! pImport->cThemeName)
 		cd_warning ("Couldn't download the theme.");
-		bSuccess = FALSE;
-	}
-	else
+	
+	if (pImport->bSuccess)
 	{
-		bSuccess = _cairo_dock_import_local_theme (pSharedMemory[0], GPOINTER_TO_INT (pSharedMemory[1]), GPOINTER_TO_INT (pSharedMemory[2]));
+		_finish_local_theme_import (pImport->cThemeName, pImport->bLoadBehavior);
+		pImport->bFinished = TRUE;
 	}
 	
-	GFunc pCallback = pSharedMemory[3];
-	pCallback (GINT_TO_POINTER (bSuccess), pSharedMemory[4]);
+	pImport->pCallback (GINT_TO_POINTER (pImport->bSuccess), pImport->data);
 	return FALSE;
 }
-static void _discard_import (gpointer *pSharedMemory)
+static void _discard_import (CDThemeImport *pImport)
 {
-	g_free (pSharedMemory[0]);
-	g_free (pSharedMemory);
+	if (pImport->bSuccess && ! pImport->bFinished)  // the task was discarded once the current theme had been modified: finish the import and load it ourselves, since the caller is not there any more.
+	{
+		_finish_local_theme_import (pImport->cThemeName, pImport->bLoadBehavior);
+		cairo_dock_load_current_theme ();
+	}
+	g_free (pImport->cThemeName);
+	g_free (pImport);
 }
 GldiTask *cairo_dock_import_theme_async (const gchar *cThemeName, gboolean bLoadBehavior, gboolean bLoadLaunchers, GFunc pCallback, gpointer data)
 {
-	gpointer *pSharedMemory = g_new0 (gpointer, 5);
-	pSharedMemory[0] = g_strdup (cThemeName);
-	pSharedMemory[1] = GINT_TO_POINTER (bLoadBehavior);
-	pSharedMemory[2] = GINT_TO_POINTER (bLoadLaunchers);
-	pSharedMemory[3] = pCallback;
-	pSharedMemory[4] = data;
-	GldiTask *pTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc) _import_theme, (GldiUpdateSyncFunc) _finish_import, (GFreeFunc) _discard_import, pSharedMemory);
+	CDThemeImport *pImport = g_new0 (CDThemeImport, 1);
+	pImport->cThemeName = g_strdup (cThemeName);
+	pImport->bLoadBehavior = (g_pMainDock == NULL || bLoadBehavior);
+	pImport->bLoadLaunchers = (g_pMainDock == NULL || bLoadLaunchers);
+	pImport->pCallback = pCallback;
+	pImport->data = data;
+	g_atomic_int_set (&s_iNbProcessedFiles, 0);
+	GldiTask *pTask = gldi_task_new_full (0, (GldiGetDataAsyncFunc) _import_theme, (GldiUpdateSyncFunc) _finish_import, (GFreeFunc) _discard_import, pImport);
+	pImport->pCancel = &pTask->bDiscard;  // the task is only freed once the thread is over.
 	gldi_task_launch (pTask);
 	return pTask;
 }
 
+gint cairo_dock_get_theme_import_progress (void)
+{
+	return g_atomic_int_get (&s_iNbProcessedFiles);
+}
+
 
 #define _check_dir(cDirPath) \
 	if (! g_file_test (cDirPath, G_FILE_TEST_IS_DIR)) {\
@@ -76,7 +76,7 @@ gchar * cairo_dock_depackage_theme (const gchar *cPackagePath);
  */
 gboolean cairo_dock_delete_themes (gchar **cThemesList);
 
-/** Import a theme, which can be : a local theme, a user theme, a distant theme, or even the path to a packaged theme.
+/** Import a theme, which can be : a local theme, a user theme, a distant theme, or even the path to a packaged theme. It blocks the main loop, so it must not be called while an asynchronous import is running.
  * @param cThemeName name of the theme to import.
  * @param bLoadBehavior whether to import the behavior parameters too.
  * @param bLoadLaunchers whether to import the launchers too.
@@ -85,7 +85,7 @@ gboolean cairo_dock_delete_themes (gchar **cThemesList);
 gboolean cairo_dock_import_theme (const gchar *cThemeName, gboolean bLoadBehavior, gboolean bLoadLaunchers);
 
 /** Asynchronously import a theme, which can be : a local theme, a user theme, a distant theme, or even the path to a packaged theme. This function is non-blocking, you'll get a CairoTask that you can discard at any time, and you'll get the result of the import as the first argument of the callback (the second being the data you passed to this function).
- * Note that only downloading or unpacking the theme is done asynchronously, actually copying the files in the current theme folder is not (because it couldn't be cancelled without first making a backup).
+ * The files are copied into the current theme folder asynchronously too, and files that didn't change are not copied again. Once the copy has started, discarding the task doesn't stop it (the current theme would be left half-replaced); the callback is not called, but the import is still finished and the current theme reloaded on the main loop.
  * @param cThemeName name of the theme to import.
  * @param bLoadBehavior whether to import the behavior parameters too.
  * @param bLoadLaunchers whether to import the launchers too.
@@ -95,6 +95,11 @@ gboolean cairo_dock_import_theme (const gchar *cThemeName, gboolean bLoadBehavio
  */
 GldiTask *cairo_dock_import_theme_async (const gchar *cThemeName, gboolean bLoadBehavior, gboolean bLoadLaunchers, GFunc pCallback, gpointer data);
 
+/** Get the progress of the current import of a theme.
+ * @return the number of files that have been processed so far.
+ */
+gint cairo_dock_get_theme_import_progress (void);
+
 /** Define the paths of themes. Do it just after 'gldi_init'.
 *@param cRootDataDirPath path to the root folder of libgldi
 *@param cExtraDirPath path to the extras themes (plug-in themes)
@@ -20,6 +20,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <glib.h>
+#include <gio/gio.h>  // GSubprocess
 
 #include <cairo-dock-log.h>
 #include <cairo-dock-file-manager.h>  // g_iDesktopEnv
@@ -270,6 +271,83 @@ gchar *cairo_dock_launch_command_sync_with_stderr (const gchar *cCommand, gboole
 	return standard_output;
 }
 
+typedef struct {
+	CairoDockCommandResultFunc pCallback;
+	gpointer data;
+	guint iSidTimeout;
+} CDCommandAsync;
+
+static gboolean _on_command_timeout (GSubprocess *pProcess)
+{
+	cd_warning ("a command took too long (pid %s), killing it", g_subprocess_get_identifier (pProcess));
+	g_subprocess_force_exit (pProcess);  // the output is then received as usual.
+	CDCommandAsync *pCmd = g_object_get_data (G_OBJECT (pProcess), "cd-command");
+	if (pCmd)
+		pCmd->iSidTimeout = 0;
+	return FALSE;
+}
+
+static void _on_command_finished (GSubprocess *pProcess, GAsyncResult *res, CDCommandAsync *pCmd)
+{
+	gchar *cOutput = NULL;
+	GError *erreur = NULL;
+	if (pCmd->iSidTimeout != 0)
+		g_source_remove (pCmd->iSidTimeout);
+	g_object_set_data (G_OBJECT (pProcess), "cd-command", NULL);
+	
+	if (! g_subprocess_communicate_utf8_finish (pProcess, res, &cOutput, NULL, &erreur))
+	{
+		cd_warning (erreur->message);
+		g_error_free (erreur);
+	}
+	else if (! g_subprocess_get_successful (pProcess) && ! g_subprocess_get_if_exited (pProcess))  // killed.
+	{
+		g_free (cOutput);
+		cOutput = NULL;
+	}
+	// same output as cairo_dock_launch_command_sync
+	if (cOutput != NULL && *cOutput == '\0')
+	{
+		g_free (cOutput);
+		cOutput = NULL;
+	}
+	if (cOutput != NULL && cOutput[strlen (cOutput) - 1] == '\n')
+		cOutput[strlen (cOutput) - 1] = '\0';
+	
+	pCmd->pCallback (cOutput, pCmd->data);
+	g_free (cOutput);
+	g_free (pCmd);
+	g_object_unref (pProcess);
+}
+
+void cairo_dock_launch_command_async (const gchar *cCommand, gint iTimeout, CairoDockCommandResultFunc pCallback, gpointer data)
+{
+	g_return_if_fail (cCommand != NULL && pCallback != NULL);
+	gchar **argv = NULL;
+	GError *erreur = NULL;
+	GSubprocess *pProcess = NULL;
+	if (g_shell_parse_argv (cCommand, NULL, &argv, &erreur))
+		pProcess = g_subprocess_newv ((const gchar * const *)argv, G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE, &erreur);
+	g_strfreev (argv);
+	if (pProcess == NULL)
+	{
+		cd_warning ("couldn't launch '%s': %s", cCommand, erreur->message);
+		g_error_free (erreur);
+		pCallback (NULL, data);
+		return;
+	}
+	
+	CDCommandAsync *pCmd = g_new0 (CDCommandAsync, 1);
+	pCmd->pCallback = pCallback;
+	pCmd->data = data;
+	if (iTimeout > 0)
+	{
+		g_object_set_data (G_OBJECT (pProcess), "cd-command", pCmd);
+		pCmd->iSidTimeout = g_timeout_add_seconds (iTimeout, (GSourceFunc) _on_command_timeout, pProcess);
+	}
+	g_subprocess_communicate_utf8_async (pProcess, NULL, NULL, (GAsyncReadyCallback) _on_command_finished, pCmd);
+}
+
 gboolean cairo_dock_launch_command_printf (const gchar *cCommandFormat, const gchar *cWorkingDirectory, ...)
 {
 	va_list args;
@@ -368,6 +446,66 @@ gchar * cairo_dock_get_command_with_right_terminal (const gchar *cCommand)
 }
 
 
+// look for a .desktop file in a folder and its sub-folders, from its file name (bSearchContent = FALSE) or its content; cClass is in lower case.
+static gchar *_search_desktop_file_in_dir (const gchar *cDirPath, const gchar *cClass, gboolean bSearchContent, int iDepth)
+{
+	GDir *dir = g_dir_open (cDirPath, 0, NULL);
+	if (dir == NULL)
+		return NULL;
+	gchar *cResult = NULL;
+	const gchar *cFileName;
+	while (cResult == NULL && (cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		gchar *cFilePath = g_strdup_printf ("%s/%s", cDirPath, cFileName);
+		if (g_file_test (cFilePath, G_FILE_TEST_IS_DIR))
+		{
+			// don't follow links to folders: they could loop, and point to folders that are searched anyway.
+			if (iDepth < 8 && ! g_file_test (cFilePath, G_FILE_TEST_IS_SYMLINK))
+				cResult = _search_desktop_file_in_dir (cFilePath, cClass, bSearchContent, iDepth + 1);
+		}
+		else if (g_str_has_suffix (cFileName, ".desktop"))
+		{
+			gchar *cText = NULL;
+			if (! bSearchContent)
+				cText = g_ascii_strdown (cFileName, -1);
+			else if (g_file_get_contents (cFilePath, &cText, NULL, NULL))
+			{
+				gchar *tmp = g_ascii_strdown (cText, -1);
+				g_free (cText);
+				cText = tmp;
+			}
+			if (cText != NULL && strstr (cText, cClass) != NULL)
+			{
+				cResult = cFilePath;
+				cFilePath = NULL;
+			}
+			g_free (cText);
+		}
+		g_free (cFilePath);
+	}
+	g_dir_close (dir);
+	return cResult;
+}
+
+gchar *cairo_dock_search_desktop_file (const gchar *cClass, const gchar * const *cDirs)
+{
+	g_return_val_if_fail (cClass != NULL, NULL);
+	const gchar *cDefaultDirs[] = {"/usr/share/applications", "/usr/local/share/applications", NULL};
+	if (cDirs == NULL)
+		cDirs = cDefaultDirs;
+	gchar *cLowerClass = g_ascii_strdown (cClass, -1);
+	gchar *cResult = NULL;
+	int i, j;
+	for (j = 0; j < 2 && cResult == NULL; j ++)  // first look for a desktop file from their file name, then search harder from their content.
+	{
+		for (i = 0; cDirs[i] != NULL && cResult == NULL; i ++)
+			cResult = _search_desktop_file_in_dir (cDirs[i], cLowerClass, j == 1, 0);
+	}
+	g_free (cLowerClass);
+	return cResult;
+}
+
+
 #ifdef HAVE_X11
 
 #include <gdk/gdkx.h>  // gdk_x11_get_default_xdisplay
@@ -62,6 +62,17 @@ gboolean cairo_dock_string_contains (const char *cNames, const gchar *cName, con
 gchar *cairo_dock_launch_command_sync_with_stderr (const gchar *cCommand, gboolean bPrintStdErr);
 #define cairo_dock_launch_command_sync(cCommand) cairo_dock_launch_command_sync_with_stderr (cCommand, TRUE)
 
+/// Function called with the output of a command launched asynchronously; the output (without its trailing linefeed) is NULL if the command failed, timed out or printed nothing, and is freed after the call.
+typedef void (*CairoDockCommandResultFunc) (const gchar *cResult, gpointer data);
+
+/** Launch a command and get its output asynchronously, without blocking the main loop like \ref cairo_dock_launch_command_sync does.
+*@param cCommand the command (not interpreted by a shell, like with cairo_dock_launch_command_sync).
+*@param iTimeout time in seconds after which the command is killed, or 0 to wait for it indefinitely.
+*@param pCallback function called once the command has finished; it's always called, even on failure.
+*@param data data passed to the callback.
+*/
+void cairo_dock_launch_command_async (const gchar *cCommand, gint iTimeout, CairoDockCommandResultFunc pCallback, gpointer data);
+
 gboolean cairo_dock_launch_command_printf (const gchar *cCommandFormat, const gchar *cWorkingDirectory, ...) G_GNUC_PRINTF (1, 3);
 gboolean cairo_dock_launch_command_full (const gchar *cCommand, const gchar *cWorkingDirectory);
 #define cairo_dock_launch_command(cCommand) cairo_dock_launch_command_full (cCommand, NULL)
@@ -74,6 +85,13 @@ const gchar * cairo_dock_get_default_terminal (void);
  */
 gchar * cairo_dock_get_command_with_right_terminal (const gchar *cCommand);
 
+/** Look for the .desktop file of an application in some folders and their sub-folders: first from the name of the files, then from their content (case-insensitive). The folders are read directly, no command is launched; links to folders are not followed. It can take a while, so prefer calling it from a thread (a GldiTask for instance).
+*@param cClass class of the application
+*@param cDirs NULL-terminated list of folders, or NULL for the usual folders of the applications.
+*@return the path of the .desktop file, or NULL if none has been found. Free it with g_free.
+*/
+gchar *cairo_dock_search_desktop_file (const gchar *cClass, const gchar * const *cDirs);
+
 /* Like g_strcmp0, but saves a function call.
 */
 #define gldi_strings_differ(s1, s2) (!s1 ? s2 != NULL : !s2 ? s1 != NULL : strcmp(s1, s2) != 0)
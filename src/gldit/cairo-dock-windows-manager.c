@@ -283,6 +283,15 @@ GldiWindowActor *gldi_window_pick (void)
 	return NULL;
 }
 
+void gldi_window_pick_async (GldiWindowPickFunc callback, gpointer data)
+{
+	g_return_if_fail (callback != NULL);
+	if (s_backend.pick_window_async)
+		s_backend.pick_window_async (callback, data);
+	else  // the backend can only wait for the click.
+		callback (gldi_window_pick (), data);
+}
+
 
   /////////////////
  /// UTILITIES ///
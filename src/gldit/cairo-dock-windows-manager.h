@@ -53,6 +53,9 @@ typedef enum {
 
 // data
 
+/// Definition of a function called when a window has been picked (the actor is NULL if the picking has been cancelled).
+typedef void (*GldiWindowPickFunc) (GldiWindowActor *actor, gpointer data);
+
 /// Definition of the Windows Manager backend.
 struct _GldiWindowManagerBackend {
 	GldiWindowActor* (*get_active_window) (void);
@@ -77,6 +80,7 @@ struct _GldiWindowManagerBackend {
 	void (*can_minimize_maximize_close) (GldiWindowActor *actor, gboolean *bCanMinimize, gboolean *bCanMaximize, gboolean *bCanClose);
 	guint (*get_id) (GldiWindowActor *actor);
 	GldiWindowActor* (*pick_window) (void);  // grab the mouse, wait for a click, then get the clicked window and returns its actor
+	void (*pick_window_async) (GldiWindowPickFunc callback, gpointer data);  // same, but returns immediately and gives the actor to the callback
 	} ;
 
 /// Definition of a window actor.
@@ -170,6 +174,12 @@ guint gldi_window_get_id (GldiWindowActor *pAppli);
 
 GldiWindowActor *gldi_window_pick (void);
 
+/** Let the user click on a window, without blocking: the function returns immediately, and the callback gets the actor once the click is done (or NULL if it has been cancelled).
+*@param callback function called with the picked window
+*@param data user data
+*/
+void gldi_window_pick_async (GldiWindowPickFunc callback, gpointer data);
+
 
 void gldi_register_windows_manager (void);
 
@@ -82,6 +82,7 @@
 #include <implementations/cairo-dock-progressbar.h>
 #include <implementations/cairo-dock-graph.h>
 #include <implementations/cairo-dock-gauge.h>
+#include <gldit/cairo-dock-system-metrics.h>
 // base classes
 #include <gldit/cairo-dock-object.h>
 #include <gldit/cairo-dock-manager.h>
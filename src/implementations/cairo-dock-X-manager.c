@@ -110,6 +110,8 @@ struct _GldiXWindowActor {
 	Window Xid;
 	gint iLastCheckTime;
 	Pixmap iBackingPixmap;
+	cairo_surface_t *pThumbnailSurface;  // thumbnail made from the backing pixmap; it doesn't change while the window is minimized, so it's kept until the pixmap is renewed.
+	gint iThumbnailWidth, iThumbnailHeight;  // size of the thumbnail (it's not necessarily an image surface, so its size can't be queried).
 	Window XTransientFor;
 	guint iDemandsAttention;  // a mask of XAttentionFlag
 	gboolean bIgnored;
@@ -250,8 +252,18 @@ static void _on_change_desktop_geometry (gboolean bIsNetDesktopGeometry)
 	gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_GEOMETRY_CHANGED, bSizeChanged || bIsNetDesktopGeometry);
 }
 
+static void _free_thumbnail (GldiXWindowActor *actor)
+{
+	if (actor->pThumbnailSurface != NULL)
+	{
+		cairo_surface_destroy (actor->pThumbnailSurface);
+		actor->pThumbnailSurface = NULL;
+	}
+}
+
 static void _update_backing_pixmap (GldiXWindowActor *actor)
 {
+	_free_thumbnail (actor);  // the window is mapped again, its content may change from now.
 #ifdef HAVE_XEXTEND
 	if (myTaskbarParam.bShowAppli && myTaskbarParam.iMinimizedWindowRenderType == 1 && cairo_dock_xcomposite_is_available ())
 	{
@@ -994,7 +1006,21 @@ static cairo_surface_t* _get_icon_surface (GldiWindowActor *actor, int iWidth, i
 static cairo_surface_t* _get_thumbnail_surface (GldiWindowActor *actor, int iWidth, int iHeight)
 {
 	GldiXWindowActor *xactor = (GldiXWindowActor *)actor;
-	return cairo_dock_create_surface_from_xpixmap (xactor->iBackingPixmap, iWidth, iHeight);
+	if (xactor->pThumbnailSurface != NULL
+	&& (xactor->iThumbnailWidth != iWidth || xactor->iThumbnailHeight != iHeight))
+		_free_thumbnail (xactor);
+	if (xactor->pThumbnailSurface == NULL)
+	{
+		if (xactor->iBackingPixmap == 0)
+			return NULL;
+		xactor->pThumbnailSurface = cairo_dock_create_surface_from_xpixmap (xactor->iBackingPixmap, iWidth, iHeight);
+		if (xactor->pThumbnailSurface == NULL)
+			return NULL;
+		xactor->iThumbnailWidth = iWidth;
+		xactor->iThumbnailHeight = iHeight;
+	}
+	// the caller owns the returned surface and may draw on it (e.g. an emblem), so give it a copy of the thumbnail; it's only the size of an icon.
+	return cairo_dock_duplicate_surface (xactor->pThumbnailSurface, iWidth, iHeight, iWidth, iHeight);
 }
 
 static GLuint _get_texture (GldiWindowActor *actor)
@@ -1040,26 +1066,30 @@ static GldiWindowActor *_pick_window (void)
 	GldiWindowActor *actor = NULL;
 	
 	// let the user grab the window, and get the result.
-	gchar *cProp = cairo_dock_launch_command_sync ("xwininfo");
+	Window Xid = cairo_dock_pick_xwindow ();
 	
 	// get the corresponding actor
-	// look for the window ID in this chain: xwininfo: Window id: 0xc00009 "name-of-the-window"
-	
-	const gchar *str = g_strstr_len (cProp, -1, "Window id");  
-	if (str)
-	{
-		str += 9;  // skip "Window id"
-		while (*str == ' ' || *str == ':')  // skip the ':' and spaces
-			str ++;
-		Window Xid = strtol (str, NULL, 0);  // XID is an unsigned long; we let the base be 0, so that the function guesses by itself.
-		
+	if (Xid != None)
 		actor = g_hash_table_lookup (s_hXWindowTable, &Xid);
-	}
-	g_free (cProp);
 	
 	return actor;
 }
 
+static void _on_xwindow_picked (Window Xid, gpointer *data)
+{
+	GldiWindowPickFunc callback = data[0];
+	gpointer user_data = data[1];
+	g_free (data);
+	callback (Xid != None ? g_hash_table_lookup (s_hXWindowTable, &Xid) : NULL, user_data);
+}
+static void _pick_window_async (GldiWindowPickFunc callback, gpointer user_data)
+{
+	gpointer *data = g_new (gpointer, 2);
+	data[0] = callback;
+	data[1] = user_data;
+	cairo_dock_pick_xwindow_async ((CairoDockPickXWindowFunc) _on_xwindow_picked, data);
+}
+
   /////////////////////////////////
  /// CONTAINER MANAGER BACKEND ///
 /////////////////////////////////
@@ -1266,6 +1296,7 @@ static void init (void)
 	wmb.can_minimize_maximize_close = _can_minimize_maximize_close;
 	wmb.get_id = _get_id;
 	wmb.pick_window = _pick_window;
+	wmb.pick_window_async = _pick_window_async;
 	gldi_windows_manager_register_backend (&wmb);
 	
 	GldiContainerManagerBackend cmb;
@@ -1349,6 +1380,7 @@ static void reset_object (GldiObject *obj)
 		g_hash_table_remove (s_hXWindowTable, &actor->Xid);
 	
 	// free data
+	_free_thumbnail (actor);
 	#ifdef HAVE_XEXTEND
 	if (actor->iBackingPixmap != 0)
 	{
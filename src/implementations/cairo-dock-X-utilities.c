@@ -22,6 +22,8 @@
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 #include <X11/Xutil.h>
+#include <X11/cursorfont.h>  // XC_crosshair
+#include <X11/keysym.h>  // XK_Escape
 #include "gldi-config.h"
 #ifdef HAVE_XEXTEND
 #include <X11/extensions/Xcomposite.h>
@@ -1478,6 +1480,183 @@ Window cairo_dock_get_active_xwindow (void)
 	return xActiveWindow;
 }
 
+// find the client window inside a frame window, i.e. the one having the WM_STATE property (like XmuClientWindow does).
+static Window _find_client_window (Display *display, Window Xid, Atom aWmState, int iDepth)
+{
+	Atom aReturnedType = 0;
+	int aReturnedFormat = 0;
+	unsigned long iLeftBytes, iBufferNbElements = 0;
+	guchar *pBuffer = NULL;
+	XGetWindowProperty (display, Xid, aWmState, 0, 0, False, AnyPropertyType, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pBuffer);
+	if (pBuffer)
+		XFree (pBuffer);
+	if (aReturnedType != None)
+		return Xid;
+	if (iDepth > 5)  // clients are never that deep inside their frame.
+		return None;
+	
+	Window root, parent, *children = NULL, client = None;
+	unsigned int i, n = 0;
+	if (! XQueryTree (display, Xid, &root, &parent, &children, &n))
+		return None;
+	for (i = 0; i < n && client == None; i ++)
+		client = _find_client_window (display, children[i], aWmState, iDepth + 1);
+	if (children)
+		XFree (children);
+	return client;
+}
+
+#define CD_PICK_WINDOW_TIMEOUT 30  // s
+
+typedef struct {
+	Display *display;
+	Window root;
+	Cursor cursor;
+	Window target;
+	int iNbPressedButtons;
+	guint iSidEvents;
+	guint iSidTimeout;
+	CairoDockPickXWindowFunc callback;
+	gpointer data;
+} CDPickWindow;
+
+// process the events of the grab that are already there; return TRUE when the picking is over (a click has been done, or it has been cancelled).
+static gboolean _process_pick_events (CDPickWindow *pPick)
+{
+	XEvent event;
+	while (XPending (pPick->display))
+	{
+		XNextEvent (pPick->display, &event);
+		if (event.type == ButtonPress)
+		{
+			if (pPick->target == None)
+				pPick->target = (event.xbutton.subwindow != None ? event.xbutton.subwindow : pPick->root);
+			pPick->iNbPressedButtons ++;
+		}
+		else if (event.type == ButtonRelease && pPick->iNbPressedButtons > 0)
+		{
+			pPick->iNbPressedButtons --;
+		}
+		else if (event.type == KeyPress && XLookupKeysym (&event.xkey, 0) == XK_Escape)
+		{
+			pPick->target = None;
+			return TRUE;
+		}
+	}
+	return (pPick->target != None && pPick->iNbPressedButtons == 0);  // wait until the button is released too, so that the click doesn't go to the window below.
+}
+
+static void _finish_pick (CDPickWindow *pPick)
+{
+	if (pPick->iSidEvents != 0)
+		g_source_remove (pPick->iSidEvents);
+	if (pPick->iSidTimeout != 0)
+		g_source_remove (pPick->iSidTimeout);
+	Display *display = pPick->display;
+	XUngrabKeyboard (display, CurrentTime);
+	XUngrabPointer (display, CurrentTime);
+	XFreeCursor (display, pPick->cursor);
+	
+	//\__________________ get the application window from the frame that has been clicked.
+	Window target = pPick->target;
+	Window client = None;
+	if (target != None && target != pPick->root)
+		client = _find_client_window (display, target, XInternAtom (display, "WM_STATE", False), 0);
+	XCloseDisplay (display);
+	
+	pPick->callback (client != None ? client : target, pPick->data);
+	g_free (pPick);
+}
+static gboolean _on_pick_event (G_GNUC_UNUSED GIOChannel *pChannel, GIOCondition iCondition, CDPickWindow *pPick)
+{
+	if (iCondition & (G_IO_HUP | G_IO_ERR))
+		pPick->target = None;
+	if ((iCondition & (G_IO_HUP | G_IO_ERR)) || _process_pick_events (pPick))
+	{
+		pPick->iSidEvents = 0;
+		_finish_pick (pPick);
+		return FALSE;
+	}
+	return TRUE;
+}
+static gboolean _on_pick_timeout (CDPickWindow *pPick)
+{
+	cd_message ("no window has been picked");
+	pPick->target = None;
+	pPick->iSidTimeout = 0;
+	_finish_pick (pPick);
+	return FALSE;
+}
+
+void cairo_dock_pick_xwindow_async (CairoDockPickXWindowFunc callback, gpointer data)
+{
+	g_return_if_fail (callback != NULL);
+	// use our own connection, so that the events of the grab don't mix with the ones of the dock.
+	Display *display = XOpenDisplay (NULL);
+	if (display == NULL)
+	{
+		cd_warning ("couldn't open the display");
+		callback (None, data);
+		return;
+	}
+	Window root = DefaultRootWindow (display);
+	
+	//\__________________ grab the pointer with a crosshair cursor, and the keyboard to be able to cancel with Escape.
+	Cursor cursor = XCreateFontCursor (display, XC_crosshair);
+	if (XGrabPointer (display, root, False, ButtonPressMask | ButtonReleaseMask, GrabModeAsync, GrabModeAsync, root, cursor, CurrentTime) != GrabSuccess)
+	{
+		cd_warning ("couldn't grab the pointer");
+		XFreeCursor (display, cursor);
+		XCloseDisplay (display);
+		callback (None, data);
+		return;
+	}
+	if (XGrabKeyboard (display, root, False, GrabModeAsync, GrabModeAsync, CurrentTime) != GrabSuccess)
+		cd_warning ("couldn't grab the keyboard, the picking can't be cancelled with Escape");
+	
+	//\__________________ wait for a click (the button is pressed and released) by watching the events of our connection from the main loop.
+	CDPickWindow *pPick = g_new0 (CDPickWindow, 1);
+	pPick->display = display;
+	pPick->root = root;
+	pPick->cursor = cursor;
+	pPick->callback = callback;
+	pPick->data = data;
+	if (_process_pick_events (pPick))
+	{
+		_finish_pick (pPick);
+		return;
+	}
+	GIOChannel *pChannel = g_io_channel_unix_new (ConnectionNumber (display));
+	pPick->iSidEvents = g_io_add_watch (pChannel, G_IO_IN | G_IO_HUP | G_IO_ERR, (GIOFunc) _on_pick_event, pPick);
+	g_io_channel_unref (pChannel);
+	pPick->iSidTimeout = g_timeout_add_seconds (CD_PICK_WINDOW_TIMEOUT, (GSourceFunc) _on_pick_timeout, pPick);
+}
+
+typedef struct {
+	Window Xid;
+	gboolean bDone;
+	GMainLoop *pBlockingLoop;
+} CDPickWindowResult;
+static void _on_window_picked (Window Xid, CDPickWindowResult *pResult)
+{
+	pResult->Xid = Xid;
+	pResult->bDone = TRUE;
+	if (pResult->pBlockingLoop != NULL)
+		g_main_loop_quit (pResult->pBlockingLoop);
+}
+Window cairo_dock_pick_xwindow (void)
+{
+	CDPickWindowResult result = {None, FALSE, NULL};
+	cairo_dock_pick_xwindow_async ((CairoDockPickXWindowFunc) _on_window_picked, &result);
+	if (! result.bDone)  // wait in a nested loop, like gldi_dialog_show_and_wait does.
+	{
+		result.pBlockingLoop = g_main_loop_new (NULL, FALSE);
+		g_main_loop_run (result.pBlockingLoop);
+		g_main_loop_unref (result.pBlockingLoop);
+	}
+	return result.Xid;
+}
+
 
 
 cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight)
@@ -1577,23 +1756,62 @@ cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth,
 
 cairo_surface_t *cairo_dock_create_surface_from_xpixmap (Pixmap Xid, int iWidth, int iHeight)
 {
-	g_return_val_if_fail (Xid > 0, NULL);
-	GdkPixbuf *pPixbuf = cairo_dock_get_pixbuf_from_pixmap (Xid, TRUE);
-	if (pPixbuf == NULL)
+	g_return_val_if_fail (Xid > 0 && iWidth > 0 && iHeight > 0, NULL);
+	
+	//\__________________ get the size of the pixmap on the X server.
+	Window root;  // inutile.
+	int x, y;  // inutile.
+	guint border_width;  // inutile.
+	guint iPixmapWidth, iPixmapHeight, iDepth;
+	if (! XGetGeometry (s_XDisplay,
+		Xid, &root, &x, &y,
+		&iPixmapWidth, &iPixmapHeight, &border_width, &iDepth)
+	|| iPixmapWidth == 0 || iPixmapHeight == 0)
 	{
 		cd_warning ("No thumbnail available.\nEither the WM doesn't support this functionnality, or the window was minimized when the dock has been launched.");
 		return NULL;
 	}
+	cd_debug ("window pixmap : %ux%u (%u bits)", iPixmapWidth, iPixmapHeight, iDepth);
 	
-	cd_debug ("window pixmap : %dx%d", gdk_pixbuf_get_width (pPixbuf), gdk_pixbuf_get_height (pPixbuf));
-	double fWidth, fHeight;
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_pixbuf (pPixbuf,
-		1.,
-		iWidth, iHeight,
-		CAIRO_DOCK_KEEP_RATIO | CAIRO_DOCK_FILL_SPACE,  // on conserve le ratio de la fenetre, tout en gardant la taille habituelle des icones d'appli.
-		&fWidth, &fHeight,
-		NULL, NULL);
-	g_object_unref (pPixbuf);
+	Visual *pVisual = DefaultVisual (s_XDisplay, 0);
+	XVisualInfo vinfo;
+	if ((int)iDepth != DefaultDepth (s_XDisplay, 0) && XMatchVisualInfo (s_XDisplay, 0, iDepth, TrueColor, &vinfo))  // ARGB windows.
+		pVisual = vinfo.visual;
+	cairo_surface_t *pPixmapSurface = cairo_xlib_surface_create (s_XDisplay,
+		Xid,
+		pVisual,
+		iPixmapWidth,
+		iPixmapHeight);
+	
+	//\__________________ scale it down on the X server, so that only the thumbnail is transferred (rather than the whole window and scaling it on our side).
+	double fZoom = MIN ((double)iWidth / iPixmapWidth, (double)iHeight / iPixmapHeight);  // on conserve le ratio de la fenetre, tout en gardant la taille habituelle des icones d'appli.
+	double fUsedWidth = iPixmapWidth * fZoom, fUsedHeight = iPixmapHeight * fZoom;
+	cairo_surface_t *pScaledSurface = cairo_surface_create_similar (pPixmapSurface,
+		CAIRO_CONTENT_COLOR_ALPHA,
+		iWidth,
+		iHeight);
+	cairo_t *pCairoContext = cairo_create (pScaledSurface);
+	cairo_translate (pCairoContext, (iWidth - fUsedWidth) / 2, (iHeight - fUsedHeight) / 2);
+	cairo_scale (pCairoContext, fZoom, fZoom);
+	cairo_set_source_surface (pCairoContext, pPixmapSurface, 0, 0);
+	cairo_pattern_set_filter (cairo_get_source (pCairoContext), CAIRO_FILTER_GOOD);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pPixmapSurface);
+	
+	//\__________________ get it back in an image surface.
+	cairo_surface_t *pSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+	pCairoContext = cairo_create (pSurface);
+	cairo_set_source_surface (pCairoContext, pScaledSurface, 0, 0);
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pScaledSurface);
+	
+	if (cairo_surface_status (pSurface) != CAIRO_STATUS_SUCCESS)  // e.g. the pixmap is not valid any more.
+	{
+		cairo_surface_destroy (pSurface);
+		return NULL;
+	}
 	return pSurface;
 }
 
@@ -113,6 +113,16 @@ Window *cairo_dock_get_windows_list (gulong *iNbWindows, gboolean bStackOrder);
 
 Window cairo_dock_get_active_xwindow (void);
 
+typedef void (*CairoDockPickXWindowFunc) (Window Xid, gpointer data);
+
+/* Let the user click on a window, and give it to the callback (the client window, not its frame), like 'xwininfo' does. It returns immediately; the callback is called from the main loop once the click is done. Escape or a timeout cancels it (the callback gets None).
+ */
+void cairo_dock_pick_xwindow_async (CairoDockPickXWindowFunc callback, gpointer data);
+
+/* Same as above, but waits for the click in a nested main loop and returns the window. Prefer the asynchronous version.
+ */
+Window cairo_dock_pick_xwindow (void);
+
 
 cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth, int iHeight);
 
@@ -31,29 +31,36 @@ static DBusGProxy *s_pProxy = NULL;
 
 /// Note: this has been tested with Cinnamon-1.6 on Mint-14 and Cinnamon-1.7.4 on Ubuntu-13.04
 
+static void _on_eval_done (GVariant *pReply, const GError *pError, G_GNUC_UNUSED gpointer data)
+{
+	if (pError != NULL)
+	{
+		cd_warning (pError->message);
+		return;
+	}
+	const gchar *cResult = NULL;
+	gboolean bSuccess = FALSE;
+	g_variant_get (pReply, "(b&s)", &bSuccess, &cResult);
+	if (cResult)
+		cd_debug ("%s (%d)", cResult, bSuccess);
+}
+// the command is evaluated without waiting for Cinnamon, so that the dock doesn't freeze if it's slow to answer; so we only know if it could be sent.
 static gboolean _eval (const gchar *cmd)
 {
 	gboolean bSuccess = FALSE;
 	if (s_pProxy != NULL)
 	{
-		gchar *cResult = NULL;
-		GError *error = NULL;
-		dbus_g_proxy_call (s_pProxy, "Eval", &error,
-			G_TYPE_STRING, cmd,
-			G_TYPE_INVALID,
-			G_TYPE_BOOLEAN, &bSuccess,
-			G_TYPE_STRING, &cResult,
-			G_TYPE_INVALID);
-		if (error)
-		{
-			cd_warning (error->message);
-			g_error_free (error);
-		}
-		if (cResult)
-		{
-			cd_debug ("%s", cResult);
-			g_free (cResult);
-		}
+		bSuccess = cairo_dock_dbus_call_async (G_BUS_TYPE_SESSION,
+			CD_CINNAMON_BUS,
+			CD_CINNAMON_OBJECT,
+			CD_CINNAMON_INTERFACE,
+			"Eval",
+			g_variant_new ("(s)", cmd),
+			G_VARIANT_TYPE ("(bs)"),
+			-1,
+			NULL,
+			(CairoDockDbusReplyFunc) _on_eval_done,
+			NULL);
 	}
 	return bSuccess;
 }
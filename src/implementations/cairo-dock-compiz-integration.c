@@ -50,6 +50,27 @@ static inline Window _get_root_Xid (void)
 #define _get_root_Xid(...) 0
 #endif
 
+static void _on_compiz_action_done (G_GNUC_UNUSED GVariant *pReply, const GError *pError, const gchar *cAction)
+{
+	if (pError != NULL)
+		cd_warning ("compiz %s error: %s", cAction, pError->message);
+}
+// call an option of Compiz without waiting for the answer, so that the dock doesn't freeze if Compiz is slow to answer.
+static gboolean _call_compiz (DBusGProxy *pProxy, const gchar *cMethod, GVariant *pParams, const gchar *cAction)
+{
+	return cairo_dock_dbus_call_async (G_BUS_TYPE_SESSION,
+		CD_COMPIZ_BUS,
+		dbus_g_proxy_get_path (pProxy),
+		CD_COMPIZ_INTERFACE,
+		cMethod,
+		pParams,
+		NULL,
+		-1,
+		NULL,
+		(CairoDockDbusReplyFunc) _on_compiz_action_done,
+		(gpointer) cAction);  // a constant string
+}
+
 static gboolean present_windows (void)
 {
 	int root = _get_root_Xid();
@@ -57,22 +78,7 @@ static gboolean present_windows (void)
 		return FALSE;
 	gboolean bSuccess = FALSE;
 	if (s_pScaleProxy != NULL)
-	{
-		GError *erreur = NULL;
-		bSuccess = dbus_g_proxy_call (s_pScaleProxy, "activate", &erreur,
-			G_TYPE_STRING, "root",
-			G_TYPE_INT, root,
-			G_TYPE_STRING, "",
-			G_TYPE_STRING, "",
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);
-		if (erreur)
-		{
-			cd_warning ("compiz scale error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
-	}
+		bSuccess = _call_compiz (s_pScaleProxy, "activate", g_variant_new ("(siss)", "root", root, "", ""), "scale");
 	return bSuccess;
 }
 
@@ -101,7 +107,6 @@ static gboolean present_class (const gchar *cClass)
 	gboolean bSuccess = FALSE;
 	if (s_pScaleProxy != NULL)
 	{
-		GError *erreur = NULL;
 		const gchar *cWmClass = cairo_dock_get_class_wm_class (cClass);
 		gchar *cMatch;
 		if (cWmClass)
@@ -109,20 +114,8 @@ static gboolean present_class (const gchar *cClass)
 		else
 			cMatch = g_strdup_printf ("class=.%s*", cClass+1);
 		cd_message ("Compiz: match '%s'", cMatch);
-		bSuccess = dbus_g_proxy_call (s_pScaleProxy, "activate", &erreur,
-			G_TYPE_STRING, "root",
-			G_TYPE_INT, root,
-			G_TYPE_STRING, "match",
-			G_TYPE_STRING, cMatch,
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);  // in oldest version of Compiz (< 0.9.8), it doesn't present windows of other viewports
+		bSuccess = _call_compiz (s_pScaleProxy, "activate", g_variant_new ("(siss)", "root", root, "match", cMatch), "scale");  // in oldest version of Compiz (< 0.9.8), it doesn't present windows of other viewports
 		g_free (cMatch);
-		if (erreur)
-		{
-			cd_warning ("compiz scale error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
 	}
 	return bSuccess;
 }
@@ -135,20 +128,7 @@ static gboolean present_desktops (void)
 	
 	gboolean bSuccess = FALSE;
 	if (s_pExposeProxy != NULL)
-	{
-		GError *erreur = NULL;
-		bSuccess = dbus_g_proxy_call (s_pExposeProxy, "activate", &erreur,
-			G_TYPE_STRING, "root",
-			G_TYPE_INT, root,
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);
-		if (erreur)
-		{
-			cd_warning ("compiz expo error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
-	}
+		bSuccess = _call_compiz (s_pExposeProxy, "activate", g_variant_new ("(si)", "root", root), "expo");
 	return bSuccess;
 }
 
@@ -160,20 +140,7 @@ static gboolean show_widget_layer (void)
 	
 	gboolean bSuccess = FALSE;
 	if (s_pWidgetLayerProxy != NULL)
-	{
-		GError *erreur = NULL;
-		bSuccess = dbus_g_proxy_call (s_pWidgetLayerProxy, "activate", &erreur,
-			G_TYPE_STRING, "root",
-			G_TYPE_INT, root,
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);
-		if (erreur)
-		{
-			cd_warning ("compiz widget layer error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
-	}
+		bSuccess = _call_compiz (s_pWidgetLayerProxy, "activate", g_variant_new ("(si)", "root", root), "widget layer");
 	return bSuccess;
 }
 
@@ -325,27 +292,8 @@ static gboolean set_nb_desktops (int iNbDesktops, int iNbViewportX, int iNbViewp
 			Y = iNbViewportY > 0 ? iNbViewportY : 1;
 		}
 
-		GError *error = NULL;
-		bSuccess = dbus_g_proxy_call (s_pHSizeProxy, "set", &error,
-			G_TYPE_INT, X,
-			G_TYPE_INVALID, G_TYPE_INVALID);
-		if (error)
-		{
-			cd_warning ("compiz HSize error: %s", error->message);
-			g_error_free (error);
-			error = NULL;
-			bSuccess = FALSE;
-		}
-		error = NULL;
-		bSuccess &= dbus_g_proxy_call (s_pVSizeProxy, "set", &error,
-			G_TYPE_INT, Y,
-			G_TYPE_INVALID, G_TYPE_INVALID);
-		if (error)
-		{
-			cd_warning ("compiz VSize error: %s", error->message);
-			g_error_free (error);
-			bSuccess = FALSE;
-		}
+		bSuccess = _call_compiz (s_pHSizeProxy, "set", g_variant_new ("(i)", X), "HSize");
+		bSuccess &= _call_compiz (s_pVSizeProxy, "set", g_variant_new ("(i)", Y), "VSize");
 	}
 	return bSuccess;
 }
@@ -20,6 +20,7 @@
 
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>  // memcmp
 
 #include <gtk/gtk.h>
 #include <cairo.h>
@@ -198,6 +199,175 @@ static void _cairo_dock_draw_separator (Icon *icon, CairoDock *pDock, cairo_t *p
 		_draw_physical_separator (icon, pDock, pCairoContext, fDockMagnitude);
 }
 
+  ///////////////////////
+ /// DECORATION CACHE ///
+///////////////////////
+// The frame, its background and its outline don't change while icons are animated, so they're drawn once in a surface (cairo) or a display-list (OpenGL), that is re-used as long as the frame's geometry and style stay the same.
+// The cache is only built once the geometry has been the same for 2 frames in a row, so that a zooming or resizing dock is not slowed down by rebuilding it at each frame.
+
+typedef struct {
+	gdouble fRadius, fLineWidth, fDockWidth, fDockOffsetX, fDockOffsetY;
+	gint iDecorationsHeight;
+	gint iWidth, iHeight;
+	gboolean bDirectionUp, bIsHorizontal, bRoundedBottomCorner;
+	GldiColor fLineColor;
+	gpointer pBackground;  // surface (cairo) or texture (opengl) of the dock's background.
+	} CDDecorationKey;
+
+typedef struct {
+	CDDecorationKey key;
+	gboolean bKeyIsValid;
+	// cairo
+	cairo_surface_t *pSurface;
+	gint iBandY;  // position of the surface along the dock's height.
+	gint iBandHeight;
+	// opengl
+	GLuint iDisplayList;
+	} CDDecorationCache;
+
+static cairo_user_data_key_t s_BgOwnerKey;  // marks the background surface a cache has been drawn with, since a new background can be allocated at the same address.
+
+static CDDecorationCache *_get_decoration_cache (CairoDock *pDock)
+{
+	if (pDock->pRendererData == NULL)
+		pDock->pRendererData = g_new0 (CDDecorationCache, 1);
+	return pDock->pRendererData;
+}
+
+static void _invalidate_decoration_cache (CDDecorationCache *pCache)
+{
+	if (pCache->pSurface != NULL)
+	{
+		cairo_surface_destroy (pCache->pSurface);
+		pCache->pSurface = NULL;
+	}
+	if (pCache->iDisplayList != 0)
+	{
+		glDeleteLists (pCache->iDisplayList, 1);
+		pCache->iDisplayList = 0;
+	}
+}
+
+static void cd_free_data_default (CairoDock *pDock)
+{
+	CDDecorationCache *pCache = pDock->pRendererData;
+	if (pCache == NULL)
+		return;
+	_invalidate_decoration_cache (pCache);
+	g_free (pCache);
+	pDock->pRendererData = NULL;
+}
+
+static void _make_decoration_key (CDDecorationKey *pKey, CairoDock *pDock, double fRadius, double fLineWidth, double fDockWidth, double fDockOffsetX, double fDockOffsetY, gpointer pBackground)
+{
+	memset (pKey, 0, sizeof (CDDecorationKey));  // the key is compared with memcmp.
+	pKey->fRadius = fRadius;
+	pKey->fLineWidth = fLineWidth;
+	pKey->fDockWidth = fDockWidth;
+	pKey->fDockOffsetX = fDockOffsetX;
+	pKey->fDockOffsetY = fDockOffsetY;
+	pKey->iDecorationsHeight = pDock->iDecorationsHeight;
+	pKey->iWidth = pDock->container.iWidth;
+	pKey->iHeight = pDock->container.iHeight;
+	pKey->bDirectionUp = pDock->container.bDirectionUp;
+	pKey->bIsHorizontal = pDock->container.bIsHorizontal;
+	pKey->bRoundedBottomCorner = myDocksParam.bRoundedBottomCorner;
+	if (myDocksParam.bUseDefaultColors)
+		gldi_style_color_get (GLDI_COLOR_LINE, &pKey->fLineColor);
+	else
+		pKey->fLineColor = myDocksParam.fLineColor;
+	pKey->pBackground = pBackground;
+}
+
+// returns TRUE if the cache can be (re)built: the geometry is the same as at the previous frame.
+static gboolean _update_decoration_key (CDDecorationCache *pCache, CDDecorationKey *pKey, gboolean *bCacheIsValid)
+{
+	if (pCache->bKeyIsValid && memcmp (&pCache->key, pKey, sizeof (CDDecorationKey)) == 0)
+	{
+		*bCacheIsValid = TRUE;
+		return TRUE;
+	}
+	_invalidate_decoration_cache (pCache);
+	memcpy (&pCache->key, pKey, sizeof (CDDecorationKey));  // not a struct copy, so that the padding is copied too.
+	pCache->bKeyIsValid = TRUE;
+	*bCacheIsValid = FALSE;
+	return FALSE;
+}
+
+static void _draw_decorations (cairo_t *pCairoContext, CairoDock *pDock, double fRadius, double fLineWidth, double fDockWidth, double fDockOffsetX, double fDockOffsetY, int sens)
+{
+	cairo_save (pCairoContext);
+	double fDeltaXTrapeze = cairo_dock_draw_frame (pCairoContext, fRadius, fLineWidth, fDockWidth, pDock->iDecorationsHeight, fDockOffsetX, fDockOffsetY, sens, 0., pDock->container.bIsHorizontal, myDocksParam.bRoundedBottomCorner);
+
+	//\____________________ On dessine les decorations dedans.
+	fDockOffsetY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
+	cairo_dock_render_decorations_in_frame (pCairoContext, pDock, fDockOffsetY, fDockOffsetX - fDeltaXTrapeze, fDockWidth + 2*fDeltaXTrapeze);
+
+	//\____________________ On dessine le cadre.
+	if (fLineWidth > 0)
+	{
+		cairo_set_line_width (pCairoContext, fLineWidth);
+		if (myDocksParam.bUseDefaultColors)
+			gldi_style_colors_set_line_color (pCairoContext);
+		else
+			gldi_color_set_cairo (pCairoContext, &myDocksParam.fLineColor);
+		cairo_stroke (pCairoContext);
+	}
+	else
+		cairo_new_path (pCairoContext);
+	cairo_restore (pCairoContext);
+}
+
+static void _render_decorations_cached (cairo_t *pCairoContext, CairoDock *pDock, double fRadius, double fLineWidth, double fDockWidth, double fDockOffsetX, double fDockOffsetY, int sens)
+{
+	CDDecorationCache *pCache = _get_decoration_cache (pDock);
+	cairo_surface_t *pBgSurface = pDock->backgroundBuffer.pSurface;
+	CDDecorationKey key;
+	_make_decoration_key (&key, pDock, fRadius, fLineWidth, fDockWidth, fDockOffsetX, fDockOffsetY, pBgSurface);
+	gboolean bCacheIsValid;
+	gboolean bCanBuild = _update_decoration_key (pCache, &key, &bCacheIsValid);
+	if (bCacheIsValid && pCache->pSurface != NULL
+	&& pBgSurface != NULL && cairo_surface_get_user_data (pBgSurface, &s_BgOwnerKey) != pCache)  // same address, but not the same background.
+	{
+		_invalidate_decoration_cache (pCache);
+		bCanBuild = FALSE;
+	}
+	
+	//\____________________ draw the decorations in a band that covers the whole length of the dock, on the height of the frame.
+	if (bCanBuild && pCache->pSurface == NULL)
+	{
+		int iBandHeight = ceil (pDock->iDecorationsHeight + 2 * fLineWidth) + 2;
+		int iBandY = (pDock->container.bDirectionUp ? pDock->container.iHeight - iBandHeight : 0);
+		int w = (pDock->container.bIsHorizontal ? pDock->container.iWidth : iBandHeight);
+		int h = (pDock->container.bIsHorizontal ? iBandHeight : pDock->container.iWidth);
+		pCache->pSurface = cairo_surface_create_similar (cairo_get_target (pCairoContext), CAIRO_CONTENT_COLOR_ALPHA, w, h);
+		cairo_t *ctx = cairo_create (pCache->pSurface);
+		if (pDock->container.bIsHorizontal)
+			cairo_translate (ctx, 0, - iBandY);
+		else
+			cairo_translate (ctx, - iBandY, 0);
+		_draw_decorations (ctx, pDock, fRadius, fLineWidth, fDockWidth, fDockOffsetX, fDockOffsetY, sens);
+		cairo_destroy (ctx);
+		pCache->iBandY = iBandY;
+		pCache->iBandHeight = iBandHeight;
+		if (pBgSurface != NULL)
+			cairo_surface_set_user_data (pBgSurface, &s_BgOwnerKey, pCache, NULL);
+	}
+	
+	if (pCache->pSurface != NULL)
+	{
+		if (pDock->container.bIsHorizontal)
+			cairo_set_source_surface (pCairoContext, pCache->pSurface, 0, pCache->iBandY);
+		else
+			cairo_set_source_surface (pCairoContext, pCache->pSurface, pCache->iBandY, 0);
+		cairo_paint (pCairoContext);
+	}
+	else  // geometry is changing, draw directly.
+	{
+		_draw_decorations (pCairoContext, pDock, fRadius, fLineWidth, fDockWidth, fDockOffsetX, fDockOffsetY, sens);
+	}
+}
+
 static void cd_render_default (cairo_t *pCairoContext, CairoDock *pDock)
 {
 	//\____________________ On trace le cadre.
@@ -237,26 +407,7 @@ static void cd_render_default (cairo_t *pCairoContext, CairoDock *pDock)
 		fDockOffsetY = pDock->iDecorationsHeight + 1.5 * fLineWidth;
 	}
 
-	cairo_save (pCairoContext);
-	double fDeltaXTrapeze = cairo_dock_draw_frame (pCairoContext, fRadius, fLineWidth, fDockWidth, pDock->iDecorationsHeight, fDockOffsetX, fDockOffsetY, sens, 0., pDock->container.bIsHorizontal, myDocksParam.bRoundedBottomCorner);
-
-	//\____________________ On dessine les decorations dedans.
-	fDockOffsetY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iDecorationsHeight - fLineWidth : fLineWidth);
-	cairo_dock_render_decorations_in_frame (pCairoContext, pDock, fDockOffsetY, fDockOffsetX - fDeltaXTrapeze, fDockWidth + 2*fDeltaXTrapeze);
-
-	//\____________________ On dessine le cadre.
-	if (fLineWidth > 0)
-	{
-		cairo_set_line_width (pCairoContext, fLineWidth);
-		if (myDocksParam.bUseDefaultColors)
-			gldi_style_colors_set_line_color (pCairoContext);
-		else
-			gldi_color_set_cairo (pCairoContext, &myDocksParam.fLineColor);
-		cairo_stroke (pCairoContext);
-	}
-	else
-		cairo_new_path (pCairoContext);
-	cairo_restore (pCairoContext);
+	_render_decorations_cached (pCairoContext, pDock, fRadius, fLineWidth, fDockWidth, fDockOffsetX, fDockOffsetY, sens);
 
 	//\____________________ On dessine la ficelle qui les joint.
 	if (myIconsParam.iStringLineWidth > 0)
@@ -565,36 +716,49 @@ static void cd_render_opengl_default (CairoDock *pDock)
 	
 	double fDockMagnitude = cairo_dock_calculate_magnitude (pDock->iMagnitudeIndex);
 	
-	//\_____________ On genere les coordonnees du contour.
-	const CairoDockGLPath *pFramePath = cairo_dock_generate_rectangle_path (fDockWidth, fFrameHeight, fRadius, myDocksParam.bRoundedBottomCorner);
+	//\_____________ On dessine le cadre, en reutilisant celui de l'image precedente s'il n'a pas change.
+	CDDecorationCache *pCache = _get_decoration_cache (pDock);
+	CDDecorationKey key;
+	_make_decoration_key (&key, pDock, fRadius, fLineWidth, fDockWidth, 0., 0., GUINT_TO_POINTER (pDock->backgroundBuffer.iTexture));  // the position of the frame is applied outside of the display-list.
+	gboolean bCacheIsValid;
+	gboolean bCanBuild = _update_decoration_key (pCache, &key, &bCacheIsValid);
 	
-	//\_____________ On remplit avec le fond.
 	glPushMatrix ();
 	cairo_dock_set_container_orientation_opengl (CAIRO_CONTAINER (pDock));
 	glTranslatef (fDockOffsetX + (fDockWidth+2*fRadius)/2 + .5,  // +.5 so that left and right edges are pixel-aligned
 		fDockOffsetY - fFrameHeight/2,
 		0.);
 	
-	/*int i;
-	for (i = 0; i < pFramePath->iCurrentPt; i++)
+	if (pCache->iDisplayList != 0)
 	{
-		pFramePath->pVertices[2*i] /= fDockWidth + fExtraWidth;
-		pFramePath->pVertices[2*i+1] /= fFrameHeight;
+		glCallList (pCache->iDisplayList);
 	}
-	glScalef (fDockWidth + fExtraWidth, fFrameHeight, 1.);
-	cairo_dock_gl_path_set_extent (pFramePath, 1, 1);*/
-	cairo_dock_fill_gl_path (pFramePath, pDock->backgroundBuffer.iTexture);
-	
-	//\_____________ On trace le contour.
-	if (fLineWidth != 0)
+	else
 	{
-		glLineWidth (fLineWidth);
-		if (myDocksParam.bUseDefaultColors)
-			gldi_style_colors_set_line_color (NULL);
-		else
-			gldi_color_set_opengl (&myDocksParam.fLineColor);
-		_cairo_dock_set_blend_alpha ();
-		cairo_dock_stroke_gl_path (pFramePath, TRUE);
+		if (bCanBuild)
+		{
+			pCache->iDisplayList = glGenLists (1);
+			if (pCache->iDisplayList != 0)
+				glNewList (pCache->iDisplayList, GL_COMPILE_AND_EXECUTE);  // the vertices are copied into the list, so the shared path below can be modified afterwards.
+		}
+		
+		//\_____________ On genere les coordonnees du contour.
+		const CairoDockGLPath *pFramePath = cairo_dock_generate_rectangle_path (fDockWidth, fFrameHeight, fRadius, myDocksParam.bRoundedBottomCorner);
+		
+		//\_____________ On remplit avec le fond.
+		cairo_dock_fill_gl_path (pFramePath, pDock->backgroundBuffer.iTexture);
+		
+		//\_____________ On trace le contour.
+		if (fLineWidth != 0)
+		{
+			glLineWidth (fLineWidth);
+			gldi_color_set_opengl (&key.fLineColor);
+			_cairo_dock_set_blend_alpha ();
+			cairo_dock_stroke_gl_path (pFramePath, TRUE);
+		}
+		
+		if (pCache->iDisplayList != 0)
+			glEndList ();
 	}
 	glPopMatrix ();
 	
@@ -684,6 +848,7 @@ void cairo_dock_register_default_renderer (void)
 	pDefaultRenderer->render = cd_render_default;
 	pDefaultRenderer->render_optimized = cd_render_optimized_default;
 	pDefaultRenderer->render_opengl = cd_render_opengl_default;
+	pDefaultRenderer->free_data = cd_free_data_default;
 	pDefaultRenderer->set_subdock_position = cairo_dock_set_subdock_position_linear;
 	pDefaultRenderer->bUseReflect = FALSE;
 	pDefaultRenderer->cDisplayedName = gettext (CAIRO_DOCK_DEFAULT_RENDERER_NAME);
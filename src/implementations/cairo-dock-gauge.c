@@ -23,6 +23,7 @@
 #include <math.h>
 #include <libxml/tree.h>
 #include <libxml/parser.h>
+#include <glib/gstdio.h>  // g_stat
 
 #include "gldi-config.h"
 #include "cairo-dock-log.h"
@@ -102,6 +103,104 @@ typedef struct {
 
 extern gboolean g_bUseOpenGL;
 
+  /////////////////
+ // GAUGE CACHE //
+/////////////////
+// Several gauges often use the same theme at the same size (one per instance of an applet), and a gauge is reloaded each time its icon is resized.
+// So the parsed themes and the rasterized layers are kept in memory and shared between all the gauges.
+
+#define CD_GAUGE_CACHE_MAX_IMAGES 48
+
+typedef struct {
+	time_t iMTime;  // modification time of the theme.xml
+	Gauge *pGauge;  // the parsed theme, without any image loaded.
+} GaugeTheme;
+
+typedef struct {
+	CairoDockImageBuffer image;  // only the surface, textures are not shared.
+	// geometry of the needle, that is computed along with its surface.
+	gint iNeedleRealWidth, iNeedleRealHeight;
+	gdouble iNeedleOffsetX, iNeedleOffsetY;
+	gdouble fNeedleScale;
+	gint iNeedleWidth, iNeedleHeight;
+} GaugeCachedImage;
+
+static GHashTable *s_pGaugeThemes = NULL;  // theme path -> GaugeTheme
+static GHashTable *s_pGaugeImages = NULL;  // "WxH:image path" -> GaugeCachedImage
+
+static void _free_cached_image (GaugeCachedImage *pCachedImage)
+{
+	if (pCachedImage->image.pSurface != NULL)
+		cairo_surface_destroy (pCachedImage->image.pSurface);
+	g_free (pCachedImage);
+}
+
+static gboolean _cached_image_is_unused (G_GNUC_UNUSED gchar *cKey, GaugeCachedImage *pCachedImage, G_GNUC_UNUSED gpointer data)
+{
+	return (pCachedImage->image.pSurface == NULL || cairo_surface_get_reference_count (pCachedImage->image.pSurface) == 1);  // only referenced by the cache.
+}
+
+static GaugeCachedImage *_get_cached_image (const gchar *cKey)
+{
+	return (s_pGaugeImages ? g_hash_table_lookup (s_pGaugeImages, cKey) : NULL);
+}
+
+static void _cache_image (gchar *cKey, GaugeCachedImage *pCachedImage)  // takes the key
+{
+	if (s_pGaugeImages == NULL)
+		s_pGaugeImages = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_cached_image);
+	else if (g_hash_table_size (s_pGaugeImages) >= CD_GAUGE_CACHE_MAX_IMAGES)  // forget the images that no gauge uses any more.
+		g_hash_table_foreach_remove (s_pGaugeImages, (GHRFunc)_cached_image_is_unused, NULL);
+	g_hash_table_insert (s_pGaugeImages, cKey, pCachedImage);
+}
+
+static void _load_image_buffer_from_cache (CairoDockImageBuffer *pImage, GaugeCachedImage *pCachedImage)
+{
+	if (pCachedImage->image.pSurface == NULL)
+		return;
+	cairo_dock_load_image_buffer_from_surface (pImage,
+		cairo_surface_reference (pCachedImage->image.pSurface),
+		pCachedImage->image.iWidth,
+		pCachedImage->image.iHeight);
+	pImage->fZoomX = pCachedImage->image.fZoomX;
+	pImage->fZoomY = pCachedImage->image.fZoomY;
+}
+
+static void _free_gauge_theme (GaugeTheme *pTheme);
+
+static Gauge *_parse_theme (const gchar *cThemePath, const gchar *cXmlFile);
+
+static Gauge *_get_gauge_theme (const gchar *cThemePath)
+{
+	gchar *cXmlFile = g_strdup_printf ("%s/theme.xml", cThemePath);
+	GStatBuf st;
+	time_t iMTime = (g_stat (cXmlFile, &st) == 0 ? st.st_mtime : 0);
+	
+	GaugeTheme *pTheme = (s_pGaugeThemes ? g_hash_table_lookup (s_pGaugeThemes, cThemePath) : NULL);
+	if (pTheme != NULL && pTheme->iMTime != iMTime)  // the theme has been modified since we parsed it.
+	{
+		g_hash_table_remove (s_pGaugeThemes, cThemePath);
+		pTheme = NULL;
+		if (s_pGaugeImages != NULL)  // its images may have changed too; the gauges that still use them keep their own reference.
+			g_hash_table_remove_all (s_pGaugeImages);
+	}
+	if (pTheme == NULL)
+	{
+		Gauge *pGauge = _parse_theme (cThemePath, cXmlFile);
+		if (pGauge != NULL)
+		{
+			if (s_pGaugeThemes == NULL)
+				s_pGaugeThemes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_gauge_theme);
+			pTheme = g_new0 (GaugeTheme, 1);
+			pTheme->iMTime = iMTime;
+			pTheme->pGauge = pGauge;
+			g_hash_table_insert (s_pGaugeThemes, g_strdup (cThemePath), pTheme);
+		}
+	}
+	g_free (cXmlFile);
+	return (pTheme ? pTheme->pGauge : NULL);
+}
+
   ////////////////////////////////////////////
  /////////////// LOAD GAUGE /////////////////
 ////////////////////////////////////////////
@@ -114,17 +213,20 @@ static double _str2double (xmlChar *s)
 	return g_ascii_strtod ((char *) s, NULL);
 }
 
-static void _load_gauge_image (GaugeImage *pGaugeImage, const gchar *cThemePath, const xmlChar *cImageName, int iWidth, int iHeight)
+static GaugeImage *_new_gauge_image (const gchar *cThemePath, const xmlChar *cImageName)
 {
+	GaugeImage *pGaugeImage = g_new0 (GaugeImage, 1);
 	pGaugeImage->cImagePath = g_strdup_printf ("%s/%s", cThemePath, (gchar *) cImageName);
-	cairo_dock_load_image_buffer (&pGaugeImage->image, pGaugeImage->cImagePath, iWidth, iHeight, 0);
+	return pGaugeImage;
 }
 
-static GaugeImage *_new_gauge_image (const gchar *cThemePath, const xmlChar *cImageName, int iWidth, int iHeight)
+static GaugeImage *_copy_gauge_image (GaugeImage *pGaugeImage)
 {
-	GaugeImage *pGaugeImage = g_new0 (GaugeImage, 1);
-	_load_gauge_image (pGaugeImage, cThemePath, cImageName, iWidth, iHeight);
-	return pGaugeImage;
+	if (pGaugeImage == NULL)
+		return NULL;
+	GaugeImage *pCopy = g_new0 (GaugeImage, 1);
+	pCopy->cImagePath = g_strdup (pGaugeImage->cImagePath);
+	return pCopy;
 }
 
 static void _reload_gauge_image (GaugeImage *pGaugeImage, int iWidth, int iHeight)
@@ -133,7 +235,29 @@ static void _reload_gauge_image (GaugeImage *pGaugeImage, int iWidth, int iHeigh
 	
 	if (pGaugeImage->cImagePath)
 	{
-		cairo_dock_load_image_buffer (&pGaugeImage->image, pGaugeImage->cImagePath, iWidth, iHeight, 0);
+		gchar *cKey = g_strdup_printf ("%dx%d:%s", iWidth, iHeight, pGaugeImage->cImagePath);
+		GaugeCachedImage *pCachedImage = _get_cached_image (cKey);
+		if (pCachedImage == NULL)  // rasterize the image once, like cairo_dock_load_image_buffer() does.
+		{
+			pCachedImage = g_new0 (GaugeCachedImage, 1);
+			double w=0, h=0;
+			pCachedImage->image.pSurface = cairo_dock_create_surface_from_image (pGaugeImage->cImagePath,
+				1.,
+				iWidth,
+				iHeight,
+				0,
+				&w,
+				&h,
+				&pCachedImage->image.fZoomX,
+				&pCachedImage->image.fZoomY);
+			pCachedImage->image.iWidth = w;
+			pCachedImage->image.iHeight = h;
+			_cache_image (cKey, pCachedImage);
+		}
+		else
+			g_free (cKey);
+		
+		_load_image_buffer_from_cache (&pGaugeImage->image, pCachedImage);
 	}
 }
 
@@ -141,9 +265,31 @@ static void __load_needle (GaugeIndicator *pGaugeIndicator, int iWidth, int iHei
 {
 	GaugeImage *pGaugeImage = pGaugeIndicator->pImageNeedle;
 	
+	// look for an already rasterized needle.
+	gchar *cKey = g_strdup_printf ("needle:%dx%d:%s", iWidth, iHeight, pGaugeImage->cImagePath);
+	GaugeCachedImage *pCachedImage = _get_cached_image (cKey);
+	if (pCachedImage != NULL)
+	{
+		g_free (cKey);
+		pGaugeIndicator->iNeedleRealWidth = pCachedImage->iNeedleRealWidth;
+		pGaugeIndicator->iNeedleRealHeight = pCachedImage->iNeedleRealHeight;
+		pGaugeIndicator->iNeedleOffsetX = pCachedImage->iNeedleOffsetX;
+		pGaugeIndicator->iNeedleOffsetY = pCachedImage->iNeedleOffsetY;
+		pGaugeIndicator->fNeedleScale = pCachedImage->fNeedleScale;
+		pGaugeIndicator->iNeedleWidth = pCachedImage->iNeedleWidth;
+		pGaugeIndicator->iNeedleHeight = pCachedImage->iNeedleHeight;
+		_load_image_buffer_from_cache (&pGaugeImage->image, pCachedImage);
+		return;
+	}
+	
 	// load the SVG file.
 	RsvgHandle *pSvgHandle = rsvg_handle_new_from_file (pGaugeImage->cImagePath, NULL);
-	g_return_if_fail (pSvgHandle != NULL);
+	if (pSvgHandle == NULL)
+	{
+		cd_warning ("couldn't load the needle '%s'", pGaugeImage->cImagePath);
+		g_free (cKey);
+		return;
+	}
 	
 	// get the SVG dimensions.
 	RsvgDimensionData SizeInfo;
@@ -170,10 +316,15 @@ static void __load_needle (GaugeIndicator *pGaugeIndicator, int iWidth, int iHei
 	
 	// make a cairo surface.
 	cairo_surface_t *pNeedleSurface = cairo_dock_create_blank_surface (pGaugeIndicator->iNeedleWidth, pGaugeIndicator->iNeedleHeight);
-	g_return_if_fail (cairo_surface_status (pNeedleSurface) == CAIRO_STATUS_SUCCESS);
+	if (cairo_surface_status (pNeedleSurface) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_surface_destroy (pNeedleSurface);
+		g_object_unref (pSvgHandle);
+		g_free (cKey);
+		return;
+	}
 	
 	cairo_t* pDrawingContext = cairo_create (pNeedleSurface);
-	g_return_if_fail (cairo_status (pDrawingContext) == CAIRO_STATUS_SUCCESS);
 	
 	cairo_scale (pDrawingContext, pGaugeIndicator->fNeedleScale, pGaugeIndicator->fNeedleScale);
 	cairo_translate (pDrawingContext, pGaugeIndicator->iNeedleOffsetX, pGaugeIndicator->iNeedleOffsetY);
@@ -182,8 +333,24 @@ static void __load_needle (GaugeIndicator *pGaugeIndicator, int iWidth, int iHei
 	cairo_destroy (pDrawingContext);
 	g_object_unref (pSvgHandle);
 	
+	// keep it for the other gauges.
+	pCachedImage = g_new0 (GaugeCachedImage, 1);
+	pCachedImage->image.pSurface = pNeedleSurface;
+	pCachedImage->image.iWidth = iWidth;
+	pCachedImage->image.iHeight = iHeight;
+	pCachedImage->image.fZoomX = 1.;
+	pCachedImage->image.fZoomY = 1.;
+	pCachedImage->iNeedleRealWidth = pGaugeIndicator->iNeedleRealWidth;
+	pCachedImage->iNeedleRealHeight = pGaugeIndicator->iNeedleRealHeight;
+	pCachedImage->iNeedleOffsetX = pGaugeIndicator->iNeedleOffsetX;
+	pCachedImage->iNeedleOffsetY = pGaugeIndicator->iNeedleOffsetY;
+	pCachedImage->fNeedleScale = pGaugeIndicator->fNeedleScale;
+	pCachedImage->iNeedleWidth = pGaugeIndicator->iNeedleWidth;
+	pCachedImage->iNeedleHeight = pGaugeIndicator->iNeedleHeight;
+	_cache_image (cKey, pCachedImage);
+	
 	// load it into an image buffer.
-	cairo_dock_load_image_buffer_from_surface (&pGaugeImage->image, pNeedleSurface, iWidth, iHeight);
+	_load_image_buffer_from_cache (&pGaugeImage->image, pCachedImage);
 }
 
 static void _reload_gauge_needle (GaugeIndicator *pGaugeIndicator, int iWidth, int iHeight)
@@ -200,7 +367,7 @@ static void _reload_gauge_needle (GaugeIndicator *pGaugeIndicator, int iWidth, i
 	}
 }
 
-static void _load_gauge_needle (GaugeIndicator *pGaugeIndicator, const gchar *cThemePath, const gchar *cImageName, int iWidth, int iHeight)
+static void _load_gauge_needle (GaugeIndicator *pGaugeIndicator, const gchar *cThemePath, const gchar *cImageName)
 {
 	if (!cImageName)
 		return;
@@ -208,27 +375,39 @@ static void _load_gauge_needle (GaugeIndicator *pGaugeIndicator, const gchar *cT
 	GaugeImage *pGaugeImage = g_new0 (GaugeImage, 1);
 	pGaugeImage->cImagePath = g_strdup_printf ("%s/%s", cThemePath, cImageName);
 	pGaugeIndicator->pImageNeedle = pGaugeImage;
-	
-	__load_needle (pGaugeIndicator, iWidth, iHeight);
 }
 
-static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
+static GaugeIndicator *_copy_gauge_indicator (GaugeIndicator *pGaugeIndicator)
+{
+	GaugeIndicator *pCopy = g_new (GaugeIndicator, 1);
+	memcpy (pCopy, pGaugeIndicator, sizeof (GaugeIndicator));
+	pCopy->pImageNeedle = _copy_gauge_image (pGaugeIndicator->pImageNeedle);
+	pCopy->pImageUndef = _copy_gauge_image (pGaugeIndicator->pImageUndef);
+	if (pGaugeIndicator->pImageList != NULL)
+	{
+		pCopy->pImageList = g_new0 (GaugeImage, pGaugeIndicator->iNbImages);
+		int i;
+		for (i = 0; i < pGaugeIndicator->iNbImages; i ++)
+			pCopy->pImageList[i].cImagePath = g_strdup (pGaugeIndicator->pImageList[i].cImagePath);
+	}
+	return pCopy;
+}
+
+static void unload (Gauge *pGauge);
+static void _load_gauge_images (Gauge *pGauge, int iWidth, int iHeight);
+
+// parse the theme into a new gauge, without loading any image.
+static Gauge *_parse_theme (const gchar *cThemePath, const gchar *cXmlFile)
 {
 	cd_message ("%s (%s)", __func__, cThemePath);
-	int iWidth = pGauge->dataRenderer.iWidth, iHeight = pGauge->dataRenderer.iHeight;
-	if (iWidth == 0 || iHeight == 0)
-		return FALSE;
-	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGauge);
-	
-	g_return_val_if_fail (cThemePath != NULL, FALSE);
-	
 	xmlInitParser ();
 	xmlDocPtr pGaugeTheme;
 	xmlNodePtr pGaugeMainNode;
-	gchar *cXmlFile = g_strdup_printf ("%s/theme.xml", cThemePath);
 	pGaugeTheme = cairo_dock_open_xml_file (cXmlFile, "gauge", &pGaugeMainNode, NULL);
-	g_free (cXmlFile);
-	g_return_val_if_fail (pGaugeTheme != NULL && pGaugeMainNode != NULL, FALSE);
+	g_return_val_if_fail (pGaugeTheme != NULL && pGaugeMainNode != NULL, NULL);
+	
+	Gauge *pGauge = g_new0 (Gauge, 1);
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGauge);
 	
 	xmlChar *cAttribute, *cNodeContent, *cTextNodeContent, *cTypeAttr;
 	GString *sImagePath = g_string_new ("");
@@ -269,11 +448,11 @@ static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
 			{
 				if (xmlStrcmp (cAttribute, BAD_CAST "background") == 0)
 				{
-					pGauge->pImageBackground = _new_gauge_image (cThemePath, cNodeContent, iWidth, iHeight);
+					pGauge->pImageBackground = _new_gauge_image (cThemePath, cNodeContent);
 				}
 				else if (xmlStrcmp (cAttribute, BAD_CAST "foreground") == 0)
 				{
-					pGauge->pImageForeground = _new_gauge_image (cThemePath, cNodeContent, iWidth, iHeight);
+					pGauge->pImageForeground = _new_gauge_image (cThemePath, cNodeContent);
 				}
 				xmlFree (cAttribute);
 			}
@@ -397,7 +576,7 @@ static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
 							cAttribute = xmlGetProp (pIndicatorNode, BAD_CAST "type");
 							if (cAttribute && strcmp ((char *) cAttribute, "undef-value") == 0)
 							{
-								pGaugeIndicator->pImageUndef = _new_gauge_image (cThemePath, cNodeContent, iWidth, iHeight);
+								pGaugeIndicator->pImageUndef = _new_gauge_image (cThemePath, cNodeContent);
 							}
 							else
 							{
@@ -420,12 +599,10 @@ static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
 								if (pGaugeIndicator->pImageList == NULL)
 									pGaugeIndicator->pImageList = g_new0 (GaugeImage, pGaugeIndicator->iNbImages);
 								
-								// load the image.
+								// remember the image, it will be loaded with the gauge.
 								if (pGaugeIndicator->iNbImageLoaded < pGaugeIndicator->iNbImages)
 								{
-									_load_gauge_image (&pGaugeIndicator->pImageList[pGaugeIndicator->iNbImageLoaded],
-										cThemePath, cNodeContent,
-										iWidth, iHeight);
+									pGaugeIndicator->pImageList[pGaugeIndicator->iNbImageLoaded].cImagePath = g_strdup_printf ("%s/%s", cThemePath, (gchar *) cNodeContent);
 									pGaugeIndicator->iNbImageLoaded ++;
 								}
 							}
@@ -505,10 +682,10 @@ static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
 				xmlFree (cNodeContent);
 			}
 			
-			// in the case of a needle, load it now, since we need to know the dimensions beforehand.
+			// in the case of a needle, the image is known at the end, since we need to know the dimensions beforehand.
 			if (cNeedleImage != NULL)
 			{
-				_load_gauge_needle (pGaugeIndicator, cThemePath, cNeedleImage, iWidth, iHeight);
+				_load_gauge_needle (pGaugeIndicator, cThemePath, cNeedleImage);
 				xmlFree (cNeedleImage);
 			}
 			pGauge->pIndicatorList = g_list_append (pGauge->pIndicatorList, pGaugeIndicator);
@@ -517,7 +694,44 @@ static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
 	cairo_dock_close_xml_file (pGaugeTheme);
 	g_string_free (sImagePath, TRUE);
 	
-	g_return_val_if_fail (pRenderer->iRank != 0 && pGaugeIndicator != NULL, FALSE);
+	if (pRenderer->iRank == 0 || pGaugeIndicator == NULL)
+	{
+		cd_warning ("invalid gauge theme '%s'", cThemePath);
+		unload (pGauge);
+		g_free (pGauge);
+		return NULL;
+	}
+	
+	return pGauge;
+}
+
+static gboolean _load_theme (Gauge *pGauge, const gchar *cThemePath)
+{
+	int iWidth = pGauge->dataRenderer.iWidth, iHeight = pGauge->dataRenderer.iHeight;
+	if (iWidth == 0 || iHeight == 0)
+		return FALSE;
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGauge);
+	
+	g_return_val_if_fail (cThemePath != NULL, FALSE);
+	
+	// get the parsed theme (the XML is only parsed the first time, or if it has changed).
+	Gauge *pTheme = _get_gauge_theme (cThemePath);
+	if (pTheme == NULL)
+		return FALSE;
+	
+	// copy it into our gauge.
+	pRenderer->iRank = pTheme->dataRenderer.iRank;
+	pGauge->iMultiDisplay = pTheme->iMultiDisplay;
+	pGauge->pImageBackground = _copy_gauge_image (pTheme->pImageBackground);
+	pGauge->pImageForeground = _copy_gauge_image (pTheme->pImageForeground);
+	GList *il;
+	for (il = pTheme->pIndicatorList; il != NULL; il = il->next)
+	{
+		pGauge->pIndicatorList = g_list_append (pGauge->pIndicatorList, _copy_gauge_indicator (il->data));
+	}
+	
+	// and load the images at our size (they are only rasterized once per size).
+	_load_gauge_images (pGauge, iWidth, iHeight);
 	
 	return TRUE;
 }
@@ -557,6 +771,9 @@ static void load (Gauge *pGauge, G_GNUC_UNUSED Icon *pIcon, CairoGaugeAttribute
 			memcpy (pLabel, &pGaugeIndicator->labelZone, sizeof (CairoDataRendererTextParam));
 		}
 	}
+	
+	// when the gauge is drawn once, what is above the indicators can be kept during the smooth animation; several drawings overlap each other, so they are drawn in one go.
+	cairo_data_renderer_enable_static_layer (pRenderer, pRenderer->iRank > 0 && (int) ceil (1. * iNbValues / pRenderer->iRank) == 1);
 }
 
   ////////////////////////////////////////////
@@ -786,6 +1003,14 @@ static void cairo_dock_draw_one_gauge_opengl (Gauge *pGauge, int iDataOffset)
 	int iWidth, iHeight;
 	cairo_data_renderer_get_size (pRenderer, &iWidth, &iHeight);
 	GaugeImage *pGaugeImage;
+	CairoDataRendererPass iPass = cairo_data_renderer_get_render_pass ();
+	GList *pIndicatorElement;
+	double fValue;
+	GaugeIndicator *pIndicator;
+	int i;
+	
+	if (iPass == CAIRO_DATA_RENDERER_PASS_STATIC)  // the background and the indicators move under the static layer.
+		goto static_layer;
 	
 	//\________________ On affiche le fond.
 	if(pGauge->pImageBackground != NULL)
@@ -796,10 +1021,6 @@ static void cairo_dock_draw_one_gauge_opengl (Gauge *pGauge, int iDataOffset)
 	}
 	
 	//\________________ On represente l'indicateur de chaque valeur.
-	GList *pIndicatorElement;
-	double fValue;
-	GaugeIndicator *pIndicator;
-	int i;
 	for (i = iDataOffset, pIndicatorElement = pGauge->pIndicatorList; i < pData->iNbValues && pIndicatorElement != NULL; i++, pIndicatorElement = pIndicatorElement->next)
 	{
 		pIndicator = pIndicatorElement->data;
@@ -815,6 +1036,10 @@ static void cairo_dock_draw_one_gauge_opengl (Gauge *pGauge, int iDataOffset)
 		}
 	}
 	
+	if (iPass == CAIRO_DATA_RENDERER_PASS_DYNAMIC)  // the rest is in the static layer.
+		return;
+	
+	static_layer:
 	//\________________ On affiche l'avant-plan.
 	if(pGauge->pImageForeground != NULL)
 	{
@@ -903,14 +1128,8 @@ static void render_opengl (Gauge *pGauge)
   //////////////////////////////////////////////
  /////////////// RELOAD GAUGE /////////////////
 //////////////////////////////////////////////
-static void reload (Gauge *pGauge)
+static void _load_gauge_images (Gauge *pGauge, int iWidth, int iHeight)
 {
-	//g_print ("%s (%dx%d)\n", __func__, iWidth, iHeight);
-	g_return_if_fail (pGauge != NULL);
-	
-	int iWidth, iHeight;
-	cairo_data_renderer_get_size (CAIRO_DATA_RENDERER (pGauge), &iWidth, &iHeight);
-	
 	if (pGauge->pImageBackground)
 		_reload_gauge_image (pGauge->pImageBackground, iWidth, iHeight);
 	
@@ -927,6 +1146,10 @@ static void reload (Gauge *pGauge)
 		{
 			_reload_gauge_image (&pGaugeIndicator->pImageList[i], iWidth, iHeight);
 		}
+		if (pGaugeIndicator->pImageUndef)
+		{
+			_reload_gauge_image (pGaugeIndicator->pImageUndef, iWidth, iHeight);
+		}
 		if (pGaugeIndicator->pImageNeedle)
 		{
 			_reload_gauge_needle (pGaugeIndicator, iWidth, iHeight);
@@ -934,6 +1157,17 @@ static void reload (Gauge *pGauge)
 	}
 }
 
+static void reload (Gauge *pGauge)
+{
+	//g_print ("%s (%dx%d)\n", __func__, iWidth, iHeight);
+	g_return_if_fail (pGauge != NULL);
+	
+	int iWidth, iHeight;
+	cairo_data_renderer_get_size (CAIRO_DATA_RENDERER (pGauge), &iWidth, &iHeight);
+	
+	_load_gauge_images (pGauge, iWidth, iHeight);
+}
+
   ////////////////////////////////////////////
  /////////////// FREE GAUGE /////////////////
 ////////////////////////////////////////////
@@ -977,6 +1211,13 @@ static void unload (Gauge *pGauge)
 	g_list_free (pGauge->pIndicatorList);
 }
 
+static void _free_gauge_theme (GaugeTheme *pTheme)
+{
+	unload (pTheme->pGauge);
+	g_free (pTheme->pGauge);
+	g_free (pTheme);
+}
+
 
   //////////////////////////////////////////
  /////////////// RENDERER /////////////////
@@ -131,6 +131,15 @@ static void _unregister_gs_backend (void)
 	//cairo_dock_wm_register_backend (NULL);
 }
 
+static void _on_got_dash_visibility (GVariant *pReply, G_GNUC_UNUSED const GError *pError, G_GNUC_UNUSED gpointer data)
+{
+	const gchar *cResult = NULL;
+	gboolean bSuccess = FALSE;
+	if (pReply != NULL)
+		g_variant_get (pReply, "(b&s)", &bSuccess, &cResult);
+	s_DashIsVisible = (!cResult || strcmp (cResult, "true") == 0);
+}
+
 static void _on_gs_owner_changed (G_GNUC_UNUSED const gchar *cName, gboolean bOwned, G_GNUC_UNUSED gpointer data)
 {
 	cd_debug ("Gnome-Shell is on the bus (%d)", bOwned);
@@ -144,15 +153,18 @@ static void _on_gs_owner_changed (G_GNUC_UNUSED const gchar *cName, gboolean bOw
 			CD_GS_OBJECT,
 			CD_GS_INTERFACE);
 		
-		gchar *cResult = NULL;
-		gboolean bSuccess = FALSE;
-		dbus_g_proxy_call (s_pGSProxy, "Eval", NULL,
-			G_TYPE_STRING, "Main.overview._dash.actor.visible;",
-			G_TYPE_INVALID,
-			G_TYPE_BOOLEAN, &bSuccess,
-			G_TYPE_STRING, &cResult,
-			G_TYPE_INVALID);
-		s_DashIsVisible = (!cResult || strcmp (cResult, "true") == 0);
+		s_DashIsVisible = TRUE;  // until we know it, like when the Shell doesn't answer.
+		cairo_dock_dbus_call_async (G_BUS_TYPE_SESSION,
+			CD_GS_BUS,
+			CD_GS_OBJECT,
+			CD_GS_INTERFACE,
+			"Eval",
+			g_variant_new ("(s)", "Main.overview._dash.actor.visible;"),
+			G_VARIANT_TYPE ("(bs)"),
+			-1,
+			NULL,
+			(CairoDockDbusReplyFunc) _on_got_dash_visibility,
+			NULL);  // don't wait for the Shell while the dock is starting.
 		
 		_register_gs_backend ();
 	}
@@ -28,6 +28,7 @@
 #include "cairo-dock-draw-opengl.h"
 #include "cairo-dock-draw.h"
 #include "cairo-dock-container.h"
+#include "cairo-dock-opengl.h"  // g_openglConfig
 #include "cairo-dock-icon-manager.h"  // myIconsParam.quickInfoTextDescription
 #include "cairo-dock-graph.h"
 
@@ -42,27 +43,27 @@ typedef struct _Graph {
 	GLuint iBackgroundTexture;
 	gint iMargin;
 	gboolean bMixGraphs;
+	gfloat *pColumns;  // (min,max) of the history for each pixel column, the most recent first; filled at each render.
+	gint iNbColumns;
+	cairo_surface_t *pPlotSurface;  // the curves, without the background; in scrolling mode, it's a ring of one column per value of the history.
+	GLuint iPlotTexture;
+	gint iPlotWidth, iPlotHeight;
+	gint iScrollOffset;  // column of the ring holding the most recent value.
+	gint iLastIndex;  // index in the history of the most recent value drawn in the ring.
+	gboolean bScrollValid;  // FALSE if the ring has to be drawn again entirely.
+	gdouble *fLastMinMax;  // range of the values when the ring was drawn.
 	} Graph;
 
 
 extern gboolean g_bUseOpenGL;
+extern CairoDockGLConfig g_openglConfig;
 
 
-static void render (Graph *pGraph, cairo_t *pCairoContext)
+static void _draw_plot (Graph *pGraph, cairo_t *pCairoContext)
 {
-	g_return_if_fail (pGraph != NULL);
-	g_return_if_fail (pCairoContext != NULL && cairo_status (pCairoContext) == CAIRO_STATUS_SUCCESS);
-	
 	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
-	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
 	
-	if (pGraph->pBackgroundSurface != NULL)
-	{
-		cairo_set_source_surface (pCairoContext, pGraph->pBackgroundSurface, 0., 0.);
-		cairo_paint (pCairoContext);
-	}
-
 	g_return_if_fail (pRenderer->iRank != 0); // workaround: FIXME
 	int iNbDrawings = iNbValues / pRenderer->iRank;
 	if (iNbDrawings == 0)
@@ -73,12 +74,16 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 	double fHeight = pRenderer->iHeight - 2*iMargin;
 	fHeight /= iNbDrawings;
 	
-	double fValue;
+	double fValue, fMin, fMax, y, fPrevY;
 	cairo_pattern_t *pGradationPattern;
-	int t, n = MIN (pData->iMemorySize, iWidth);  // for iteration over the memorized values.
+	gfloat *pColumns = pGraph->pColumns;
+	int t, n;  // for iteration over the columns of the history.
 	int i, iCurrentGraph, iGraphTop, iGraphBottom, iHeight = 0;
 	for (i = 0; i < iNbValues; i ++)
 	{
+		n = cairo_data_renderer_downsample_history (pRenderer, i, MIN (iWidth, pGraph->iNbColumns), pColumns);
+		if (n == 0)
+			continue;
 		cairo_save (pCairoContext);
 		if (pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE || pGraph->iType == CAIRO_DOCK_GRAPH_CIRCLE_PLAIN)
 		{
@@ -113,20 +118,28 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 			default :
 				cairo_set_line_width (pCairoContext, 1);
 				cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
-				fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
-				if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
-					fValue = 0;
-				cairo_move_to (pCairoContext,
-					iWidth - .5,
-					(1 - fValue) * (iHeight - 1) + .5) ; // - .5 to align line draw on pixel and + 1 px down because size is reduced
-				for (t = 1; t < n; t ++)
+				fPrevY = 0;
+				for (t = 0; t < n; t ++)
 				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
-					if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
-						fValue = 0;
-					cairo_line_to (pCairoContext,
-						iWidth - t - .5,
-						(1 - fValue) * (iHeight - 1) + .5); // - .5 to align line draw on pixel and + 1 px down because size is reduced
+					fMin = pColumns[2*t];
+					fMax = pColumns[2*t+1];
+					if (fMax <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
+						fMin = fMax = 0;
+					y = (1 - fMax) * (iHeight - 1) + .5;  // - .5 to align line draw on pixel and + 1 px down because size is reduced
+					fValue = (1 - fMin) * (iHeight - 1) + .5;
+					if (t == 0)
+						cairo_move_to (pCairoContext, iWidth - .5, y);
+					else if (fabs (fPrevY - y) > fabs (fPrevY - fValue))  // a column that gathers several values is a vertical segment between its extrema; start with the one closest to the previous point.
+					{
+						fValue = y;
+						y = (1 - fMin) * (iHeight - 1) + .5;
+						cairo_line_to (pCairoContext, iWidth - t - .5, y);
+					}
+					else
+						cairo_line_to (pCairoContext, iWidth - t - .5, y);
+					if (fValue != y)
+						cairo_line_to (pCairoContext, iWidth - t - .5, fValue);
+					fPrevY = fValue;
 				}
 				if (pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN)
 				{
@@ -147,7 +160,7 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 				cairo_set_line_width (pCairoContext, 1);
 				for (t = 0; t < n; t ++)
 				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
+					fValue = pColumns[2*t+1];
 					if (fValue > CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> no draw
 					{
 						cairo_move_to (pCairoContext,
@@ -156,9 +169,9 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 						cairo_rel_line_to (pCairoContext,
 							0.,
 							- fValue * iHeight);
-						cairo_stroke (pCairoContext);
 					}
 				}
+				cairo_stroke (pCairoContext);  // all the bars have the same source, so they can be stroked at once.
 			}
 			break;
 			
@@ -166,21 +179,21 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 			case CAIRO_DOCK_GRAPH_CIRCLE_PLAIN:
 				cairo_set_line_width (pCairoContext, 1);
 				cairo_set_line_join (pCairoContext, CAIRO_LINE_JOIN_ROUND);
-				fValue = cairo_data_renderer_get_normalized_current_value (pRenderer, i);
+				fValue = pColumns[1];
 				if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
 					fValue = 0;
 				double angle, radius = MIN (iWidth, fHeight)/2;
-				angle = -2*G_PI*(-.5/pData->iMemorySize);
+				angle = -2*G_PI*(-.5/n);
 				cairo_move_to (pCairoContext,
 					iMargin + iWidth/2 + radius * (fValue * cos (angle)),
 					iMargin + fHeight/2 + radius * (fValue * sin (angle)));
-				angle = -2*G_PI*(.5/pData->iMemorySize);
+				angle = -2*G_PI*(.5/n);
 				cairo_line_to (pCairoContext,
 					iMargin + iWidth/2 + radius * (fValue * cos (angle)),
 					iMargin + fHeight/2 + radius * (fValue * sin (angle)));
 				for (t = 1; t < n; t ++)
 				{
-					fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -t);
+					fValue = pColumns[2*t+1];
 					if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
 						fValue = 0;
 					angle = -2*G_PI*((t-.5)/n);
@@ -201,29 +214,320 @@ static void render (Graph *pGraph, cairo_t *pCairoContext)
 			break;
 		}
 		cairo_restore (pCairoContext);
+	}
+}
+
+  ///////////////////////////////////////////
+ /////////////// SCROLLING /////////////////
+///////////////////////////////////////////
+// When each value of the history has its own column (line, plain and bar graphs), the curves only shift by one pixel when a new value arrives.
+// So we keep them in a ring of columns, draw only the new column(s), and composite the ring with an offset.
+
+static inline gboolean _graph_can_scroll (Graph *pGraph)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	return ((pGraph->iType == CAIRO_DOCK_GRAPH_LINE || pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN || pGraph->iType == CAIRO_DOCK_GRAPH_BAR)
+		&& pRenderer->iRank != 0
+		&& pRenderer->data.iMemorySize <= pRenderer->iWidth - 2*pGraph->iMargin);
+}
+
+static void _free_plot_buffers (Graph *pGraph)
+{
+	if (pGraph->pPlotSurface != NULL)
+	{
+		cairo_surface_destroy (pGraph->pPlotSurface);
+		pGraph->pPlotSurface = NULL;
+	}
+	if (pGraph->iPlotTexture != 0)
+	{
+		_cairo_dock_delete_texture (pGraph->iPlotTexture);
+		pGraph->iPlotTexture = 0;
+	}
+	pGraph->iPlotWidth = pGraph->iPlotHeight = 0;
+	pGraph->bScrollValid = FALSE;
+}
+
+static gboolean _ensure_plot_buffers (Graph *pGraph, int iWidth, int iHeight, gboolean bUseTexture)
+{
+	if (iWidth <= 0 || iHeight <= 0)
+		return FALSE;
+	if (pGraph->pPlotSurface == NULL || pGraph->iPlotWidth != iWidth || pGraph->iPlotHeight != iHeight)
+	{
+		_free_plot_buffers (pGraph);
+		pGraph->pPlotSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+		pGraph->iPlotWidth = iWidth;
+		pGraph->iPlotHeight = iHeight;
+	}
+	if (bUseTexture && pGraph->iPlotTexture == 0)
+		pGraph->iPlotTexture = cairo_dock_create_texture_from_surface (pGraph->pPlotSurface);
+	return (pGraph->pPlotSurface != NULL);
+}
+
+// draw the value of age 'iAge' in the column 'iColumn' of the ring, joined to the previous value.
+static void _draw_scroll_column (Graph *pGraph, cairo_t *pCairoContext, int iColumn, int iAge)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	int iNbDrawings = iNbValues / pRenderer->iRank;
+	double fHeight = (double) pGraph->iPlotHeight / iNbDrawings;
+	gboolean bHasPrevious = (iAge + 1 < pRenderer->data.iMemorySize);
+	
+	cairo_save (pCairoContext);
+	cairo_rectangle (pCairoContext, iColumn, 0., 1., pGraph->iPlotHeight);
+	cairo_clip (pCairoContext);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_CLEAR);
+	cairo_paint (pCairoContext);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_OVER);
+	cairo_set_line_width (pCairoContext, 1);
+	
+	double fValue, fPrevValue, y, fPrevY;
+	int i, iGraphTop, iHeight;
+	for (i = 0; i < iNbValues; i ++)
+	{
+		cairo_save (pCairoContext);
+		iGraphTop = floor ((pGraph->bMixGraphs ? 0 : i) * fHeight);
+		iHeight = floor (((pGraph->bMixGraphs ? 0 : i) + 1) * fHeight) - iGraphTop;
+		cairo_translate (pCairoContext, 0., iGraphTop);
+		if (pGraph->pGradationPatterns[i] != NULL)
+			cairo_set_source (pCairoContext, pGraph->pGradationPatterns[i]);
+		else
+			cairo_set_source_rgb (pCairoContext,
+				pGraph->fLowColor[3*i+0],
+				pGraph->fLowColor[3*i+1],
+				pGraph->fLowColor[3*i+2]);
 		
+		fValue = cairo_data_renderer_get_normalized_value (pRenderer, i, -iAge);
+		if (pGraph->iType == CAIRO_DOCK_GRAPH_BAR)
+		{
+			if (fValue > CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> no draw
+			{
+				cairo_move_to (pCairoContext, iColumn + .5, iHeight);
+				cairo_rel_line_to (pCairoContext, 0., - fValue * iHeight);
+				cairo_stroke (pCairoContext);
+			}
+		}
+		else
+		{
+			if (fValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)  // undef value -> let's draw 0
+				fValue = 0;
+			fPrevValue = (bHasPrevious ? cairo_data_renderer_get_normalized_value (pRenderer, i, -iAge-1) : fValue);
+			if (fPrevValue <= CAIRO_DATA_RENDERER_UNDEF_VALUE+1)
+				fPrevValue = 0;
+			y = (1 - fValue) * (iHeight - 1) + .5;
+			fPrevY = (1 - fPrevValue) * (iHeight - 1) + .5;
+			if (pGraph->iType == CAIRO_DOCK_GRAPH_PLAIN)
+			{
+				cairo_move_to (pCairoContext, iColumn, fPrevY);
+				cairo_line_to (pCairoContext, iColumn + 1, y);
+				cairo_line_to (pCairoContext, iColumn + 1, iHeight);
+				cairo_line_to (pCairoContext, iColumn, iHeight);
+				cairo_close_path (pCairoContext);
+				cairo_fill (pCairoContext);
+				cairo_move_to (pCairoContext, iColumn, iHeight - .5);
+				cairo_rel_line_to (pCairoContext, 1., 0.);
+			}
+			cairo_move_to (pCairoContext, iColumn, fPrevY);
+			cairo_line_to (pCairoContext, iColumn + 1, y);
+			cairo_stroke (pCairoContext);
+		}
+		cairo_restore (pCairoContext);
+	}
+	cairo_restore (pCairoContext);
+}
+
+// bring the ring up to date with the history; return the number of columns that were drawn, the last one being at iScrollOffset.
+static int _update_scroll_surface (Graph *pGraph)
+{
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	CairoDataToRenderer *pData = cairo_data_renderer_get_data (pRenderer);
+	int n = pData->iMemorySize;
+	
+	int iNbNew;
+	if (pGraph->bScrollValid && pData->iCurrentIndex >= 0 && memcmp (pGraph->fLastMinMax, pData->pMinMaxValues, 2 * pData->iNbValues * sizeof (gdouble)) == 0)
+	{
+		iNbNew = pData->iCurrentIndex - pGraph->iLastIndex;
+		if (iNbNew < 0)
+			iNbNew += n;
+		if (iNbNew == 0)
+			return 0;
+	}
+	else  // the range of the values has changed, or the ring is new: redraw everything.
+	{
+		iNbNew = n;
+		pGraph->iScrollOffset = -1;
+	}
+	
+	cairo_t *pCairoContext = cairo_create (pGraph->pPlotSurface);
+	int iAge;
+	for (iAge = iNbNew - 1; iAge >= 0; iAge --)
+	{
+		pGraph->iScrollOffset ++;
+		if (pGraph->iScrollOffset >= n)
+			pGraph->iScrollOffset = 0;
+		_draw_scroll_column (pGraph, pCairoContext, pGraph->iScrollOffset, iAge);
+	}
+	cairo_destroy (pCairoContext);
+	cairo_surface_flush (pGraph->pPlotSurface);
+	
+	pGraph->iLastIndex = pData->iCurrentIndex;
+	pGraph->bScrollValid = (pData->iCurrentIndex >= 0);
+	memcpy (pGraph->fLastMinMax, pData->pMinMaxValues, 2 * pData->iNbValues * sizeof (gdouble));
+	return iNbNew;
+}
+
+static void _upload_plot_columns (Graph *pGraph, int iFirstColumn, int iNbColumns)
+{
+	if (! g_openglConfig.bNonPowerOfTwoAvailable)  // the texture has been rescaled to a power of 2, so we can't update a part of it.
+	{
+		_cairo_dock_delete_texture (pGraph->iPlotTexture);
+		pGraph->iPlotTexture = cairo_dock_create_texture_from_surface (pGraph->pPlotSurface);
+		return;
+	}
+	
+	glBindTexture (GL_TEXTURE_2D, pGraph->iPlotTexture);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pGraph->pPlotSurface) / 4);
+	glPixelStorei (GL_UNPACK_SKIP_PIXELS, iFirstColumn);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		iFirstColumn,
+		0,
+		iNbColumns,
+		pGraph->iPlotHeight,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		cairo_image_surface_get_data (pGraph->pPlotSurface));
+	glPixelStorei (GL_UNPACK_SKIP_PIXELS, 0);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+}
+
+static void render (Graph *pGraph, cairo_t *pCairoContext)
+{
+	g_return_if_fail (pGraph != NULL);
+	g_return_if_fail (pCairoContext != NULL && cairo_status (pCairoContext) == CAIRO_STATUS_SUCCESS);
+	
+	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	
+	if (pGraph->pBackgroundSurface != NULL)
+	{
+		cairo_set_source_surface (pCairoContext, pGraph->pBackgroundSurface, 0., 0.);
+		cairo_paint (pCairoContext);
+	}
+	
+	int iMargin = pGraph->iMargin;
+	if (_graph_can_scroll (pGraph)
+	&& _ensure_plot_buffers (pGraph, pRenderer->data.iMemorySize, pRenderer->iHeight - 2*iMargin, FALSE))
+	{
+		_update_scroll_surface (pGraph);
+		
+		// the ring is drawn on the right of the graph, the column after iScrollOffset being the oldest one.
+		int x = pRenderer->iWidth - iMargin - pGraph->iPlotWidth;
+		int iNbOldColumns = pGraph->iPlotWidth - pGraph->iScrollOffset - 1;
+		cairo_set_source_surface (pCairoContext, pGraph->pPlotSurface, x - (pGraph->iScrollOffset + 1), iMargin);
+		cairo_rectangle (pCairoContext, x, iMargin, iNbOldColumns, pGraph->iPlotHeight);
+		cairo_fill (pCairoContext);
+		cairo_set_source_surface (pCairoContext, pGraph->pPlotSurface, x + iNbOldColumns, iMargin);
+		cairo_rectangle (pCairoContext, x + iNbOldColumns, iMargin, pGraph->iScrollOffset + 1, pGraph->iPlotHeight);
+		cairo_fill (pCairoContext);
+	}
+	else
+	{
+		pGraph->bScrollValid = FALSE;
+		_draw_plot (pGraph, pCairoContext);
+	}
+	
+	int i;
+	for (i = 0; i < iNbValues; i ++)
+	{
 		cairo_dock_render_overlays_to_context (pRenderer, i, pCairoContext);
 	}
 }
-/* not used
+
 static void render_opengl (Graph *pGraph)
 {
 	g_return_if_fail (pGraph != NULL);
 	
 	CairoDataRenderer *pRenderer = CAIRO_DATA_RENDERER (pGraph);
+	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
+	int iMargin = pGraph->iMargin;
+	
+	_cairo_dock_enable_texture ();
+	_cairo_dock_set_blend_pbuffer ();  // ceci reste un mystere...
+	_cairo_dock_set_alpha (1.);
 	
+	//\________________ background.
 	if (pGraph->iBackgroundTexture != 0)
 	{
-		_cairo_dock_enable_texture ();
-		_cairo_dock_set_blend_pbuffer ();  // ceci reste un mystere...
-		_cairo_dock_set_alpha (1.);
-		_cairo_dock_apply_texture_at_size_with_alpha (pGraph->iBackgroundTexture, pRenderer->iWidth, pRenderer->iHeight, 1.);
-		_cairo_dock_disable_texture ();
+		_cairo_dock_apply_texture_at_size (pGraph->iBackgroundTexture, pRenderer->iWidth, pRenderer->iHeight);
+	}
+	
+	//\________________ curves.
+	if (_graph_can_scroll (pGraph))
+	{
+		if (_ensure_plot_buffers (pGraph, pRenderer->data.iMemorySize, pRenderer->iHeight - 2*iMargin, TRUE))
+		{
+			int iNbNew = _update_scroll_surface (pGraph);
+			if (iNbNew >= pGraph->iPlotWidth)
+			{
+				_upload_plot_columns (pGraph, 0, pGraph->iPlotWidth);
+			}
+			else if (iNbNew > 0)  // only upload the new columns, which may wrap around the end of the ring.
+			{
+				int iFirstColumn = pGraph->iScrollOffset - iNbNew + 1;
+				if (iFirstColumn >= 0)
+					_upload_plot_columns (pGraph, iFirstColumn, iNbNew);
+				else
+				{
+					_upload_plot_columns (pGraph, pGraph->iPlotWidth + iFirstColumn, - iFirstColumn);
+					_upload_plot_columns (pGraph, 0, pGraph->iScrollOffset + 1);
+				}
+			}
+		}
+		
+		if (pGraph->iPlotTexture != 0)
+		{
+			int w = pGraph->iPlotWidth, h = pGraph->iPlotHeight;
+			double x = pRenderer->iWidth/2. - iMargin - w;  // left of the ring.
+			double y = pRenderer->iHeight/2. - iMargin - h/2.;
+			double u = (double) (pGraph->iScrollOffset + 1) / w;
+			double du = 1. - u;
+			int iNbOldColumns = w - pGraph->iScrollOffset - 1;
+			int iNbRecentColumns = pGraph->iScrollOffset + 1;
+			double xOld = x + iNbOldColumns/2.;
+			double xRecent = x + iNbOldColumns + iNbRecentColumns/2.;
+			glBindTexture (GL_TEXTURE_2D, pGraph->iPlotTexture);
+			_cairo_dock_apply_current_texture_portion_at_size_with_offset (u, 0., du, 1.,
+				iNbOldColumns, h,
+				xOld, y);
+			_cairo_dock_apply_current_texture_portion_at_size_with_offset (0., 0., u, 1.,
+				iNbRecentColumns, h,
+				xRecent, y);
+		}
+	}
+	else if (_ensure_plot_buffers (pGraph, pRenderer->iWidth - 2*iMargin, pRenderer->iHeight - 2*iMargin, TRUE))  // no scrolling possible: draw the whole curves and upload them.
+	{
+		pGraph->bScrollValid = FALSE;
+		cairo_t *pCairoContext = cairo_create (pGraph->pPlotSurface);
+		cairo_set_operator (pCairoContext, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (pCairoContext);
+		cairo_set_operator (pCairoContext, CAIRO_OPERATOR_OVER);
+		cairo_translate (pCairoContext, - iMargin, - iMargin);
+		_draw_plot (pGraph, pCairoContext);
+		cairo_destroy (pCairoContext);
+		cairo_surface_flush (pGraph->pPlotSurface);
+		
+		_upload_plot_columns (pGraph, 0, pGraph->iPlotWidth);
+		_cairo_dock_apply_texture_at_size (pGraph->iPlotTexture, pGraph->iPlotWidth, pGraph->iPlotHeight);
 	}
+	_cairo_dock_disable_texture ();
 	
-	/// to be continued ...
+	//\________________ overlays.
+	int i;
+	for (i = 0; i < iNbValues; i ++)
+	{
+		cairo_dock_render_overlays_to_texture (pRenderer, i);
+	}
 }
-*/
 
 static inline cairo_surface_t *_cairo_dock_create_graph_background (double fWidth, double fHeight, int iMargin, gdouble *pBackGroundColor, CairoDockTypeGraph iType, int iNbDrawings)
 {
@@ -461,6 +765,9 @@ static void load (Graph *pGraph, G_GNUC_UNUSED Icon *pIcon, CairoGraphAttribute
 	}
 
 	pGraph->iMargin = floor (MIN (iWidth, iHeight) / 32);
+	pGraph->iNbColumns = MAX (1, iWidth);
+	pGraph->pColumns = g_new (gfloat, 2 * pGraph->iNbColumns);
+	pGraph->fLastMinMax = g_new0 (gdouble, 2 * iNbValues);
 
 	if (pAttribute->fBackGroundColor != NULL)
 		memcpy (pGraph->fBackGroundColor, pAttribute->fBackGroundColor, 4 * sizeof (double));
@@ -471,7 +778,7 @@ static void load (Graph *pGraph, G_GNUC_UNUSED Icon *pIcon, CairoGraphAttribute
 		pGraph->fBackGroundColor,
 		pGraph->iType,
 		iNbValues / pRenderer->iRank);
-	if (g_bUseOpenGL && 0)
+	if (g_bUseOpenGL)
 		pGraph->iBackgroundTexture = cairo_dock_create_texture_from_surface (pGraph->pBackgroundSurface);
 	
 	// on complete le data-renderer.
@@ -485,15 +792,18 @@ static void reload (Graph *pGraph)
 	int iNbValues = cairo_data_renderer_get_nb_values (pRenderer);
 	int iWidth = pRenderer->iWidth, iHeight = pRenderer->iHeight;
 	pGraph->iMargin = floor (MIN (iWidth, iHeight) / 32);
+	pGraph->iNbColumns = MAX (1, iWidth);
+	pGraph->pColumns = g_renew (gfloat, pGraph->pColumns, 2 * pGraph->iNbColumns);
 	if (pGraph->pBackgroundSurface != NULL)
 		cairo_surface_destroy (pGraph->pBackgroundSurface);
 	pGraph->pBackgroundSurface = _cairo_dock_create_graph_background (iWidth, iHeight, pGraph->iMargin, pGraph->fBackGroundColor, pGraph->iType, iNbValues / pRenderer->iRank);
 	if (pGraph->iBackgroundTexture != 0)
 		_cairo_dock_delete_texture (pGraph->iBackgroundTexture);
-	if (g_bUseOpenGL && 0)
+	if (g_bUseOpenGL)
 		pGraph->iBackgroundTexture = cairo_dock_create_texture_from_surface (pGraph->pBackgroundSurface);
 	else
 		pGraph->iBackgroundTexture = 0;
+	_free_plot_buffers (pGraph);  // the curves will be drawn again at the new size.
 	int i;
 	for (i = 0; i < iNbValues; i ++)
 	{
@@ -527,6 +837,9 @@ static void unload (Graph *pGraph)
 	}
 	
 	g_free (pGraph->pGradationPatterns);
+	g_free (pGraph->pColumns);
+	g_free (pGraph->fLastMinMax);
+	_free_plot_buffers (pGraph);
 	g_free (pGraph->fHighColor);
 	g_free (pGraph->fLowColor);
 }
@@ -544,7 +857,7 @@ void cairo_dock_register_data_renderer_graph (void)
 	// fill the properties we need
 	pRecord->interface.load              = (CairoDataRendererLoadFunc) load;
 	pRecord->interface.render            = (CairoDataRendererRenderFunc) render;
-	pRecord->interface.render_opengl     = (CairoDataRendererRenderOpenGLFunc) NULL;
+	pRecord->interface.render_opengl     = (CairoDataRendererRenderOpenGLFunc) render_opengl;
 	pRecord->interface.reload            = (CairoDataRendererReloadFunc) reload;
 	pRecord->interface.unload            = (CairoDataRendererUnloadFunc) unload;
 	pRecord->iStructSize                 = sizeof (Graph);
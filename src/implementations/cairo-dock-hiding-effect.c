@@ -192,15 +192,9 @@ static void _post_render_move_down_opengl (CairoDock *pDock, double fOffset)
  // FADE OUT //
 //////////////
 
-static void _init_fade_out (CairoDock *pDock)
-{
-	if (g_bUseOpenGL && ! g_openglConfig.bAccumBufferAvailable)
-		cairo_dock_create_redirect_texture_for_dock (pDock);
-}
-
 static void _pre_render_fade_out_opengl (CairoDock *pDock, double fOffset)
 {
-	if (! g_openglConfig.bAccumBufferAvailable && pDock->iFboId != 0)  // pas de glAccum.
+	if (pDock->iFboId != 0)  // prefer the FBO to glAccum: the icons can then be drawn only once for the whole animation.
 	{
 		_pre_render_opengl (pDock, fOffset);
 	}
@@ -222,12 +216,7 @@ static void _post_render_fade_out (CairoDock *pDock, double fOffset, cairo_t *pC
 static void _post_render_fade_out_opengl (CairoDock *pDock, double fOffset)
 {
 	double fAlpha = 1 - fOffset;
-	if (g_openglConfig.bAccumBufferAvailable)
-	{
-		glAccum (GL_LOAD, fAlpha*fAlpha);
-		glAccum (GL_RETURN, 1.0);
-	}
-	else if (pDock->iFboId != 0)
+	if (pDock->iFboId != 0)
 	{
 		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);  // switch back to window-system-provided framebuffer
 		glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT,
@@ -260,6 +249,11 @@ static void _post_render_fade_out_opengl (CairoDock *pDock, double fOffset)
 		
 		_cairo_dock_disable_texture ();
 	}
+	else if (g_openglConfig.bAccumBufferAvailable)
+	{
+		glAccum (GL_LOAD, fAlpha*fAlpha);
+		glAccum (GL_RETURN, 1.0);
+	}
 }
 
   //////////////////////
@@ -283,12 +277,7 @@ static void _post_render_semi_transparent (CairoDock *pDock, double fOffset, cai
 static void _post_render_semi_transparent_opengl (CairoDock *pDock, double fOffset)
 {
 	double fAlpha = 1 - (1 - CD_SEMI_ALPHA)*fOffset;
-	if (g_openglConfig.bAccumBufferAvailable)
-	{
-		glAccum (GL_LOAD, fAlpha);
-		glAccum (GL_RETURN, 1.0);
-	}
-	else if (pDock->iFboId != 0)
+	if (pDock->iFboId != 0)
 	{
 		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, 0);  // switch back to window-system-provided framebuffer
 		glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT,
@@ -322,6 +311,11 @@ static void _post_render_semi_transparent_opengl (CairoDock *pDock, double fOffs
 		
 		_cairo_dock_disable_texture ();
 	}
+	else if (g_openglConfig.bAccumBufferAvailable)
+	{
+		glAccum (GL_LOAD, fAlpha);
+		glAccum (GL_RETURN, 1.0);
+	}
 }
 
   //////////////
@@ -579,23 +573,26 @@ void cairo_dock_register_hiding_effects (void)
 	p->pre_render_opengl = _pre_render_opengl;
 	p->post_render_opengl = _post_render_move_down_opengl;
 	cairo_dock_register_hiding_effect ("Move down", p);
+	cairo_dock_set_hiding_effect_can_use_snapshot (p);
 	
 	p = g_new0 (CairoDockHidingEffect, 1);
 	p->cDisplayedName = _("Fade out");
-	p->init = _init_fade_out;
+	p->init = _init_opengl;
 	p->pre_render_opengl = _pre_render_fade_out_opengl;
 	p->post_render = _post_render_fade_out;
 	p->post_render_opengl = _post_render_fade_out_opengl;
 	cairo_dock_register_hiding_effect ("Fade out", p);
+	cairo_dock_set_hiding_effect_can_use_snapshot (p);
 	
 	p = g_new0 (CairoDockHidingEffect, 1);
 	p->cDisplayedName = _("Semi transparent");
-	p->init = _init_fade_out;
+	p->init = _init_opengl;
 	p->pre_render_opengl = _pre_render_fade_out_opengl;
 	p->post_render = _post_render_semi_transparent;
 	p->post_render_opengl = _post_render_semi_transparent_opengl;
 	p->bCanDisplayHiddenDock = TRUE;
 	cairo_dock_register_hiding_effect ("Semi transparent", p);
+	cairo_dock_set_hiding_effect_can_use_snapshot (p);
 	
 	p = g_new0 (CairoDockHidingEffect, 1);
 	p->cDisplayedName = _("Zoom out");
@@ -604,6 +601,7 @@ void cairo_dock_register_hiding_effects (void)
 	p->pre_render_opengl = _pre_render_opengl;
 	p->post_render_opengl = _post_render_zoom_opengl;
 	cairo_dock_register_hiding_effect ("Zoom out", p);
+	cairo_dock_set_hiding_effect_can_use_snapshot (p);
 	
 	p = g_new0 (CairoDockHidingEffect, 1);
 	p->cDisplayedName = _("Folding");
@@ -612,4 +610,5 @@ void cairo_dock_register_hiding_effects (void)
 	p->pre_render_opengl = _pre_render_opengl;
 	p->post_render_opengl = _post_render_folding_opengl;
 	cairo_dock_register_hiding_effect ("Folding", p);
+	cairo_dock_set_hiding_effect_can_use_snapshot (p);
 }
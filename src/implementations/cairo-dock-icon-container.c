@@ -359,11 +359,13 @@ void cairo_dock_register_icon_container_renderers (void)
 	p->render = _cairo_dock_draw_subdock_content_as_emblem;
 	p->render_opengl = _cairo_dock_draw_subdock_content_as_emblem_opengl;
 	cairo_dock_register_icon_container_renderer ("Emblem", p);
+	cairo_dock_set_icon_container_renderer_nb_icons (p, 4);
 	
 	p = g_new0 (CairoIconContainerRenderer, 1);
 	p->render = _cairo_dock_draw_subdock_content_as_stack;
 	p->render_opengl = _cairo_dock_draw_subdock_content_as_stack_opengl;
 	cairo_dock_register_icon_container_renderer ("Stack", p);
+	cairo_dock_set_icon_container_renderer_nb_icons (p, 3);
 	
 	p = g_new0 (CairoIconContainerRenderer, 1);
 	p->load = _cairo_dock_load_box_surface;
@@ -371,6 +373,7 @@ void cairo_dock_register_icon_container_renderers (void)
 	p->render = _cairo_dock_draw_subdock_content_as_box;
 	p->render_opengl = _cairo_dock_draw_subdock_content_as_box_opengl;
 	cairo_dock_register_icon_container_renderer ("Box", p);
+	cairo_dock_set_icon_container_renderer_nb_icons (p, 3);
 	
 	memset (&g_pBoxAboveBuffer, 0, sizeof (CairoDockImageBuffer));
 	memset (&g_pBoxBelowBuffer, 0, sizeof (CairoDockImageBuffer));
@@ -45,23 +45,32 @@ static DBusGProxy *s_pPlasmaAccelProxy = NULL;
 #define CD_KGLOBALACCEL_INTERFACE "org.kde.kglobalaccel.Component"
 
 
+static void _on_shortcut_invoked (G_GNUC_UNUSED GVariant *pReply, const GError *pError, const gchar *cShortcut)
+{
+	if (pError != NULL)
+		cd_warning ("Kwin '%s' error: %s", cShortcut, pError->message);
+}
+// the shortcut is invoked without waiting for KWin, so that the dock doesn't freeze if it's slow to answer.
+static gboolean _invoke_shortcut (const gchar *cObject, const gchar *cShortcut)
+{
+	return cairo_dock_dbus_call_async (G_BUS_TYPE_SESSION,
+		CD_KGLOBALACCEL_BUS,
+		cObject,
+		CD_KGLOBALACCEL_INTERFACE,
+		"invokeShortcut",
+		g_variant_new ("(s)", cShortcut),
+		NULL,
+		-1,
+		NULL,
+		(CairoDockDbusReplyFunc) _on_shortcut_invoked,
+		(gpointer) cShortcut);  // a constant string
+}
+
 static gboolean present_windows (void)
 {
 	gboolean bSuccess = FALSE;
 	if (s_pKwinAccelProxy != NULL)
-	{
-		GError *erreur = NULL;
-		bSuccess = dbus_g_proxy_call (s_pKwinAccelProxy, "invokeShortcut", &erreur,
-			G_TYPE_STRING, "ExposeAll",
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);
-		if (erreur)
-		{
-			cd_warning ("Kwin ExposeAll error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
-	}
+		bSuccess = _invoke_shortcut (CD_KGLOBALACCEL_KWIN_OBJECT, "ExposeAll");
 	return bSuccess;
 }
 
@@ -101,19 +110,7 @@ static gboolean present_desktops (void)
 {
 	gboolean bSuccess = FALSE;
 	if (s_pKwinAccelProxy != NULL)
-	{
-		GError *erreur = NULL;
-		bSuccess = dbus_g_proxy_call (s_pKwinAccelProxy, "invokeShortcut", &erreur,
-			G_TYPE_STRING, "ShowDesktopGrid",
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);
-		if (erreur)
-		{
-			cd_warning ("Kwin ShowDesktopGrid error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
-	}
+		bSuccess = _invoke_shortcut (CD_KGLOBALACCEL_KWIN_OBJECT, "ShowDesktopGrid");
 	return bSuccess;
 }
 
@@ -121,19 +118,7 @@ static gboolean show_widget_layer (void)
 {
 	gboolean bSuccess = FALSE;
 	if (s_pPlasmaAccelProxy != NULL)
-	{
-		GError *erreur = NULL;
-		bSuccess = dbus_g_proxy_call (s_pPlasmaAccelProxy, "invokeShortcut", &erreur,
-			G_TYPE_STRING, "Show Dashboard",
-			G_TYPE_INVALID,
-			G_TYPE_INVALID);
-		if (erreur)
-		{
-			cd_warning ("Plasma-desktop 'Show Dashboard' error: %s", erreur->message);
-			g_error_free (erreur);
-			bSuccess = FALSE;
-		}
-	}
+		bSuccess = _invoke_shortcut (CD_KGLOBALACCEL_PLASMA_OBJECT, "Show Dashboard");
 	return bSuccess;
 }
 
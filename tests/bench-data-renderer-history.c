@@ -0,0 +1,138 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Feeds 10 Hz data into 20 graphs for an hour of simulated time, and compares the cost of a redraw:
+// - with the history extrema maintained on each new value and the history downsampled to the graph's width;
+// - with a walk of the whole history through cairo_data_renderer_get_value, like the graphs used to do.
+// It fails if the maintained extrema differ from the ones found by walking the history.
+
+#include <stdio.h>
+#include <math.h>
+#include <glib.h>
+
+#include "cairo-dock-data-renderer.h"
+
+#define CD_NB_GRAPHS 20
+#define CD_RATE 10  // Hz
+#define CD_DURATION 3600  // seconds of simulated time
+#define CD_HISTORY (60 * CD_RATE)  // 1 minute of history per graph
+#define CD_NB_COLUMNS 64  // width of a graph, in pixels
+
+static CairoDataRenderer *_new_graph (void)
+{
+	CairoDataRenderer *pRenderer = g_new0 (CairoDataRenderer, 1);
+	CairoDataToRenderer *pData = &pRenderer->data;
+	pData->iNbValues = 1;
+	pData->iMemorySize = CD_HISTORY;
+	pData->pValuesBuffer = g_new0 (gdouble, CD_HISTORY);
+	pData->pTabValues = g_new (gdouble *, CD_HISTORY);
+	int t;
+	for (t = 0; t < CD_HISTORY; t ++)
+		pData->pTabValues[t] = &pData->pValuesBuffer[t];
+	pData->pMinMaxValues = g_new (gdouble, 2);
+	pData->pMinMaxValues[0] = 0.;
+	pData->pMinMaxValues[1] = 100.;
+	pData->iCurrentIndex = -1;
+	return pRenderer;
+}
+
+static double _next_value (GRand *pRand, double fPrevValue)
+{
+	if (g_rand_int_range (pRand, 0, 200) == 0)  // a missing sample from time to time.
+		return CAIRO_DATA_RENDERER_UNDEF_VALUE;
+	double x = fPrevValue + g_rand_double_range (pRand, -5., 5.);
+	return CLAMP (x, 0., 100.);
+}
+
+// the extrema found by walking the history, the way the graph used to read it.
+static gboolean _walk_history (CairoDataRenderer *pRenderer, int iNbSamples, double *fMin, double *fMax)
+{
+	int n = MIN (iNbSamples, CD_HISTORY);
+	double x;
+	*fMin = G_MAXDOUBLE;
+	*fMax = - G_MAXDOUBLE;
+	int t;
+	for (t = 1 - n; t <= 0; t ++)
+	{
+		x = cairo_data_renderer_get_value (pRenderer, 0, t);
+		if (x > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+		{
+			if (x < *fMin)
+				*fMin = x;
+			if (x > *fMax)
+				*fMax = x;
+		}
+	}
+	return (*fMax >= *fMin);
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	CairoDataRenderer *pGraphs[CD_NB_GRAPHS];
+	double fValues[CD_NB_GRAPHS];
+	int g;
+	for (g = 0; g < CD_NB_GRAPHS; g ++)
+	{
+		pGraphs[g] = _new_graph ();
+		fValues[g] = 50.;
+	}
+	gfloat pColumns[2 * CD_NB_COLUMNS];
+	GRand *pRand = g_rand_new_with_seed (1);
+	int iNbTicks = CD_RATE * CD_DURATION;
+	int iNbErrors = 0;
+	gint64 iNewTime = 0, iWalkTime = 0, t0;
+	double fMin, fMax, fWalkMin, fWalkMax, x;
+	gboolean bDefined, bWalkDefined;
+	int n;
+	for (n = 1; n <= iNbTicks; n ++)
+	{
+		for (g = 0; g < CD_NB_GRAPHS; g ++)
+		{
+			x = _next_value (pRand, fValues[g]);
+			if (x > CAIRO_DATA_RENDERER_UNDEF_VALUE + 1)
+				fValues[g] = x;
+			cairo_data_renderer_push_values (pGraphs[g], &x);
+
+			// redraw with the maintained extrema and the downsampled history.
+			t0 = g_get_monotonic_time ();
+			bDefined = cairo_data_renderer_get_history_extrema (pGraphs[g], 0, &fMin, &fMax);
+			cairo_data_renderer_downsample_history (pGraphs[g], 0, CD_NB_COLUMNS, pColumns);
+			iNewTime += g_get_monotonic_time () - t0;
+
+			// redraw by walking the whole history.
+			t0 = g_get_monotonic_time ();
+			bWalkDefined = _walk_history (pGraphs[g], n, &fWalkMin, &fWalkMax);
+			iWalkTime += g_get_monotonic_time () - t0;
+
+			if (bDefined != bWalkDefined || (bDefined && ((float)fMin != (float)fWalkMin || (float)fMax != (float)fWalkMax)))  // the history is kept as floats.
+			{
+				if (iNbErrors < 10)
+					g_printerr ("graph %d, sample %d: extrema [%f;%f] instead of [%f;%f]\n", g, n, fMin, fMax, fWalkMin, fWalkMax);
+				iNbErrors ++;
+			}
+		}
+	}
+	g_rand_free (pRand);
+
+	g_print ("%d graphs at %d Hz during %ds (%d samples of history, %d columns):\n", CD_NB_GRAPHS, CD_RATE, CD_DURATION, CD_HISTORY, CD_NB_COLUMNS);
+	g_print (" maintained extrema + downsampling: %.3fs (%.2fus per redraw)\n", iNewTime / 1e6, (double)iNewTime / iNbTicks / CD_NB_GRAPHS);
+	g_print (" walk of the whole history:         %.3fs (%.2fus per redraw)\n", iWalkTime / 1e6, (double)iWalkTime / iNbTicks / CD_NB_GRAPHS);
+	g_print (" %d error(s)\n", iNbErrors);
+	return (iNbErrors == 0 ? 0 : 1);
+}
@@ -0,0 +1,175 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Measures the cost of a log call, and checks that:
+// - a call below the active level costs only a test;
+// - a stalled output (a pipe nobody reads) never blocks the caller, and every message is either written or counted as dropped;
+// - the file and domain filters, and the JSON output, work, and a warning comes after the messages sent before it.
+// A warning is used as a barrier: it's written synchronously, after everything that was queued.
+
+#define G_LOG_DOMAIN "cd-bench"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-log.h"
+
+#define CD_NB_DISABLED_CALLS 10000000
+#define CD_NB_ENABLED_CALLS 100000
+#define CD_NB_STALLED_CALLS 30000  // more than the queue can hold
+#define CD_MAX_DISABLED_COST 50  // ns
+#define CD_MAX_STALLED_CALL 10000  // us
+
+static int s_iNbErrors = 0;
+
+static void _check (gboolean bOk, const gchar *cWhat)
+{
+	if (! bOk)
+	{
+		g_printerr ("failed: %s\n", cWhat);
+		s_iNbErrors ++;
+	}
+}
+
+static void _redirect_stdout (int fd)
+{
+	fflush (stdout);
+	dup2 (fd, 1);
+}
+
+static gpointer _read_pipe (gpointer fd)
+{
+	GString *sOutput = g_string_new ("");
+	char buf[4096];
+	ssize_t n;
+	while ((n = read (GPOINTER_TO_INT (fd), buf, sizeof (buf))) > 0)
+		g_string_append_len (sOutput, buf, n);
+	return sOutput;
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	int iStdout = dup (1);
+	cd_log_init (FALSE);
+	int i;
+	gint64 t0, dt, iMaxCall = 0;
+
+	//\_____________ disabled calls.
+	cd_log_set_level (G_LOG_LEVEL_WARNING);
+	t0 = g_get_monotonic_time ();
+	for (i = 0; i < CD_NB_DISABLED_CALLS; i ++)
+		cd_debug ("disabled message %d", i);
+	double fDisabledCost = (double)(g_get_monotonic_time () - t0) * 1e3 / CD_NB_DISABLED_CALLS;
+	_check (fDisabledCost < CD_MAX_DISABLED_COST, "a disabled call is cheap");
+
+	//\_____________ enabled calls, into a fast output.
+	int iNullFd = open ("/dev/null", O_WRONLY);
+	_redirect_stdout (iNullFd);
+	cd_log_set_level (G_LOG_LEVEL_MESSAGE);
+	t0 = g_get_monotonic_time ();
+	for (i = 0; i < CD_NB_ENABLED_CALLS; i ++)
+		cd_message ("enabled message %d", i);
+	double fEnabledCost = (double)(g_get_monotonic_time () - t0) * 1e3 / CD_NB_ENABLED_CALLS;
+	cd_warning ("barrier");
+
+	//\_____________ enabled calls, into an output that nobody reads.
+	int fds[2];
+	if (pipe (fds) != 0)
+		return 1;
+	_redirect_stdout (fds[1]);
+	close (fds[1]);
+	t0 = g_get_monotonic_time ();
+	for (i = 0; i < CD_NB_STALLED_CALLS; i ++)
+	{
+		cd_message ("stalled message %d", i);
+		dt = g_get_monotonic_time () - t0;
+		if (dt > iMaxCall)
+			iMaxCall = dt;
+		t0 += dt;
+	}
+	_check (iMaxCall < CD_MAX_STALLED_CALL, "a stalled output doesn't block the caller");
+
+	GThread *pReader = g_thread_new ("reader", _read_pipe, GINT_TO_POINTER (fds[0]));  // now let the output flow.
+	cd_warning ("barrier");
+	_redirect_stdout (iNullFd);  // closes the pipe.
+	GString *sOutput = g_thread_join (pReader);
+	close (fds[0]);
+
+	int iNbWritten = 0, iNbDropped = 0;
+	gchar **pLines = g_strsplit (sOutput->str, "\n", -1);
+	const gchar *str, *num;
+	for (i = 0; pLines[i] != NULL; i ++)
+	{
+		if (strstr (pLines[i], "stalled message ") != NULL)
+			iNbWritten ++;
+		else if ((str = strstr (pLines[i], " log messages were dropped")) != NULL)
+		{
+			for (num = str; num > pLines[i] && g_ascii_isdigit (num[-1]); num --);
+			iNbDropped += atoi (num);
+		}
+	}
+	g_strfreev (pLines);
+	g_string_free (sOutput, TRUE);
+	_check (iNbDropped > 0, "the output has been stalled");
+	_check (iNbWritten + iNbDropped == CD_NB_STALLED_CALLS, "every message is written or counted as dropped");
+
+	//\_____________ filters and JSON output.
+	gchar *cLogFile = NULL;
+	int iLogFd = g_file_open_tmp ("cairo-dock-log-XXXXXX", &cLogFile, NULL);
+	_redirect_stdout (iLogFd);
+	cd_log_set_json_output (TRUE);
+	cd_log_set_level (G_LOG_LEVEL_WARNING);
+	cd_log_set_filter ("bench-log-backend.c", G_LOG_LEVEL_DEBUG);
+	cd_debug ("kept by the file filter");
+	cd_log_set_filter ("bench-log-backend.c", 0);
+	cd_debug ("dropped by the level");
+	cd_log_set_filter (G_LOG_DOMAIN, G_LOG_LEVEL_MESSAGE);
+	cd_message ("kept by the domain filter");
+	cd_debug ("dropped by the domain filter");
+	cd_log_set_filter (G_LOG_DOMAIN, 0);
+	cd_warning ("after the pending messages");
+	cd_log_set_json_output (FALSE);
+	_redirect_stdout (iStdout);
+
+	gchar *cLog = NULL;
+	g_file_get_contents (cLogFile, &cLog, NULL, NULL);
+	const gchar *cFileKept = cLog ? strstr (cLog, "\"msg\":\"kept by the file filter\"") : NULL;
+	const gchar *cDomainKept = cLog ? strstr (cLog, "\"msg\":\"kept by the domain filter\"") : NULL;
+	const gchar *cWarning = cLog ? strstr (cLog, "\"msg\":\"after the pending messages\"") : NULL;
+	_check (cFileKept != NULL, "a file filter enables a message");
+	_check (cDomainKept != NULL, "a domain filter enables a message");
+	_check (cLog != NULL && strstr (cLog, "dropped by") == NULL, "removed filters and lower levels discard messages");
+	_check (cWarning != NULL && cFileKept < cWarning && cDomainKept < cWarning, "a warning comes after the messages sent before it");
+	_check (cLog != NULL && strstr (cLog, "\"file\":\"bench-log-backend.c\"") != NULL && strstr (cLog, "\"domain\":\""G_LOG_DOMAIN"\"") != NULL, "JSON fields");
+	g_free (cLog);
+	g_remove (cLogFile);
+	g_free (cLogFile);
+	close (iLogFd);
+	close (iNullFd);
+
+	g_print ("disabled call: %.1fns\n", fDisabledCost);
+	g_print ("enabled call: %.0fns\n", fEnabledCost);
+	g_print ("stalled output: longest call %.2fms, %d messages written, %d dropped\n", iMaxCall / 1e3, iNbWritten, iNbDropped);
+	g_print ("%d error(s)\n", s_iNbErrors);
+	return (s_iNbErrors == 0 ? 0 : 1);
+}
@@ -0,0 +1,257 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Runs a private session bus with a mock service that takes its time to answer, and checks that the asynchronous calls:
+// - don't block the main loop, neither while connecting to the bus nor while waiting for the answer;
+// - are all sent once connected, when they were made before the connection to the bus;
+// - get the answer, or nothing at all once cancelled.
+// It's skipped (code 77) if 'dbus-daemon' is not available.
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "cairo-dock-dbus.h"
+
+#define CD_TEST_SERVICE "org.cairodock.TestService"
+#define CD_TEST_OBJECT "/org/cairodock/TestService"
+#define CD_TEST_INTERFACE "org.cairodock.TestService"
+#define CD_SLOW_REPLY 500  // ms
+#define CD_TICK 10  // ms
+
+static const gchar s_cIntrospection[] =
+	"<node>"
+	"  <interface name='"CD_TEST_INTERFACE"'>"
+	"    <method name='Echo'>"
+	"      <arg type='s' name='text' direction='in'/>"
+	"      <arg type='u' name='delay' direction='in'/>"
+	"      <arg type='s' name='text' direction='out'/>"
+	"    </method>"
+	"  </interface>"
+	"</node>";
+
+static GMainLoop *s_pLoop = NULL;
+static gint64 s_iLastTick = 0;
+static gint64 s_iMaxGap = 0;  // longest time without a tick of the main loop, in us.
+static GString *s_pAnswers = NULL;
+static int s_iNbPendingCalls = 0;
+static int s_iNbErrors = 0;
+
+  /////////////////////
+ /// MOCK SERVICE ///
+/////////////////////
+
+typedef struct {
+	GDBusMethodInvocation *pInvocation;
+	gchar *cText;
+} CDDelayedReply;
+
+static gboolean _send_delayed_reply (CDDelayedReply *pReply)
+{
+	g_dbus_method_invocation_return_value (pReply->pInvocation, g_variant_new ("(s)", pReply->cText));
+	g_free (pReply->cText);
+	g_free (pReply);
+	return G_SOURCE_REMOVE;
+}
+
+static void _on_method_call (G_GNUC_UNUSED GDBusConnection *pConnection, G_GNUC_UNUSED const gchar *cSender, G_GNUC_UNUSED const gchar *cPath, G_GNUC_UNUSED const gchar *cInterface, G_GNUC_UNUSED const gchar *cMethod, GVariant *pParams, GDBusMethodInvocation *pInvocation, G_GNUC_UNUSED gpointer data)
+{
+	CDDelayedReply *pReply = g_new0 (CDDelayedReply, 1);
+	guint iDelay = 0;
+	g_variant_get (pParams, "(su)", &pReply->cText, &iDelay);
+	pReply->pInvocation = pInvocation;
+	g_timeout_add (iDelay, (GSourceFunc) _send_delayed_reply, pReply);  // a slow service, that doesn't block our own loop though.
+}
+
+static const GDBusInterfaceVTable s_vtable = {_on_method_call, NULL, NULL, {0}};
+
+static void _on_name_acquired (G_GNUC_UNUSED GDBusConnection *pConnection, G_GNUC_UNUSED const gchar *cName, G_GNUC_UNUSED gpointer data)
+{
+	g_main_loop_quit (s_pLoop);
+}
+
+static GDBusConnection *_start_mock_service (const gchar *cAddress)
+{
+	GError *erreur = NULL;
+	GDBusConnection *pConnection = g_dbus_connection_new_for_address_sync (cAddress,
+		G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT | G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+		NULL, NULL, &erreur);
+	if (erreur != NULL)
+	{
+		g_printerr ("couldn't connect the mock service: %s\n", erreur->message);
+		g_error_free (erreur);
+		return NULL;
+	}
+	GDBusNodeInfo *pInfo = g_dbus_node_info_new_for_xml (s_cIntrospection, NULL);
+	g_dbus_connection_register_object (pConnection, CD_TEST_OBJECT, pInfo->interfaces[0], &s_vtable, NULL, NULL, NULL);
+	g_dbus_node_info_unref (pInfo);
+	g_bus_own_name_on_connection (pConnection, CD_TEST_SERVICE, G_BUS_NAME_OWNER_FLAGS_NONE, _on_name_acquired, NULL, NULL, NULL);
+	g_main_loop_run (s_pLoop);  // wait until we own the name.
+	return pConnection;
+}
+
+  //////////////
+ /// CLIENT ///
+//////////////
+
+static gboolean _on_tick (G_GNUC_UNUSED gpointer data)
+{
+	gint64 t = g_get_monotonic_time ();
+	if (s_iLastTick != 0 && t - s_iLastTick > s_iMaxGap)
+		s_iMaxGap = t - s_iLastTick;
+	s_iLastTick = t;
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean _on_timeout (G_GNUC_UNUSED gpointer data)
+{
+	g_main_loop_quit (s_pLoop);
+	return G_SOURCE_CONTINUE;  // removed once the loop is over.
+}
+
+static void _on_echo (GVariant *pReply, const GError *pError, const gchar *cExpected)
+{
+	if (pError != NULL || pReply == NULL)
+	{
+		g_printerr ("'%s': %s\n", cExpected, pError ? pError->message : "no answer");
+		s_iNbErrors ++;
+	}
+	else
+	{
+		const gchar *cText = NULL;
+		g_variant_get (pReply, "(&s)", &cText);
+		if (strcmp (cText, cExpected) != 0)
+		{
+			g_printerr ("got '%s' instead of '%s'\n", cText, cExpected);
+			s_iNbErrors ++;
+		}
+		g_string_append (s_pAnswers, cText);
+	}
+	if (-- s_iNbPendingCalls == 0)
+		g_main_loop_quit (s_pLoop);
+}
+
+static void _on_cancelled_echo (G_GNUC_UNUSED GVariant *pReply, G_GNUC_UNUSED const GError *pError, G_GNUC_UNUSED gpointer data)
+{
+	g_printerr ("a cancelled call got an answer\n");
+	s_iNbErrors ++;
+}
+
+static void _on_list_names (GVariant *pReply, const GError *pError, gboolean *bFound)
+{
+	if (pReply != NULL)
+	{
+		GVariantIter *it = NULL;
+		const gchar *cName;
+		g_variant_get (pReply, "(as)", &it);
+		while (g_variant_iter_next (it, "&s", &cName))
+		{
+			if (strcmp (cName, CD_TEST_SERVICE) == 0)
+				*bFound = TRUE;
+		}
+		g_variant_iter_free (it);
+	}
+	else
+		g_printerr ("ListNames: %s\n", pError ? pError->message : "no answer");
+	if (-- s_iNbPendingCalls == 0)
+		g_main_loop_quit (s_pLoop);
+}
+
+static gboolean _echo (const gchar *cText, guint iDelay, GCancellable *pCancellable, CairoDockDbusReplyFunc pCallback)
+{
+	return cairo_dock_dbus_call_async (G_BUS_TYPE_SESSION, CD_TEST_SERVICE, CD_TEST_OBJECT, CD_TEST_INTERFACE, "Echo",
+		g_variant_new ("(su)", cText, iDelay),
+		G_VARIANT_TYPE ("(s)"),
+		-1,
+		pCancellable,
+		pCallback,
+		(gpointer) cText);
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	gchar *cDaemon = g_find_program_in_path ("dbus-daemon");
+	if (cDaemon == NULL)
+	{
+		g_print ("no dbus-daemon, skipped\n");
+		return 77;
+	}
+	g_free (cDaemon);
+
+	GTestDBus *pTestBus = g_test_dbus_new (G_TEST_DBUS_NONE);
+	g_test_dbus_up (pTestBus);  // sets DBUS_SESSION_BUS_ADDRESS for the calls below.
+	s_pLoop = g_main_loop_new (NULL, FALSE);
+	s_pAnswers = g_string_new ("");
+	GDBusConnection *pService = _start_mock_service (g_test_dbus_get_bus_address (pTestBus));
+	if (pService == NULL)
+	{
+		g_test_dbus_down (pTestBus);
+		return 1;
+	}
+
+	// the first calls are sent while the connection to the bus is being made; the slowest one is sent first.
+	GCancellable *pCancellable = g_cancellable_new ();
+	gint64 t0 = g_get_monotonic_time ();
+	gboolean bFound = FALSE;
+	s_iNbPendingCalls = 3;
+	_echo ("a", CD_SLOW_REPLY, NULL, (CairoDockDbusReplyFunc) _on_echo);
+	_echo ("x", CD_SLOW_REPLY / 2, pCancellable, _on_cancelled_echo);
+	_echo ("b", 0, NULL, (CairoDockDbusReplyFunc) _on_echo);
+	cairo_dock_dbus_list_names_async (G_BUS_TYPE_SESSION, NULL, (CairoDockDbusReplyFunc) _on_list_names, &bFound);
+	gint64 iSendTime = g_get_monotonic_time () - t0;
+	g_cancellable_cancel (pCancellable);
+
+	g_timeout_add (CD_TICK, _on_tick, NULL);
+	guint iSidTimeout = g_timeout_add_seconds (10, _on_timeout, NULL);  // in case an answer never comes.
+	g_main_loop_run (s_pLoop);
+	g_source_remove (iSidTimeout);
+
+	if (s_iNbPendingCalls != 0)
+	{
+		g_printerr ("%d call(s) got no answer\n", s_iNbPendingCalls);
+		s_iNbErrors ++;
+	}
+	if (strcmp (s_pAnswers->str, "ba") != 0)  // the quick answer comes first, the cancelled one never comes.
+	{
+		g_printerr ("answers: '%s' instead of 'ba'\n", s_pAnswers->str);
+		s_iNbErrors ++;
+	}
+	if (! bFound)
+	{
+		g_printerr ("the mock service is not in the list of names\n");
+		s_iNbErrors ++;
+	}
+	if (iSendTime > CD_SLOW_REPLY * 1000 / 5 || s_iMaxGap > CD_SLOW_REPLY * 1000 / 5)  // way shorter than the slow answer.
+	{
+		g_printerr ("the main loop was blocked: %.1fms to send the calls, %.1fms without a tick\n", iSendTime / 1e3, s_iMaxGap / 1e3);
+		s_iNbErrors ++;
+	}
+
+	g_print ("calls sent in %.2fms, main loop blocked for %.1fms at most while waiting for a %dms answer\n", iSendTime / 1e3, s_iMaxGap / 1e3, CD_SLOW_REPLY);
+	g_print ("%d error(s)\n", s_iNbErrors);
+
+	g_object_unref (pCancellable);
+	g_object_unref (pService);
+	g_string_free (s_pAnswers, TRUE);
+	g_main_loop_unref (s_pLoop);
+	g_test_dbus_down (pTestBus);
+	g_object_unref (pTestBus);
+	return (s_iNbErrors == 0 ? 0 : 1);
+}
@@ -0,0 +1,123 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Searches .desktop files in a fake application folder, like "Make it a launcher" does:
+// - by file name, then by content;
+// - through a folder holding 2 links back to its parent, which would make the search recurse endlessly if the links were followed;
+// - without any PATH and while counting the forks, since the search must not launch any command.
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-utils.h"
+
+static int s_iNbForks = 0;
+
+static void _on_fork (void)
+{
+	s_iNbForks ++;
+}
+
+static void _write_file (const gchar *cDir, const gchar *cName, const gchar *cContent)
+{
+	gchar *cPath = g_build_filename (cDir, cName, NULL);
+	g_file_set_contents (cPath, cContent, -1, NULL);
+	g_free (cPath);
+}
+
+static void _remove_tree (const gchar *cPath)
+{
+	if (! g_file_test (cPath, G_FILE_TEST_IS_SYMLINK) && g_file_test (cPath, G_FILE_TEST_IS_DIR))
+	{
+		GDir *dir = g_dir_open (cPath, 0, NULL);
+		const gchar *cName;
+		while (dir != NULL && (cName = g_dir_read_name (dir)) != NULL)
+		{
+			gchar *cChild = g_build_filename (cPath, cName, NULL);
+			_remove_tree (cChild);
+			g_free (cChild);
+		}
+		if (dir != NULL)
+			g_dir_close (dir);
+	}
+	g_remove (cPath);
+}
+
+static int _check (const gchar *cClass, const gchar *cDir, const gchar *cExpectedPath)
+{
+	const gchar *cDirs[] = {cDir, NULL};
+	gchar *cResult = cairo_dock_search_desktop_file (cClass, cDirs);
+	int iNbErrors = 0;
+	if (g_strcmp0 (cResult, cExpectedPath) != 0)
+	{
+		g_printerr ("'%s': found %s instead of %s\n", cClass, cResult, cExpectedPath);
+		iNbErrors = 1;
+	}
+	g_free (cResult);
+	return iNbErrors;
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	pthread_atfork (_on_fork, NULL, NULL);
+	g_setenv ("PATH", "", TRUE);  // a search relying on 'find' or 'grep' can't find anything.
+
+	gchar *cTmpDir = g_dir_make_tmp ("cairo-dock-test-XXXXXX", NULL);
+	g_return_val_if_fail (cTmpDir != NULL, 1);
+	gchar *cAppsDir = g_build_filename (cTmpDir, "applications", NULL);
+	gchar *cSubDir = g_build_filename (cAppsDir, "kde4", NULL);
+	g_mkdir_with_parents (cSubDir, 0700);
+
+	_write_file (cAppsDir, "Org.Example.Editor.desktop", "[Desktop Entry]\nName=Editor\nExec=editor\n");
+	_write_file (cSubDir, "calc.desktop", "[Desktop Entry]\nName=Calculator\nExec=calc\nStartupWMClass=KCalc-Window\n");
+	_write_file (cSubDir, "readme.txt", "kcalc-window");
+	gchar *cLink1 = g_build_filename (cSubDir, "loop1", NULL);
+	gchar *cLink2 = g_build_filename (cSubDir, "loop2", NULL);
+	if (symlink ("..", cLink1) != 0 || symlink ("..", cLink2) != 0)
+		g_printerr ("couldn't create the links, the loop is not tested\n");
+
+	gchar *cEditorPath = g_build_filename (cAppsDir, "Org.Example.Editor.desktop", NULL);
+	gchar *cCalcPath = g_build_filename (cSubDir, "calc.desktop", NULL);
+	int iNbErrors = 0;
+	iNbErrors += _check ("org.example.editor", cAppsDir, cEditorPath);  // from the file name, case-insensitive.
+	iNbErrors += _check ("KCalc-Window", cAppsDir, cCalcPath);  // from the content of a file in a sub-folder.
+	iNbErrors += _check ("no-such-application", cAppsDir, NULL);  // the whole tree is walked, without following the links.
+
+	if (s_iNbForks != 0)
+	{
+		g_printerr ("the search forked %d time(s)\n", s_iNbForks);
+		iNbErrors ++;
+	}
+
+	_remove_tree (cTmpDir);
+	g_free (cEditorPath);
+	g_free (cCalcPath);
+	g_free (cLink1);
+	g_free (cLink2);
+	g_free (cSubDir);
+	g_free (cAppsDir);
+	g_free (cTmpDir);
+
+	g_print ("%d error(s)\n", iNbErrors);
+	return (iNbErrors == 0 ? 0 : 1);
+}
@@ -0,0 +1,206 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Copies a fake theme the way an import does, then imports it again, and checks that:
+// - contents, permissions, dates and links are kept;
+// - the second import only copies the files that changed, and never writes through a link;
+// - a cancelled copy stops at once;
+// - removing the copy doesn't follow the links it holds.
+// It also prints the time of the first import and of the second one.
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-file-manager.h"
+
+#define CD_NB_DIRS 10
+#define CD_NB_FILES_PER_DIR 20
+#define CD_FILE_SIZE (64 * 1024)
+
+static int s_iNbErrors = 0;
+
+static void _check (gboolean bOk, const gchar *cWhat)
+{
+	if (! bOk)
+	{
+		g_printerr ("failed: %s\n", cWhat);
+		s_iNbErrors ++;
+	}
+}
+
+static void _write_file (const gchar *cPath, gsize iSize, char c)
+{
+	gchar *cContent = g_malloc (iSize);
+	memset (cContent, c, iSize);
+	g_file_set_contents (cPath, cContent, iSize, NULL);
+	g_free (cContent);
+}
+
+static gboolean _same_content (const gchar *cPath1, const gchar *cPath2)
+{
+	gchar *c1 = NULL, *c2 = NULL;
+	gsize n1 = 0, n2 = 0;
+	gboolean bSame = g_file_get_contents (cPath1, &c1, &n1, NULL)
+		&& g_file_get_contents (cPath2, &c2, &n2, NULL)
+		&& n1 == n2 && memcmp (c1, c2, n1) == 0;
+	g_free (c1);
+	g_free (c2);
+	return bSame;
+}
+
+// overwrite a file with something else of the same size, and give it back its date, so that only its content tells it has been touched.
+static void _tamper (const gchar *cPath)
+{
+	struct stat st;
+	stat (cPath, &st);
+	int fd = open (cPath, O_WRONLY);
+	if (fd < 0 || write (fd, "#", 1) != 1)
+		_check (FALSE, "modification of a copied file");
+	struct timespec times[2] = {st.st_atim, st.st_mtim};
+	futimens (fd, times);
+	close (fd);
+}
+
+static gint64 _copy (const gchar *cSrc, const gchar *cDest, gboolean bSkipUnchanged, gint *pNbFiles)
+{
+	gint64 t0 = g_get_monotonic_time ();
+	_check (cairo_dock_copy_tree (cSrc, cDest, bSkipUnchanged, NULL, pNbFiles), "copy of the tree");
+	return g_get_monotonic_time () - t0;
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	gchar *cTmpDir = g_dir_make_tmp ("cairo-dock-test-XXXXXX", NULL);
+	g_return_val_if_fail (cTmpDir != NULL, 1);
+	gchar *cSrc = g_build_filename (cTmpDir, "theme", NULL);
+	gchar *cDest = g_build_filename (cTmpDir, "current_theme", NULL);
+	gchar *cOutside = g_build_filename (cTmpDir, "outside", NULL);
+	g_mkdir_with_parents (cOutside, 0700);
+	gchar *cVictim = g_build_filename (cOutside, "victim", NULL);
+	_write_file (cVictim, 10, 'v');
+
+	//\_____________ a fake theme: some folders of images, a script, a link.
+	gchar *cPath;
+	int i, j, iNbFiles = 0;
+	for (i = 0; i < CD_NB_DIRS; i ++)
+	{
+		gchar *cDir = g_strdup_printf ("%s/launchers-%d", cSrc, i);
+		g_mkdir_with_parents (cDir, 0755);
+		for (j = 0; j < CD_NB_FILES_PER_DIR; j ++)
+		{
+			cPath = g_strdup_printf ("%s/icon-%d.png", cDir, j);
+			_write_file (cPath, CD_FILE_SIZE + j, 'a' + j);
+			g_free (cPath);
+			iNbFiles ++;
+		}
+		g_free (cDir);
+	}
+	gchar *cScript = g_build_filename (cSrc, "script.sh", NULL);
+	_write_file (cScript, 100, 's');
+	g_chmod (cScript, 0750);
+	gchar *cLink = g_build_filename (cSrc, "link.png", NULL);
+	_check (symlink ("launchers-0/icon-0.png", cLink) == 0, "creation of a link");
+	gchar *cConf = g_build_filename (cSrc, "cairo-dock.conf", NULL);
+	_write_file (cConf, 1000, 'c');
+	iNbFiles += 3;
+
+	//\_____________ first import.
+	gint iNbProcessed = 0;
+	gint64 iFirstTime = _copy (cSrc, cDest, TRUE, &iNbProcessed);
+	_check (iNbProcessed == iNbFiles, "number of processed files");
+
+	gchar *cCopy = g_build_filename (cDest, "launchers-3", "icon-7.png", NULL);
+	gchar *cOrig = g_build_filename (cSrc, "launchers-3", "icon-7.png", NULL);
+	_check (_same_content (cOrig, cCopy), "content of a copied file");
+	struct stat st, dest_st;
+	stat (cOrig, &st);
+	stat (cCopy, &dest_st);
+	_check (st.st_mtime == dest_st.st_mtime && st.st_size == dest_st.st_size, "date and size of a copied file");
+
+	gchar *cScriptCopy = g_build_filename (cDest, "script.sh", NULL);
+	stat (cScriptCopy, &dest_st);
+	_check ((dest_st.st_mode & 0777) == 0750, "permissions of a copied file");
+
+	gchar *cLinkCopy = g_build_filename (cDest, "link.png", NULL);
+	gchar *cTarget = g_file_read_link (cLinkCopy, NULL);
+	_check (g_strcmp0 (cTarget, "launchers-0/icon-0.png") == 0, "target of a copied link");
+	g_free (cTarget);
+
+	//\_____________ second import, after a change in the theme.
+	_tamper (cCopy);  // same size and date as the original: must be seen as unchanged, and left as is.
+	_write_file (cConf, 2000, 'C');  // changed in the theme: must be copied again.
+	gchar *cConfCopy = g_build_filename (cDest, "cairo-dock.conf", NULL);
+	g_remove (cConfCopy);
+	_check (symlink (cVictim, cConfCopy) == 0, "creation of a link in the copy");  // must be replaced, not written through.
+
+	gint64 iSecondTime = _copy (cSrc, cDest, TRUE, NULL);
+	_check (! _same_content (cOrig, cCopy), "an unchanged file is not copied again");
+	_check (_same_content (cConf, cConfCopy) && ! g_file_test (cConfCopy, G_FILE_TEST_IS_SYMLINK), "a changed file is copied again");
+	gsize iVictimSize = 0;
+	gchar *cVictimContent = NULL;
+	g_file_get_contents (cVictim, &cVictimContent, &iVictimSize, NULL);
+	_check (iVictimSize == 10, "a link in the copy is not written through");
+	g_free (cVictimContent);
+
+	_copy (cSrc, cDest, FALSE, NULL);
+	_check (_same_content (cOrig, cCopy), "every file is copied without the skip");
+
+	//\_____________ cancelled copy.
+	gchar *cCancelled = g_build_filename (cTmpDir, "cancelled", NULL);
+	gint iCancel = 1;
+	_check (! cairo_dock_copy_tree (cSrc, cCancelled, FALSE, &iCancel, NULL), "a cancelled copy fails");
+	_check (! g_file_test (cCancelled, G_FILE_TEST_EXISTS), "a cancelled copy doesn't write anything");
+	g_free (cCancelled);
+
+	//\_____________ removal, through a link to a folder outside of the copy.
+	gchar *cOutsideLink = g_build_filename (cDest, "outside", NULL);
+	_check (symlink (cOutside, cOutsideLink) == 0, "creation of a link to a folder");
+	gint iNbRemoved = 0;
+	_check (cairo_dock_remove_tree (cDest, NULL, &iNbRemoved), "removal of the copy");
+	_check (! g_file_test (cDest, G_FILE_TEST_EXISTS), "the copy is gone");
+	_check (g_file_test (cVictim, G_FILE_TEST_EXISTS), "the removal doesn't follow links");
+	_check (iNbRemoved > iNbFiles, "number of removed files");
+	_check (cairo_dock_remove_tree (cDest, NULL, NULL), "removal of a missing folder");
+	g_free (cOutsideLink);
+
+	g_print ("%d files of %dkB: first import in %.1fms, second one in %.1fms\n", iNbFiles, CD_FILE_SIZE / 1024, iFirstTime / 1e3, iSecondTime / 1e3);
+
+	cairo_dock_remove_tree (cTmpDir, NULL, NULL);
+	g_free (cConfCopy);
+	g_free (cLinkCopy);
+	g_free (cScriptCopy);
+	g_free (cOrig);
+	g_free (cCopy);
+	g_free (cConf);
+	g_free (cLink);
+	g_free (cScript);
+	g_free (cVictim);
+	g_free (cOutside);
+	g_free (cDest);
+	g_free (cSrc);
+	g_free (cTmpDir);
+
+	g_print ("%d error(s)\n", s_iNbErrors);
+	return (s_iNbErrors == 0 ? 0 : 1);
+}
@@ -0,0 +1,226 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Loads gauges from a copy of the default gauge theme, and checks that:
+// - a second gauge at a size already seen is drawn the same, while the theme's images are gone and its theme.xml is garbage (with the same date), ie. without parsing nor rasterizing anything;
+// - resizing a gauge back to a size already seen doesn't need the images either;
+// - a theme.xml with a new date is parsed again.
+// It also prints the time to load the first gauge and the second one.
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <cairo.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#include "cairo-dock-manager.h"
+#include "cairo-dock-data-renderer.h"
+#include "cairo-dock-data-renderer-manager.h"
+#include "cairo-dock-gauge.h"
+#include "cairo-dock-file-manager.h"
+
+#define CD_GAUGE_SIZE 64
+#define CD_OTHER_SIZE 48
+#define CD_VALUE 70.  // out of 100
+
+static const gchar *s_cImages[] = {"background.svg", "foreground.svg", "needle.svg", NULL};
+static int s_iNbErrors = 0;
+
+static void _check (gboolean bOk, const gchar *cWhat)
+{
+	if (! bOk)
+	{
+		g_printerr ("failed: %s\n", cWhat);
+		s_iNbErrors ++;
+	}
+}
+
+static CairoDataRenderer *_new_gauge (const gchar *cThemePath, int iSize, gint64 *pLoadTime)
+{
+	CairoDataRenderer *pRenderer = cairo_dock_new_data_renderer ("gauge");
+	CairoDataToRenderer *pData = &pRenderer->data;
+	pData->iNbValues = 1;
+	pData->iMemorySize = 2;
+	pData->pValuesBuffer = g_new0 (gdouble, 2);
+	pData->pTabValues = g_new (gdouble *, 2);
+	pData->pTabValues[0] = &pData->pValuesBuffer[0];
+	pData->pTabValues[1] = &pData->pValuesBuffer[1];
+	pData->pMinMaxValues = g_new (gdouble, 2);
+	pData->pMinMaxValues[0] = 0.;
+	pData->pMinMaxValues[1] = 100.;
+	pData->iCurrentIndex = -1;
+	pRenderer->iWidth = iSize;
+	pRenderer->iHeight = iSize;
+
+	CairoGaugeAttribute attr;
+	memset (&attr, 0, sizeof (attr));
+	attr.cThemePath = cThemePath;
+	gint64 t0 = g_get_monotonic_time ();
+	pRenderer->interface.load (pRenderer, NULL, CAIRO_DATA_RENDERER_ATTRIBUTE (&attr));
+	if (pLoadTime)
+		*pLoadTime = g_get_monotonic_time () - t0;
+
+	double x = CD_VALUE;
+	cairo_data_renderer_push_values (pRenderer, &x);
+	return pRenderer;
+}
+
+static void _resize_gauge (CairoDataRenderer *pRenderer, int iSize)
+{
+	pRenderer->iWidth = iSize;
+	pRenderer->iHeight = iSize;
+	pRenderer->interface.reload (pRenderer);
+}
+
+static void _free_gauge (CairoDataRenderer *pRenderer)
+{
+	pRenderer->interface.unload (pRenderer);
+	g_free (pRenderer->data.pValuesBuffer);
+	g_free (pRenderer->data.pTabValues);
+	g_free (pRenderer->data.pMinMaxValues);
+	g_free (pRenderer);
+}
+
+static cairo_surface_t *_render (CairoDataRenderer *pRenderer)
+{
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, CD_GAUGE_SIZE, CD_GAUGE_SIZE);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	pRenderer->interface.render (pRenderer, pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_flush (pSurface);
+	return pSurface;
+}
+
+static gboolean _same_pixels (cairo_surface_t *s1, cairo_surface_t *s2)
+{
+	int iStride = cairo_image_surface_get_stride (s1);
+	return (memcmp (cairo_image_surface_get_data (s1), cairo_image_surface_get_data (s2), iStride * CD_GAUGE_SIZE) == 0);
+}
+
+static gboolean _is_empty (cairo_surface_t *pSurface)
+{
+	const guchar *p = cairo_image_surface_get_data (pSurface);
+	int i, n = cairo_image_surface_get_stride (pSurface) * CD_GAUGE_SIZE;
+	for (i = 0; i < n; i ++)
+	{
+		if (p[i] != 0)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+// replace the content of a file and set its date.
+static void _rewrite_file (const gchar *cPath, const gchar *cContent, time_t iMTime)
+{
+	g_file_set_contents (cPath, cContent, -1, NULL);
+	struct timespec times[2] = {{iMTime, 0}, {iMTime, 0}};
+	utimensat (AT_FDCWD, cPath, times, 0);
+}
+
+static void _hide_images (const gchar *cThemePath, gboolean bHide)
+{
+	int i;
+	for (i = 0; s_cImages[i] != NULL; i ++)
+	{
+		gchar *cPath = g_strdup_printf ("%s/%s", cThemePath, s_cImages[i]);
+		gchar *cHiddenPath = g_strdup_printf ("%s.bak", cPath);
+		if (bHide)
+			g_rename (cPath, cHiddenPath);
+		else
+			g_rename (cHiddenPath, cPath);
+		g_free (cHiddenPath);
+		g_free (cPath);
+	}
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	// just what is needed to create gauges.
+	gldi_register_managers_manager ();
+	gldi_register_data_renderers_manager ();
+	myDataRenderersMgr.init ();
+	cairo_dock_register_data_renderer_gauge ();
+
+	gchar *cTmpDir = g_dir_make_tmp ("cairo-dock-test-XXXXXX", NULL);
+	g_return_val_if_fail (cTmpDir != NULL, 1);
+	gchar *cThemePath = g_build_filename (cTmpDir, "turbo-night-fuel", NULL);
+	if (! cairo_dock_copy_tree (CD_TEST_DATA_DIR"/gauges/turbo-night-fuel", cThemePath, FALSE, NULL, NULL))
+	{
+		g_printerr ("couldn't copy the gauge theme\n");
+		return 1;
+	}
+	gchar *cXmlFile = g_build_filename (cThemePath, "theme.xml", NULL);
+	gchar *cXml = NULL;
+	g_file_get_contents (cXmlFile, &cXml, NULL, NULL);
+	GStatBuf st;
+	g_stat (cXmlFile, &st);
+
+	//\_____________ first gauge: the theme is parsed and its images are rasterized.
+	gint64 iFirstTime, iSecondTime;
+	CairoDataRenderer *pGauge1 = _new_gauge (cThemePath, CD_GAUGE_SIZE, &iFirstTime);
+	cairo_surface_t *pReference = _render (pGauge1);
+	_check (! _is_empty (pReference), "the gauge is drawn");
+
+	//\_____________ second gauge at the same size, without the theme's files.
+	_hide_images (cThemePath, TRUE);
+	_rewrite_file (cXmlFile, "garbage", st.st_mtime);
+	CairoDataRenderer *pGauge2 = _new_gauge (cThemePath, CD_GAUGE_SIZE, &iSecondTime);
+	cairo_surface_t *pSurface = _render (pGauge2);
+	_check (_same_pixels (pSurface, pReference), "a gauge at a known size is loaded from the cache");
+	cairo_surface_destroy (pSurface);
+
+	//\_____________ resize the first gauge, and back to its size.
+	_resize_gauge (pGauge1, CD_OTHER_SIZE);  // the images are missing, nothing can be rasterized at this size.
+	_resize_gauge (pGauge1, CD_GAUGE_SIZE);
+	pSurface = _render (pGauge1);
+	_check (_same_pixels (pSurface, pReference), "a gauge resized to a known size is loaded from the cache");
+	cairo_surface_destroy (pSurface);
+
+	//\_____________ a modified theme is parsed again.
+	_hide_images (cThemePath, FALSE);
+	gchar *cModifiedXml = g_strdup (cXml);
+	gchar *str = strstr (cModifiedXml, "<posStart>-43</posStart>");
+	_check (str != NULL, "the theme has a needle");
+	if (str != NULL)
+		memcpy (str, "<posStart>-90</posStart>", strlen ("<posStart>-90</posStart>"));
+	_rewrite_file (cXmlFile, cModifiedXml, st.st_mtime + 10);
+	CairoDataRenderer *pGauge3 = _new_gauge (cThemePath, CD_GAUGE_SIZE, NULL);
+	pSurface = _render (pGauge3);
+	_check (! _is_empty (pSurface) && ! _same_pixels (pSurface, pReference), "a modified theme is parsed again");
+	cairo_surface_destroy (pSurface);
+
+	_check (iSecondTime < iFirstTime, "a cached gauge loads faster");
+	g_print ("first gauge loaded in %.2fms, second one in %.2fms\n", iFirstTime / 1e3, iSecondTime / 1e3);
+
+	_free_gauge (pGauge3);
+	_free_gauge (pGauge2);
+	_free_gauge (pGauge1);
+	cairo_surface_destroy (pReference);
+	cairo_dock_remove_tree (cTmpDir, NULL, NULL);
+	g_free (cModifiedXml);
+	g_free (cXml);
+	g_free (cXmlFile);
+	g_free (cThemePath);
+	g_free (cTmpDir);
+
+	g_print ("%d error(s)\n", s_iNbErrors);
+	return (s_iNbErrors == 0 ? 0 : 1);
+}
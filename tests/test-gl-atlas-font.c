@@ -0,0 +1,300 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Draws texts with a glyph-atlas font in a GLX window, reads the pixels back, and checks that:
+// - the text is drawn exactly like its glyphs rendered by Pango and put one after the other, with nothing around;
+// - it's still the case once the atlas has been filled and started again;
+// - the extent of a text is the sum of the advances of its glyphs.
+// It also prints the time to draw changing values with the atlas, compared to making a texture for each text.
+// It needs an X server with GLX (e.g. 'xvfb-run ctest' with Mesa), and is skipped (code 77) without one.
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <cairo.h>
+#include <pango/pangocairo.h>
+
+#include "gldi-config.h"
+#ifdef HAVE_GLX
+#include <X11/Xlib.h>
+#include <GL/gl.h>
+#include <GL/glx.h>
+
+#include "cairo-dock-opengl-font.h"
+
+#define CD_FONT "Sans 20"
+#define CD_WIDTH 256
+#define CD_HEIGHT 64
+#define CD_X 10
+#define CD_Y 20
+#define CD_PADDING 1  // as in the atlas
+#define CD_TOLERANCE 2
+#define CD_NB_FILLING_CHARS 3000  // way more than the atlas can hold at this size.
+#define CD_NB_VALUES 1000
+
+static int s_iNbErrors = 0;
+
+static void _check (gboolean bOk, const gchar *cWhat)
+{
+	if (! bOk)
+	{
+		g_printerr ("failed: %s\n", cWhat);
+		s_iNbErrors ++;
+	}
+}
+
+  //////////////////
+ /// REFERENCE ///
+//////////////////
+
+static PangoLayout *_create_layout (cairo_t *ctx, const gchar *cText)
+{
+	PangoLayout *pLayout = pango_cairo_create_layout (ctx);
+	PangoFontDescription *pDesc = pango_font_description_from_string (CD_FONT);
+	pango_layout_set_font_description (pLayout, pDesc);
+	pango_font_description_free (pDesc);
+	pango_layout_set_text (pLayout, cText, -1);
+	return pLayout;
+}
+
+static void _get_logical_extent (const gchar *cText, PangoRectangle *log)
+{
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *ctx = cairo_create (pSurface);
+	PangoLayout *pLayout = _create_layout (ctx, cText);
+	pango_layout_get_pixel_extents (pLayout, NULL, log);
+	g_object_unref (pLayout);
+	cairo_destroy (ctx);
+	cairo_surface_destroy (pSurface);
+}
+
+static int _get_line_height (void)
+{
+	PangoRectangle log;
+	_get_logical_extent ("0", &log);
+	return log.height;
+}
+
+// what the text should look like in the window (upside down, since GL rows go from the bottom): each glyph rendered alone, in white, at the advance of the previous ones.
+static cairo_surface_t *_make_reference (const gchar *cText, int *iTextWidth)
+{
+	cairo_surface_t *pReference = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, CD_WIDTH, CD_HEIGHT);
+	cairo_t *pCairoContext = cairo_create (pReference);
+	int h = _get_line_height () + 2 * CD_PADDING;
+	int x = CD_X;
+	const gchar *str;
+	gchar utf8[8];
+	PangoRectangle log;
+	for (str = cText; *str != '\0'; str = g_utf8_next_char (str))
+	{
+		utf8[g_unichar_to_utf8 (g_utf8_get_char (str), utf8)] = '\0';
+		_get_logical_extent (utf8, &log);
+		cairo_surface_t *pCell = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, log.width + 2 * CD_PADDING, h);
+		cairo_t *ctx = cairo_create (pCell);
+		PangoLayout *pLayout = _create_layout (ctx, utf8);
+		cairo_translate (ctx, CD_PADDING - log.x, CD_PADDING);
+		cairo_set_source_rgb (ctx, 1., 1., 1.);
+		cairo_move_to (ctx, 0, 0);
+		pango_cairo_show_layout (ctx, pLayout);
+		g_object_unref (pLayout);
+		cairo_destroy (ctx);
+
+		cairo_set_source_surface (pCairoContext, pCell, x - CD_PADDING, CD_HEIGHT - CD_Y - h + CD_PADDING);
+		cairo_paint (pCairoContext);
+		cairo_surface_destroy (pCell);
+		x += log.width;
+	}
+	cairo_destroy (pCairoContext);
+	cairo_surface_flush (pReference);
+	if (iTextWidth)
+		*iTextWidth = x - CD_X;
+	return pReference;
+}
+
+  //////////
+ /// GL ///
+//////////
+
+static void _draw_text (CairoDockGLFont *pFont, const gchar *cText)
+{
+	glClearColor (0., 0., 0., 0.);
+	glClear (GL_COLOR_BUFFER_BIT);
+	glColor4f (1., 1., 1., 1.);
+	glPushMatrix ();
+	cairo_dock_draw_gl_text_at_position ((const guchar *) cText, pFont, CD_X, CD_Y);
+	glPopMatrix ();
+}
+
+static gboolean _same_as_reference (cairo_surface_t *pReference)
+{
+	static guchar pPixels[CD_WIDTH * CD_HEIGHT * 4];
+	glFinish ();
+	glReadBuffer (GL_BACK);
+	glPixelStorei (GL_PACK_ALIGNMENT, 1);
+	glReadPixels (0, 0, CD_WIDTH, CD_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, pPixels);
+
+	const guchar *pRefData = cairo_image_surface_get_data (pReference);
+	int iStride = cairo_image_surface_get_stride (pReference);
+	int x, y, r, ref;
+	for (y = 0; y < CD_HEIGHT; y ++)
+	{
+		for (x = 0; x < CD_WIDTH; x ++)
+		{
+			r = pPixels[4 * (y * CD_WIDTH + x)];  // the text is white, so the red channel is enough.
+			ref = (((const guint32 *)(pRefData + (CD_HEIGHT - 1 - y) * iStride))[x] >> 16) & 0xFF;
+			if (ABS (r - ref) > CD_TOLERANCE)
+			{
+				g_printerr ("pixel (%d;%d) is %d instead of %d\n", x, y, r, ref);
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static void _check_text (CairoDockGLFont *pFont, const gchar *cText, const gchar *cWhat)
+{
+	int iTextWidth, w, h;
+	cairo_surface_t *pReference = _make_reference (cText, &iTextWidth);
+	_draw_text (pFont, cText);
+	_check (_same_as_reference (pReference), cWhat);
+	cairo_dock_get_gl_text_extent (cText, pFont, &w, &h);
+	_check (w == iTextWidth && h == _get_line_height (), "extent of a text");
+	cairo_surface_destroy (pReference);
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	Display *dpy = XOpenDisplay (NULL);
+	if (dpy == NULL)
+	{
+		g_print ("no X display, skipped\n");
+		return 77;
+	}
+	int attr[] = {GLX_RGBA, GLX_RED_SIZE, 8, GLX_GREEN_SIZE, 8, GLX_BLUE_SIZE, 8, GLX_DOUBLEBUFFER, None};
+	XVisualInfo *pVisInfo = glXChooseVisual (dpy, DefaultScreen (dpy), attr);
+	if (pVisInfo == NULL)
+	{
+		g_print ("no GLX visual, skipped\n");
+		return 77;
+	}
+	XSetWindowAttributes wattr;
+	memset (&wattr, 0, sizeof (wattr));
+	wattr.colormap = XCreateColormap (dpy, DefaultRootWindow (dpy), pVisInfo->visual, AllocNone);
+	Window win = XCreateWindow (dpy, DefaultRootWindow (dpy), 0, 0, CD_WIDTH, CD_HEIGHT, 0, pVisInfo->depth, InputOutput, pVisInfo->visual, CWColormap, &wattr);
+	XMapWindow (dpy, win);
+	GLXContext context = glXCreateContext (dpy, pVisInfo, NULL, True);
+	if (context == NULL || ! glXMakeCurrent (dpy, win, context))
+	{
+		g_print ("no GLX context, skipped\n");
+		return 77;
+	}
+	XSync (dpy, False);
+
+	glViewport (0, 0, CD_WIDTH, CD_HEIGHT);
+	glMatrixMode (GL_PROJECTION);
+	glLoadIdentity ();
+	glOrtho (0, CD_WIDTH, 0, CD_HEIGHT, -1., 1.);
+	glMatrixMode (GL_MODELVIEW);
+	glLoadIdentity ();
+
+	//\_____________ some texts, with glyphs added to the atlas as they come.
+	CairoDockGLFont *pFont = cairo_dock_load_atlas_font (CD_FONT);
+	_check_text (pFont, "8", "a glyph is drawn as rendered by Pango");
+	_check_text (pFont, "88", "a glyph is drawn again from the atlas");
+	_check_text (pFont, "12.5%", "glyphs are put one after the other");
+
+	int w, h;
+	cairo_dock_get_gl_text_extent ("8\n88", pFont, &w, &h);
+	_check (h == 2 * _get_line_height () + 1, "extent of a multi-line text");
+
+	//\_____________ fill the atlas, so that it has to start again.
+	GString *sText = g_string_new ("");
+	gunichar c;
+	for (c = 0x4E00; c < 0x4E00 + CD_NB_FILLING_CHARS; c ++)
+	{
+		g_string_append_unichar (sText, c);
+		if (sText->len > 3 * 20)  // a few glyphs at a time, like a real text.
+		{
+			_draw_text (pFont, sText->str);
+			g_string_truncate (sText, 0);
+		}
+	}
+	g_string_free (sText, TRUE);
+	_check_text (pFont, "12.5%", "glyphs are drawn right once the atlas has been cleared");
+
+	//\_____________ timings: changing values, like a data-renderer does.
+	gchar cValue[16];
+	int i;
+	gint64 t0 = g_get_monotonic_time ();
+	for (i = 0; i < CD_NB_VALUES; i ++)
+	{
+		snprintf (cValue, sizeof (cValue), "%.1f%%", i / 10.);
+		_draw_text (pFont, cValue);
+	}
+	glFinish ();
+	gint64 iAtlasTime = g_get_monotonic_time () - t0;
+
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *pSourceContext = cairo_create (pSurface);
+	t0 = g_get_monotonic_time ();
+	for (i = 0; i < CD_NB_VALUES; i ++)
+	{
+		snprintf (cValue, sizeof (cValue), "%.1f%%", i / 10.);
+		GLuint iTexture = cairo_dock_create_texture_from_text_simple (cValue, CD_FONT, pSourceContext, &w, &h);
+		glClear (GL_COLOR_BUFFER_BIT);
+		glEnable (GL_TEXTURE_2D);
+		glBindTexture (GL_TEXTURE_2D, iTexture);
+		glBegin (GL_QUADS);
+		glTexCoord2f (0., 0.); glVertex3f (CD_X, CD_Y + h, 0.);
+		glTexCoord2f (1., 0.); glVertex3f (CD_X + w, CD_Y + h, 0.);
+		glTexCoord2f (1., 1.); glVertex3f (CD_X + w, CD_Y, 0.);
+		glTexCoord2f (0., 1.); glVertex3f (CD_X, CD_Y, 0.);
+		glEnd ();
+		glDisable (GL_TEXTURE_2D);
+		glDeleteTextures (1, &iTexture);
+	}
+	glFinish ();
+	gint64 iTextureTime = g_get_monotonic_time () - t0;
+	cairo_destroy (pSourceContext);
+	cairo_surface_destroy (pSurface);
+
+	_check (iAtlasTime < iTextureTime, "the atlas is faster than a texture per text");
+	g_print ("%d values: %.1fus each with the atlas, %.1fus each with a texture per text\n", CD_NB_VALUES, (double)iAtlasTime / CD_NB_VALUES, (double)iTextureTime / CD_NB_VALUES);
+
+	cairo_dock_free_gl_font (pFont);
+	glXMakeCurrent (dpy, None, NULL);
+	glXDestroyContext (dpy, context);
+	XDestroyWindow (dpy, win);
+	XFree (pVisInfo);
+	XCloseDisplay (dpy);
+
+	g_print ("%d error(s)\n", s_iNbErrors);
+	return (s_iNbErrors == 0 ? 0 : 1);
+}
+
+#else
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	g_print ("built without GLX support, skipped\n");
+	return 77;
+}
+
+#endif
@@ -0,0 +1,189 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Makes thumbnails of pixmaps drawn on the X server, the way it's done for minimized windows, and checks that:
+// - the thumbnail has the requested size, and the pixmap is scaled into it with its ratio kept and centered;
+// - the pixels of an ARGB pixmap keep their transparency;
+// - an invalid pixmap gives no thumbnail.
+// It also prints the time to make a thumbnail of a screen-sized pixmap, compared to copying the whole pixmap.
+// It needs an X server (e.g. 'xvfb-run ctest'), and is skipped (code 77) without one.
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+#include <cairo.h>
+
+#include "gldi-config.h"
+#ifdef HAVE_X11
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <gdk-pixbuf/gdk-pixbuf.h>
+
+#include "cairo-dock-X-utilities.h"
+
+#define CD_THUMBNAIL_SIZE 48
+#define CD_PIXMAP_WIDTH 400
+#define CD_PIXMAP_HEIGHT 200
+#define CD_SCREEN_WIDTH 1920
+#define CD_SCREEN_HEIGHT 1080
+#define CD_TOLERANCE 8
+
+static int s_iNbErrors = 0;
+
+static void _check (gboolean bOk, const gchar *cWhat)
+{
+	if (! bOk)
+	{
+		g_printerr ("failed: %s\n", cWhat);
+		s_iNbErrors ++;
+	}
+}
+
+// a pixmap with its left half in one color and its right half in another one.
+static Pixmap _make_pixmap (Display *dpy, int iWidth, int iHeight, int iDepth, unsigned long iLeftPixel, unsigned long iRightPixel)
+{
+	Pixmap pixmap = XCreatePixmap (dpy, DefaultRootWindow (dpy), iWidth, iHeight, iDepth);
+	GC gc = XCreateGC (dpy, pixmap, 0, NULL);
+	XSetForeground (dpy, gc, iLeftPixel);
+	XFillRectangle (dpy, pixmap, gc, 0, 0, iWidth / 2, iHeight);
+	XSetForeground (dpy, gc, iRightPixel);
+	XFillRectangle (dpy, pixmap, gc, iWidth / 2, 0, iWidth - iWidth / 2, iHeight);
+	XFreeGC (dpy, gc);
+	XSync (dpy, False);
+	return pixmap;
+}
+
+// the ARGB (premultiplied) value of a pixel of an image surface.
+static guint32 _get_pixel (cairo_surface_t *pSurface, int x, int y)
+{
+	cairo_surface_flush (pSurface);
+	const guchar *p = cairo_image_surface_get_data (pSurface) + y * cairo_image_surface_get_stride (pSurface);
+	return ((const guint32 *)p)[x];
+}
+
+static gboolean _is_close (guint32 iPixel, guint32 iExpected)
+{
+	int i;
+	for (i = 0; i < 32; i += 8)
+	{
+		if (ABS ((int)((iPixel >> i) & 0xFF) - (int)((iExpected >> i) & 0xFF)) > CD_TOLERANCE)
+			return FALSE;
+	}
+	return TRUE;
+}
+
+static void _check_pixel (cairo_surface_t *pSurface, int x, int y, guint32 iExpected, const gchar *cWhat)
+{
+	guint32 iPixel = _get_pixel (pSurface, x, y);
+	if (! _is_close (iPixel, iExpected))
+		g_printerr ("pixel (%d;%d) is 0x%08x instead of 0x%08x\n", x, y, iPixel, iExpected);
+	_check (_is_close (iPixel, iExpected), cWhat);
+}
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	Display *dpy = XOpenDisplay (NULL);
+	if (dpy == NULL)
+	{
+		g_print ("no X display, skipped\n");
+		return 77;
+	}
+	XCloseDisplay (dpy);
+	dpy = cairo_dock_initialize_X_desktop_support ();
+	g_return_val_if_fail (dpy != NULL, 1);
+	int iDepth = DefaultDepth (dpy, 0);
+	if (iDepth != 24)
+	{
+		g_print ("the X screen has a depth of %d instead of 24, skipped\n", iDepth);
+		return 77;
+	}
+
+	//\_____________ a wide pixmap: scaled to the width of the thumbnail, and centered vertically.
+	Pixmap pixmap = _make_pixmap (dpy, CD_PIXMAP_WIDTH, CD_PIXMAP_HEIGHT, iDepth, 0xFF0000, 0x0000FF);
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_xpixmap (pixmap, CD_THUMBNAIL_SIZE, CD_THUMBNAIL_SIZE);
+	_check (pSurface != NULL, "a thumbnail is made from a pixmap");
+	if (pSurface != NULL)
+	{
+		_check (cairo_image_surface_get_width (pSurface) == CD_THUMBNAIL_SIZE && cairo_image_surface_get_height (pSurface) == CD_THUMBNAIL_SIZE, "size of the thumbnail");
+		int h = CD_THUMBNAIL_SIZE * CD_PIXMAP_HEIGHT / CD_PIXMAP_WIDTH;  // height of the pixmap in the thumbnail.
+		int y0 = (CD_THUMBNAIL_SIZE - h) / 2;
+		_check_pixel (pSurface, CD_THUMBNAIL_SIZE / 4, CD_THUMBNAIL_SIZE / 2, 0xFFFF0000, "left part of the pixmap");
+		_check_pixel (pSurface, 3 * CD_THUMBNAIL_SIZE / 4, CD_THUMBNAIL_SIZE / 2, 0xFF0000FF, "right part of the pixmap");
+		_check_pixel (pSurface, CD_THUMBNAIL_SIZE / 4, y0 + 2, 0xFFFF0000, "top of the pixmap");
+		_check_pixel (pSurface, CD_THUMBNAIL_SIZE / 4, y0 - 3, 0x00000000, "the ratio is kept (above the pixmap)");
+		_check_pixel (pSurface, 3 * CD_THUMBNAIL_SIZE / 4, y0 + h + 2, 0x00000000, "the ratio is kept (below the pixmap)");
+		cairo_surface_destroy (pSurface);
+	}
+	XFreePixmap (dpy, pixmap);
+
+	//\_____________ an ARGB pixmap, like the one of a window with an RGBA visual.
+	XVisualInfo vinfo;
+	if (XMatchVisualInfo (dpy, 0, 32, TrueColor, &vinfo))
+	{
+		pixmap = _make_pixmap (dpy, CD_PIXMAP_HEIGHT, CD_PIXMAP_WIDTH, 32, 0x80008000, 0x00000000);  // half-transparent green (premultiplied) | fully transparent.
+		pSurface = cairo_dock_create_surface_from_xpixmap (pixmap, CD_THUMBNAIL_SIZE, CD_THUMBNAIL_SIZE);
+		_check (pSurface != NULL, "a thumbnail is made from an ARGB pixmap");
+		if (pSurface != NULL)
+		{
+			_check_pixel (pSurface, CD_THUMBNAIL_SIZE / 2 - 6, CD_THUMBNAIL_SIZE / 2, 0x80008000, "transparency of an ARGB pixmap");
+			_check_pixel (pSurface, CD_THUMBNAIL_SIZE / 2 + 6, CD_THUMBNAIL_SIZE / 2, 0x00000000, "transparent part of an ARGB pixmap");
+			cairo_surface_destroy (pSurface);
+		}
+		XFreePixmap (dpy, pixmap);
+	}
+	else
+		g_print ("no 32-bit visual, ARGB pixmaps are not tested\n");
+
+	//\_____________ a pixmap that doesn't exist (any more).
+	pixmap = _make_pixmap (dpy, 10, 10, iDepth, 0, 0);
+	XFreePixmap (dpy, pixmap);
+	XSync (dpy, False);
+	pSurface = cairo_dock_create_surface_from_xpixmap (pixmap, CD_THUMBNAIL_SIZE, CD_THUMBNAIL_SIZE);
+	_check (pSurface == NULL, "an invalid pixmap gives no thumbnail");
+	if (pSurface != NULL)
+		cairo_surface_destroy (pSurface);
+
+	//\_____________ timings, with a screen-sized pixmap.
+	pixmap = _make_pixmap (dpy, CD_SCREEN_WIDTH, CD_SCREEN_HEIGHT, iDepth, 0x336699, 0x996633);
+	gint64 t0 = g_get_monotonic_time ();
+	pSurface = cairo_dock_create_surface_from_xpixmap (pixmap, CD_THUMBNAIL_SIZE, CD_THUMBNAIL_SIZE);
+	gint64 iThumbnailTime = g_get_monotonic_time () - t0;
+	if (pSurface != NULL)
+		cairo_surface_destroy (pSurface);
+	t0 = g_get_monotonic_time ();
+	GdkPixbuf *pPixbuf = cairo_dock_get_pixbuf_from_pixmap (pixmap, TRUE);  // what was done before: the whole pixmap is copied out of the X server.
+	gint64 iCopyTime = g_get_monotonic_time () - t0;
+	if (pPixbuf != NULL)
+		g_object_unref (pPixbuf);
+	XFreePixmap (dpy, pixmap);
+	g_print ("%dx%d pixmap: thumbnail in %.2fms, full copy in %.2fms\n", CD_SCREEN_WIDTH, CD_SCREEN_HEIGHT, iThumbnailTime / 1e3, iCopyTime / 1e3);
+
+	g_print ("%d error(s)\n", s_iNbErrors);
+	return (s_iNbErrors == 0 ? 0 : 1);
+}
+
+#else
+
+int main (G_GNUC_UNUSED int argc, G_GNUC_UNUSED char **argv)
+{
+	g_print ("built without X support, skipped\n");
+	return 77;
+}
+
+#endif